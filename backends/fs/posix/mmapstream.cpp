@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#if defined(UNIX)
+
+// Disable symbol overrides so that we can use open, close etc.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/mmapstream.h"
+
+#include "common/mutex.h"
+#include "common/system.h"
+
+#if !defined(__OS2__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Files smaller than this are left to stdio, mapping them costs more
+// than it saves
+static const off_t kMinMappedFileSize = 64 * 1024;
+
+// Files larger than this are left to stdio as well, and all mappings
+// together stay below the total, so that games with many large data
+// files don't use up the address space
+static const off_t kMaxMappedFileSize = 32 * 1024 * 1024;
+static const uint32 kMaxMappedTotalSize = 128 * 1024 * 1024;
+
+// Streams may be deleted from the audio thread
+static uint32 s_mappedTotalSize = 0;
+static Common::Mutex *s_mappedTotalSizeMutex = 0;
+
+MMapReadStream *MMapReadStream::makeFromPath(const Common::String &path) {
+#if defined(__OS2__)
+	return 0;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat st;
+	if (!g_system || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < kMinMappedFileSize || st.st_size > kMaxMappedFileSize) {
+		close(fd);
+		return 0;
+	}
+
+	// The first stream is always created on the main thread
+	if (!s_mappedTotalSizeMutex)
+		s_mappedTotalSizeMutex = new Common::Mutex();
+
+	{
+		Common::StackLock lock(*s_mappedTotalSizeMutex);
+
+		if (s_mappedTotalSize + st.st_size > kMaxMappedTotalSize) {
+			close(fd);
+			return 0;
+		}
+
+		s_mappedTotalSize += st.st_size;
+	}
+
+	// The mapping stays valid after closing the file
+	void *mapping = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED) {
+		Common::StackLock lock(*s_mappedTotalSizeMutex);
+		s_mappedTotalSize -= st.st_size;
+		return 0;
+	}
+
+	return new MMapReadStream(mapping, st.st_size);
+#endif
+}
+
+MMapReadStream::MMapReadStream(void *mapping, uint32 size)
+	: MemoryReadStream((const byte *)mapping, size), _mapping(mapping), _mappingSize(size) {
+}
+
+MMapReadStream::~MMapReadStream() {
+#if !defined(__OS2__)
+	munmap(_mapping, _mappingSize);
+
+	Common::StackLock lock(*s_mappedTotalSizeMutex);
+	s_mappedTotalSize -= _mappingSize;
+#endif
+}
+
+#endif
@@ -0,0 +1,63 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_MMAPSTREAM_H
+#define BACKENDS_FS_POSIX_MMAPSTREAM_H
+
+#include "common/scummsys.h"
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+/**
+ * A read stream on a file mapped into memory. Reads are copies from the
+ * mapping, without any system calls, and getDataPtr() gives access to the
+ * whole file.
+ *
+ * The file must not be truncated while the stream exists: accessing the
+ * pages beyond its new end is an error the system reports with a signal.
+ */
+class MMapReadStream : public Common::MemoryReadStream, public Common::NonCopyable {
+public:
+	/**
+	 * Given a path, maps the regular file at that path into memory and
+	 * wraps the mapping in a MMapReadStream instance.
+	 *
+	 * @return the stream, or 0 if the file couldn't be mapped, is too
+	 *         small to be worth mapping or too large for the mappings
+	 *         left; use StdioStream then.
+	 */
+	static MMapReadStream *makeFromPath(const Common::String &path);
+
+	virtual ~MMapReadStream();
+
+private:
+	MMapReadStream(void *mapping, uint32 size);
+
+	void *_mapping;
+	uint32 _mappingSize;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #if defined(UNIX)
 
 #include "backends/fs/posix/posix-fs.h"
+#include "backends/fs/posix/mmapstream.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
 
@@ -238,6 +239,12 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+	// Map larger files into memory, which saves the system calls and
+	// copies of stdio on every read and seek
+	Common::SeekableReadStream *stream = MMapReadStream::makeFromPath(getPath());
+	if (stream)
+		return stream;
+
 	return StdioStream::makeFromPath(getPath().c_str(), false);
 }
 
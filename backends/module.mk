@@ -15,6 +15,7 @@ MODULE_OBJS := \
 	fs/abstract-fs.o \
 	fs/stdiostream.o \
 	fs/amigaos4/amigaos4-fs-factory.o \
+	fs/posix/mmapstream.o \
 	fs/posix/posix-fs-factory.o \
 	fs/symbian/symbian-fs-factory.o \
 	fs/windows/windows-fs-factory.o \
@@ -27,6 +27,8 @@
 #define COMMON_BUFFEREDSTREAM_H
 
 #include "common/stream.h"
+#include "common/noncopyable.h"
+#include "common/mutex.h"
 
 namespace Common {
 
@@ -63,6 +65,91 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
  */
 WriteStream *wrapBufferedWriteStream(WriteStream *parentStream, uint32 bufSize);
 
+/**
+ * Wrapper class reading a SeekableReadStream in windows, meant for
+ * streams mostly read sequentially, like videos.
+ *
+ * The window grows, up to a maximum size, while the stream is read
+ * sequentially, and falls back to the minimum size after seeking
+ * elsewhere. Optionally, the window following the current one is read
+ * ahead from a timer callback, which the backend may run in a separate
+ * thread, so that reading it later doesn't have to wait for the parent
+ * stream.
+ *
+ * The time read() spent waiting for the parent stream is recorded, to
+ * see how much a consumer is slowed down by I/O.
+ */
+class ReadAheadSeekableReadStream : public SeekableReadStream, public NonCopyable {
+public:
+	ReadAheadSeekableReadStream(SeekableReadStream *parentStream, DisposeAfterUse::Flag disposeParentStream,
+	                            uint32 minWindowSize = 4 * 1024, uint32 maxWindowSize = 128 * 1024);
+	virtual ~ReadAheadSeekableReadStream();
+
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const;
+	virtual void clearErr();
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+	virtual bool seek(int32 offset, int whence = SEEK_SET);
+
+	/**
+	 * Enable or disable reading the next window ahead in the background.
+	 * This needs the timer manager of g_system, and is off by default.
+	 */
+	void setBackgroundReading(bool enable);
+
+	/** Returns the current window size. */
+	uint32 getWindowSize() const { return _windowSize; }
+
+	/** Returns how often read() had to wait for the parent stream. */
+	uint32 getStallCount() const { return _stallCount; }
+
+	/** Returns the time in ms read() spent waiting for the parent stream. */
+	uint32 getStallTime() const { return _stallTime; }
+
+private:
+	struct Window {
+		byte *data;
+		uint32 start;	///< Position of the data in the stream
+		uint32 size;	///< Number of bytes read, 0 if none
+	};
+
+	/** Makes the data at _pos available; returns the bytes read directly into dst instead. */
+	uint32 refill(byte *dst, uint32 dataSize);
+	uint32 readParent(byte *dst, uint32 start, uint32 dataSize);
+
+	void lock() const;
+	void unlock() const;
+
+	void readAhead();
+	static void readAheadProc(void *refCon);
+	static void registerStream(ReadAheadSeekableReadStream *stream, bool add);
+
+	SeekableReadStream *_parentStream;
+	DisposeAfterUse::Flag _disposeParentStream;
+	uint32 _parentPos;
+	int32 _size;
+
+	uint32 _pos;
+	bool _eos;
+
+	Window _cur;
+	Window _next;		///< The window after _cur, once read ahead
+	bool _nextWanted;	///< Whether _next should be read ahead
+
+	uint32 _minWindowSize;
+	uint32 _maxWindowSize;
+	uint32 _windowSize;
+
+	MutexRef _mutex;	///< Only used while reading in the background
+
+	uint32 _stallCount;
+	uint32 _stallTime;
+};
+
 }	// End of namespace Common
 
 #endif
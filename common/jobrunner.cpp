@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "common/jobrunner.h"
+
+#include "common/list.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+namespace Common {
+
+// All the runners share one timer callback, since removing a timer
+// callback removes all of its instances. The list is only modified while
+// the callback is removed, so the callback can walk it without locking.
+static List<JobRunner *> *s_runners = 0;
+
+JobRunner::JobRunner() : _proc(0), _refCon(0), _count(0), _next(0), _done(0) {
+	registerRunner(this, true);
+}
+
+JobRunner::~JobRunner() {
+	registerRunner(this, false);
+}
+
+void JobRunner::registerRunner(JobRunner *runner, bool add) {
+	TimerManager *timer = g_system->getTimerManager();
+
+	// Once removed, the callback isn't running anymore
+	timer->removeTimerProc(timerProc);
+
+	if (!s_runners)
+		s_runners = new List<JobRunner *>();
+
+	if (add)
+		s_runners->push_back(runner);
+	else
+		s_runners->remove(runner);
+
+	if (!s_runners->empty()) {
+		timer->installTimerProc(timerProc, kTimerInterval, 0);
+	} else {
+		delete s_runners;
+		s_runners = 0;
+	}
+}
+
+void JobRunner::timerProc(void *refCon) {
+	for (List<JobRunner *>::iterator it = s_runners->begin(); it != s_runners->end(); ++it) {
+		while ((*it)->runNextJob())
+			;
+	}
+}
+
+void JobRunner::run(JobProc proc, void *refCon, uint count) {
+	assert(proc);
+
+	if (count == 0)
+		return;
+
+	// A single job isn't worth waking anybody up for
+	if (count == 1) {
+		proc(refCon, 0);
+		return;
+	}
+
+	_mutex.lock();
+	assert(!_proc);
+	_proc = proc;
+	_refCon = refCon;
+	_count = count;
+	_next = 0;
+	_done = 0;
+	_mutex.unlock();
+
+	while (runNextJob())
+		;
+
+	// Wait for the jobs the timer callback took over
+	while (true) {
+		_mutex.lock();
+		const bool finished = (_done == _count);
+		if (finished)
+			_proc = 0;
+		_mutex.unlock();
+
+		if (finished)
+			break;
+		g_system->delayMillis(0);
+	}
+}
+
+bool JobRunner::runNextJob() {
+	_mutex.lock();
+	if (!_proc || _next == _count) {
+		_mutex.unlock();
+		return false;
+	}
+	const uint job = _next++;
+	JobProc proc = _proc;
+	void *refCon = _refCon;
+	_mutex.unlock();
+
+	proc(refCon, job);
+
+	_mutex.lock();
+	_done++;
+	_mutex.unlock();
+	return true;
+}
+
+} // End of namespace Common
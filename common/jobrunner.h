@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef COMMON_JOBRUNNER_H
+#define COMMON_JOBRUNNER_H
+
+#include "common/scummsys.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * Runs batches of independent jobs, like the strips of an image, on the
+ * calling thread and from a timer callback, which the backend may run in
+ * a separate thread.
+ *
+ * The caller works through the jobs itself, while the timer callback
+ * takes over the remaining jobs whenever it gets to run in the meantime.
+ * So a batch never waits for the timer, and a job must not depend on
+ * which thread runs it or on the order the jobs are run in.
+ */
+class JobRunner : NonCopyable {
+public:
+	typedef void (*JobProc)(void *refCon, uint job);
+
+	JobRunner();
+	~JobRunner();
+
+	/**
+	 * Runs proc for the jobs 0 to count - 1 and returns once all of them
+	 * are done. Jobs may run at the same time, and must not use the
+	 * runner themselves.
+	 * @param proc		the function doing a job
+	 * @param refCon	an arbitrary pointer passed to proc
+	 * @param count		the number of jobs
+	 */
+	void run(JobProc proc, void *refCon, uint count);
+
+private:
+	enum {
+		kTimerInterval = 10000	///< Interval of the timer callback in microseconds
+	};
+
+	/** Runs the next job of the batch, returns false if there's none left. */
+	bool runNextJob();
+
+	static void timerProc(void *refCon);
+	static void registerRunner(JobRunner *runner, bool add);
+
+	Mutex _mutex;
+	JobProc _proc;
+	void *_refCon;
+	uint _count;
+	uint _next;		///< The next job to run
+	uint _done;		///< The number of jobs finished
+};
+
+} // End of namespace Common
+
+#endif
@@ -29,6 +29,9 @@
 #include "common/bufferedstream.h"
 #include "common/str.h"
 #include "common/util.h"
+#include "common/list.h"
+#include "common/system.h"
+#include "common/timer.h"
 
 namespace Common {
 
@@ -245,6 +248,11 @@ bool SeekableSubReadStream::seek(int32 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getDataPtr() const {
+	const byte *data = _parentStream->getDataPtr();
+	return data ? data + _begin : 0;
+}
+
 
 #pragma mark -
 
@@ -412,6 +420,240 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
 
 #pragma mark -
 
+// All the streams reading in the background share one timer callback,
+// since removing a timer callback removes all of its instances. The list
+// is only modified while the callback is removed, so the callback can walk
+// it without locking.
+static List<ReadAheadSeekableReadStream *> *s_readAheadStreams = 0;
+
+enum {
+	kReadAheadInterval = 10000	///< Interval of the read ahead timer in microseconds
+};
+
+static uint32 getReadAheadMillis() {
+	return g_system ? g_system->getMillis() : 0;
+}
+
+ReadAheadSeekableReadStream::ReadAheadSeekableReadStream(SeekableReadStream *parentStream, DisposeAfterUse::Flag disposeParentStream,
+                                                         uint32 minWindowSize, uint32 maxWindowSize)
+	: _parentStream(parentStream), _disposeParentStream(disposeParentStream),
+	_pos(0), _eos(false), _nextWanted(false),
+	_minWindowSize(minWindowSize), _maxWindowSize(maxWindowSize), _windowSize(minWindowSize),
+	_mutex(0), _stallCount(0), _stallTime(0) {
+
+	assert(parentStream);
+	assert(minWindowSize > 0 && minWindowSize <= maxWindowSize);
+
+	_parentPos = _parentStream->pos();
+	_size = _parentStream->size();
+
+	_cur.data = new byte[maxWindowSize];
+	_cur.start = 0;
+	_cur.size = 0;
+	_next.data = new byte[maxWindowSize];
+	_next.start = 0;
+	_next.size = 0;
+}
+
+ReadAheadSeekableReadStream::~ReadAheadSeekableReadStream() {
+	setBackgroundReading(false);
+
+	if (_disposeParentStream)
+		delete _parentStream;
+
+	delete[] _cur.data;
+	delete[] _next.data;
+}
+
+void ReadAheadSeekableReadStream::lock() const {
+	if (_mutex)
+		g_system->lockMutex(_mutex);
+}
+
+void ReadAheadSeekableReadStream::unlock() const {
+	if (_mutex)
+		g_system->unlockMutex(_mutex);
+}
+
+bool ReadAheadSeekableReadStream::err() const {
+	lock();
+	const bool result = _parentStream->err();
+	unlock();
+	return result;
+}
+
+void ReadAheadSeekableReadStream::clearErr() {
+	lock();
+	_eos = false;
+	_parentStream->clearErr();
+	unlock();
+}
+
+void ReadAheadSeekableReadStream::setBackgroundReading(bool enable) {
+	if (enable == (_mutex != 0))
+		return;
+
+	if (enable) {
+		_mutex = g_system->createMutex();
+		registerStream(this, true);
+
+		lock();
+		_nextWanted = (_next.size == 0 && _cur.start + _cur.size < (uint32)_size);
+		unlock();
+	} else {
+		registerStream(this, false);
+		g_system->deleteMutex(_mutex);
+		_mutex = 0;
+	}
+}
+
+void ReadAheadSeekableReadStream::registerStream(ReadAheadSeekableReadStream *stream, bool add) {
+	TimerManager *timer = g_system->getTimerManager();
+
+	// Once removed, the callback isn't running anymore
+	timer->removeTimerProc(readAheadProc);
+
+	if (!s_readAheadStreams)
+		s_readAheadStreams = new List<ReadAheadSeekableReadStream *>();
+
+	if (add)
+		s_readAheadStreams->push_back(stream);
+	else
+		s_readAheadStreams->remove(stream);
+
+	if (!s_readAheadStreams->empty()) {
+		timer->installTimerProc(readAheadProc, kReadAheadInterval, 0);
+	} else {
+		delete s_readAheadStreams;
+		s_readAheadStreams = 0;
+	}
+}
+
+void ReadAheadSeekableReadStream::readAheadProc(void *refCon) {
+	for (List<ReadAheadSeekableReadStream *>::iterator it = s_readAheadStreams->begin(); it != s_readAheadStreams->end(); ++it)
+		(*it)->readAhead();
+}
+
+void ReadAheadSeekableReadStream::readAhead() {
+	lock();
+	if (_nextWanted) {
+		_next.size = readParent(_next.data, _next.start, _windowSize);
+		_nextWanted = false;
+	}
+	unlock();
+}
+
+uint32 ReadAheadSeekableReadStream::readParent(byte *dst, uint32 start, uint32 dataSize) {
+	if (_parentPos != start) {
+		_parentStream->seek(start);
+		_parentPos = start;
+	}
+
+	const uint32 n = _parentStream->read(dst, dataSize);
+	_parentPos += n;
+	return n;
+}
+
+uint32 ReadAheadSeekableReadStream::refill(byte *dst, uint32 dataSize) {
+	const uint32 startTime = getReadAheadMillis();
+	uint32 directSize = 0;
+
+	lock();
+
+	// Grow the window while reading sequentially, start over otherwise
+	if (_pos == _cur.start + _cur.size)
+		_windowSize = MIN(_windowSize * 2, _maxWindowSize);
+	else
+		_windowSize = _minWindowSize;
+
+	if (_next.size && _pos >= _next.start && _pos < _next.start + _next.size) {
+		SWAP(_cur, _next);
+	} else if (dataSize >= _windowSize) {
+		// Buffering doesn't help with large reads
+		directSize = readParent(dst, _pos, dataSize);
+		_cur.start = _pos + directSize;
+		_cur.size = 0;
+		_stallCount++;
+	} else {
+		_cur.start = _pos;
+		_cur.size = readParent(_cur.data, _pos, _windowSize);
+		_stallCount++;
+	}
+
+	_next.start = _cur.start + _cur.size;
+	_next.size = 0;
+	_nextWanted = (_mutex != 0 && _next.start < (uint32)_size);
+
+	unlock();
+
+	_stallTime += getReadAheadMillis() - startTime;
+	return directSize;
+}
+
+uint32 ReadAheadSeekableReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 total = 0;
+
+	while (dataSize > 0) {
+		if (_pos < _cur.start || _pos >= _cur.start + _cur.size) {
+			const uint32 directSize = refill(dst, dataSize);
+			if (directSize) {
+				dst += directSize;
+				_pos += directSize;
+				total += directSize;
+				dataSize -= directSize;
+				continue;
+			}
+
+			if (_pos < _cur.start || _pos >= _cur.start + _cur.size) {
+				_eos = true;
+				break;
+			}
+		}
+
+		const uint32 n = MIN(dataSize, _cur.start + _cur.size - _pos);
+		memcpy(dst, _cur.data + (_pos - _cur.start), n);
+		dst += n;
+		_pos += n;
+		total += n;
+		dataSize -= n;
+	}
+
+	return total;
+}
+
+bool ReadAheadSeekableReadStream::seek(int32 offset, int whence) {
+	int32 newPos = offset;
+	switch (whence) {
+	case SEEK_END:
+		newPos += _size;
+		break;
+	case SEEK_CUR:
+		newPos += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (newPos < 0)
+		return false;
+
+	// Seeking within the current window keeps the window read ahead
+	if ((uint32)newPos < _cur.start || (uint32)newPos > _cur.start + _cur.size) {
+		lock();
+		_next.size = 0;
+		_nextWanted = false;
+		unlock();
+	}
+
+	_pos = newPos;
+	_eos = false;
+	return true;
+}
+
+#pragma mark -
+
 namespace {
 
 /**
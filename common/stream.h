@@ -350,6 +350,16 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Returns the contents of the stream, if it keeps all of them in
+	 * memory. They can then be accessed directly, without copying them.
+	 * The pointer refers to position 0, covers size() bytes and stays
+	 * valid as long as the stream exists.
+	 *
+	 * @return a pointer to the contents, or 0 if they aren't in memory
+	 */
+	virtual const byte *getDataPtr() const { return 0; }
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
@@ -36,6 +36,7 @@
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
 #include "sci/engine/features.h"
+#include "sci/engine/script_patches.h"
 #include "sci/sound/midiparser_sci.h"
 #include "sci/sound/music.h"
 #include "sci/sound/drivers/mididriver.h"
@@ -46,6 +47,9 @@
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette.h"
+#ifdef ENABLE_SCI32
+#include "sci/graphics/frameout.h"
+#endif
 
 #include "sci/parser/vocabulary.h"
 
@@ -65,6 +69,7 @@ namespace Sci {
 int g_debug_sleeptime_factor = 1;
 int g_debug_simulated_key = 0;
 bool g_debug_track_mouse_clicks = false;
+int g_debug_signature_check = kSignatureCheckCached;
 
 // Refer to the "addresses" command on how to pass address parameters
 static int parse_reg_t(EngineState *s, const char *str, reg_t *dest, bool mayBeValue);
@@ -75,8 +80,10 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	DVar_Register("sleeptime_factor",	&g_debug_sleeptime_factor, DVAR_INT, 0);
 	DVar_Register("gc_interval",		&engine->_gamestate->scriptGCInterval, DVAR_INT, 0);
+	DVar_Register("gc_incremental",		&engine->_gamestate->scriptGCIncremental, DVAR_BOOL, 0);
 	DVar_Register("simulated_key",		&g_debug_simulated_key, DVAR_INT, 0);
 	DVar_Register("track_mouse_clicks",	&g_debug_track_mouse_clicks, DVAR_BOOL, 0);
+	DVar_Register("signature_check",	&g_debug_signature_check, DVAR_INT, 0);
 	DVar_Register("script_abort_flag",	&_engine->_gamestate->abortScriptProcessing, DVAR_INT, 0);
 
 	// General
@@ -87,6 +94,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("selector",			WRAP_METHOD(Console, cmdSelector));
 	DCmd_Register("selectors",			WRAP_METHOD(Console, cmdSelectors));
 	DCmd_Register("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
+	DCmd_Register("signature_bench",	WRAP_METHOD(Console, cmdSignatureBench));
 	DCmd_Register("class_table",		WRAP_METHOD(Console, cmdClassTable));
 	// Parser
 	DCmd_Register("suffixes",			WRAP_METHOD(Console, cmdSuffixes));
@@ -106,6 +114,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("list",				WRAP_METHOD(Console, cmdList));
 	DCmd_Register("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	DCmd_Register("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
+	DCmd_Register("scriptpatch_bench",	WRAP_METHOD(Console, cmdScriptPatchBench));
 	// Game
 	DCmd_Register("save_game",			WRAP_METHOD(Console, cmdSaveGame));
 	DCmd_Register("restore_game",		WRAP_METHOD(Console, cmdRestoreGame));
@@ -114,14 +123,17 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("room",				WRAP_METHOD(Console, cmdRoomNumber));
 	DCmd_Register("quit",				WRAP_METHOD(Console, cmdQuit));
 	DCmd_Register("list_saves",			WRAP_METHOD(Console, cmdListSaves));
+	DCmd_Register("avoidpath_bench",	WRAP_METHOD(Console, cmdAvoidPathBench));
 	// Graphics
 	DCmd_Register("show_map",			WRAP_METHOD(Console, cmdShowMap));
 	DCmd_Register("set_palette",		WRAP_METHOD(Console, cmdSetPalette));
+	DCmd_Register("palette_bench",		WRAP_METHOD(Console, cmdPaletteBench));
 	DCmd_Register("draw_pic",			WRAP_METHOD(Console, cmdDrawPic));
 	DCmd_Register("draw_cel",			WRAP_METHOD(Console, cmdDrawCel));
 #ifdef ENABLE_SCI32
 	DCmd_Register("draw_robot",			WRAP_METHOD(Console, cmdDrawRobot));
 	DCmd_Register("play_robot_audio",		WRAP_METHOD(Console, cmdPlayRobotAudio));
+	DCmd_Register("frameout_stats",		WRAP_METHOD(Console, cmdFrameoutStats));
 #endif
 	DCmd_Register("undither",           WRAP_METHOD(Console, cmdUndither));
 	DCmd_Register("pic_visualize",		WRAP_METHOD(Console, cmdPicVisualize));
@@ -139,6 +151,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	DCmd_Register("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	DCmd_Register("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	DCmd_Register("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	DCmd_Register("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	DCmd_Register("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -301,8 +314,10 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("---------\n");
 	DebugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	DebugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	DebugPrintf("gc_incremental: Spreads the sweep phase of garbage collections over several kernel calls\n");
 	DebugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	DebugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
+	DebugPrintf("signature_check: Kernel call argument checks: 0 = check every call, 1 = cache matching arguments, 2 = cache and verify\n");
 	DebugPrintf("weak_validations: Turns some validation errors into warnings\n");
 	DebugPrintf("script_abort_flag: Set to 1 to abort script execution. Set to 2 to force a replay afterwards\n");
 	DebugPrintf("\n");
@@ -319,6 +334,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" selectors - Lists the selector names\n");
 	DebugPrintf(" selector - Attempts to find the requested selector by name\n");
 	DebugPrintf(" functions - Lists the kernel functions\n");
+	DebugPrintf(" signature_bench - Measures the time taken by checking the arguments of kernel calls\n");
 	DebugPrintf(" class_table - Shows the available classes\n");
 	DebugPrintf("\n");
 	DebugPrintf("Parser:\n");
@@ -340,11 +356,13 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" list - Lists all the resources of a given type\n");
 	DebugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	DebugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
+	DebugPrintf(" scriptpatch_bench - Loads every script of the game, with and without applying the script patches\n");
 	DebugPrintf("\n");
 	DebugPrintf("Game:\n");
 	DebugPrintf(" save_game - Saves the current game state to the hard disk\n");
 	DebugPrintf(" restore_game - Restores a saved game from the hard disk\n");
 	DebugPrintf(" list_saves - List all saved games including filenames\n");
+	DebugPrintf(" avoidpath_bench - Replays the last pathfinding request, with and without the visibility cache\n");
 	DebugPrintf(" restart_game - Restarts the game\n");
 	DebugPrintf(" version - Shows the resource and interpreter versions\n");
 	DebugPrintf(" room - Gets or sets the current room number\n");
@@ -353,10 +371,14 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("Graphics:\n");
 	DebugPrintf(" show_map - Switches to visual, priority, control or display screen\n");
 	DebugPrintf(" set_palette - Sets a palette resource\n");
+	DebugPrintf(" palette_bench - Replays the last palette merges, with and without the color lookup cache\n");
 	DebugPrintf(" draw_pic - Draws a pic resource\n");
 	DebugPrintf(" draw_cel - Draws a cel from a view resource\n");
 	DebugPrintf(" pic_visualize - Enables visualization of the drawing process of EGA pictures\n");
 	DebugPrintf(" undither - Enable/disable undithering\n");
+#ifdef ENABLE_SCI32
+	DebugPrintf(" frameout_stats - Shows the time taken by kFrameout and how much got redrawn\n");
+#endif
 	DebugPrintf("\n");
 	DebugPrintf("Segments:\n");
 	DebugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -369,6 +391,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	DebugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	DebugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	DebugPrintf(" gc_stats - Shows pause times and results of the garbage collections so far\n");
 	DebugPrintf("\n");
 	DebugPrintf("Music/SFX:\n");
 	DebugPrintf(" songlib - Shows the song library\n");
@@ -578,6 +601,31 @@ bool Console::cmdKernelFunctions(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSignatureBench(int argc, const char **argv) {
+	const int iterations = (argc > 1) ? atoi(argv[1]) : 1000;
+
+	if (iterations <= 0) {
+		DebugPrintf("Measures the time taken by checking the arguments of kernel calls\n");
+		DebugPrintf("Usage: %s [<iterations>]\n", argv[0]);
+		return true;
+	}
+
+	Kernel *kernel = _engine->getKernel();
+	DebugPrintf("Signature checks so far: %d, cache hits: %d\n", kernel->getSignatureChecks(), kernel->getSignatureCacheHits());
+
+	uint32 fullTime, cachedTime;
+	uint argumentLists = kernel->benchmarkSignatures(iterations, fullTime, cachedTime);
+	if (!argumentLists) {
+		DebugPrintf("No argument lists cached since the heap last changed\n");
+		return true;
+	}
+
+	DebugPrintf("%d checks of %d cached argument lists: %d ms without cache, %d ms with cache\n",
+				iterations * argumentLists, argumentLists, fullTime, cachedTime);
+
+	return true;
+}
+
 bool Console::cmdSuffixes(int argc, const char **argv) {
 	_engine->getVocabulary()->printSuffixes();
 
@@ -739,6 +787,29 @@ bool Console::cmdRoomNumber(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdAvoidPathBench(int argc, const char **argv) {
+	const int iterations = (argc > 1) ? atoi(argv[1]) : 100;
+
+	if (iterations <= 0) {
+		DebugPrintf("Replays the last kAvoidPath pathfinding request of the current room\n");
+		DebugPrintf("Usage: %s [<iterations>]\n", argv[0]);
+		return true;
+	}
+
+	const int uncachedTime = benchmarkAvoidPath(_engine->_gamestate, iterations, false);
+	if (uncachedTime < 0) {
+		DebugPrintf("No pathfinding request has been made yet\n");
+		return true;
+	}
+	const int cachedTime = benchmarkAvoidPath(_engine->_gamestate, iterations, true);
+
+	const AvoidPathCache &cache = _engine->_gamestate->_avoidPathCache;
+	DebugPrintf("%d iterations: %d ms without visibility cache, %d ms with visibility cache\n", iterations, uncachedTime, cachedTime);
+	DebugPrintf("Visibility cache: %d hits, %d misses\n", cache.getHits(), cache.getMisses());
+
+	return true;
+}
+
 bool Console::cmdResourceInfo(int argc, const char **argv) {
 	if (argc != 3) {
 		DebugPrintf("Shows information about a resource\n");
@@ -884,6 +955,26 @@ bool Console::cmdVerifyScripts(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdScriptPatchBench(int argc, const char **argv) {
+	const int iterations = (argc > 1) ? atoi(argv[1]) : 10;
+
+	if (iterations <= 0) {
+		DebugPrintf("Loads every script of the game, with and without applying the script patches\n");
+		DebugPrintf("Usage: %s [<iterations>]\n", argv[0]);
+		return true;
+	}
+
+	uint32 timeCopy, timeSeparate, timeCompiled;
+	int mismatches = _engine->_scriptPatcher->benchmark(_engine->getResMan(), iterations, timeCopy, timeSeparate, timeCompiled);
+
+	DebugPrintf("%d iterations: %d ms without patching, %d ms searching each signature separately, %d ms using the compiled signatures\n",
+				iterations, timeCopy, timeSeparate, timeCompiled);
+	if (mismatches)
+		DebugPrintf("Warning: %d scripts got patched differently by both methods\n", mismatches);
+
+	return true;
+}
+
 // Same as in sound/drivers/midi.cpp 
 uint8 getGmInstrument(const Mt32ToGmMap &Mt32Ins) {
 	if (Mt32Ins.gmInstr == MIDI_MAPPED_TO_RHYTHM)
@@ -1479,6 +1570,39 @@ bool Console::cmdSetPalette(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdPaletteBench(int argc, const char **argv) {
+	const int iterations = (argc > 1) ? atoi(argv[1]) : 100;
+
+	if (iterations <= 0) {
+		DebugPrintf("Replays the last palette merges done by the game. The first use\n");
+		DebugPrintf("starts recording the merges.\n");
+		DebugPrintf("Usage: %s [<iterations>]\n", argv[0]);
+		return true;
+	}
+
+	// Merges are only recorded on request, copying the palettes costs time
+	if (!_engine->_gfxPalette->isRecordingMerges()) {
+		_engine->_gfxPalette->startMergeRecording();
+		DebugPrintf("Recording palette merges now, use %s again once the game has merged some palettes\n", argv[0]);
+		return true;
+	}
+
+	uint32 timeLinear, timeCached;
+	const int mismatches = _engine->_gfxPalette->benchmarkMerges(iterations, timeLinear, timeCached);
+	if (mismatches < 0) {
+		DebugPrintf("No palettes have been merged since the recording started\n");
+		return true;
+	}
+
+	const ColorMatcher &matcher = _engine->_gfxPalette->getColorMatcher();
+	DebugPrintf("%d iterations: %d ms scanning the palette, %d ms with the color lookup cache\n", iterations, timeLinear, timeCached);
+	DebugPrintf("Color lookups: %d, cells rebuilt: %d\n", matcher.getLookups(), matcher.getCellRebuilds());
+	if (mismatches)
+		DebugPrintf("WARNING: %d merges had different results\n", mismatches);
+
+	return true;
+}
+
 bool Console::cmdDrawPic(int argc, const char **argv) {
 	if (argc < 2) {
 		DebugPrintf("Draws a pic resource\n");
@@ -1546,6 +1670,31 @@ bool Console::cmdPlayRobotAudio(int argc, const char **argv) {
 	}
 	return true;
 }
+
+bool Console::cmdFrameoutStats(int argc, const char **argv) {
+	if (!_engine->_gfxFrameout) {
+		DebugPrintf("command not available in non-sci32 games");
+		return true;
+	}
+
+	if (argc > 1 && !scumm_stricmp(argv[1], "reset")) {
+		_engine->_gfxFrameout->resetStatistics();
+		DebugPrintf("Frame statistics reset\n");
+		return true;
+	}
+
+	const FrameoutStatistics &stats = _engine->_gfxFrameout->getStatistics();
+
+	DebugPrintf("Frames: %d, %d of them didn't need to draw anything\n", stats.frames, stats.idleFrames);
+	DebugPrintf("Planes redrawn: %d\n", stats.planesDrawn);
+	DebugPrintf("Last frame: %d ms, longest frame: %d ms\n", stats.lastTime, stats.maxTime);
+	DebugPrintf("Total time: %d ms\n", stats.totalTime);
+	if (stats.frames)
+		DebugPrintf("Average time per frame: %d ms\n", stats.totalTime / stats.frames);
+	DebugPrintf("Use \"%s reset\" to reset the statistics\n", argv[0]);
+
+	return true;
+}
 #endif
 
 bool Console::cmdUndither(int argc, const char **argv) {
@@ -2003,15 +2152,14 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 }
 
 bool Console::cmdGCObjects(int argc, const char **argv) {
-	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
+	Common::Array<reg_t> activeRefs;
+	_engine->_gamestate->_gc->findAllActiveReferences(_engine->_gamestate).getAddresses(activeRefs);
 
 	DebugPrintf("Reachable object references (normalised):\n");
-	for (AddrSet::iterator i = use_map->begin(); i != use_map->end(); ++i) {
-		DebugPrintf(" - %04x:%04x\n", PRINT_REG(i->_key));
+	for (Common::Array<reg_t>::const_iterator it = activeRefs.begin(); it != activeRefs.end(); ++it) {
+		DebugPrintf(" - %04x:%04x\n", PRINT_REG(*it));
 	}
 
-	delete use_map;
-
 	return true;
 }
 
@@ -2108,6 +2256,20 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	const GCStatistics &stats = _engine->_gamestate->_gc->getStatistics();
+
+	DebugPrintf("Garbage collections: %d (%s)\n", stats.collections,
+				_engine->_gamestate->scriptGCIncremental ? "incremental" : "stop-the-world");
+	DebugPrintf("Last collection: longest pause %d ms, freed %d addresses\n", stats.lastPause, stats.lastFreed);
+	DebugPrintf("Longest pause: %d ms\n", stats.maxPause);
+	DebugPrintf("Total time: %d ms, total freed: %d addresses\n", stats.totalTime, stats.totalFreed);
+	if (stats.collections)
+		DebugPrintf("Average time per collection: %d ms\n", stats.totalTime / stats.collections);
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
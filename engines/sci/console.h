@@ -58,6 +58,7 @@ private:
 	bool cmdSelector(int argc, const char **argv);
 	bool cmdSelectors(int argc, const char **argv);
 	bool cmdKernelFunctions(int argc, const char **argv);
+	bool cmdSignatureBench(int argc, const char **argv);
 	bool cmdClassTable(int argc, const char **argv);
 	// Parser
 	bool cmdSuffixes(int argc, const char **argv);
@@ -77,6 +78,7 @@ private:
 	bool cmdList(int argc, const char **argv);
 	bool cmdHexgrep(int argc, const char **argv);
 	bool cmdVerifyScripts(int argc, const char **argv);
+	bool cmdScriptPatchBench(int argc, const char **argv);
 	// Game
 	bool cmdSaveGame(int argc, const char **argv);
 	bool cmdRestoreGame(int argc, const char **argv);
@@ -85,15 +87,18 @@ private:
 	bool cmdRoomNumber(int argc, const char **argv);
 	bool cmdQuit(int argc, const char **argv);
 	bool cmdListSaves(int argc, const char **argv);
+	bool cmdAvoidPathBench(int argc, const char **argv);
 	// Screen
 	bool cmdShowMap(int argc, const char **argv);
 	// Graphics
 	bool cmdSetPalette(int argc, const char **argv);
+	bool cmdPaletteBench(int argc, const char **argv);
 	bool cmdDrawPic(int argc, const char **argv);
 	bool cmdDrawCel(int argc, const char **argv);
 #ifdef ENABLE_SCI32
 	bool cmdDrawRobot(int argc, const char **argv);
 	bool cmdPlayRobotAudio(int argc, const char **argv);
+	bool cmdFrameoutStats(int argc, const char **argv);
 #endif
 	bool cmdUndither(int argc, const char **argv);
 	bool cmdPicVisualize(int argc, const char **argv);
@@ -108,6 +113,7 @@ private:
 	bool cmdGCShowReachable(int argc, const char **argv);
 	bool cmdGCShowFreeable(int argc, const char **argv);
 	bool cmdGCNormalize(int argc, const char **argv);
+	bool cmdGCStats(int argc, const char **argv);
 	// Music/SFX
 	bool cmdSongLib(int argc, const char **argv);
 	bool cmdSongInfo(int argc, const char **argv);
@@ -81,6 +81,7 @@ struct DebugState {
 extern int g_debug_sleeptime_factor;
 extern int g_debug_simulated_key;
 extern bool g_debug_track_mouse_clicks;
+extern int g_debug_signature_check;
 
 } // End of namespace Sci
 
@@ -25,73 +25,121 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 
 namespace Sci {
 
 //#define GC_DEBUG_CODE
 
-struct WorklistManager {
-	Common::Array<reg_t> _worklist;
-	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
+enum {
+	kGCSweepBudget = 256	///< Number of addresses checked per incremental sweep step
+};
 
-	void push(reg_t reg) {
-		if (!reg.segment) // No numbers
-			return;
+void AddrSet::clear() {
+	for (uint i = 0; i < _usedSegments.size(); i++) {
+		Common::Array<uint32> &bits = _segments[_usedSegments[i]];
+		memset(bits.begin(), 0, bits.size() * sizeof(uint32));
+		_segmentUsed[_usedSegments[i]] = false;
+	}
+	_usedSegments.clear();
+	_size = 0;
+}
 
-		debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
+bool AddrSet::insert(reg_t addr) {
+	if (addr.segment >= _segments.size()) {
+		// Array::resize() doesn't overallocate, and copying the bitmaps
+		// is not cheap
+		_segments.reserve(2 * addr.segment + 1);
+		_segments.resize(addr.segment + 1);
+		_segmentUsed.resize(addr.segment + 1);
+	}
 
-		if (_map.contains(reg))
-			return; // already dealt with it
+	Common::Array<uint32> &bits = _segments[addr.segment];
+	const uint word = addr.offset >> 5;
+	const uint32 mask = 1u << (addr.offset & 31);
 
-		_map.setVal(reg, true);
-		_worklist.push_back(reg);
-	}
+	// Grow in steps of 1024 addresses, the bitmap is reused afterwards
+	if (word >= bits.size())
+		bits.resize((word + 32) & ~31);
 
-	void pushArray(const Common::Array<reg_t> &tmp) {
-		for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it)
-			push(*it);
-	}
-};
+	if (bits[word] & mask)
+		return false;
 
-static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
-	AddrSet *normal_map = new AddrSet();
+	if (!_segmentUsed[addr.segment]) {
+		_segmentUsed[addr.segment] = true;
+		_usedSegments.push_back(addr.segment);
+	}
 
-	for (AddrSet::const_iterator i = nonnormal_map.begin(); i != nonnormal_map.end(); ++i) {
-		reg_t reg = i->_key;
-		SegmentObj *mobj = segMan->getSegmentObj(reg.segment);
+	bits[word] |= mask;
+	_size++;
+	return true;
+}
 
-		if (mobj) {
-			reg = mobj->findCanonicAddress(segMan, reg);
-			normal_map->setVal(reg, true);
+void AddrSet::getAddresses(Common::Array<reg_t> &addresses) const {
+	for (uint seg = 0; seg < _segments.size(); seg++) {
+		const Common::Array<uint32> &bits = _segments[seg];
+		for (uint word = 0; word < bits.size(); word++) {
+			if (!bits[word])
+				continue;
+			for (uint bit = 0; bit < 32; bit++)
+				if (bits[word] & (1 << bit))
+					addresses.push_back(make_reg(seg, (word << 5) | bit));
 		}
 	}
+}
 
-	return normal_map;
+GarbageCollector::GarbageCollector() : _sweeping(false), _sweepSegment(0),
+	_cycleFreed(0), _cyclePause(0), _cycleTime(0) {
+	memset(&_stats, 0, sizeof(_stats));
 }
 
-static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
+void GarbageCollector::push(reg_t reg) {
+	if (!reg.segment) // No numbers
+		return;
+
+	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
+
+	if (!_visited.insert(reg))
+		return; // already dealt with it
+
+	_worklist.push_back(reg);
+}
+
+void GarbageCollector::pushArray(const Common::Array<reg_t> &tmp) {
+	for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it)
+		push(*it);
+}
+
+void GarbageCollector::processWorkList(SegManager *segMan, const Common::Array<SegmentObj *> &heap) {
 	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
-	while (!wm._worklist.empty()) {
-		reg_t reg = wm._worklist.back();
-		wm._worklist.pop_back();
+	while (!_worklist.empty()) {
+		reg_t reg = _worklist.back();
+		_worklist.pop_back();
 		if (reg.segment != stackSegment) { // No need to repeat this one
 			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
 			if (reg.segment < heap.size() && heap[reg.segment]) {
 				// Valid heap object? Find its outgoing references!
-				wm.pushArray(heap[reg.segment]->listAllOutgoingReferences(reg));
+				pushArray(heap[reg.segment]->listAllOutgoingReferences(reg));
 			}
 		}
+
+		// Normalise the address right away, so that the sweep only needs to
+		// look up the canonic addresses
+		if (reg.segment < heap.size() && heap[reg.segment])
+			_activeRefs.insert(heap[reg.segment]->findCanonicAddress(segMan, reg));
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+const AddrSet &GarbageCollector::findAllActiveReferences(EngineState *s) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
+	_visited.clear();
+	_activeRefs.clear();
+	_worklist.clear();
 
 	// Initialize registers
-	wm.push(s->r_acc);
-	wm.push(s->r_prev);
+	push(s->r_acc);
+	push(s->r_prev);
 
 	// Initialize value stack
 	// We do this one by hand since the stack doesn't know the current execution stack
@@ -106,7 +154,7 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	ExecStack &xs = *iter;
 
 	for (reg_t *pos = s->stack_base; pos < xs.sp; pos++)
-		wm.push(*pos);
+		push(*pos);
 
 	debugC(kDebugLevelGC, "[GC] -- Finished adding value stack");
 
@@ -116,10 +164,10 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 		ExecStack &es = *iter;
 
 		if (es.type != EXEC_STACK_TYPE_KERNEL) {
-			wm.push(es.objp);
-			wm.push(es.sendp);
+			push(es.objp);
+			push(es.sendp);
 			if (es.type == EXEC_STACK_TYPE_VARSELECTOR)
-				wm.push(*(es.getVarPointer(s->_segMan)));
+				push(*(es.getVarPointer(s->_segMan)));
 		}
 	}
 
@@ -134,72 +182,141 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 			Script *script = (Script *)heap[i];
 
 			if (script->getLockers()) { // Explicitly loaded?
-				wm.pushArray(script->listObjectReferences());
+				pushArray(script->listObjectReferences());
 			}
 		}
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
 
-	processWorkList(s->_segMan, wm, heap);
+	processWorkList(s->_segMan, heap);
 
-	return normalizeAddresses(s->_segMan, wm._map);
+	return _activeRefs;
 }
 
-void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
-
-	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
-#ifdef GC_DEBUG_CODE
-	const char *segnames[SEG_TYPE_MAX + 1];
-	int segcount[SEG_TYPE_MAX + 1];
-	memset(segnames, 0, sizeof(segnames));
-	memset(segcount, 0, sizeof(segcount));
-#endif
-
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
-
+bool GarbageCollector::sweep(SegManager *segMan, uint budget) {
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
 	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
-	for (uint seg = 1; seg < heap.size(); seg++) {
+	uint checked = 0;
+
+	while (_sweepSegment < heap.size()) {
+		if (checked >= budget)
+			return false;
+
+		const uint seg = _sweepSegment++;
 		SegmentObj *mobj = heap[seg];
 
 		if (mobj != NULL) {
-#ifdef GC_DEBUG_CODE
-			const SegmentType type = mobj->getType();
-			segnames[type] = SegmentObj::getSegmentTypeName(type);
-#endif
-
 			// Get a list of all deallocatable objects in this segment,
 			// then free any which are not referenced from somewhere.
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!_activeRefs.contains(addr) && !_allocated.contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					segMan->heapChanged();
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
-#ifdef GC_DEBUG_CODE
-					segcount[type]++;
-#endif
+					_cycleFreed++;
 				}
 			}
-
+			checked += tmp.size();
 		}
 	}
 
-	delete activeRefs;
+	return true;
+}
+
+void GarbageCollector::finishCollection() {
+	_stats.collections++;
+	_stats.lastPause = _cyclePause;
+	_stats.maxPause = MAX(_stats.maxPause, _cyclePause);
+	_stats.totalTime += _cycleTime;
+	_stats.lastFreed = _cycleFreed;
+	_stats.totalFreed += _cycleFreed;
+
+	debugC(kDebugLevelGC, "[GC] Freed %d addresses, longest pause %d ms", _cycleFreed, _cyclePause);
+}
+
+void GarbageCollector::run(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+
+	// Some debug stuff
+	debugC(kDebugLevelGC, "[GC] Running...");
+
+	abort(segMan);
+
+	const uint32 startTime = g_system->getMillis();
+
+	// Compute the set of all segments references currently in use.
+	findAllActiveReferences(s);
+
+	_cycleFreed = 0;
+	_sweepSegment = 1;
+	sweep(segMan, 0xFFFFFFFF);
+
+	_cycleTime = _cyclePause = g_system->getMillis() - startTime;
+	finishCollection();
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
-	debugC(kDebugLevelGC, "[GC] Summary:");
-	for (int i = 0; i <= SEG_TYPE_MAX; i++)
-		if (segcount[i])
-			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
+	debugC(kDebugLevelGC, "[GC] Summary: %d of %d reachable addresses are canonic", _activeRefs.size(), _visited.size());
 #endif
 }
 
+void GarbageCollector::start(EngineState *s) {
+	if (_sweeping) {
+		// Complete the previous collection before marking again
+		const uint32 startTime = g_system->getMillis();
+		sweep(s->_segMan, 0xFFFFFFFF);
+		const uint32 pause = g_system->getMillis() - startTime;
+		_cyclePause = MAX(_cyclePause, pause);
+		_cycleTime += pause;
+		abort(s->_segMan);
+		finishCollection();
+	}
+
+	debugC(kDebugLevelGC, "[GC] Starting incremental collection...");
+
+	const uint32 startTime = g_system->getMillis();
+
+	findAllActiveReferences(s);
+
+	_allocated.clear();
+	s->_segMan->setGCAllocationLog(&_allocated);
+	_sweeping = true;
+	_sweepSegment = 1;
+	_cycleFreed = 0;
+
+	_cycleTime = _cyclePause = g_system->getMillis() - startTime;
+}
+
+void GarbageCollector::step(EngineState *s) {
+	if (!_sweeping)
+		return;
+
+	const uint32 startTime = g_system->getMillis();
+	const bool done = sweep(s->_segMan, kGCSweepBudget);
+	const uint32 pause = g_system->getMillis() - startTime;
+
+	_cyclePause = MAX(_cyclePause, pause);
+	_cycleTime += pause;
+
+	if (done) {
+		abort(s->_segMan);
+		finishCollection();
+	}
+}
+
+void GarbageCollector::abort(SegManager *segMan) {
+	if (_sweeping)
+		segMan->setGCAllocationLog(NULL);
+	_sweeping = false;
+}
+
+void run_gc(EngineState *s) {
+	s->_gc->run(s);
+}
+
 } // End of namespace Sci
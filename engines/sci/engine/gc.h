@@ -27,30 +27,141 @@
 #ifndef SCI_ENGINE_GC_H
 #define SCI_ENGINE_GC_H
 
-#include "common/hashmap.h"
+#include "common/array.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/state.h"
 
 namespace Sci {
 
-struct reg_t_Hash {
-	uint operator()(const reg_t& x) const {
-		return (x.segment << 3) ^ x.offset ^ (x.offset << 16);
+/**
+ * The AddrSet is a set of reg_t values, stored as one bitmap per segment.
+ * Clearing the set keeps the bitmaps around, so that a set which is reused
+ * for every garbage collection does not need to allocate anything once it
+ * has grown to the size of the heap.
+ */
+class AddrSet {
+public:
+	AddrSet() : _size(0) {}
+
+	/**
+	 * Removes all addresses from the set. Only the bitmaps of segments which
+	 * were actually used are cleared, and no memory is released.
+	 */
+	void clear();
+
+	/**
+	 * Adds an address to the set.
+	 * @return true if the address was not in the set before
+	 */
+	bool insert(reg_t addr);
+
+	bool contains(reg_t addr) const {
+		if (addr.segment >= _segments.size())
+			return false;
+		const Common::Array<uint32> &bits = _segments[addr.segment];
+		const uint word = addr.offset >> 5;
+		return word < bits.size() && (bits[word] & (1u << (addr.offset & 31)));
 	}
+
+	uint size() const { return _size; }
+
+	/**
+	 * Appends all addresses in the set to the given array, sorted by segment
+	 * and offset.
+	 */
+	void getAddresses(Common::Array<reg_t> &addresses) const;
+
+private:
+	Common::Array<Common::Array<uint32> > _segments;
+	Common::Array<bool> _segmentUsed;
+	Common::Array<SegmentId> _usedSegments;	///< Segments with at least one bit set
+	uint _size;
 };
 
-/*
- * The AddrSet is a "set" of reg_t values.
- * We don't have a HashSet type, so we abuse a HashMap for this.
+/**
+ * Timing and result information about the garbage collections done so far.
+ * All times are in milliseconds.
  */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
+struct GCStatistics {
+	uint32 collections;	///< Number of completed collections
+	uint32 lastPause;	///< Longest pause caused by the last collection
+	uint32 maxPause;	///< Longest pause caused by any collection
+	uint32 totalTime;	///< Total time spent in the garbage collector
+	uint32 lastFreed;	///< Number of addresses freed by the last collection
+	uint32 totalFreed;	///< Number of addresses freed by all collections
+};
 
 /**
- * Finds all used references and normalises them to their memory addresses
- * @param s The state to gather all information from
- * @return A hash map containing entries for all used references
+ * Mark and sweep garbage collector for the SCI heap.
+ *
+ * The mark phase always runs to completion in one go, as the VM has no write
+ * barrier which would allow it to be interleaved with script execution. The
+ * sweep phase may be spread over several VM time slices instead: everything
+ * unmarked was unreachable when the mark phase ran and stays unreachable, and
+ * everything allocated since is logged by the segment manager and skipped.
  */
-AddrSet *findAllActiveReferences(EngineState *s);
+class GarbageCollector {
+public:
+	GarbageCollector();
+
+	/**
+	 * Runs a complete garbage collection.
+	 * @param s The state in which we should gc
+	 */
+	void run(EngineState *s);
+
+	/**
+	 * Marks all reachable objects and prepares an incremental sweep, which is
+	 * then done by subsequent calls to step(). A pending sweep of an earlier
+	 * collection is completed first.
+	 * @param s The state in which we should gc
+	 */
+	void start(EngineState *s);
+
+	/**
+	 * Sweeps the next few segments of an incremental collection.
+	 * @param s The state in which we should gc
+	 */
+	void step(EngineState *s);
+
+	/**
+	 * Drops a pending incremental sweep, e.g. because the heap was replaced
+	 * when restoring a saved game.
+	 */
+	void abort(SegManager *segMan);
+
+	bool isSweeping() const { return _sweeping; }
+
+	/**
+	 * Finds all used references and normalises them to their memory addresses
+	 * @param s The state to gather all information from
+	 * @return A set containing entries for all used references. The set is
+	 *         owned by the collector and overwritten by the next collection.
+	 */
+	const AddrSet &findAllActiveReferences(EngineState *s);
+
+	const GCStatistics &getStatistics() const { return _stats; }
+
+private:
+	void push(reg_t reg);
+	void pushArray(const Common::Array<reg_t> &tmp);
+	void processWorkList(SegManager *segMan, const Common::Array<SegmentObj *> &heap);
+	bool sweep(SegManager *segMan, uint budget);
+	void finishCollection();
+
+	Common::Array<reg_t> _worklist;	///< Kept between collections to avoid reallocating it
+	AddrSet _visited;	///< All addresses pushed onto the worklist so far
+	AddrSet _activeRefs;	///< Canonic addresses of all reachable objects
+	AddrSet _allocated;	///< Addresses allocated during an incremental sweep
+
+	bool _sweeping;
+	uint _sweepSegment;	///< Next segment to sweep
+	uint32 _cycleFreed;
+	uint32 _cyclePause;
+	uint32 _cycleTime;
+
+	GCStatistics _stats;
+};
 
 /**
  * Runs garbage collection on the current system state
@@ -37,7 +37,8 @@
 namespace Sci {
 
 Kernel::Kernel(ResourceManager *resMan, SegManager *segMan)
-	: _resMan(resMan), _segMan(segMan), _invalid("<invalid>") {
+	: _resMan(resMan), _segMan(segMan), _signatureChecks(0), _signatureCacheHits(0), _invalid("<invalid>") {
+	memset(_signatureCache, 0, sizeof(_signatureCache));
 	loadSelectorNames();
 	mapSelectors();      // Map a few special selectors for later use
 }
@@ -519,6 +520,79 @@ bool Kernel::signatureMatch(const uint16 *sig, int argc, const reg_t *argv) {
 	return false;
 }
 
+uint Kernel::signatureCacheIndex(const uint16 *sig, int argc, const reg_t *argv) const {
+	uint32 hash = (uint32)(size_t)sig ^ argc;
+	for (int i = 0; i < argc; i++)
+		hash = (hash * 33) ^ ((argv[i].segment << 16) | argv[i].offset);
+	return (hash ^ (hash >> 16)) & (SIGNATURE_CACHE_SIZE - 1);
+}
+
+bool Kernel::checkSignature(const uint16 *sig, int argc, const reg_t *argv) {
+	_signatureChecks++;
+
+	if (g_debug_signature_check == kSignatureCheckFull || argc > SIGNATURE_CACHE_MAXARGS)
+		return signatureMatch(sig, argc, argv);
+
+	// The type of an address only changes, when segments or their entries
+	// get allocated or freed, so an argument list which matched before still
+	// matches as long as the heap generation is the same
+	SignatureCacheEntry &entry = _signatureCache[signatureCacheIndex(sig, argc, argv)];
+	const uint32 heapGeneration = _segMan->getHeapGeneration();
+	if (entry.signature == sig && entry.argc == argc && entry.heapGeneration == heapGeneration
+			&& !memcmp(entry.argv, argv, argc * sizeof(reg_t))) {
+		_signatureCacheHits++;
+		if (g_debug_signature_check == kSignatureCheckVerify && !signatureMatch(sig, argc, argv)) {
+			warning("Kernel signature cache accepted arguments, which don't match the signature");
+			return false;
+		}
+		return true;
+	}
+
+	if (!signatureMatch(sig, argc, argv))
+		return false;
+
+	entry.signature = sig;
+	entry.heapGeneration = heapGeneration;
+	entry.argc = argc;
+	memcpy(entry.argv, argv, argc * sizeof(reg_t));
+	return true;
+}
+
+uint Kernel::benchmarkSignatures(int iterations, uint32 &fullTime, uint32 &cachedTime) {
+	const uint32 heapGeneration = _segMan->getHeapGeneration();
+	Common::Array<const SignatureCacheEntry *> entries;
+	int i;
+	uint entryNr;
+
+	for (entryNr = 0; entryNr < SIGNATURE_CACHE_SIZE; entryNr++) {
+		if (_signatureCache[entryNr].signature && _signatureCache[entryNr].heapGeneration == heapGeneration)
+			entries.push_back(&_signatureCache[entryNr]);
+	}
+
+	uint32 startTime = g_system->getMillis();
+	for (i = 0; i < iterations; i++) {
+		for (entryNr = 0; entryNr < entries.size(); entryNr++)
+			signatureMatch(entries[entryNr]->signature, entries[entryNr]->argc, entries[entryNr]->argv);
+	}
+	fullTime = g_system->getMillis() - startTime;
+
+	const int oldMode = g_debug_signature_check;
+	const uint32 oldChecks = _signatureChecks;
+	const uint32 oldCacheHits = _signatureCacheHits;
+	g_debug_signature_check = kSignatureCheckCached;
+	startTime = g_system->getMillis();
+	for (i = 0; i < iterations; i++) {
+		for (entryNr = 0; entryNr < entries.size(); entryNr++)
+			checkSignature(entries[entryNr]->signature, entries[entryNr]->argc, entries[entryNr]->argv);
+	}
+	cachedTime = g_system->getMillis() - startTime;
+	g_debug_signature_check = oldMode;
+	_signatureChecks = oldChecks;
+	_signatureCacheHits = oldCacheHits;
+
+	return entries.size();
+}
+
 void Kernel::mapFunctions() {
 	int mapped = 0;
 	int ignored = 0;
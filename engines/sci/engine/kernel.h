@@ -141,6 +141,26 @@ struct KernelFunction {
 	bool debugBreakpoint;
 };
 
+enum SignatureCheckMode {
+	kSignatureCheckFull = 0,	///< Check the arguments of every kernel call
+	kSignatureCheckCached = 1,	///< Remember argument lists which matched a signature
+	kSignatureCheckVerify = 2	///< Like kSignatureCheckCached, but also check cache hits and warn about differences
+};
+
+#define SIGNATURE_CACHE_SIZE 256
+#define SIGNATURE_CACHE_MAXARGS 8
+
+/**
+ * An argument list, which matched a kernel function signature. It's only
+ * valid as long as the heap generation of the segment manager is the same.
+ */
+struct SignatureCacheEntry {
+	const uint16 *signature;
+	uint32 heapGeneration;
+	int argc;
+	reg_t argv[SIGNATURE_CACHE_MAXARGS];
+};
+
 class Kernel {
 public:
 	/**
@@ -184,6 +204,32 @@ public:
 	 */
 	bool signatureMatch(const uint16 *sig, int argc, const reg_t *argv);
 
+	/**
+	 * Determines whether a list of registers matches a given signature, like
+	 * signatureMatch(). Depending on g_debug_signature_check, argument lists
+	 * which matched are remembered, so that the same call doesn't need to
+	 * look up the types of its arguments again. Mismatches are never cached.
+	 *
+	 * @param sig	 signature to test against
+	 * @param argc	 number of arguments to test
+	 * @param argv	 argument list
+	 * @return true if the signature was matched, false otherwise
+	 */
+	bool checkSignature(const uint16 *sig, int argc, const reg_t *argv);
+
+	/**
+	 * Measures the overhead of signature checks, by checking the argument
+	 * lists which are currently cached with and without using the cache.
+	 * @param iterations	number of times to check every argument list
+	 * @param fullTime		the time taken without the cache in ms
+	 * @param cachedTime	the time taken using the cache in ms
+	 * @return the number of argument lists which got checked
+	 */
+	uint benchmarkSignatures(int iterations, uint32 &fullTime, uint32 &cachedTime);
+
+	uint32 getSignatureChecks() const { return _signatureChecks; }
+	uint32 getSignatureCacheHits() const { return _signatureCacheHits; }
+
 	// Prints out debug information in case a signature check fails
 	void signatureDebug(const uint16 *sig, int argc, const reg_t *argv);
 
@@ -267,6 +313,12 @@ private:
 	ResourceManager *_resMan;
 	SegManager *_segMan;
 
+	uint signatureCacheIndex(const uint16 *sig, int argc, const reg_t *argv) const;
+
+	SignatureCacheEntry _signatureCache[SIGNATURE_CACHE_SIZE];
+	uint32 _signatureChecks;
+	uint32 _signatureCacheHits;
+
 	// Kernel-related lists
 	Common::StringArray _selectorNames;
 	Common::StringArray _kernelNames;
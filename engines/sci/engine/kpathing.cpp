@@ -27,6 +27,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -59,6 +60,9 @@ enum {
 
 #define HUGE_DISTANCE 0xFFFFFFFF
 
+// Number of cells per dimension of the grid used for finding edges
+#define EDGE_GRID_SIZE 16
+
 #define VERTEX_HAS_EDGES(V) ((V) != CLIST_NEXT(V))
 
 // Error codes
@@ -95,21 +99,27 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// A* open and closed set membership
+	bool inOpenSet;
+	bool inClosedSet;
+
+	// Order in which the vertex entered the open set
+	uint openSeq;
+
+	// Position in the vertex index
+	int idx;
+
+	// Last edge query which has checked the edge starting at this vertex
+	uint32 queryStamp;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
-	}
-};
-
-class VertexList: public Common::List<Vertex *> {
-public:
-	bool contains(Vertex *v) {
-		for (iterator it = begin(); it != end(); ++it) {
-			if (v == *it)
-				return true;
-		}
-		return false;
+		inOpenSet = inClosedSet = false;
+		openSeq = 0;
+		idx = -1;
+		queryStamp = 0;
 	}
 };
 
@@ -236,6 +246,27 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Set when merging the start or end point has split up an edge
+	bool _edgeSplit;
+
+	// Number of single-vertex polygons added when merging the start and end points
+	int _mergedPolygons;
+
+	// Visibility cache, if it matches the polygon set, and the index of
+	// the first cached vertex in the vertex index
+	AvoidPathCache *_cache;
+	int _cacheOffset;
+
+	// Uniform grid over the bounding box of all vertices. Each cell lists the
+	// vertices starting an edge that overlaps the cell.
+	Common::Array<Common::Array<Vertex *> > _edgeGrid;
+	Common::Rect _gridBounds;
+	int _gridCellWidth, _gridCellHeight;
+	uint32 _queryStamp;
+
+	// Result of visible_vertices()
+	Common::Array<Vertex *> _visVerts;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -243,6 +274,12 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_edgeSplit = false;
+		_mergedPolygons = 0;
+		_cache = NULL;
+		_cacheOffset = 0;
+		_gridCellWidth = _gridCellHeight = 1;
+		_queryStamp = 0;
 	}
 
 	~PathfindingState() {
@@ -259,6 +296,14 @@ struct PathfindingState {
 	bool pointOnScreenBorder(const Common::Point &p);
 	bool edgeOnScreenBorder(const Common::Point &p, const Common::Point &q);
 	int findNearPoint(const Common::Point &p, Polygon *polygon, Common::Point *ret);
+
+	void buildCacheKey(Common::Array<int16> &key, uint &vertexCount) const;
+	void buildEdgeGrid();
+	bool isVisible(Vertex *a, Vertex *b);
+
+private:
+	bool edgeBlocksLine(Vertex *a, Vertex *b, Vertex *edge) const;
+	bool computeVisibility(Vertex *a, Vertex *b);
 };
 
 static Common::Point readPoint(SegmentRef list_r, int offset) {
@@ -639,42 +684,147 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 }
 
 /**
- * Returns a list of all vertices that are visible from a particular vertex.
- * @param s				the pathfinding state
- * @param vertex_cur	the vertex
- * @return list of vertices that are visible from vert
+ * Determines whether or not an edge obstructs the line between two vertices
+ * @param a, b		the vertices
+ * @param edge		the first vertex of the edge
+ * @return true if the line (a, b) intersects the edge
  */
-static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
-	VertexList *visVerts = new VertexList();
+bool PathfindingState::edgeBlocksLine(Vertex *a, Vertex *b, Vertex *edge) const {
+	if (between(a->v, b->v, edge->v)) {
+		// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+		return inside(a->v, edge) || inside(b->v, edge);
+	}
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
+	return intersect_proper(a->v, b->v, edge->v, CLIST_NEXT(edge)->v);
+}
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
+/**
+ * Determines whether or not two vertices can see each other. Only the edges
+ * in the grid cells overlapping the bounding box of the line between the
+ * vertices are checked, as no other edge can intersect that line.
+ * @param a, b		the vertices
+ * @return true if the vertices can see each other
+ */
+bool PathfindingState::computeVisibility(Vertex *a, Vertex *b) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if (inside(b->v, a) || inside(a->v, b))
+		return false;
+
+	const int x1 = (MIN(a->v.x, b->v.x) - _gridBounds.left) / _gridCellWidth;
+	const int x2 = (MAX(a->v.x, b->v.x) - _gridBounds.left) / _gridCellWidth;
+	const int y1 = (MIN(a->v.y, b->v.y) - _gridBounds.top) / _gridCellHeight;
+	const int y2 = (MAX(a->v.y, b->v.y) - _gridBounds.top) / _gridCellHeight;
+
+	// Edges overlapping several cells are only checked once per query
+	_queryStamp++;
+
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) {
+			const Common::Array<Vertex *> &cell = _edgeGrid[y * EDGE_GRID_SIZE + x];
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
+			for (uint i = 0; i < cell.size(); i++) {
+				Vertex *edge = cell[i];
+
+				if (edge->queryStamp == _queryStamp)
 					continue;
-				}
+				edge->queryStamp = _queryStamp;
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
+				if (edgeBlocksLine(a, b, edge))
+					return false;
 			}
 		}
+	}
+
+	return true;
+}
+
+/**
+ * Determines whether or not two vertices can see each other, using the
+ * visibility cache when both vertices are part of the cached polygon set.
+ * Visibility is symmetric, so the cache stores it for both directions.
+ * @param a, b		the vertices
+ * @return true if the vertices can see each other
+ */
+bool PathfindingState::isVisible(Vertex *a, Vertex *b) {
+	if (_cache) {
+		const int from = a->idx - _cacheOffset;
+		const int to = b->idx - _cacheOffset;
+
+		if (from >= 0 && to >= 0) {
+			if (_cache->isKnown(from, to))
+				return _cache->isVisible(from, to);
+
+			const bool visible = computeVisibility(a, b);
+			_cache->setVisible(from, to, visible);
+			return visible;
+		}
+	}
+
+	return computeVisibility(a, b);
+}
+
+/**
+ * Builds the grid of polygon edges used by computeVisibility()
+ */
+void PathfindingState::buildEdgeGrid() {
+	_gridBounds = Common::Rect();
+
+	for (int i = 0; i < vertices; i++) {
+		const Common::Point &p = vertex_index[i]->v;
+
+		if (i == 0) {
+			_gridBounds = Common::Rect(p.x, p.y, p.x + 1, p.y + 1);
+		} else {
+			_gridBounds.left = MIN(_gridBounds.left, p.x);
+			_gridBounds.top = MIN(_gridBounds.top, p.y);
+			_gridBounds.right = MAX<int16>(_gridBounds.right, p.x + 1);
+			_gridBounds.bottom = MAX<int16>(_gridBounds.bottom, p.y + 1);
+		}
+	}
+
+	_gridCellWidth = (_gridBounds.width() + EDGE_GRID_SIZE - 1) / EDGE_GRID_SIZE;
+	_gridCellHeight = (_gridBounds.height() + EDGE_GRID_SIZE - 1) / EDGE_GRID_SIZE;
+	_gridCellWidth = MAX(_gridCellWidth, 1);
+	_gridCellHeight = MAX(_gridCellHeight, 1);
 
-		if (j == s->vertices)
-			visVerts->push_front(vertex);
+	_edgeGrid.resize(EDGE_GRID_SIZE * EDGE_GRID_SIZE);
+
+	for (int i = 0; i < vertices; i++) {
+		Vertex *edge = vertex_index[i];
+
+		if (!VERTEX_HAS_EDGES(edge))
+			continue;
+
+		const Common::Point &p = edge->v;
+		const Common::Point &q = CLIST_NEXT(edge)->v;
+
+		const int x1 = (MIN(p.x, q.x) - _gridBounds.left) / _gridCellWidth;
+		const int x2 = (MAX(p.x, q.x) - _gridBounds.left) / _gridCellWidth;
+		const int y1 = (MIN(p.y, q.y) - _gridBounds.top) / _gridCellHeight;
+		const int y2 = (MAX(p.y, q.y) - _gridBounds.top) / _gridCellHeight;
+
+		for (int y = y1; y <= y2; y++)
+			for (int x = x1; x <= x2; x++)
+				_edgeGrid[y * EDGE_GRID_SIZE + x].push_back(edge);
+	}
+}
+
+/**
+ * Returns a list of all vertices that are visible from a particular vertex.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex
+ * @return list of vertices that are visible from vert, in reverse vertex
+ *         index order. The list is overwritten by the next call.
+ */
+static const Common::Array<Vertex *> &visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
+	Common::Array<Vertex *> &visVerts = s->_visVerts;
+	visVerts.clear();
+
+	for (int i = s->vertices - 1; i >= 0; i--) {
+		Vertex *vertex = s->vertex_index[i];
+
+		if ((vertex != vertex_cur) && s->isVisible(vertex_cur, vertex))
+			visVerts.push_back(vertex);
 	}
 
 	return visVerts;
@@ -1062,6 +1212,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 				if (between(vertex->v, next->v, v)) {
 					// Split edge by adding vertex
 					polygon->vertices.insertAfter(vertex, v_new);
+					s->_edgeSplit = true;
 					return v_new;
 				}
 			}
@@ -1072,6 +1223,7 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 	polygon = new Polygon(POLY_BARRED_ACCESS);
 	polygon->vertices.insertHead(v_new);
 	s->polygons.push_front(polygon);
+	s->_mergedPolygons++;
 
 	return v_new;
 }
@@ -1165,40 +1317,46 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
+ * Builds the key for the visibility cache, which lists the vertices of all
+ * polygons. Polygons are separated by their vertex count.
+ * @param key			the key
+ * @param vertexCount	the total number of vertices
+ */
+void PathfindingState::buildCacheKey(Common::Array<int16> &key, uint &vertexCount) const {
+	key.clear();
+	vertexCount = 0;
+
+	for (PolygonList::const_iterator it = polygons.begin(); it != polygons.end(); ++it) {
+		Vertex *vertex;
+		uint sizePos = key.size();
+
+		key.push_back(0);
+		CLIST_FOREACH(vertex, &(*it)->vertices) {
+			key.push_back(vertex->v.x);
+			key.push_back(vertex->v.y);
+			key[sizePos]++;
+		}
+		vertexCount += key[sizePos];
+	}
+}
+
+/**
+ * Prepares a polygon set for pathfinding: fixes up the start and end points,
+ * merges them into the polygon set and builds the vertex index
  * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
+ *             (PathfindingState *) pf_s: The pathfinding state holding the polygons
  *             (Common::Point) start: The start point
  *             (Common::Point) end: The end point
  *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ *             (AvoidPathCache *) cache: The visibility cache, or NULL
+ * Returns   : (PathfindingState *) On success the pathfinding state,
+ *                            NULL otherwise (pf_s is deleted in that case)
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
+static PathfindingState *prepare_polygon_set(EngineState *s, PathfindingState *pf_s, Common::Point start, Common::Point end, int opt, AvoidPathCache *cache) {
 	Polygon *polygon;
 	int err;
-	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
-
-	// Convert all polygons
-	if (poly_list.segment) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
-
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #3041232
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
-
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
-
-			node = s->_segMan->lookupNode(node->succ);
-		}
-	}
+	Common::Array<int16> cacheKey;
+	uint cacheVertexCount;
 
 	if (opt == 0) {
 		Common::Point intersection;
@@ -1216,6 +1374,8 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 			return NULL;
 		}
 
+		pf_s->buildCacheKey(cacheKey, cacheVertexCount);
+
 		if (err == PF_OK) {
 			// Intersection was found, prepend original start position after pathfinding
 			pf_s->_prependPoint = new Common::Point(start);
@@ -1252,6 +1412,8 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 			new_start = new Common::Point(77, 107);
 		}
 
+		pf_s->buildCacheKey(cacheKey, cacheVertexCount);
+
 		// Merge start and end points into polygon set
 		pf_s->vertex_start = merge_point(pf_s, *new_start);
 		pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1261,7 +1423,12 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	}
 
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	int count = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
@@ -1270,15 +1437,143 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->idx = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
 
+	// The merged start and end points are single-vertex polygons at the head
+	// of the polygon list, and don't affect the visibility between the other
+	// vertices. If an edge was split, the cached visibility can't be used.
+	if (cache && cache->_enabled && !pf_s->_edgeSplit) {
+		assert(pf_s->_mergedPolygons + cacheVertexCount == (uint)count);
+		cache->setKey(cacheKey, cacheVertexCount);
+		pf_s->_cache = cache;
+		pf_s->_cacheOffset = pf_s->_mergedPolygons;
+	}
+
+	pf_s->buildEdgeGrid();
+
 	return pf_s;
 }
 
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+	AvoidPathCache::Input &input = s->_avoidPathCache._lastInput;
+
+	input.polygons.clear();
+
+	// Convert all polygons
+	if (poly_list.segment) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #3041232
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon) {
+				pf_s->polygons.push_back(polygon);
+
+				// Remember the polygon, so that the debugger can replay this call
+				Vertex *vertex;
+				input.polygons.push_back(polygon->type);
+				input.polygons.push_back(polygon->vertices.size());
+				CLIST_FOREACH(vertex, &polygon->vertices) {
+					input.polygons.push_back(vertex->v.x);
+					input.polygons.push_back(vertex->v.y);
+				}
+			}
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	input.start = start;
+	input.end = end;
+	input.width = width;
+	input.height = height;
+	input.opt = opt;
+
+	return prepare_polygon_set(s, pf_s, start, end, opt, &s->_avoidPathCache);
+}
+
+/**
+ * Entry of the A* open set. A vertex may have several entries, as a new one
+ * is added whenever its cost decreases; entries with an outdated cost are
+ * skipped.
+ */
+struct OpenSetEntry {
+	uint32 costF;
+	uint seq;
+	Vertex *vertex;
+};
+
+/**
+ * Orders the open set by F cost. Ties are broken in favour of the vertex that
+ * entered the open set last, just like the linear search over a list with
+ * vertices added at the front which was used before.
+ */
+static bool openSetBefore(const OpenSetEntry &a, const OpenSetEntry &b) {
+	if (a.costF != b.costF)
+		return a.costF < b.costF;
+	return a.seq > b.seq;
+}
+
+static void openSetPush(Common::Array<OpenSetEntry> &heap, Vertex *vertex) {
+	OpenSetEntry entry;
+	entry.costF = vertex->costF;
+	entry.seq = vertex->openSeq;
+	entry.vertex = vertex;
+
+	uint pos = heap.size();
+	heap.push_back(entry);
+
+	while (pos > 0) {
+		uint parent = (pos - 1) / 2;
+		if (!openSetBefore(heap[pos], heap[parent]))
+			break;
+		SWAP(heap[pos], heap[parent]);
+		pos = parent;
+	}
+}
+
+static OpenSetEntry openSetPop(Common::Array<OpenSetEntry> &heap) {
+	OpenSetEntry top = heap[0];
+
+	heap[0] = heap.back();
+	heap.pop_back();
+
+	uint pos = 0;
+	while (true) {
+		uint child = pos * 2 + 1;
+		if (child >= heap.size())
+			break;
+		if (child + 1 < heap.size() && openSetBefore(heap[child + 1], heap[child]))
+			child++;
+		if (!openSetBefore(heap[child], heap[pos]))
+			break;
+		SWAP(heap[pos], heap[child]);
+		pos = child;
+	}
+
+	return top;
+}
+
 /**
  * Computes a shortest path from vertex_start to vertex_end. The caller can
  * construct the resulting path by following the path_prev links from
@@ -1287,52 +1582,49 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
-	// Vertices of which the shortest path is known
-	VertexList closedSet;
+	// The open set, as a binary heap
+	Common::Array<OpenSetEntry> openSet;
+	uint openSeq = 0;
+	bool found = false;
 
-	// The remaining vertices
-	VertexList openSet;
-
-	openSet.push_front(s->vertex_start);
 	s->vertex_start->costG = 0;
 	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+	s->vertex_start->inOpenSet = true;
+	s->vertex_start->openSeq = openSeq++;
+	openSetPush(openSet, s->vertex_start);
 
 	while (!openSet.empty()) {
 		// Find vertex in open set with lowest F cost
-		VertexList::iterator vertex_min_it = openSet.end();
-		Vertex *vertex_min = 0;
-		uint32 min = HUGE_DISTANCE;
-
-		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
-			Vertex *vertex = *it;
-			if (vertex->costF < min) {
-				vertex_min_it = it;
-				vertex_min = *vertex_min_it;
-				min = vertex->costF;
-			}
-		}
+		OpenSetEntry entry = openSetPop(openSet);
+		Vertex *vertex_min = entry.vertex;
 
-		assert(vertex_min != 0);	// the vertex cost should never be bigger than HUGE_DISTANCE
+		// Skip entries which have been superseded by a lower cost
+		if (vertex_min->inClosedSet || entry.costF != vertex_min->costF)
+			continue;
 
 		// Check if we are done
-		if (vertex_min == s->vertex_end)
+		if (vertex_min == s->vertex_end) {
+			found = true;
 			break;
+		}
 
 		// Move vertex from set open to set closed
-		closedSet.push_front(vertex_min);
-		openSet.erase(vertex_min_it);
+		vertex_min->inOpenSet = false;
+		vertex_min->inClosedSet = true;
 
-		VertexList *visVerts = visible_vertices(s, vertex_min);
+		const Common::Array<Vertex *> &visVerts = visible_vertices(s, vertex_min);
 
-		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
+		for (Common::Array<Vertex *>::const_iterator it = visVerts.begin(); it != visVerts.end(); ++it) {
 			uint32 new_dist;
 			Vertex *vertex = *it;
 
-			if (closedSet.contains(vertex))
+			if (vertex->inClosedSet)
 				continue;
 
-			if (!openSet.contains(vertex))
-				openSet.push_front(vertex);
+			if (!vertex->inOpenSet) {
+				vertex->inOpenSet = true;
+				vertex->openSeq = openSeq++;
+			}
 
 			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
 
@@ -1350,13 +1642,12 @@ static void AStar(PathfindingState *s) {
 				vertex->costG = new_dist;
 				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
 				vertex->path_prev = vertex_min;
+				openSetPush(openSet, vertex);
 			}
 		}
-
-		delete visVerts;
 	}
 
-	if (openSet.empty())
+	if (!found)
 		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
 }
 
@@ -1548,6 +1839,81 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	}
 }
 
+bool AvoidPathCache::setKey(const Common::Array<int16> &key, uint vertexCount) {
+	if (vertexCount == _vertexCount && key == _key) {
+		_hits++;
+		return true;
+	}
+
+	_misses++;
+	_key = key;
+	_vertexCount = vertexCount;
+
+	// Reuse the bitmaps, as the polygon sets of a game have similar sizes
+	const uint words = (vertexCount * vertexCount + 31) / 32;
+	_known.resize(words);
+	_visible.resize(words);
+	memset(_known.begin(), 0, words * sizeof(uint32));
+
+	return false;
+}
+
+void AvoidPathCache::setVisible(uint from, uint to, bool visible) {
+	const uint bits[2] = { from * _vertexCount + to, to * _vertexCount + from };
+
+	for (int i = 0; i < 2; i++) {
+		const uint32 mask = 1 << (bits[i] & 31);
+
+		_known[bits[i] >> 5] |= mask;
+		if (visible)
+			_visible[bits[i] >> 5] |= mask;
+		else
+			_visible[bits[i] >> 5] &= ~mask;
+	}
+}
+
+int benchmarkAvoidPath(EngineState *s, int iterations, bool useCache) {
+	AvoidPathCache &cache = s->_avoidPathCache;
+	const AvoidPathCache::Input &input = cache._lastInput;
+
+	if (!input.width)
+		return -1;
+
+	const bool wasEnabled = cache._enabled;
+	cache._enabled = useCache;
+
+	const uint32 startTime = g_system->getMillis();
+
+	for (int i = 0; i < iterations; i++) {
+		PathfindingState *p = new PathfindingState(input.width, input.height);
+
+		uint pos = 0;
+		while (pos < input.polygons.size()) {
+			Polygon *polygon = new Polygon(input.polygons[pos]);
+			const int size = input.polygons[pos + 1];
+
+			pos += 2;
+			// The points were stored in list order, so insert them backwards
+			for (int j = size - 1; j >= 0; j--)
+				polygon->vertices.insertHead(new Vertex(Common::Point(input.polygons[pos + j * 2], input.polygons[pos + j * 2 + 1])));
+			pos += size * 2;
+
+			p->polygons.push_back(polygon);
+		}
+
+		p = prepare_polygon_set(s, p, input.start, input.end, input.opt, &cache);
+
+		if (p) {
+			AStar(p);
+			delete p;
+		}
+	}
+
+	cache._enabled = wasEnabled;
+
+	return g_system->getMillis() - startTime;
+}
+
 static bool PointInRect(const Common::Point &point, int16 rectX1, int16 rectY1, int16 rectX2, int16 rectY2) {
 	int16 top = MIN<int16>(rectY1, rectY2);
 	int16 left = MIN<int16>(rectX1, rectX2);
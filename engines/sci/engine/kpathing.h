@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+struct EngineState;
+
+/**
+ * Visibility information kept between kAvoidPath calls. Rooms call
+ * kAvoidPath every few frames with the same polygon list, so the visibility
+ * between the polygon vertices is remembered, keyed on the polygon geometry.
+ * The start and end points of a path are merged into the polygon set after
+ * the lookup; the cached information is only used when that merge doesn't
+ * split any polygon edge.
+ */
+class AvoidPathCache {
+public:
+	AvoidPathCache() : _enabled(true), _vertexCount(0), _hits(0), _misses(0) {}
+
+	/**
+	 * Makes the cache refer to the given polygon geometry, dropping all
+	 * information about a different geometry.
+	 * @param key	the polygon vertices, see PathfindingState::buildCacheKey()
+	 * @param vertexCount	the number of polygon vertices
+	 * @return true if the geometry was already cached
+	 */
+	bool setKey(const Common::Array<int16> &key, uint vertexCount);
+
+	bool isKnown(uint from, uint to) const { return getBit(_known, from, to); }
+	bool isVisible(uint from, uint to) const { return getBit(_visible, from, to); }
+
+	/** Stores the visibility between two vertices, in both directions. */
+	void setVisible(uint from, uint to, bool visible);
+
+	uint getHits() const { return _hits; }
+	uint getMisses() const { return _misses; }
+
+	/** Set to false to bypass the cache, e.g. for benchmarking. */
+	bool _enabled;
+
+	/**
+	 * The input of the last kAvoidPath call doing pathfinding, stored as
+	 * plain data so that it can be replayed by the debugger: for each
+	 * polygon its type, its size and its points.
+	 */
+	struct Input {
+		Common::Array<int16> polygons;
+		Common::Point start, end;
+		int width, height, opt;
+	} _lastInput;
+
+private:
+	bool getBit(const Common::Array<uint32> &bits, uint from, uint to) const {
+		const uint bit = from * _vertexCount + to;
+		return bits[bit >> 5] & (1 << (bit & 31));
+	}
+
+	Common::Array<int16> _key;
+	uint _vertexCount;
+	Common::Array<uint32> _known;	///< Vertex pairs whose visibility was computed
+	Common::Array<uint32> _visible;	///< Vertex pairs which can see each other
+
+	uint _hits, _misses;
+};
+
+/**
+ * Replays the last pathfinding input of kAvoidPath.
+ * @param s				the game state
+ * @param iterations	number of times to compute the path
+ * @param useCache		whether to use the cached visibility information
+ * @return the total time taken in ms, or -1 when there's no input to replay
+ */
+int benchmarkAvoidPath(EngineState *s, int iterations, bool useCache);
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
@@ -208,6 +208,10 @@ void SegManager::saveLoadWithSerializer(Common::Serializer &s) {
 
 	syncArray<Class>(s, _classTable);
 
+	// The segments got replaced without going through allocSegment()
+	if (s.isLoading())
+		heapChanged();
+
 	// Now that all scripts are loaded, init their objects
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (!_heap[i] ||  _heap[i]->getType() != SEG_TYPE_SCRIPT)
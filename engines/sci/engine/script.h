@@ -33,7 +33,6 @@ namespace Sci {
 
 struct EngineState;
 class ResourceManager;
-struct SciScriptSignature;
 
 enum ScriptObjectTypes {
 	SCI_OBJ_TERMINATOR,
@@ -101,10 +100,6 @@ public:
 	void init(int script_nr, ResourceManager *resMan);
 	void load(ResourceManager *resMan);
 
-	void matchSignatureAndPatch(uint16 scriptNr, byte *scriptData, const uint32 scriptSize);
-	int32 findSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize);
-	void applyPatch(const uint16 *patch, byte *scriptData, const uint32 scriptSize, int32 signatureOffset);
-
 	virtual bool isValidOffset(uint16 offset) const;
 	virtual SegmentRef dereference(reg_t pointer);
 	virtual reg_t findCanonicAddress(SegManager *segMan, reg_t sub_addr) const;
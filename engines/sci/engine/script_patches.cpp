@@ -25,8 +25,10 @@
 
 #include "sci/sci.h"
 #include "sci/engine/script.h"
+#include "sci/engine/script_patches.h"
 #include "sci/engine/state.h"
 
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Sci {
@@ -1097,12 +1099,94 @@ const SciScriptSignature sq5Signatures[] = {
 };
 
 
+ScriptPatcher::ScriptPatcher() : _signatureTable(NULL), _compiled(false), _reportPatches(true) {
+}
+
+void ScriptPatcher::compile() {
+	switch (g_sci->getGameId()) {
+	// Dr. Brain now works because we properly maintain the state of the string heap in savegames
+#if 0
+	case GID_CASTLEBRAIN:
+		_signatureTable = castlebrainSignatures;
+		break;
+#endif
+	case GID_ECOQUEST:
+		_signatureTable = ecoquest1Signatures;
+		break;
+	case GID_ECOQUEST2:
+		_signatureTable = ecoquest2Signatures;
+		break;
+	case GID_FANMADE:
+		_signatureTable = fanmadeSignatures;
+		break;
+	case GID_FREDDYPHARKAS:
+		_signatureTable = freddypharkasSignatures;
+		break;
+	case GID_GK1:
+		_signatureTable = gk1Signatures;
+		break;
+	// hoyle4 now works due to workaround inside GfxPorts
+#if 0
+	case GID_HOYLE4:
+		_signatureTable = hoyle4Signatures;
+		break;
+#endif
+	case GID_KQ5:
+		_signatureTable = kq5Signatures;
+		break;
+	case GID_LAURABOW2:
+		_signatureTable = laurabow2Signatures;
+		break;
+	case GID_LSL6:
+		_signatureTable = larry6Signatures;
+		break;
+	case GID_MOTHERGOOSE256:
+		_signatureTable = mothergoose256Signatures;
+		break;
+	case GID_QFG1VGA:
+		_signatureTable = qfg1vgaSignatures;
+		break;
+	case GID_QFG2:
+		_signatureTable = qfg2Signatures;
+		break;
+	case GID_QFG3:
+		_signatureTable = qfg3Signatures;
+		break;
+	case GID_SQ4:
+		_signatureTable = sq4Signatures;
+		break;
+	case GID_SQ5:
+		_signatureTable = sq5Signatures;
+		break;
+	default:
+		break;
+	}
+
+	_compiled = true;
+	if (!_signatureTable)
+		return;
+
+	for (const SciScriptSignature *signature = _signatureTable; signature->data; signature++) {
+		ScriptSignatures &scriptSignatures = _scriptSignatures[signature->scriptNr];
+		if (scriptSignatures.signatures.empty())
+			memset(scriptSignatures.firstBytes, 0, sizeof(scriptSignatures.firstBytes));
+		scriptSignatures.signatures.push_back(signature);
+		// magicDWord is in platform-specific form, so get its first byte the same way it's matched
+		byte firstByte = *(const byte *)&signature->magicDWord;
+		scriptSignatures.firstBytes[firstByte >> 3] |= 1 << (firstByte & 7);
+	}
+}
+
 // will actually patch previously found signature area
-void Script::applyPatch(const uint16 *patch, byte *scriptData, const uint32 scriptSize, int32 signatureOffset) {
+void ScriptPatcher::applyPatch(const SciScriptSignature *signature, uint16 scriptNr, byte *scriptData, const uint32 scriptSize, int32 signatureOffset) {
+	const uint16 *patch = signature->patch;
 	byte orgData[PATCH_VALUELIMIT];
 	int32 offset = signatureOffset;
 	uint16 patchWord = *patch;
 
+	if (_reportPatches)
+		warning("matched and patched %s on script %d offset %d", signature->description, scriptNr, signatureOffset);
+
 	// Copy over original bytes from script
 	uint32 orgDataSize = scriptSize - offset;
 	if (orgDataSize > PATCH_VALUELIMIT)
@@ -1148,8 +1232,32 @@ void Script::applyPatch(const uint16 *patch, byte *scriptData, const uint32 scri
 	}	
 }
 
+// will return -1 if the signature doesn't match at the given magic DWORD, otherwise an offset to the start of the signature match
+int32 ScriptPatcher::matchSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize, uint32 DWordOffset) {
+	uint32 offset = DWordOffset + signature->magicOffset;
+	uint32 byteOffset = offset;
+	const byte *signatureData = signature->data;
+	byte matchAdjust = 1;
+	while (matchAdjust) {
+		byte matchBytesCount = *signatureData++;
+		if ((byteOffset + matchBytesCount) > scriptSize) // Out-Of-Bounds?
+			break;
+		if (memcmp(signatureData, &scriptData[byteOffset], matchBytesCount)) // Byte-Mismatch?
+			break;
+		// those bytes matched, adjust offsets accordingly
+		signatureData += matchBytesCount;
+		byteOffset += matchBytesCount;
+		// get offset...
+		matchAdjust = *signatureData++;
+		byteOffset += matchAdjust;
+	}
+	if (!matchAdjust) // all matches worked?
+		return offset;
+	return -1;
+}
+
 // will return -1 if no match was found, otherwise an offset to the start of the signature match
-int32 Script::findSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize) {
+int32 ScriptPatcher::findSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize) {
 	if (scriptSize < 4) // we need to find a DWORD, so less than 4 bytes is not okay
 		return -1;
 
@@ -1160,24 +1268,8 @@ int32 Script::findSignature(const SciScriptSignature *signature, const byte *scr
 	while (DWordOffset < searchLimit) {
 		if (magicDWord == READ_UINT32(scriptData + DWordOffset)) {
 			// magic DWORD found, check if actual signature matches
-			uint32 offset = DWordOffset + signature->magicOffset;
-			uint32 byteOffset = offset;
-			const byte *signatureData = signature->data;
-			byte matchAdjust = 1;
-			while (matchAdjust) {
-				byte matchBytesCount = *signatureData++;
-				if ((byteOffset + matchBytesCount) > scriptSize) // Out-Of-Bounds?
-					break;
-				if (memcmp(signatureData, &scriptData[byteOffset], matchBytesCount)) // Byte-Mismatch?
-					break;
-				// those bytes matched, adjust offsets accordingly
-				signatureData += matchBytesCount;
-				byteOffset += matchBytesCount;
-				// get offset...
-				matchAdjust = *signatureData++;
-				byteOffset += matchAdjust;
-			}
-			if (!matchAdjust) // all matches worked?
+			int32 offset = matchSignature(signature, scriptData, scriptSize, DWordOffset);
+			if (offset != -1)
 				return offset;
 		}
 		DWordOffset++;
@@ -1186,66 +1278,62 @@ int32 Script::findSignature(const SciScriptSignature *signature, const byte *scr
 	return -1;
 }
 
-void Script::matchSignatureAndPatch(uint16 scriptNr, byte *scriptData, const uint32 scriptSize) {
-	const SciScriptSignature *signatureTable = NULL;
-	switch (g_sci->getGameId()) {
-	// Dr. Brain now works because we properly maintain the state of the string heap in savegames
-#if 0
-	case GID_CASTLEBRAIN:
-		signatureTable = castlebrainSignatures;
-		break;
-#endif
-	case GID_ECOQUEST:
-		signatureTable = ecoquest1Signatures;
-		break;
-	case GID_ECOQUEST2:
-		signatureTable = ecoquest2Signatures;
-		break;
-	case GID_FANMADE:
-		signatureTable = fanmadeSignatures;
-		break;
-	case GID_FREDDYPHARKAS:
-		signatureTable = freddypharkasSignatures;
-		break;
-	case GID_GK1:
-		signatureTable = gk1Signatures;
-		break;
-	// hoyle4 now works due to workaround inside GfxPorts
-#if 0
-	case GID_HOYLE4:
-		signatureTable = hoyle4Signatures;
-		break;
-#endif
-	case GID_KQ5:
-		signatureTable = kq5Signatures;
-		break;
-	case GID_LAURABOW2:
-		signatureTable = laurabow2Signatures;
-		break;
-	case GID_LSL6:
-		signatureTable = larry6Signatures;
-		break;
-	case GID_MOTHERGOOSE256:
-		signatureTable = mothergoose256Signatures;
-		break;
-	case GID_QFG1VGA:
-		signatureTable = qfg1vgaSignatures;
-		break;
-	case GID_QFG2:
-		signatureTable = qfg2Signatures;
-		break;
-	case GID_QFG3:
-		signatureTable = qfg3Signatures;
-		break;
-	case GID_SQ4:
-		signatureTable = sq4Signatures;
-		break;
-	case GID_SQ5:
-		signatureTable = sq5Signatures;
-		break;
-	default:
-		break;
+// Collects the offsets of the magic DWORDs of all signatures of a script in one go
+void ScriptPatcher::findCandidates(const ScriptSignatures &scriptSignatures, const byte *scriptData, const uint32 scriptSize) {
+	const uint signatureCount = scriptSignatures.signatures.size();
+	uint signatureNr;
+
+	_candidates.resize(signatureCount);
+	for (signatureNr = 0; signatureNr < signatureCount; signatureNr++)
+		_candidates[signatureNr].resize(0);
+
+	if (scriptSize < 4) // we need to find a DWORD, so less than 4 bytes is not okay
+		return;
+
+	const uint32 searchLimit = scriptSize - 3;
+	for (uint32 DWordOffset = 0; DWordOffset < searchLimit; DWordOffset++) {
+		const byte curByte = scriptData[DWordOffset];
+		if (!(scriptSignatures.firstBytes[curByte >> 3] & (1 << (curByte & 7))))
+			continue;
+		const uint32 curDWord = READ_UINT32(scriptData + DWordOffset);
+		for (signatureNr = 0; signatureNr < signatureCount; signatureNr++) {
+			if (scriptSignatures.signatures[signatureNr]->magicDWord == curDWord)
+				_candidates[signatureNr].push_back(DWordOffset);
+		}
+	}
+}
+
+void ScriptPatcher::processScriptCompiled(uint16 scriptNr, byte *scriptData, const uint32 scriptSize) {
+	ScriptSignatureMap::const_iterator it = _scriptSignatures.find(scriptNr);
+	if (it == _scriptSignatures.end())
+		return;
+
+	const ScriptSignatures &scriptSignatures = it->_value;
+	findCandidates(scriptSignatures, scriptData, scriptSize);
+
+	for (uint signatureNr = 0; signatureNr < scriptSignatures.signatures.size(); signatureNr++) {
+		const SciScriptSignature *signature = scriptSignatures.signatures[signatureNr];
+		int32 foundOffset = 0;
+		int16 applyCount = signature->applyCount;
+		do {
+			// the candidates are in ascending order, so this finds the same match as findSignature()
+			const Common::Array<uint32> &candidates = _candidates[signatureNr];
+			foundOffset = -1;
+			for (uint candidateNr = 0; candidateNr < candidates.size() && foundOffset == -1; candidateNr++)
+				foundOffset = matchSignature(signature, scriptData, scriptSize, candidates[candidateNr]);
+			if (foundOffset != -1) {
+				// found, so apply the patch
+				applyPatch(signature, scriptNr, scriptData, scriptSize, foundOffset);
+				// the patch may have added or removed magic DWORDs
+				findCandidates(scriptSignatures, scriptData, scriptSize);
+			}
+			applyCount--;
+		} while ((foundOffset != -1) && (applyCount));
 	}
+}
+
+void ScriptPatcher::processScriptSeparate(uint16 scriptNr, byte *scriptData, const uint32 scriptSize) {
+	const SciScriptSignature *signatureTable = _signatureTable;
 
 	if (signatureTable) {
 		while (signatureTable->data) {
@@ -1256,8 +1344,7 @@ void Script::matchSignatureAndPatch(uint16 scriptNr, byte *scriptData, const uin
 					foundOffset = findSignature(signatureTable, scriptData, scriptSize);
 					if (foundOffset != -1) {
 						// found, so apply the patch
-						warning("matched and patched %s on script %d offset %d", signatureTable->description, scriptNr, foundOffset);
-						applyPatch(signatureTable->patch, scriptData, scriptSize, foundOffset);
+						applyPatch(signatureTable, scriptNr, scriptData, scriptSize, foundOffset);
 					}
 					applyCount--;
 				} while ((foundOffset != -1) && (applyCount));
@@ -1267,4 +1354,77 @@ void Script::matchSignatureAndPatch(uint16 scriptNr, byte *scriptData, const uin
 	}
 }
 
+void ScriptPatcher::processScript(uint16 scriptNr, byte *scriptData, const uint32 scriptSize) {
+	if (!_compiled)
+		compile();
+	processScriptCompiled(scriptNr, scriptData, scriptSize);
+}
+
+int ScriptPatcher::benchmark(ResourceManager *resMan, int iterations, uint32 &timeCopy, uint32 &timeSeparate, uint32 &timeCompiled) {
+	Common::List<ResourceId> *resources = resMan->listResources(kResourceTypeScript);
+	Common::Array<uint16> scriptNumbers;
+	Common::Array<Common::Array<byte> > scripts;
+	uint32 maxSize = 0;
+	int mismatches = 0;
+	uint scriptNr;
+
+	if (!_compiled)
+		compile();
+
+	for (Common::List<ResourceId>::iterator itr = resources->begin(); itr != resources->end(); ++itr) {
+		Resource *script = resMan->findResource(*itr, false);
+		if (!script)
+			continue;
+		scriptNumbers.push_back(itr->getNumber());
+		scripts.push_back(Common::Array<byte>(script->data, script->size));
+		maxSize = MAX<uint32>(maxSize, script->size);
+	}
+	delete resources;
+
+	byte *buffer = new byte[maxSize];
+	byte *compareBuffer = new byte[maxSize];
+	_reportPatches = false;
+
+	// Make sure both methods patch the same way
+	for (scriptNr = 0; scriptNr < scripts.size(); scriptNr++) {
+		const uint32 size = scripts[scriptNr].size();
+		memcpy(buffer, scripts[scriptNr].begin(), size);
+		processScriptSeparate(scriptNumbers[scriptNr], buffer, size);
+		memcpy(compareBuffer, scripts[scriptNr].begin(), size);
+		processScriptCompiled(scriptNumbers[scriptNr], compareBuffer, size);
+		if (memcmp(buffer, compareBuffer, size))
+			mismatches++;
+	}
+
+	uint32 startTime = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (scriptNr = 0; scriptNr < scripts.size(); scriptNr++)
+			memcpy(buffer, scripts[scriptNr].begin(), scripts[scriptNr].size());
+	}
+	timeCopy = g_system->getMillis() - startTime;
+
+	startTime = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (scriptNr = 0; scriptNr < scripts.size(); scriptNr++) {
+			memcpy(buffer, scripts[scriptNr].begin(), scripts[scriptNr].size());
+			processScriptSeparate(scriptNumbers[scriptNr], buffer, scripts[scriptNr].size());
+		}
+	}
+	timeSeparate = g_system->getMillis() - startTime;
+
+	startTime = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (scriptNr = 0; scriptNr < scripts.size(); scriptNr++) {
+			memcpy(buffer, scripts[scriptNr].begin(), scripts[scriptNr].size());
+			processScriptCompiled(scriptNumbers[scriptNr], buffer, scripts[scriptNr].size());
+		}
+	}
+	timeCompiled = g_system->getMillis() - startTime;
+
+	_reportPatches = true;
+	delete[] compareBuffer;
+	delete[] buffer;
+	return mismatches;
+}
+
 } // End of namespace Sci
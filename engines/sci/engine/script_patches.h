@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef SCI_ENGINE_SCRIPT_PATCHES_H
+#define SCI_ENGINE_SCRIPT_PATCHES_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+
+namespace Sci {
+
+struct SciScriptSignature;
+class ResourceManager;
+
+/**
+ * Patches game scripts on load. The signature table of the current game gets
+ * compiled on first use: the signatures are grouped per script and the first
+ * bytes of their magic DWORDs are put into a lookup table, so that the
+ * candidate patch sites of all signatures of a script are found in a single
+ * pass over its data.
+ */
+class ScriptPatcher {
+public:
+	ScriptPatcher();
+
+	/** Looks for all signatures of the given script and applies their patches. */
+	void processScript(uint16 scriptNr, byte *scriptData, const uint32 scriptSize);
+
+	/**
+	 * Loads every script resource of the game: without patching, looking for
+	 * each signature separately and using the compiled signatures.
+	 * @param resMan		the resource manager
+	 * @param iterations	number of times to load every script
+	 * @param timeCopy		the time taken without patching in ms
+	 * @param timeSeparate	the time taken looking for each signature separately in ms
+	 * @param timeCompiled	the time taken using the compiled signatures in ms
+	 * @return the number of scripts, which got patched differently by both methods
+	 */
+	int benchmark(ResourceManager *resMan, int iterations, uint32 &timeCopy, uint32 &timeSeparate, uint32 &timeCompiled);
+
+private:
+	struct ScriptSignatures {
+		Common::Array<const SciScriptSignature *> signatures;
+		byte firstBytes[256 / 8]; ///< Bitmap of the first bytes of the magic DWORDs
+	};
+	typedef Common::HashMap<uint16, ScriptSignatures> ScriptSignatureMap;
+
+	void compile();
+	void findCandidates(const ScriptSignatures &scriptSignatures, const byte *scriptData, const uint32 scriptSize);
+	void processScriptCompiled(uint16 scriptNr, byte *scriptData, const uint32 scriptSize);
+	void processScriptSeparate(uint16 scriptNr, byte *scriptData, const uint32 scriptSize);
+
+	int32 findSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize);
+	int32 matchSignature(const SciScriptSignature *signature, const byte *scriptData, const uint32 scriptSize, uint32 DWordOffset);
+	void applyPatch(const SciScriptSignature *signature, uint16 scriptNr, byte *scriptData, const uint32 scriptSize, int32 signatureOffset);
+
+	const SciScriptSignature *_signatureTable;
+	bool _compiled;
+	bool _reportPatches;
+	ScriptSignatureMap _scriptSignatures;
+	Common::Array<Common::Array<uint32> > _candidates; ///< Offsets of the magic DWORDs found for each signature of the current script
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_SCRIPT_PATCHES_H
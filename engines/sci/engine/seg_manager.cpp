@@ -24,6 +24,7 @@
  */
 
 #include "sci/sci.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
@@ -51,6 +52,8 @@ SegManager::SegManager(ResourceManager *resMan) {
 #endif
 
 	_resMan = resMan;
+	_gcAllocationLog = NULL;
+	_heapGeneration = 0;
 
 	createClassTable();
 }
@@ -110,6 +113,12 @@ SegmentId SegManager::findFreeSegment() const {
 	return seg;
 }
 
+void SegManager::noteAllocation(reg_t addr) {
+	heapChanged();
+	if (_gcAllocationLog)
+		_gcAllocationLog->insert(addr);
+}
+
 SegmentObj *SegManager::allocSegment(SegmentObj *mem, SegmentId *segid) {
 	// Find a free segment
 	SegmentId id = findFreeSegment();
@@ -125,6 +134,7 @@ SegmentObj *SegManager::allocSegment(SegmentObj *mem, SegmentId *segid) {
 		_heap.push_back(0);
 	}
 	_heap[id] = mem;
+	heapChanged();
 
 	return mem;
 }
@@ -160,6 +170,7 @@ void SegManager::deallocate(SegmentId seg, bool recursive) {
 
 	delete mobj;
 	_heap[seg] = NULL;
+	heapChanged();
 }
 
 bool SegManager::isHeapObject(reg_t pos) const {
@@ -397,6 +408,7 @@ void SegManager::freeHunkEntry(reg_t addr) {
 	}
 
 	ht->freeEntry(addr.offset);
+	heapChanged();
 }
 
 reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
@@ -419,6 +431,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	h->size = size;
 	h->type = hunk_type;
 
+	noteAllocation(addr);
 	return addr;
 }
 
@@ -445,6 +458,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	noteAllocation(*addr);
 	return &(table->_table[offset]);
 }
 
@@ -459,6 +473,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	noteAllocation(*addr);
 	return &(table->_table[offset]);
 }
 
@@ -473,6 +488,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	noteAllocation(*addr);
 	return &(table->_table[offset]);
 }
 
@@ -838,6 +854,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 	SegmentId seg;
 	SegmentObj *mobj = allocSegment(new DynMem(), &seg);
 	*addr = make_reg(seg, 0);
+	noteAllocation(*addr);
 
 	DynMem &d = *(DynMem *)mobj;
 
@@ -875,6 +892,7 @@ SciArray<reg_t> *SegManager::allocateArray(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	noteAllocation(*addr);
 	return &(table->_table[offset]);
 }
 
@@ -901,6 +919,7 @@ void SegManager::freeArray(reg_t addr) {
 
 	arrayTable->_table[addr.offset].destroy();
 	arrayTable->freeEntry(addr.offset);
+	heapChanged();
 }
 
 SciString *SegManager::allocateString(reg_t *addr) {
@@ -915,6 +934,7 @@ SciString *SegManager::allocateString(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_stringSegId, offset);
+	noteAllocation(*addr);
 	return &(table->_table[offset]);
 }
 
@@ -941,6 +961,7 @@ void SegManager::freeString(reg_t addr) {
 
 	stringTable->_table[addr.offset].destroy();
 	stringTable->freeEntry(addr.offset);
+	heapChanged();
 }
 
 #endif
@@ -1007,6 +1028,7 @@ int SegManager::instantiateScript(int scriptNum) {
 	scr->initialiseLocals(this);
 	scr->initialiseClasses(this);
 	scr->initialiseObjects(this, segmentId);
+	noteAllocation(make_reg(segmentId, 0));
 
 	return segmentId;
 }
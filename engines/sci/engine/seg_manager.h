@@ -53,6 +53,7 @@ enum ScriptLoadType {
 	SCRIPT_GET_LOCK = 3 /**< Load, if neccessary, and lock */
 };
 
+class AddrSet;
 class Script;
 
 class SegManager : public Common::Serializable {
@@ -453,6 +454,24 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Sets the set in which the addresses of all newly allocated objects are
+	 * recorded. Used by the garbage collector while it is sweeping
+	 * incrementally, as anything allocated after its mark phase must survive.
+	 * @param log	the set to add new addresses to, or NULL to stop logging
+	 */
+	void setGCAllocationLog(AddrSet *log) { _gcAllocationLog = log; }
+
+	/**
+	 * Returns a number which changes whenever segments or their entries are
+	 * allocated or freed. As long as it stays the same, Kernel::findRegType()
+	 * returns the same type for any given address.
+	 */
+	uint32 getHeapGeneration() const { return _heapGeneration; }
+
+	/** Marks the heap as changed, see getHeapGeneration(). */
+	void heapChanged() { _heapGeneration++; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -466,6 +485,9 @@ private:
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
 	SegmentId _hunksSegId; ///< ID of the (a) hunk segment
 
+	AddrSet *_gcAllocationLog; ///< Newly allocated addresses are added here, if set
+	uint32 _heapGeneration;
+
 	// Statically allocated memory for system strings
 	reg_t _saveDirPtr;
 	reg_t _parserPtr;
@@ -482,6 +504,12 @@ private:
 
 	SegmentId findFreeSegment() const;
 
+	/**
+	 * Called for every newly allocated address: marks the heap as changed and
+	 * adds the address to the GC allocation log.
+	 */
+	void noteAllocation(reg_t addr);
+
 	/**
 	 * Check segment validity
 	 * @param[in] seg	The segment to validate
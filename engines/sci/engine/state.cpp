@@ -29,6 +29,7 @@
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/event.h"
 
+#include "sci/engine/gc.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
@@ -73,11 +74,14 @@ static const uint16 s_halfWidthSJISMap[256] = {
 EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan), _dirseeker() {
 
+	_gc = new GarbageCollector();
+
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _gc;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -102,6 +106,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	_gc->abort(_segMan);
 
 	_throttleCounter = 0;
 	_throttleLastTime = 0;
@@ -117,6 +122,7 @@ void EngineState::reset(bool isRestoring) {
 
 	scriptStepCounter = 0;
 	scriptGCInterval = GC_INTERVAL;
+	scriptGCIncremental = false;
 
 	_videoState.reset();
 	_syncedAudioOptions = false;
@@ -37,6 +37,7 @@ namespace Common {
 }
 
 #include "sci/sci.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/seg_manager.h"
 
 #include "sci/parser/vocabulary.h"
@@ -46,6 +47,7 @@ namespace Common {
 namespace Sci {
 
 class EventManager;
+class GarbageCollector;
 class MessageState;
 class SoundCommandParser;
 
@@ -206,6 +208,7 @@ public:
 
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
+	bool scriptGCIncremental; // Sweep incrementally in between kernel calls
 
 	uint16 currentRoomNumber() const;
 	void setRoomNumber(uint16 roomNumber);
@@ -222,6 +225,9 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GarbageCollector *_gc; /**< The garbage collector */
+
+	AvoidPathCache _avoidPathCache; /**< Visibility information kept between kAvoidPath calls */
 
 	MessageState *_msgState;
 
@@ -728,7 +728,7 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	reg_t *argv = s->xs->sp + 1;
 
 	if (kernelCall.signature
-			&& !kernel->signatureMatch(kernelCall.signature, argc, argv)) {
+			&& !kernel->checkSignature(kernelCall.signature, argc, argv)) {
 		// signature mismatch, check if a workaround is available
 		SciTrackOriginReply originReply;
 		SciWorkaroundSolution solution = trackOriginAndFindWorkaround(0, kernelCall.workarounds, &originReply);
@@ -777,7 +777,7 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 		if (subId >= kernelCall.subFunctionCount)
 			error("[VM] k%s: subfunction-id %d requested, but not available", kernelCall.name, subId);
 		const KernelSubFunction &kernelSubCall = kernelCall.subFunctions[subId];
-		if (kernelSubCall.signature && !kernel->signatureMatch(kernelSubCall.signature, argc, argv)) {
+		if (kernelSubCall.signature && !kernel->checkSignature(kernelSubCall.signature, argc, argv)) {
 			// Signature mismatch
 			SciTrackOriginReply originReply;
 			SciWorkaroundSolution solution = trackOriginAndFindWorkaround(0, kernelSubCall.workarounds, &originReply);
@@ -827,9 +827,15 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 }
 
 static void gcCountDown(EngineState *s) {
+	if (s->_gc->isSweeping())
+		s->_gc->step(s);
+
 	if (s->gcCountDown-- <= 0) {
 		s->gcCountDown = s->scriptGCInterval;
-		run_gc(s);
+		if (s->scriptGCIncremental)
+			s->_gc->start(s);
+		else
+			run_gc(s);
 	}
 }
 
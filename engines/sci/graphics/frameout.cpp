@@ -25,6 +25,7 @@
 
 #include "common/util.h"
 #include "common/stack.h"
+#include "common/system.h"
 #include "graphics/primitives.h"
 
 #include "sci/sci.h"
@@ -53,9 +54,21 @@ GfxFrameout::GfxFrameout(SegManager *segMan, ResourceManager *resMan, GfxCoordAd
 	_coordAdjuster = (GfxCoordAdjuster32 *)coordAdjuster;
 	scriptsRunningWidth = 320;
 	scriptsRunningHeight = 200;
+	_redrawAll = true;
+	resetStatistics();
 }
 
 GfxFrameout::~GfxFrameout() {
+	for (PlanePictureList::iterator it = _planePictures.begin(); it != _planePictures.end(); it++) {
+		delete it->picture;
+		delete[] it->pictureCels;
+	}
+	for (FrameoutList::iterator it = _screenItems.begin(); it != _screenItems.end(); it++)
+		delete *it;
+}
+
+void GfxFrameout::resetStatistics() {
+	memset(&_stats, 0, sizeof(_stats));
 }
 
 void GfxFrameout::kernelAddPlane(reg_t object) {
@@ -81,6 +94,10 @@ void GfxFrameout::kernelAddPlane(reg_t object) {
 	newPlane.priority = readSelectorValue(_segMan, object, SELECTOR(priority));
 	newPlane.lastPriority = 0xFFFF; // hidden
 	newPlane.planeOffsetX = 0;
+	newPlane.needsRedraw = true;
+	newPlane.hasText = false;
+	newPlane.firstItem = 0;
+	newPlane.itemCount = 0;
 	_planes.push_back(newPlane);
 
 	kernelUpdatePlane(object);
@@ -89,6 +106,11 @@ void GfxFrameout::kernelAddPlane(reg_t object) {
 void GfxFrameout::kernelUpdatePlane(reg_t object) {
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
 		if (it->object == object) {
+			// Whatever the plane covered before needs to be redrawn
+			if (it->lastPriority != 0xFFFF)
+				addDamage(it->planeRect);
+			it->needsRedraw = true;
+
 			// Read some information
 			it->priority = readSelectorValue(_segMan, object, SELECTOR(priority));
 			GuiResourceId lastPictureId = it->pictureId;
@@ -156,7 +178,11 @@ void GfxFrameout::kernelUpdatePlane(reg_t object) {
 }
 
 void GfxFrameout::kernelRepaintPlane(reg_t object) {
-	// TODO
+	// TODO: Check what this is supposed to do besides repainting the plane
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+		if (it->object == object)
+			it->needsRedraw = true;
+	}
 }
 
 void GfxFrameout::kernelDeletePlane(reg_t object) {
@@ -178,6 +204,7 @@ void GfxFrameout::kernelDeletePlane(reg_t object) {
 			planeRect.clip(screenRect); // we need to do this, at least in gk1 on cemetary we get bottom right -> 201, 321
 			// Blackout removed plane rect
 			_paint32->fillRect(planeRect, 0);
+			addDamage(planeRect);
 			return;
 		}
 	}
@@ -189,14 +216,35 @@ void GfxFrameout::addPlanePicture(reg_t object, GuiResourceId pictureId, uint16
 	newPicture.pictureId = pictureId;
 	newPicture.picture = new GfxPicture(_resMan, _coordAdjuster, 0, _screen, _palette, pictureId, false);
 	newPicture.startX = startX;
-	newPicture.pictureCels = 0;
+
+	// The cels are added to the item list of the plane during every frame
+	int16 celCount = newPicture.picture->getSci32celCount();
+	newPicture.pictureCels = new FrameoutEntry[celCount]();
+	for (int16 celNo = 0; celNo < celCount; celNo++) {
+		FrameoutEntry *picEntry = &newPicture.pictureCels[celNo];
+		picEntry->givenOrderNr = celNo;
+		picEntry->celNo = celNo;
+		picEntry->object = NULL_REG;
+		picEntry->picture = newPicture.picture;
+		picEntry->y = newPicture.picture->getSci32celY(celNo);
+		picEntry->x = newPicture.picture->getSci32celX(celNo);
+		picEntry->picStartX = startX;
+		picEntry->priority = newPicture.picture->getSci32celPriority(celNo);
+		picEntry->plane = object;
+	}
 	_planePictures.push_back(newPicture);
+
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+		if (it->object == object)
+			it->needsRedraw = true;
+	}
 }
 
 void GfxFrameout::deletePlanePictures(reg_t object) {
 	for (PlanePictureList::iterator it = _planePictures.begin(); it != _planePictures.end(); it++) {
 		if (it->object == object) {
 			delete it->picture;
+			delete[] it->pictureCels;
 			_planePictures.erase(it);
 			deletePlanePictures(object);
 			return;
@@ -224,32 +272,39 @@ void GfxFrameout::kernelUpdateScreenItem(reg_t object) {
 		return;
 
 	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
-		FrameoutEntry *itemEntry = *listIterator;
-
-		if (itemEntry->object == object) {
-			itemEntry->viewId = readSelectorValue(_segMan, object, SELECTOR(view));
-			itemEntry->loopNo = readSelectorValue(_segMan, object, SELECTOR(loop));
-			itemEntry->celNo = readSelectorValue(_segMan, object, SELECTOR(cel));
-			itemEntry->x = readSelectorValue(_segMan, object, SELECTOR(x));
-			itemEntry->y = readSelectorValue(_segMan, object, SELECTOR(y));
-			itemEntry->z = readSelectorValue(_segMan, object, SELECTOR(z));
-			itemEntry->priority = readSelectorValue(_segMan, object, SELECTOR(priority));
-			if (readSelectorValue(_segMan, object, SELECTOR(fixPriority)) == 0)
-				itemEntry->priority = itemEntry->y;
-
-			itemEntry->signal = readSelectorValue(_segMan, object, SELECTOR(signal));
-			itemEntry->scaleX = readSelectorValue(_segMan, object, SELECTOR(scaleX));
-			itemEntry->scaleY = readSelectorValue(_segMan, object, SELECTOR(scaleY));
+		if ((*listIterator)->object == object) {
+			updateScreenItem(*listIterator);
 			return;
 		}
 	}
 }
 
+void GfxFrameout::updateScreenItem(FrameoutEntry *itemEntry) {
+	reg_t object = itemEntry->object;
+
+	itemEntry->plane = readSelector(_segMan, object, SELECTOR(plane));
+	itemEntry->viewId = readSelectorValue(_segMan, object, SELECTOR(view));
+	itemEntry->loopNo = readSelectorValue(_segMan, object, SELECTOR(loop));
+	itemEntry->celNo = readSelectorValue(_segMan, object, SELECTOR(cel));
+	itemEntry->x = readSelectorValue(_segMan, object, SELECTOR(x));
+	itemEntry->y = readSelectorValue(_segMan, object, SELECTOR(y));
+	itemEntry->z = readSelectorValue(_segMan, object, SELECTOR(z));
+	itemEntry->priority = readSelectorValue(_segMan, object, SELECTOR(priority));
+	if (readSelectorValue(_segMan, object, SELECTOR(fixPriority)) == 0)
+		itemEntry->priority = itemEntry->y;
+
+	itemEntry->signal = readSelectorValue(_segMan, object, SELECTOR(signal));
+	itemEntry->scaleX = readSelectorValue(_segMan, object, SELECTOR(scaleX));
+	itemEntry->scaleY = readSelectorValue(_segMan, object, SELECTOR(scaleY));
+}
+
 void GfxFrameout::kernelDeleteScreenItem(reg_t object) {
 	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
 		FrameoutEntry *itemEntry = *listIterator;
 		if (itemEntry->object == object) {
+			addDamage(itemEntry->drawnState.screenRect);
 			_screenItems.remove(itemEntry);
+			delete itemEntry;
 			return;
 		}
 	}
@@ -338,266 +393,439 @@ static int16 GetLongest(const char *text, int16 maxWidth, GfxFont *font) {
 	return maxChars;
 }
 
-void GfxFrameout::kernelFrameout() {
-	if (g_sci->_gfxRobot->isPlaying())
-		return;
+// Returns whether a view screen item still looks the same on screen
+static bool sameItemState(const FrameoutItemState &state1, const FrameoutItemState &state2) {
+	return state1.plane == state2.plane && state1.viewId == state2.viewId &&
+		state1.loopNo == state2.loopNo && state1.celNo == state2.celNo &&
+		state1.priority == state2.priority && state1.scaleX == state2.scaleX &&
+		state1.scaleY == state2.scaleY && state1.celRect == state2.celRect &&
+		state1.screenRect == state2.screenRect;
+}
 
-	_palette->palVaryUpdate();
+void GfxFrameout::addDamage(const Common::Rect &rect) {
+	if (rect.isEmpty())
+		return;
 
-	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
-		reg_t planeObject = it->object;
-		uint16 planeLastPriority = it->lastPriority;
+	// Keep the list short, the rects only decide which parts get redrawn
+	for (uint i = 0; i < _damage.size(); i++) {
+		if (_damage[i].intersects(rect)) {
+			_damage[i].extend(rect);
+			return;
+		}
+	}
+	_damage.push_back(rect);
+}
 
-		// Update priority here, sq6 sets it w/o UpdatePlane
-		uint16 planePriority = it->priority = readSelectorValue(_segMan, planeObject, SELECTOR(priority));
+Common::Rect GfxFrameout::getPlaneDamage(const PlaneEntry &plane) const {
+	if (plane.needsRedraw || plane.hasText)
+		return plane.planeRect;
 
-		it->lastPriority = planePriority;
-		if (planePriority == 0xffff) { // Plane currently not meant to be shown
-			// If plane was shown before, delete plane rect
-			if (planePriority != planeLastPriority)
-				_paint32->fillRect(it->planeRect, 0);
+	Common::Rect planeDamage;
+	for (uint i = 0; i < _damage.size(); i++) {
+		if (!_damage[i].intersects(plane.planeRect))
 			continue;
+		Common::Rect rect = _damage[i];
+		rect.clip(plane.planeRect);
+		if (planeDamage.isEmpty())
+			planeDamage = rect;
+		else
+			planeDamage.extend(rect);
+	}
+	return planeDamage;
+}
+
+void GfxFrameout::placeScreenItems(PlaneEntry &plane) {
+	reg_t planeObject = plane.object;
+
+	plane.firstItem = _itemList.size();
+	plane.hasText = false;
+
+	// Copy screen items of the current frame to the list of items to be drawn
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		if ((*listIterator)->plane == planeObject)
+			_itemList.push_back(*listIterator);
+	}
+
+	for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
+		if (pictureIt->object == planeObject) {
+			int16 planePictureCels = pictureIt->picture->getSci32celCount();
+			for (int16 pictureCelNr = 0; pictureCelNr < planePictureCels; pictureCelNr++)
+				_itemList.push_back(&pictureIt->pictureCels[pictureCelNr]);
 		}
+	}
 
-		if (it->planeBack)
-			_paint32->fillRect(it->planeRect, it->planeBack);
+	plane.itemCount = _itemList.size() - plane.firstItem;
 
-		GuiResourceId planeMainPictureId = it->pictureId;
+	// Now sort our itemlist
+	Common::sort(_itemList.begin() + plane.firstItem, _itemList.end(), sortHelper);
 
-		_coordAdjuster->pictureSetDisplayArea(it->planeRect);
-		_palette->drewPicture(planeMainPictureId);
+	for (uint itemNr = plane.firstItem; itemNr < _itemList.size(); itemNr++) {
+		FrameoutEntry *itemEntry = _itemList[itemNr];
 
-		FrameoutList itemList;
+		// Picture cels only change together with the plane
+		if (itemEntry->object.isNull())
+			continue;
 
-		// Copy screen items of the current frame to the list of items to be drawn
-		for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
-			reg_t itemPlane = readSelector(_segMan, (*listIterator)->object, SELECTOR(plane));
-			if (planeObject == itemPlane) {
-				kernelUpdateScreenItem((*listIterator)->object);	// TODO: Why is this necessary?
-				itemList.push_back(*listIterator);
-			}
+		itemEntry->visible = true;
+
+		if (itemEntry->viewId == 0xFFFF) {
+			plane.hasText = true;
+			continue;
 		}
 
-		for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
-			if (pictureIt->object == planeObject) {
-				GfxPicture *planePicture = pictureIt->picture;
-				// Allocate memory for picture cels
-				pictureIt->pictureCels = new FrameoutEntry[planePicture->getSci32celCount()];
-
-				// Add following cels to the itemlist
-				FrameoutEntry *picEntry = pictureIt->pictureCels;
-				int planePictureCels = planePicture->getSci32celCount();
-				for (int pictureCelNr = 0; pictureCelNr < planePictureCels; pictureCelNr++) {
-					picEntry->celNo = pictureCelNr;
-					picEntry->object = NULL_REG;
-					picEntry->picture = planePicture;
-					picEntry->y = planePicture->getSci32celY(pictureCelNr);
-					picEntry->x = planePicture->getSci32celX(pictureCelNr);
-					picEntry->picStartX = pictureIt->startX;
-
-					picEntry->priority = planePicture->getSci32celPriority(pictureCelNr);
-
-					itemList.push_back(picEntry);
-					picEntry++;
-				}
+		GfxView *view = _cache->getView(itemEntry->viewId);
+		int16 x = itemEntry->x;
+		int16 y = itemEntry->y;
+		int16 z = itemEntry->z;
+
+		switch (getSciVersion()) {
+		case SCI_VERSION_2:
+			if (view->isSci2Hires()) {
+				int16 dummyX = 0;
+				_screen->adjustToUpscaledCoordinates(y, x);
+				_screen->adjustToUpscaledCoordinates(z, dummyX);
 			}
+			break;
+		case SCI_VERSION_2_1:
+			y = (y * _screen->getHeight()) / scriptsRunningHeight;
+			x = (x * _screen->getWidth()) / scriptsRunningWidth;
+			z = (z * _screen->getHeight()) / scriptsRunningHeight;
+			break;
+		default:
+			break;
 		}
-
-		// Now sort our itemlist
-		Common::sort(itemList.begin(), itemList.end(), sortHelper);
-
-//		warning("Plane %s", _segMan->getObjectName(planeObject));
-
-		for (FrameoutList::iterator listIterator = itemList.begin(); listIterator != itemList.end(); listIterator++) {
-			FrameoutEntry *itemEntry = *listIterator;
-
-			if (itemEntry->object.isNull()) {
-				// Picture cel data
-				itemEntry->y = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
-				itemEntry->x = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
-				itemEntry->picStartX = ((itemEntry->picStartX * _screen->getWidth()) / scriptsRunningWidth);
-
-				// Out of view
-				int16 pictureCelStartX = itemEntry->picStartX + itemEntry->x;
-				int16 pictureCelEndX = pictureCelStartX + itemEntry->picture->getSci32celWidth(itemEntry->celNo);
-				int16 planeStartX = it->planeOffsetX;
-				int16 planeEndX = planeStartX + it->planeRect.width();
-				if (pictureCelEndX < planeStartX)
-					continue;
-				if (pictureCelStartX > planeEndX)
-					continue;
-
-				int16 pictureOffsetX = it->planeOffsetX;
-				int16 pictureX = itemEntry->x;
-				if ((it->planeOffsetX) || (itemEntry->picStartX)) {
-					if (it->planeOffsetX <= itemEntry->picStartX) {
-						pictureX += itemEntry->picStartX - it->planeOffsetX;
-						pictureOffsetX = 0;
-					} else {
-						pictureOffsetX = it->planeOffsetX - itemEntry->picStartX;
-					}
+		// Adjust according to current scroll position
+		x -= plane.planeOffsetX;
+
+		uint16 useInsetRect = readSelectorValue(_segMan, itemEntry->object, SELECTOR(useInsetRect));
+		if (useInsetRect) {
+			itemEntry->celRect.top = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inTop));
+			itemEntry->celRect.left = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inLeft));
+			itemEntry->celRect.bottom = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inBottom)) + 1;
+			itemEntry->celRect.right = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inRight)) + 1;
+			if (view->isSci2Hires()) {
+				_screen->adjustToUpscaledCoordinates(itemEntry->celRect.top, itemEntry->celRect.left);
+				_screen->adjustToUpscaledCoordinates(itemEntry->celRect.bottom, itemEntry->celRect.right);
+			}
+			itemEntry->celRect.translate(x, y);
+			// TODO: maybe we should clip the cels rect with this, i'm not sure
+			//  the only currently known usage is game menu of gk1
+		} else {
+			if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
+				view->getCelRect(itemEntry->loopNo, itemEntry->celNo, x, y, z, itemEntry->celRect);
+			else
+				view->getCelScaledRect(itemEntry->loopNo, itemEntry->celNo, x, y, z, itemEntry->scaleX, itemEntry->scaleY, itemEntry->celRect);
+
+			Common::Rect nsRect = itemEntry->celRect;
+			// Translate back to actual coordinate within scrollable plane
+			nsRect.translate(plane.planeOffsetX, 0);
+			switch (getSciVersion()) {
+			case SCI_VERSION_2:
+				if (view->isSci2Hires()) {
+					_screen->adjustBackUpscaledCoordinates(nsRect.top, nsRect.left);
+					_screen->adjustBackUpscaledCoordinates(nsRect.bottom, nsRect.right);
 				}
+				break;
+			case SCI_VERSION_2_1:
+				nsRect.top = (nsRect.top * scriptsRunningHeight) / _screen->getHeight();
+				nsRect.left = (nsRect.left * scriptsRunningWidth) / _screen->getWidth();
+				nsRect.bottom = (nsRect.bottom * scriptsRunningHeight) / _screen->getHeight();
+				nsRect.right = (nsRect.right * scriptsRunningWidth) / _screen->getWidth();
+				break;
+			default:
+				break;
+			}
+			writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsLeft), nsRect.left);
+			writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsTop), nsRect.top);
+			writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsRight), nsRect.right);
+			writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsBottom), nsRect.bottom);
+		}
 
-				itemEntry->picture->drawSci32Vga(itemEntry->celNo, pictureX, itemEntry->y, pictureOffsetX, it->planePictureMirrored);
-//				warning("picture cel %d %d", itemEntry->celNo, itemEntry->priority);
-
-			} else if (itemEntry->viewId != 0xFFFF) {
-				GfxView *view = _cache->getView(itemEntry->viewId);
-
-//				warning("view %s %04x:%04x", _segMan->getObjectName(itemEntry->object), PRINT_REG(itemEntry->object));
-
-				switch (getSciVersion()) {
-				case SCI_VERSION_2:
-					if (view->isSci2Hires()) {
-						int16 dummyX = 0;
-						_screen->adjustToUpscaledCoordinates(itemEntry->y, itemEntry->x);
-						_screen->adjustToUpscaledCoordinates(itemEntry->z, dummyX);
-					}
-					break;
-				case SCI_VERSION_2_1:
-					itemEntry->y = (itemEntry->y * _screen->getHeight()) / scriptsRunningHeight;
-					itemEntry->x = (itemEntry->x * _screen->getWidth()) / scriptsRunningWidth;
-					itemEntry->z = (itemEntry->z * _screen->getHeight()) / scriptsRunningHeight;
-					break;
-				default:
-					break;
-				}
-				// Adjust according to current scroll position
-				itemEntry->x -= it->planeOffsetX;
-
-				uint16 useInsetRect = readSelectorValue(_segMan, itemEntry->object, SELECTOR(useInsetRect));
-				if (useInsetRect) {
-					itemEntry->celRect.top = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inTop));
-					itemEntry->celRect.left = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inLeft));
-					itemEntry->celRect.bottom = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inBottom)) + 1;
-					itemEntry->celRect.right = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inRight)) + 1;
-					if (view->isSci2Hires()) {
-						_screen->adjustToUpscaledCoordinates(itemEntry->celRect.top, itemEntry->celRect.left);
-						_screen->adjustToUpscaledCoordinates(itemEntry->celRect.bottom, itemEntry->celRect.right);
-					}
-					itemEntry->celRect.translate(itemEntry->x, itemEntry->y);
-					// TODO: maybe we should clip the cels rect with this, i'm not sure
-					//  the only currently known usage is game menu of gk1
-				} else {
-					if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
-						view->getCelRect(itemEntry->loopNo, itemEntry->celNo, itemEntry->x, itemEntry->y, itemEntry->z, itemEntry->celRect);
-					else
-						view->getCelScaledRect(itemEntry->loopNo, itemEntry->celNo, itemEntry->x, itemEntry->y, itemEntry->z, itemEntry->scaleX, itemEntry->scaleY, itemEntry->celRect);
-
-					Common::Rect nsRect = itemEntry->celRect;
-					// Translate back to actual coordinate within scrollable plane
-					nsRect.translate(it->planeOffsetX, 0);
-					switch (getSciVersion()) {
-					case SCI_VERSION_2:
-						if (view->isSci2Hires()) {
-							_screen->adjustBackUpscaledCoordinates(nsRect.top, nsRect.left);
-							_screen->adjustBackUpscaledCoordinates(nsRect.bottom, nsRect.right);
-						}
-						break;
-					case SCI_VERSION_2_1:
-						nsRect.top = (nsRect.top * scriptsRunningHeight) / _screen->getHeight();
-						nsRect.left = (nsRect.left * scriptsRunningWidth) / _screen->getWidth();
-						nsRect.bottom = (nsRect.bottom * scriptsRunningHeight) / _screen->getHeight();
-						nsRect.right = (nsRect.right * scriptsRunningWidth) / _screen->getWidth();
-						break;
-					default:
-						break;
-					}
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsLeft), nsRect.left);
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsTop), nsRect.top);
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsRight), nsRect.right);
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsBottom), nsRect.bottom);
-				}
+		int16 screenHeight = _screen->getHeight();
+		int16 screenWidth = _screen->getWidth();
+		if (view->isSci2Hires()) {
+			screenHeight = _screen->getDisplayHeight();
+			screenWidth = _screen->getDisplayWidth();
+		}
 
-				int16 screenHeight = _screen->getHeight();
-				int16 screenWidth = _screen->getWidth();
-				if (view->isSci2Hires()) {
-					screenHeight = _screen->getDisplayHeight();
-					screenWidth = _screen->getDisplayWidth();
-				}
+		itemEntry->clipRect = Common::Rect();
+		itemEntry->translatedClipRect = Common::Rect();
+		if (itemEntry->celRect.bottom >= 0 && itemEntry->celRect.top < screenHeight &&
+			itemEntry->celRect.right >= 0 && itemEntry->celRect.left < screenWidth) {
+			itemEntry->clipRect = itemEntry->celRect;
+			if (view->isSci2Hires()) {
+				itemEntry->clipRect.clip(plane.upscaledPlaneClipRect);
+				itemEntry->translatedClipRect = itemEntry->clipRect;
+				itemEntry->translatedClipRect.translate(plane.upscaledPlaneRect.left, plane.upscaledPlaneRect.top);
+			} else {
+				itemEntry->clipRect.clip(plane.planeClipRect);
+				itemEntry->translatedClipRect = itemEntry->clipRect;
+				itemEntry->translatedClipRect.translate(plane.planeRect.left, plane.planeRect.top);
+			}
+		}
 
-				if (itemEntry->celRect.bottom < 0 || itemEntry->celRect.top >= screenHeight)
-					continue;
+		FrameoutItemState state;
+		state.plane = planeObject;
+		state.viewId = itemEntry->viewId;
+		state.loopNo = itemEntry->loopNo;
+		state.celNo = itemEntry->celNo;
+		state.priority = itemEntry->priority;
+		state.scaleX = itemEntry->scaleX;
+		state.scaleY = itemEntry->scaleY;
+		state.celRect = itemEntry->celRect;
+		state.screenRect = itemEntry->clipRect.isEmpty() ? Common::Rect() : itemEntry->translatedClipRect;
+		if (view->isSci2Hires() && _screen->getUpscaledHires() && !state.screenRect.isEmpty()) {
+			// Damage is tracked in screen coordinates, round outwards
+			_screen->adjustBackUpscaledCoordinates(state.screenRect.top, state.screenRect.left);
+			_screen->adjustBackUpscaledCoordinates(state.screenRect.bottom, state.screenRect.right);
+			state.screenRect.bottom++;
+			state.screenRect.right++;
+		}
 
-				if (itemEntry->celRect.right < 0 || itemEntry->celRect.left >= screenWidth)
-					continue;
+		// Both where the item was and where it is now need to be redrawn
+		if (!sameItemState(state, itemEntry->drawnState)) {
+			addDamage(itemEntry->drawnState.screenRect);
+			addDamage(state.screenRect);
+			itemEntry->drawnState = state;
+		}
+	}
+}
 
-				Common::Rect clipRect, translatedClipRect;
-				clipRect = itemEntry->celRect;
-				if (view->isSci2Hires()) {
-					clipRect.clip(it->upscaledPlaneClipRect);
-					translatedClipRect = clipRect;
-					translatedClipRect.translate(it->upscaledPlaneRect.left, it->upscaledPlaneRect.top);
+void GfxFrameout::drawPlane(PlaneEntry &plane, const Common::Rect &damage) {
+	// Nothing gets drawn for an empty damage rect, but pictures and views still
+	//  set up their palettes like they did when they got drawn
+	if (!damage.isEmpty() && plane.planeBack)
+		_paint32->fillRect(damage, plane.planeBack);
+
+	// The damage rect in plane coordinates, for clipping the views
+	Common::Rect planeDamage = damage;
+	Common::Rect upscaledPlaneDamage = damage;
+	if (_screen->getUpscaledHires() && !damage.isEmpty()) {
+		_screen->adjustToUpscaledCoordinates(upscaledPlaneDamage.top, upscaledPlaneDamage.left);
+		_screen->adjustToUpscaledCoordinates(upscaledPlaneDamage.bottom, upscaledPlaneDamage.right);
+	}
+	planeDamage.translate(-plane.planeRect.left, -plane.planeRect.top);
+	upscaledPlaneDamage.translate(-plane.upscaledPlaneRect.left, -plane.upscaledPlaneRect.top);
+
+	for (uint itemNr = plane.firstItem; itemNr < plane.firstItem + plane.itemCount; itemNr++) {
+		FrameoutEntry *itemEntry = _itemList[itemNr];
+
+		if (itemEntry->object.isNull()) {
+			// Picture cel data
+			int16 pictureCelY = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
+			int16 pictureCelX = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
+			int16 picStartX = ((itemEntry->picStartX * _screen->getWidth()) / scriptsRunningWidth);
+
+			// Out of view
+			int16 pictureCelStartX = picStartX + pictureCelX;
+			int16 pictureCelEndX = pictureCelStartX + itemEntry->picture->getSci32celWidth(itemEntry->celNo);
+			int16 planeStartX = plane.planeOffsetX;
+			int16 planeEndX = planeStartX + plane.planeRect.width();
+			if (pictureCelEndX < planeStartX)
+				continue;
+			if (pictureCelStartX > planeEndX)
+				continue;
+
+			int16 pictureOffsetX = plane.planeOffsetX;
+			int16 pictureX = pictureCelX;
+			if ((plane.planeOffsetX) || (picStartX)) {
+				if (plane.planeOffsetX <= picStartX) {
+					pictureX += picStartX - plane.planeOffsetX;
+					pictureOffsetX = 0;
 				} else {
-					clipRect.clip(it->planeClipRect);
-					translatedClipRect = clipRect;
-					translatedClipRect.translate(it->planeRect.left, it->planeRect.top);
+					pictureOffsetX = plane.planeOffsetX - picStartX;
 				}
+			}
 
-				if (!clipRect.isEmpty()) {
-					if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
-						view->draw(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, 0, view->isSci2Hires());
-					else
-						view->drawScaled(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, itemEntry->scaleX, itemEntry->scaleY);
-				}
-			} else {
-				// Most likely a text entry
-				// This draws text the "SCI0-SCI11" way. In SCI2, text is prerendered in kCreateTextBitmap
-				// TODO: rewrite this the "SCI2" way (i.e. implement the text buffer to draw inside kCreateTextBitmap)
-				if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) == kSelectorVariable) {
-					reg_t stringObject = readSelector(_segMan, itemEntry->object, SELECTOR(text));
-
-					// The object in the text selector of the item can be either a raw string
-					// or a Str object. In the latter case, we need to access the object's data
-					// selector to get the raw string.
-					if (_segMan->isHeapObject(stringObject))
-						stringObject = readSelector(_segMan, stringObject, SELECTOR(data));
-
-					Common::String text = _segMan->getString(stringObject);
-					GfxFont *font = _cache->getFont(readSelectorValue(_segMan, itemEntry->object, SELECTOR(font)));
-					bool dimmed = readSelectorValue(_segMan, itemEntry->object, SELECTOR(dimmed));
-					uint16 foreColor = readSelectorValue(_segMan, itemEntry->object, SELECTOR(fore));
-
-					itemEntry->y = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
-					itemEntry->x = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
-
-					uint16 curX = itemEntry->x + it->planeRect.left;
-					uint16 curY = itemEntry->y + it->planeRect.top;
-					const char *txt = text.c_str();
-					uint16 w = it->planeRect.width() >= 20 ? it->planeRect.width() : _screen->getWidth() - 10;
-					int16 charCount;
-
-					while (*txt) {
-						charCount = GetLongest(txt, w, font);
-						if (charCount == 0)
-							break;
-
-						for (int i = 0; i < charCount; i++) {
-							unsigned char curChar = txt[i];
-							font->draw(curChar, curY, curX, foreColor, dimmed);
-							curX += font->getCharWidth(curChar);
-						}
-
-						curX = itemEntry->x + it->planeRect.left;
-						curY += font->getHeight();
-						txt += charCount;
-						while (*txt == ' ')
-							txt++; // skip over breaking spaces
-					}
+			itemEntry->picture->drawSci32Vga(itemEntry->celNo, pictureX, pictureCelY, pictureOffsetX, plane.planePictureMirrored, damage);
+//			warning("picture cel %d %d", itemEntry->celNo, itemEntry->priority);
 
-				}
+		} else if (itemEntry->viewId != 0xFFFF) {
+			if (itemEntry->clipRect.isEmpty())
+				continue;
+
+			GfxView *view = _cache->getView(itemEntry->viewId);
+
+//			warning("view %s %04x:%04x", _segMan->getObjectName(itemEntry->object), PRINT_REG(itemEntry->object));
+
+			const Common::Rect &damageClipRect = view->isSci2Hires() ? upscaledPlaneDamage : planeDamage;
+			if (!itemEntry->clipRect.intersects(damageClipRect)) {
+				// Merge the view palette in, like drawing would do
+				if (view->getPalette())
+					_palette->set(view->getPalette(), false);
+				continue;
 			}
+
+			Common::Rect clipRect = itemEntry->clipRect;
+			clipRect.clip(damageClipRect);
+			Common::Rect translatedClipRect = clipRect;
+			if (view->isSci2Hires())
+				translatedClipRect.translate(plane.upscaledPlaneRect.left, plane.upscaledPlaneRect.top);
+			else
+				translatedClipRect.translate(plane.planeRect.left, plane.planeRect.top);
+
+			if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
+				view->draw(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, 0, view->isSci2Hires());
+			else
+				view->drawScaled(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, itemEntry->scaleX, itemEntry->scaleY);
+		} else if (!damage.isEmpty()) {
+			drawTextItem(plane, itemEntry);
+		}
+	}
+}
+
+void GfxFrameout::drawTextItem(const PlaneEntry &plane, FrameoutEntry *itemEntry) {
+	// Most likely a text entry
+	// This draws text the "SCI0-SCI11" way. In SCI2, text is prerendered in kCreateTextBitmap
+	// TODO: rewrite this the "SCI2" way (i.e. implement the text buffer to draw inside kCreateTextBitmap)
+	if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) != kSelectorVariable)
+		return;
+
+	reg_t stringObject = readSelector(_segMan, itemEntry->object, SELECTOR(text));
+
+	// The object in the text selector of the item can be either a raw string
+	// or a Str object. In the latter case, we need to access the object's data
+	// selector to get the raw string.
+	if (_segMan->isHeapObject(stringObject))
+		stringObject = readSelector(_segMan, stringObject, SELECTOR(data));
+
+	Common::String text = _segMan->getString(stringObject);
+	GfxFont *font = _cache->getFont(readSelectorValue(_segMan, itemEntry->object, SELECTOR(font)));
+	bool dimmed = readSelectorValue(_segMan, itemEntry->object, SELECTOR(dimmed));
+	uint16 foreColor = readSelectorValue(_segMan, itemEntry->object, SELECTOR(fore));
+
+	int16 textY = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
+	int16 textX = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
+
+	uint16 curX = textX + plane.planeRect.left;
+	uint16 curY = textY + plane.planeRect.top;
+	const char *txt = text.c_str();
+	uint16 w = plane.planeRect.width() >= 20 ? plane.planeRect.width() : _screen->getWidth() - 10;
+	int16 charCount;
+
+	while (*txt) {
+		charCount = GetLongest(txt, w, font);
+		if (charCount == 0)
+			break;
+
+		for (int i = 0; i < charCount; i++) {
+			unsigned char curChar = txt[i];
+			font->draw(curChar, curY, curX, foreColor, dimmed);
+			curX += font->getCharWidth(curChar);
 		}
 
-		for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
-			if (pictureIt->object == planeObject) {
-				delete[] pictureIt->pictureCels;
-				pictureIt->pictureCels = 0;
+		curX = textX + plane.planeRect.left;
+		curY += font->getHeight();
+		txt += charCount;
+		while (*txt == ' ')
+			txt++; // skip over breaking spaces
+	}
+}
+
+void GfxFrameout::kernelFrameout() {
+	if (g_sci->_gfxRobot->isPlaying()) {
+		// The robot draws over the planes, so redraw everything afterwards
+		_redrawAll = true;
+		return;
+	}
+
+	uint32 frameStartTime = g_system->getMillis();
+	Common::Rect screenRect(_screen->getWidth(), _screen->getHeight());
+
+	_palette->palVaryUpdate();
+
+	_itemList.resize(0);
+	if (_redrawAll)
+		addDamage(screenRect);
+
+	// Scripts change the selectors of screen items without calling
+	//  kUpdateScreenItem, so the items get refreshed here
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		FrameoutEntry *itemEntry = *listIterator;
+		itemEntry->visible = false;
+		if (_segMan->isObject(itemEntry->object))
+			updateScreenItem(itemEntry);
+		else
+			itemEntry->plane = NULL_REG;
+	}
+
+	// Find out which parts of the screen changed, before anything gets drawn.
+	//  Planes below a changed item need to be redrawn as well
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+		reg_t planeObject = it->object;
+		uint16 planeLastPriority = it->lastPriority;
+
+		// Update priority here, sq6 sets it w/o UpdatePlane
+		uint16 planePriority = it->priority = readSelectorValue(_segMan, planeObject, SELECTOR(priority));
+
+		it->lastPriority = planePriority;
+		it->itemCount = 0;
+		if (planePriority == 0xffff) { // Plane currently not meant to be shown
+			// If plane was shown before, delete plane rect
+			if (planePriority != planeLastPriority) {
+				_paint32->fillRect(it->planeRect, 0);
+				addDamage(it->planeRect);
 			}
+			continue;
 		}
+
+		if (planePriority != planeLastPriority)
+			it->needsRedraw = true;
+
+		placeScreenItems(*it);
+
+		if (it->needsRedraw)
+			addDamage(it->planeRect);
 	}
 
-	_screen->copyToScreen();
+	// Items which aren't shown anymore leave damage behind
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		FrameoutEntry *itemEntry = *listIterator;
+		if (!itemEntry->visible && !itemEntry->drawnState.screenRect.isEmpty()) {
+			addDamage(itemEntry->drawnState.screenRect);
+			itemEntry->drawnState.screenRect = Common::Rect();
+		}
+	}
+
+	uint planesDrawn = 0;
+
+	// Redraw the damaged parts of the planes, from bottom to top. Whatever got
+	//  redrawn damages the planes above it
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+		if (it->priority == 0xffff)
+			continue;
+
+		_coordAdjuster->pictureSetDisplayArea(it->planeRect);
+		_palette->drewPicture(it->pictureId);
+
+		Common::Rect planeDamage = getPlaneDamage(*it);
+		drawPlane(*it, planeDamage);
+		it->needsRedraw = false;
+
+		if (!planeDamage.isEmpty()) {
+			planesDrawn++;
+			// Text isn't clipped to its plane
+			addDamage(it->hasText ? screenRect : planeDamage);
+		}
+	}
+
+	for (uint i = 0; i < _damage.size(); i++) {
+		Common::Rect rect = _damage[i];
+		rect.clip(screenRect);
+		if (!rect.isEmpty())
+			_screen->copyRectToScreen(rect);
+	}
+	_damage.resize(0);
+	_redrawAll = false;
+
+	uint32 frameTime = g_system->getMillis() - frameStartTime;
+	_stats.frames++;
+	_stats.planesDrawn += planesDrawn;
+	if (!planesDrawn)
+		_stats.idleFrames++;
+	_stats.lastTime = frameTime;
+	_stats.maxTime = MAX(_stats.maxTime, frameTime);
+	_stats.totalTime += frameTime;
 
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
@@ -28,6 +28,8 @@
 
 namespace Sci {
 
+class GfxPicture;
+
 struct PlaneEntry {
 	reg_t object;
 	uint16 priority;
@@ -40,10 +42,30 @@ struct PlaneEntry {
 	Common::Rect upscaledPlaneClipRect;
 	bool planePictureMirrored;
 	byte planeBack;
+	bool needsRedraw;	///< Set when the plane itself changed since the last frame
+	bool hasText;	///< Text items can't be tracked, they get redrawn every frame
+	uint firstItem;	///< Index of the first item of this plane in GfxFrameout::_itemList
+	uint itemCount;	///< Number of items of this plane in GfxFrameout::_itemList
 };
 
 typedef Common::List<PlaneEntry> PlaneList;
 
+/**
+ * Everything that decides what a view screen item looks like on screen. This
+ *  is compared between frames to find the items which changed.
+ */
+struct FrameoutItemState {
+	reg_t plane;
+	GuiResourceId viewId;
+	int16 loopNo;
+	int16 celNo;
+	int16 priority;
+	int16 scaleX;
+	int16 scaleY;
+	Common::Rect celRect;
+	Common::Rect screenRect;	///< Area covered on the screen, in screen coordinates
+};
+
 struct FrameoutEntry {
 	uint16 givenOrderNr;
 	reg_t object;
@@ -59,6 +81,11 @@ struct FrameoutEntry {
 	Common::Rect celRect;
 	GfxPicture *picture;
 	int16 picStartX;
+	reg_t plane;
+	Common::Rect clipRect;
+	Common::Rect translatedClipRect;
+	bool visible;	///< Set, if the item got placed on a shown plane during the current frame
+	FrameoutItemState drawnState;	///< How the item looked the last time it got drawn
 };
 
 typedef Common::List<FrameoutEntry *> FrameoutList;
@@ -68,11 +95,20 @@ struct PlanePictureEntry {
 	int16 startX;
 	GuiResourceId pictureId;
 	GfxPicture *picture;
-	FrameoutEntry *pictureCels; // temporary
+	FrameoutEntry *pictureCels;
 };
 
 typedef Common::List<PlanePictureEntry> PlanePictureList;
 
+struct FrameoutStatistics {
+	uint32 frames;	///< Number of kFrameout calls
+	uint32 idleFrames;	///< Frames which didn't need to draw anything
+	uint32 planesDrawn;	///< Number of planes (partially) redrawn
+	uint32 lastTime;	///< Time taken by the last frame
+	uint32 maxTime;	///< Longest time taken by a frame
+	uint32 totalTime;	///< Total time spent in kFrameout
+};
+
 class GfxCache;
 class GfxCoordAdjuster32;
 class GfxPaint32;
@@ -100,6 +136,12 @@ public:
 	void addPlanePicture(reg_t object, GuiResourceId pictureId, uint16 startX);
 	void deletePlanePictures(reg_t object);
 
+	/** Makes the next frame redraw all planes, e.g. after a video got played */
+	void invalidate() { _redrawAll = true; }
+
+	const FrameoutStatistics &getStatistics() const { return _stats; }
+	void resetStatistics();
+
 private:
 	SegManager *_segMan;
 	ResourceManager *_resMan;
@@ -115,6 +157,22 @@ private:
 
 	void sortPlanes();
 
+	void updateScreenItem(FrameoutEntry *itemEntry);
+
+	void addDamage(const Common::Rect &rect);
+	Common::Rect getPlaneDamage(const PlaneEntry &plane) const;
+	void placeScreenItems(PlaneEntry &plane);
+	void drawPlane(PlaneEntry &plane, const Common::Rect &damage);
+	void drawTextItem(const PlaneEntry &plane, FrameoutEntry *itemEntry);
+
+	/** Screen items and picture cels of all shown planes, kept between frames */
+	Common::Array<FrameoutEntry *> _itemList;
+	/** Parts of the screen which need to be redrawn in the current frame */
+	Common::Array<Common::Rect> _damage;
+	bool _redrawAll;
+
+	FrameoutStatistics _stats;
+
 	uint16 scriptsRunningWidth;
 	uint16 scriptsRunningHeight;
 };
@@ -51,9 +51,13 @@ namespace Sci {
 
 GfxPaint16::GfxPaint16(ResourceManager *resMan, SegManager *segMan, Kernel *kernel, GfxCache *cache, GfxPorts *ports, GfxCoordAdjuster *coordAdjuster, GfxScreen *screen, GfxPalette *palette, GfxTransitions *transitions, AudioPlayer *audio)
 	: _resMan(resMan), _segMan(segMan), _kernel(kernel), _cache(cache), _ports(ports), _coordAdjuster(coordAdjuster), _screen(screen), _palette(palette), _transitions(transitions), _audio(audio) {
+	_pictureCacheDataSize = _screen->bitsGetDataSize(Common::Rect(_screen->getWidth(), _screen->getHeight()), GFX_SCREEN_MASK_ALL);
+	_pictureCacheScratch = new byte[_pictureCacheDataSize];
 }
 
 GfxPaint16::~GfxPaint16() {
+	purgePictureCache();
+	delete[] _pictureCacheScratch;
 }
 
 void GfxPaint16::init(GfxAnimate *animate, GfxText16 *text16) {
@@ -67,6 +71,34 @@ void GfxPaint16::debugSetEGAdrawingVisualize(bool state) {
 	_EGAdrawingVisualize = state;
 }
 
+void GfxPaint16::purgePictureCache() {
+	for (PictureCache::iterator it = _cachedPictures.begin(); it != _cachedPictures.end(); ++it) {
+		delete[] (*it)->screenBefore;
+		delete[] (*it)->screenAfter;
+		delete *it;
+	}
+	_cachedPictures.clear();
+}
+
+PictureCacheEntry *GfxPaint16::findCachedPicture(GuiResourceId pictureId, bool mirroredFlag, int16 EGApaletteNo, const byte *screenBefore) {
+	Port *curPort = _ports->getPort();
+
+	for (PictureCache::iterator it = _cachedPictures.begin(); it != _cachedPictures.end(); ++it) {
+		PictureCacheEntry *entry = *it;
+		if (entry->pictureId != pictureId || entry->mirroredFlag != mirroredFlag || entry->EGApaletteNo != EGApaletteNo)
+			continue;
+		if (entry->portRect != curPort->rect || entry->portTop != curPort->top || entry->portLeft != curPort->left)
+			continue;
+		if (memcmp(entry->screenBefore, screenBefore, _pictureCacheDataSize))
+			continue;
+		// Move the entry to the front, so that the least recently used one gets dropped
+		_cachedPictures.erase(it);
+		_cachedPictures.push_front(entry);
+		return entry;
+	}
+	return NULL;
+}
+
 void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, bool addToFlag, GuiResourceId paletteId) {
 	GfxPicture *picture = new GfxPicture(_resMan, _coordAdjuster, _ports, _screen, _palette, pictureId, _EGAdrawingVisualize);
 
@@ -74,7 +106,44 @@ void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mi
 	if (!addToFlag)
 		clearScreen(_screen->getColorWhite());
 
-	picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	// Pictures drawn onto a cleared port are cached. Drawing only depends on
+	//  the screen contents, so the cached result is used, when the screen
+	//  looks the same as when the picture got drawn. Undithering is left out,
+	//  because it also remembers the dither combinations of the picture.
+	if (addToFlag || _EGAdrawingVisualize || _screen->getUnditherState()) {
+		picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	} else {
+		Common::Rect screenRect(_screen->getWidth(), _screen->getHeight());
+		_screen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, _pictureCacheScratch);
+
+		PictureCacheEntry *entry = findCachedPicture(pictureId, mirroredFlag, paletteId, _pictureCacheScratch);
+		if (entry) {
+			debugC(2, kDebugLevelGraphics, "drawPicture: using cached picture %d", pictureId);
+			picture->draw(animationNr, mirroredFlag, addToFlag, paletteId, true);
+			_screen->bitsRestore(entry->screenAfter);
+		} else {
+			picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+
+			if (_cachedPictures.size() >= MAX_CACHED_PICTURES) {
+				entry = _cachedPictures.back();
+				_cachedPictures.pop_back();
+			} else {
+				entry = new PictureCacheEntry();
+				entry->screenBefore = new byte[_pictureCacheDataSize];
+				entry->screenAfter = new byte[_pictureCacheDataSize];
+			}
+			Port *curPort = _ports->getPort();
+			entry->pictureId = pictureId;
+			entry->mirroredFlag = mirroredFlag;
+			entry->EGApaletteNo = paletteId;
+			entry->portRect = curPort->rect;
+			entry->portTop = curPort->top;
+			entry->portLeft = curPort->left;
+			memcpy(entry->screenBefore, _pictureCacheScratch, _pictureCacheDataSize);
+			_screen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, entry->screenAfter);
+			_cachedPictures.push_front(entry);
+		}
+	}
 	delete picture;
 
 	// We make a call to SciPalette here, for increasing sys timestamp and also loading targetpalette, if palvary active
@@ -29,6 +29,7 @@
 #include "sci/graphics/paint.h"
 
 #include "common/hashmap.h"
+#include "common/list.h"
 
 namespace Sci {
 
@@ -39,6 +40,23 @@ class Font;
 class SciGuiPicture;
 class GfxView;
 
+/**
+ * A picture as it got drawn onto a cleared port. The screen contents before
+ *  drawing are kept as well, the cached pixels are only valid when the screen
+ *  looks exactly like that again.
+ */
+struct PictureCacheEntry {
+	GuiResourceId pictureId;
+	bool mirroredFlag;
+	int16 EGApaletteNo;
+	Common::Rect portRect;
+	int16 portTop, portLeft;
+	byte *screenBefore;
+	byte *screenAfter;
+};
+
+typedef Common::List<PictureCacheEntry *> PictureCache;
+
 /**
  * Paint16 class, handles painting/drawing for SCI16 (SCI0-SCI1.1) games
  */
@@ -106,8 +124,15 @@ private:
 	GfxText16 *_text16;
 	GfxTransitions *_transitions;
 
+	PictureCacheEntry *findCachedPicture(GuiResourceId pictureId, bool mirroredFlag, int16 EGApaletteNo, const byte *screenBefore);
+	void purgePictureCache();
+
 	// true means make EGA picture drawing visible
 	bool _EGAdrawingVisualize;
+
+	PictureCache _cachedPictures;
+	int _pictureCacheDataSize;
+	byte *_pictureCacheScratch;
 };
 
 } // End of namespace Sci
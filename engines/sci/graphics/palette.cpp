@@ -38,8 +38,150 @@
 
 namespace Sci {
 
+ColorMatcher::ColorMatcher() : _enabled(true), _lookups(0), _cellRebuilds(0) {
+	memset(_colors, 0, sizeof(_colors));
+	memset(_cellValid, 0, sizeof(_cellValid));
+	memset(_cellBound, 0, sizeof(_cellBound));
+}
+
+// Squared distance of a color to the nearest point of a cell
+static int cellMinDistance(const Color &color, uint cellNr) {
+	const byte component[3] = { color.r, color.g, color.b };
+	int distance = 0;
+	for (int i = 0; i < 3; i++) {
+		const int low = ((cellNr >> ((2 - i) * 3)) & (COLORMATCHER_CELLS - 1)) << COLORMATCHER_CELL_SHIFT;
+		const int high = low + (1 << COLORMATCHER_CELL_SHIFT) - 1;
+		int delta = 0;
+		if (component[i] < low)
+			delta = low - component[i];
+		else if (component[i] > high)
+			delta = component[i] - high;
+		distance += delta * delta;
+	}
+	return distance;
+}
+
+// Squared distance of a color to the farthest point of a cell
+static int cellMaxDistance(const Color &color, uint cellNr) {
+	const byte component[3] = { color.r, color.g, color.b };
+	int distance = 0;
+	for (int i = 0; i < 3; i++) {
+		const int low = ((cellNr >> ((2 - i) * 3)) & (COLORMATCHER_CELLS - 1)) << COLORMATCHER_CELL_SHIFT;
+		const int high = low + (1 << COLORMATCHER_CELL_SHIFT) - 1;
+		const int delta = MAX(ABS(component[i] - low), ABS(component[i] - high));
+		distance += delta * delta;
+	}
+	return distance;
+}
+
+uint16 ColorMatcher::matchLinear(const Palette &palette, byte r, byte g, byte b) {
+	byte found = 0xFF;
+	int diff = 0x2FFFF, cdiff;
+	int16 dr,dg,db;
+
+	for (int i = 1; i < 255; i++) {
+		if ((!palette.colors[i].used))
+			continue;
+		dr = palette.colors[i].r - r;
+		dg = palette.colors[i].g - g;
+		db = palette.colors[i].b - b;
+//		minimum squares match
+		cdiff = (dr*dr) + (dg*dg) + (db*db);
+//		minimum sum match (Sierra's)
+//		cdiff = ABS(dr) + ABS(dg) + ABS(db);
+		if (cdiff < diff) {
+			if (cdiff == 0)
+				return i | 0x8000; // setting this flag to indicate exact match
+			found = i;
+			diff = cdiff;
+		}
+	}
+	return found;
+}
+
+void ColorMatcher::syncPalette(const Palette &palette) {
+	if (!memcmp(_colors + 1, palette.colors + 1, 254 * sizeof(Color)))
+		return;
+
+	for (int i = 1; i < 255; i++) {
+		const Color &oldColor = _colors[i];
+		const Color &newColor = palette.colors[i];
+		// Only whether a color is used matters, not the flags
+		if ((oldColor.used != 0) == (newColor.used != 0) &&
+			oldColor.r == newColor.r && oldColor.g == newColor.g && oldColor.b == newColor.b) {
+			_colors[i].used = newColor.used;
+			continue;
+		}
+
+		// A cell needs to be rebuilt when the old color was one of its
+		//  candidates, or the new color would be one
+		for (uint cellNr = 0; cellNr < COLORMATCHER_CELL_COUNT; cellNr++) {
+			if (!_cellValid[cellNr])
+				continue;
+			if ((oldColor.used && cellMinDistance(oldColor, cellNr) <= _cellBound[cellNr]) ||
+				(newColor.used && cellMinDistance(newColor, cellNr) <= _cellBound[cellNr]))
+				_cellValid[cellNr] = false;
+		}
+		_colors[i] = newColor;
+	}
+}
+
+void ColorMatcher::buildCell(uint cellNr) {
+	// Any point of the cell is at most this far away from its closest color
+	int bound = 0x7FFFFFFF;
+	for (int i = 1; i < 255; i++) {
+		if (_colors[i].used)
+			bound = MIN(bound, cellMaxDistance(_colors[i], cellNr));
+	}
+
+	// So colors farther away than that from the whole cell never match. The
+	//  candidates are kept in palette order, for resolving ties like a scan
+	Common::Array<byte> &candidates = _candidates[cellNr];
+	candidates.resize(0);
+	for (int i = 1; i < 255; i++) {
+		if (_colors[i].used && cellMinDistance(_colors[i], cellNr) <= bound)
+			candidates.push_back(i);
+	}
+
+	_cellBound[cellNr] = bound;
+	_cellValid[cellNr] = true;
+	_cellRebuilds++;
+}
+
+uint16 ColorMatcher::match(const Palette &palette, byte r, byte g, byte b) {
+	if (!_enabled)
+		return matchLinear(palette, r, g, b);
+
+	_lookups++;
+	syncPalette(palette);
+
+	const uint cellNr = ((r >> COLORMATCHER_CELL_SHIFT) << 6) | ((g >> COLORMATCHER_CELL_SHIFT) << 3) | (b >> COLORMATCHER_CELL_SHIFT);
+	if (!_cellValid[cellNr])
+		buildCell(cellNr);
+
+	const Common::Array<byte> &candidates = _candidates[cellNr];
+	byte found = 0xFF;
+	int diff = 0x2FFFF, cdiff;
+	int16 dr,dg,db;
+
+	for (uint i = 0; i < candidates.size(); i++) {
+		const Color &color = _colors[candidates[i]];
+		dr = color.r - r;
+		dg = color.g - g;
+		db = color.b - b;
+		cdiff = (dr*dr) + (dg*dg) + (db*db);
+		if (cdiff < diff) {
+			if (cdiff == 0)
+				return candidates[i] | 0x8000; // setting this flag to indicate exact match
+			found = candidates[i];
+			diff = cdiff;
+		}
+	}
+	return found;
+}
+
 GfxPalette::GfxPalette(ResourceManager *resMan, GfxScreen *screen, bool useMerging)
-	: _resMan(resMan), _screen(screen) {
+	: _resMan(resMan), _screen(screen), _mergeLogPos(0), _recordMerges(false), _replayingMerges(false) {
 	int16 color;
 
 	_sysPalette.timestamp = 0;
@@ -292,6 +434,21 @@ bool GfxPalette::merge(Palette *newPalette, bool force, bool forceRealMerge) {
 	int i,j;
 	bool paletteChanged = false;
 
+	if (_recordMerges && !_replayingMerges) {
+		// Keep the merge around for the palette_bench debugger command
+		PaletteMergeRecord record;
+		record.sysPalette = _sysPalette;
+		record.newPalette = *newPalette;
+		record.force = force;
+		record.forceRealMerge = forceRealMerge;
+		if (_mergeLog.size() < PALETTE_MERGELOG_SIZE) {
+			_mergeLog.push_back(record);
+		} else {
+			_mergeLog[_mergeLogPos] = record;
+			_mergeLogPos = (_mergeLogPos + 1) % PALETTE_MERGELOG_SIZE;
+		}
+	}
+
 	// colors 0 (black) and 255 (white) are not affected by merging
 	for (i = 1 ; i < 255; i++) {
 		if (!newPalette->colors[i].used)// color is not used - so skip it
@@ -357,28 +514,49 @@ void GfxPalette::drewPicture(GuiResourceId pictureId) {
 }
 
 uint16 GfxPalette::matchColor(byte r, byte g, byte b) {
-	byte found = 0xFF;
-	int diff = 0x2FFFF, cdiff;
-	int16 dr,dg,db;
-
-	for (int i = 1; i < 255; i++) {
-		if ((!_sysPalette.colors[i].used))
-			continue;
-		dr = _sysPalette.colors[i].r - r;
-		dg = _sysPalette.colors[i].g - g;
-		db = _sysPalette.colors[i].b - b;
-//		minimum squares match
-		cdiff = (dr*dr) + (dg*dg) + (db*db);
-//		minimum sum match (Sierra's)
-//		cdiff = ABS(dr) + ABS(dg) + ABS(db);
-		if (cdiff < diff) {
-			if (cdiff == 0)
-				return i | 0x8000; // setting this flag to indicate exact match
-			found = i;
-			diff = cdiff;
+	return _colorMatcher.match(_sysPalette, r, g, b);
+}
+
+int GfxPalette::benchmarkMerges(int iterations, uint32 &timeLinear, uint32 &timeCached) {
+	if (_mergeLog.empty())
+		return -1;
+
+	const Palette savedPalette = _sysPalette;
+	const bool savedPaletteChanged = _sysPaletteChanged;
+	const bool savedEnabled = _colorMatcher._enabled;
+	Common::Array<Palette> results;
+	int mismatches = 0;
+
+	_replayingMerges = true;
+	for (int useCache = 0; useCache < 2; useCache++) {
+		_colorMatcher._enabled = useCache;
+		const uint32 startTime = g_system->getMillis();
+		for (int iteration = 0; iteration < iterations; iteration++) {
+			for (uint i = 0; i < _mergeLog.size(); i++) {
+				Palette newPalette = _mergeLog[i].newPalette;
+				_sysPalette = _mergeLog[i].sysPalette;
+				merge(&newPalette, _mergeLog[i].force, _mergeLog[i].forceRealMerge);
+
+				if (iteration)
+					continue;
+				// Compare the mapping and the merged palette of both runs
+				memcpy(_sysPalette.mapping, newPalette.mapping, sizeof(newPalette.mapping));
+				if (!useCache) {
+					results.push_back(_sysPalette);
+				} else if (memcmp(results[i].mapping, _sysPalette.mapping, sizeof(_sysPalette.mapping)) ||
+						memcmp(results[i].colors, _sysPalette.colors, sizeof(_sysPalette.colors))) {
+					mismatches++;
+				}
+			}
 		}
+		(useCache ? timeCached : timeLinear) = g_system->getMillis() - startTime;
 	}
-	return found;
+	_replayingMerges = false;
+
+	_colorMatcher._enabled = savedEnabled;
+	_sysPalette = savedPalette;
+	_sysPaletteChanged = savedPaletteChanged;
+	return mismatches;
 }
 
 void GfxPalette::getSys(Palette *pal) {
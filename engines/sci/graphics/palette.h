@@ -30,6 +30,55 @@
 
 namespace Sci {
 
+#define COLORMATCHER_CELL_SHIFT 5
+#define COLORMATCHER_CELLS (256 >> COLORMATCHER_CELL_SHIFT)
+#define COLORMATCHER_CELL_COUNT (COLORMATCHER_CELLS * COLORMATCHER_CELLS * COLORMATCHER_CELLS)
+
+/**
+ * Finds the closest color within a palette, with the same result as scanning
+ * the whole palette. The RGB cube is split into cells and every cell keeps a
+ * list of the palette colors which may be the closest one for some point
+ * inside of it. Palette entries which changed since the last lookup only
+ * invalidate the cells they may affect.
+ */
+class ColorMatcher {
+public:
+	ColorMatcher();
+
+	/** Looks up a color, see GfxPalette::matchColor() for the result. */
+	uint16 match(const Palette &palette, byte r, byte g, byte b);
+	/** Looks up a color by scanning the whole palette. */
+	static uint16 matchLinear(const Palette &palette, byte r, byte g, byte b);
+
+	uint32 getLookups() const { return _lookups; }
+	uint32 getCellRebuilds() const { return _cellRebuilds; }
+
+	/** Set to false to scan the whole palette instead, e.g. for benchmarking. */
+	bool _enabled;
+
+private:
+	void syncPalette(const Palette &palette);
+	void buildCell(uint cellNr);
+
+	Color _colors[256];	///< The palette the cells are valid for
+	bool _cellValid[COLORMATCHER_CELL_COUNT];
+	int _cellBound[COLORMATCHER_CELL_COUNT];	///< Smallest maximum distance of any color to the cell
+	Common::Array<byte> _candidates[COLORMATCHER_CELL_COUNT];
+
+	uint32 _lookups;
+	uint32 _cellRebuilds;
+};
+
+/** The input of a palette merge, kept for replaying it in the debugger */
+struct PaletteMergeRecord {
+	Palette sysPalette;
+	Palette newPalette;
+	bool force;
+	bool forceRealMerge;
+};
+
+#define PALETTE_MERGELOG_SIZE 32
+
 class Screen;
 /**
  * Palette class, handles palette operations like changing intensity, setting up the palette, merging different palettes
@@ -50,6 +99,20 @@ public:
 	bool insert(Palette *newPalette, Palette *destPalette);
 	bool merge(Palette *pFrom, bool force, bool forceRealMerge);
 	uint16 matchColor(byte r, byte g, byte b);
+	const ColorMatcher &getColorMatcher() const { return _colorMatcher; }
+	/** Keeps the last palette merges for benchmarkMerges() from now on */
+	void startMergeRecording() { _recordMerges = true; }
+	bool isRecordingMerges() const { return _recordMerges; }
+	/**
+	 * Replays the last palette merges of the game, both with and without the
+	 * color lookup cells.
+	 * @param iterations	number of times to replay the merges
+	 * @param timeLinear	time taken by scanning the palette, in ms
+	 * @param timeCached	time taken by using the lookup cells, in ms
+	 * @return the number of replayed merges with different results, or -1 if
+	 *         no merges have been recorded yet
+	 */
+	int benchmarkMerges(int iterations, uint32 &timeLinear, uint32 &timeCached);
 	void getSys(Palette *pal);
 
 	void setOnScreen();
@@ -99,6 +162,12 @@ private:
 	bool _sysPaletteChanged;
 	bool _useMerging;
 
+	ColorMatcher _colorMatcher;
+	Common::Array<PaletteMergeRecord> _mergeLog;
+	uint _mergeLogPos;
+	bool _recordMerges;
+	bool _replayingMerges;
+
 	Common::Array<PalSchedule> _schedules;
 
 	GuiResourceId _palVaryResourceId;
@@ -37,7 +37,7 @@
 namespace Sci {
 
 GfxPicture::GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize)
-	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _resourceId(resourceId), _EGAdrawingVisualize(EGAdrawingVisualize) {
+	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _resourceId(resourceId), _stateOnly(false), _EGAdrawingVisualize(EGAdrawingVisualize) {
 	assert(resourceId != -1);
 	initData(resourceId);
 }
@@ -60,10 +60,11 @@ GuiResourceId GfxPicture::getResourceId() {
 // differentiation between various picture formats can NOT get done using sci-version checks.
 //  Games like PQ1 use the "old" vector data picture format, but are actually SCI1.1
 //  We should leave this that way to decide the format on-the-fly instead of hardcoding it in any way
-void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo) {
+void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo, bool stateOnly) {
 	uint16 headerSize;
 
 	_animationNr = animationNr;
+	_stateOnly = stateOnly;
 	_mirroredFlag = mirroredFlag;
 	_addToFlag = addToFlag;
 	_EGApaletteNo = EGApaletteNo;
@@ -89,12 +90,9 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 }
 
 void GfxPicture::reset() {
-	int16 x, y;
-	for (y = _ports->getPort()->top; y < _screen->getHeight(); y++) {
-		for (x = 0; x < _screen->getWidth(); x++) {
-			_screen->putPixel(x, y, GFX_SCREEN_MASK_ALL, 255, 0, 0);
-		}
-	}
+	int16 y;
+	for (y = _ports->getPort()->top; y < _screen->getHeight(); y++)
+		_screen->putPixelSpan(0, y, _screen->getWidth(), GFX_SCREEN_MASK_ALL, 255, 0, 0);
 }
 
 void GfxPicture::drawSci11Vga() {
@@ -133,7 +131,7 @@ void GfxPicture::drawSci11Vga() {
 		_palette->createFromData(inbuffer + palette_data_ptr, size - palette_data_ptr, &palette);
 		_palette->set(&palette, true);
 
-		drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, 0, 0, 0);
+		drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, 0, 0, 0, Common::Rect(_screen->getWidth(), _screen->getHeight()));
 	}
 
 	// process vector data
@@ -177,7 +175,7 @@ int16 GfxPicture::getSci32celPriority(int16 celNo) {
 	return READ_LE_UINT16(inbuffer + cel_headerPos + 36);
 }
 
-void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictureX, bool mirrored) {
+void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictureX, bool mirrored, const Common::Rect &clipRect) {
 	byte *inbuffer = _resource->data;
 	int size = _resource->size;
 	int header_size = READ_LE_UINT16(inbuffer);
@@ -217,12 +215,12 @@ void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictu
 	cel_RlePos = READ_LE_UINT32(inbuffer + cel_headerPos + 24);
 	cel_LiteralPos = READ_LE_UINT32(inbuffer + cel_headerPos + 28);
 
-	drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, drawX, drawY, pictureX);
+	drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, drawX, drawY, pictureX, clipRect);
 	cel_headerPos += 42;
 }
 #endif
 
-void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX) {
+void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX, const Common::Rect &clipRect) {
 	byte *celBitmap = NULL;
 	byte *ptr = NULL;
 	byte *headerPtr = inbuffer + headerPos;
@@ -238,6 +236,9 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 	int16 y, lastY, x, leftX, rightX;
 	int pixelNr, pixelCount;
 
+	if (_stateOnly)
+		return;
+
 #ifdef ENABLE_SCI32
 	if (_resourceType != SCI_PICTURE_TYPE_SCI32) {
 #endif
@@ -262,6 +263,37 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 	if (displaceX || displaceY)
 		error("unsupported embedded cel-data in picture");
 
+	Common::Rect displayArea = _coordAdjuster->pictureGetDisplayArea();
+
+	uint16 skipCelBitmapPixels = 0;
+	int16 displayWidth = width;
+	if (pictureX) {
+		// scroll position for picture active, we need to adjust drawX accordingly
+		drawX -= pictureX;
+		if (drawX < 0) {
+			skipCelBitmapPixels = -drawX;
+			displayWidth -= skipCelBitmapPixels;
+			drawX = 0;
+		}
+	}
+
+	if (displayWidth <= 0)
+		return;
+
+	y = displayArea.top + drawY;
+	lastY = MIN<int16>(height + y, displayArea.bottom);
+	leftX = displayArea.left + drawX;
+	rightX = MIN<int16>(displayWidth + leftX, displayArea.right);
+
+	// Only the part of the cel inside clipRect gets drawn. Don't even unpack
+	//  the cel data, if nothing of it is visible
+	const int16 clipTop = MAX<int16>(y, clipRect.top);
+	const int16 clipBottom = MIN<int16>(lastY, clipRect.bottom);
+	const int16 clipLeft = MAX<int16>(leftX, clipRect.left);
+	const int16 clipRight = MIN<int16>(rightX, clipRect.right);
+	if (clipTop >= clipBottom || clipLeft >= clipRight)
+		return;
+
 	pixelCount = width * height;
 	celBitmap = new byte[pixelCount];
 	if (!celBitmap)
@@ -348,73 +380,24 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 		memcpy(celBitmap, rlePtr, pixelCount);
 	}
 
-	Common::Rect displayArea = _coordAdjuster->pictureGetDisplayArea();
-
-	uint16 skipCelBitmapPixels = 0;
-	int16 displayWidth = width;
-	if (pictureX) {
-		// scroll position for picture active, we need to adjust drawX accordingly
-		drawX -= pictureX;
-		if (drawX < 0) {
-			skipCelBitmapPixels = -drawX;
-			displayWidth -= skipCelBitmapPixels;
-			drawX = 0;
-		}
-	}
-
-	if (displayWidth > 0) {
-		y = displayArea.top + drawY;
-		lastY = MIN<int16>(height + y, displayArea.bottom);
-		leftX = displayArea.left + drawX;
-		rightX = MIN<int16>(displayWidth + leftX, displayArea.right);
-
-		uint16 sourcePixelSkipPerRow = 0;
-		if (width > rightX - leftX)
-			sourcePixelSkipPerRow = width - (rightX - leftX);
-
-		// Change clearcolor to white, if we dont add to an existing picture. That way we will paint everything on screen
-		//  but white and that wont matter because the screen is supposed to be already white. It seems that most (if not all)
-		//  SCI1.1 games use color 0 as transparency and SCI1 games use color 255 as transparency. Sierra SCI seems to paint
-		//  the whole data to screen and wont skip over transparent pixels. So this will actually make it work like Sierra
-		if (!_addToFlag)
-			clearColor = _screen->getColorWhite();
-
-		byte drawMask = priority == 255 ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL | GFX_SCREEN_MASK_PRIORITY;
-
-		ptr = celBitmap;
-		ptr += skipCelBitmapPixels;
-		if (!_mirroredFlag) {
-			// Draw bitmap to screen
-			x = leftX;
-			while (y < lastY) {
-				curByte = *ptr++;
-				if ((curByte != clearColor) && (priority >= _screen->getPriority(x, y)))
-					_screen->putPixel(x, y, drawMask, curByte, priority, 0);
-
-				x++;
-
-				if (x >= rightX) {
-					ptr += sourcePixelSkipPerRow;
-					x = leftX;
-					y++;
-				}
-			}
-		} else {
-			// Draw bitmap to screen (mirrored)
-			x = rightX - 1;
-			while (y < lastY) {
-				curByte = *ptr++;
-				if ((curByte != clearColor) && (priority >= _screen->getPriority(x, y)))
-					_screen->putPixel(x, y, drawMask, curByte, priority, 0);
-			
-				if (x == leftX) {
-					ptr += sourcePixelSkipPerRow;
-					x = rightX;
-					y++;
-				}
-
-				x--;
-			}
+	// Change clearcolor to white, if we dont add to an existing picture. That way we will paint everything on screen
+	//  but white and that wont matter because the screen is supposed to be already white. It seems that most (if not all)
+	//  SCI1.1 games use color 0 as transparency and SCI1 games use color 255 as transparency. Sierra SCI seems to paint
+	//  the whole data to screen and wont skip over transparent pixels. So this will actually make it work like Sierra
+	if (!_addToFlag)
+		clearColor = _screen->getColorWhite();
+
+	byte drawMask = priority == 255 ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL | GFX_SCREEN_MASK_PRIORITY;
+
+	// Every row of the bitmap is width pixels wide, the first skipCelBitmapPixels
+	//  of them are scrolled out of view
+	for (y = clipTop; y < clipBottom; y++) {
+		const byte *rowPtr = celBitmap + skipCelBitmapPixels + (y - (displayArea.top + drawY)) * width;
+		for (x = clipLeft; x < clipRight; x++) {
+			// Mirrored pictures are drawn from right to left
+			curByte = _mirroredFlag ? rowPtr[rightX - 1 - x] : rowPtr[x - leftX];
+			if ((curByte != clearColor) && (priority >= _screen->getPriority(x, y)))
+				_screen->putPixel(x, y, drawMask, curByte, priority, 0);
 		}
 	}
 
@@ -578,7 +561,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (!_stateOnly)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 		case PIC_OP_MEDIUM_LINES: // medium line
@@ -598,7 +582,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (!_stateOnly)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 		case PIC_OP_LONG_LINES: // long line
@@ -609,7 +594,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (!_stateOnly)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 
@@ -711,7 +697,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					vectorGetAbsCoordsNoMirror(data, curPos, x, y);
 					size = READ_LE_UINT16(data + curPos); curPos += 2;
 					_priority = pic_priority; // set global priority so the cel gets drawn using current priority as well
-					drawCelData(data, _resource->size, curPos, curPos + 8, 0, x, y, 0);
+					drawCelData(data, _resource->size, curPos, curPos + 8, 0, x, y, 0, Common::Rect(_screen->getWidth(), _screen->getHeight()));
 					curPos += size;
 					break;
 				case PIC_OPX_EGA_SET_PRIORITY_TABLE:
@@ -751,7 +737,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					vectorGetAbsCoordsNoMirror(data, curPos, x, y);
 					size = READ_LE_UINT16(data + curPos); curPos += 2;
 					_priority = pic_priority; // set global priority so the cel gets drawn using current priority as well
-					drawCelData(data, _resource->size, curPos, curPos + 8, 0, x, y, 0);
+					drawCelData(data, _resource->size, curPos, curPos + 8, 0, x, y, 0, Common::Rect(_screen->getWidth(), _screen->getHeight()));
 					curPos += size;
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EQDIST:
@@ -771,7 +757,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 			_priority = pic_priority;
 			// Dithering EGA pictures
 			if (isEGA) {
-				_screen->dither(_addToFlag);
+				if (!_stateOnly)
+					_screen->dither(_addToFlag);
 				switch (g_sci->getGameId()) {
 				case GID_SQ3:
 					switch (_resourceId) {
@@ -862,6 +849,9 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 	byte matchedMask, matchMask;
 	int16 w, e, a_set, b_set;
 
+	if (_stateOnly)
+		return;
+
 	p.x = x + curPort->left;
 	p.y = y + curPort->top;
 	stack.push(p);
@@ -911,14 +901,15 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 		p = stack.pop();
 		if ((matchedMask = _screen->isFillMatch(p.x, p.y, matchMask, searchColor, searchPriority, searchControl)) == 0) // already filled
 			continue;
-		_screen->putPixel(p.x, p.y, screenMask, color, priority, control);
 		w = p.x;
 		e = p.x;
 		// moving west and east pointers as long as there is a matching color to fill
 		while (w > l && (matchedMask = _screen->isFillMatch(w - 1, p.y, matchMask, searchColor, searchPriority, searchControl)))
-			_screen->putPixel(--w, p.y, screenMask, color, priority, control);
+			w--;
 		while (e < r && (matchedMask = _screen->isFillMatch(e + 1, p.y, matchMask, searchColor, searchPriority, searchControl)))
-			_screen->putPixel(++e, p.y, screenMask, color, priority, control);
+			e++;
+		// the scan never looks at pixels of the current line that got filled, so we may fill the whole run at once
+		_screen->putPixelSpan(w, p.y, e - w + 1, screenMask, color, priority, control);
 		// checking lines above and below for possible flood targets
 		a_set = b_set = 0;
 		while (w <= e) {
@@ -1075,13 +1066,10 @@ static const byte vectorPatternTextureOffset[128] = {
 
 void GfxPicture::vectorPatternBox(Common::Rect box, byte color, byte prio, byte control) {
 	byte flag = _screen->getDrawingMask(color, prio, control);
-	int y, x;
+	int y;
 
-	for (y = box.top; y < box.bottom; y++) {
-		for (x = box.left; x < box.right; x++) {
-			_screen->putPixel(x, y, flag, color, prio, control);
-		}
-	}
+	for (y = box.top; y < box.bottom; y++)
+		_screen->putPixelSpan(box.left, y, box.width(), flag, color, prio, control);
 }
 
 void GfxPicture::vectorPatternTexturedBox(Common::Rect box, byte color, byte prio, byte control, byte texture) {
@@ -1104,12 +1092,18 @@ void GfxPicture::vectorPatternCircle(Common::Rect box, byte size, byte color, by
 	const byte *circleData = vectorPatternCircles[size];
 	byte bitmap = *circleData;
 	byte bitNo = 0;
-	int y, x;
+	int y, x, runStart;
 
+	// Set bits are collected into runs, which get drawn as soon as a bit is cleared or the line ends
 	for (y = box.top; y < box.bottom; y++) {
+		runStart = -1;
 		for (x = box.left; x < box.right; x++) {
 			if (bitmap & 1) {
-				_screen->putPixel(x, y, flag, color, prio, control);
+				if (runStart == -1)
+					runStart = x;
+			} else if (runStart != -1) {
+				_screen->putPixelSpan(runStart, y, x - runStart, flag, color, prio, control);
+				runStart = -1;
 			}
 			bitNo++;
 			if (bitNo == 8) {
@@ -1118,6 +1112,8 @@ void GfxPicture::vectorPatternCircle(Common::Rect box, byte size, byte color, by
 				bitmap = bitmap >> 1;
 			}
 		}
+		if (runStart != -1)
+			_screen->putPixelSpan(runStart, y, box.right - runStart, flag, color, prio, control);
 	}
 }
 
@@ -1151,6 +1147,9 @@ void GfxPicture::vectorPattern(int16 x, int16 y, byte color, byte priority, byte
 	byte size = code & SCI_PATTERN_CODE_PENSIZE;
 	Common::Rect rect;
 
+	if (_stateOnly)
+		return;
+
 	// We need to adjust the given coordinates, because the ones given us do not define upper left but somewhat middle
 	y -= size; if (y < 0) y = 0;
 	x -= size; if (x < 0) x = 0;
@@ -52,7 +52,12 @@ public:
 	~GfxPicture();
 
 	GuiResourceId getResourceId();
-	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo);
+	/**
+	 * Draws the picture. With stateOnly set, nothing gets drawn, only the
+	 * palette and priority band changes of the picture are applied. This is
+	 * used when the pixels of the picture are taken from the picture cache.
+	 */
+	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo, bool stateOnly = false);
 
 #ifdef ENABLE_SCI32
 	int16 getSci32celCount();
@@ -60,14 +65,18 @@ public:
 	int16 getSci32celX(int16 celNo);
 	int16 getSci32celWidth(int16 celNo);
 	int16 getSci32celPriority(int16 celNo);
-	void drawSci32Vga(int16 celNo, int16 callerX, int16 callerY, int16 pictureX, bool mirrored);
+	/**
+	 * Draws a cel of a SCI32 picture. Only the part inside clipRect gets
+	 * drawn, the palette of the picture is set up regardless.
+	 */
+	void drawSci32Vga(int16 celNo, int16 callerX, int16 callerY, int16 pictureX, bool mirrored, const Common::Rect &clipRect);
 #endif
 
 private:
 	void initData(GuiResourceId resourceId);
 	void reset();
 	void drawSci11Vga();
-	void drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX);
+	void drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX, const Common::Rect &clipRect);
 	void drawVectorData(byte *data, int size);
 	bool vectorIsNonOpcode(byte pixel);
 	void vectorGetAbsCoords(byte *data, int &curPos, int16 &x, int16 &y);
@@ -97,6 +106,7 @@ private:
 	bool _addToFlag;
 	int16 _EGApaletteNo;
 	byte _priority;
+	bool _stateOnly;
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
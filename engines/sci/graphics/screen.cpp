@@ -221,6 +221,37 @@ void GfxScreen::putPixel(int x, int y, byte drawMask, byte color, byte priority,
 		_controlScreen[offset] = control;
 }
 
+/**
+ * Puts a horizontal run of pixels onto the screen. The result is the same as
+ *  calling putPixel() for each of the width pixels starting at x, but every
+ *  plane gets written in one go.
+ */
+void GfxScreen::putPixelSpan(int x, int y, int width, byte drawMask, byte color, byte priority, byte control) {
+	int offset = y * _width + x;
+
+	if (width <= 0)
+		return;
+
+	if (drawMask & GFX_SCREEN_MASK_VISUAL) {
+		memset(_visualScreen + offset, color, width);
+		if (!_upscaledHires) {
+			memset(_displayScreen + offset, color, width);
+		} else {
+			int displayOffset = _upscaledMapping[y] * _displayWidth + x * 2;
+			int heightOffsetBreak = (_upscaledMapping[y + 1] - _upscaledMapping[y]) * _displayWidth;
+			int heightOffset = 0;
+			do {
+				memset(_displayScreen + displayOffset + heightOffset, color, width * 2);
+				heightOffset += _displayWidth;
+			} while (heightOffset != heightOffsetBreak);
+		}
+	}
+	if (drawMask & GFX_SCREEN_MASK_PRIORITY)
+		memset(_priorityScreen + offset, priority, width);
+	if (drawMask & GFX_SCREEN_MASK_CONTROL)
+		memset(_controlScreen + offset, control, width);
+}
+
 /**
  * This is used to put font pixels onto the screen - we adjust differently, so that we won't
  *  do triple pixel lines in any case on upscaled hires. That way the font will not get distorted
@@ -270,8 +301,7 @@ void GfxScreen::drawLine(Common::Point startPoint, Common::Point endPoint, byte
 	if (top == bottom) {
 		if (right < left)
 			SWAP(right, left);
-		for (int i = left; i <= right; i++)
-			putPixel(i, top, drawMask, color, priority, control);
+		putPixelSpan(left, top, right - left + 1, drawMask, color, priority, control);
 		return;
 	}
 	// vertical line
@@ -43,6 +43,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/script.h"	// for script_adjust_opcode_formats
+#include "sci/engine/script_patches.h"
 #include "sci/engine/selector.h"	// for SELECTOR
 
 #include "sci/sound/audio.h"
@@ -87,6 +88,7 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 
 	_audio = 0;
 	_features = 0;
+	_scriptPatcher = 0;
 	_resMan = 0;
 	_gamestate = 0;
 	_kernel = 0;
@@ -169,6 +171,7 @@ SciEngine::~SciEngine() {
 	delete _vocabulary;
 	delete _console;
 	delete _features;
+	delete _scriptPatcher;
 	delete _gfxMacIconBar;
 
 	delete _eventMan;
@@ -211,6 +214,7 @@ Common::Error SciEngine::run() {
 	_gameSuperClassAddress = NULL_REG;
 
 	SegManager *segMan = new SegManager(_resMan);
+	_scriptPatcher = new ScriptPatcher();
 
 	// Initialize the game screen
 	_gfxScreen = new GfxScreen(_resMan);
@@ -52,6 +52,7 @@ class Vocabulary;
 class ResourceManager;
 class Kernel;
 class GameFeatures;
+class ScriptPatcher;
 class Console;
 class AudioPlayer;
 class SoundCommandParser;
@@ -320,6 +321,7 @@ public:
 	AudioPlayer *_audio;
 	SoundCommandParser *_soundCmd;
 	GameFeatures *_features;
+	ScriptPatcher *_scriptPatcher;
 
 	DebugState _debugState;
 
@@ -560,7 +560,7 @@ void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 
 	scaleytab = &v1.scaletable[v1.scaleYindex];
 	maskbit = revBitMask(v1.x & 7);
-	mask = _vm->getMaskBuffer(v1.x - (_vm->_virtscr[kMainVirtScreen].xstart & 7), v1.y, _zbuf);
+	mask = v1.mask_ptr + v1.x / 8;
 
 	if (len)
 		goto StartPos;
@@ -602,7 +602,7 @@ void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 								pcolor = _shadow_table[pcolor];
 							}
 						}
-						if (_vm->_bytesPerPixel == 2) {
+						if (_out.bytesPerPixel == 2) {
 							WRITE_UINT16(dst, pcolor);
 						} else {
 							*dst = pcolor;
@@ -626,19 +626,128 @@ void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 					if (v1.x < 0 || v1.x >= v1.boundsRect.right)
 						return;
 					maskbit = revBitMask(v1.x & 7);
-					v1.destptr += v1.scaleXstep * _vm->_bytesPerPixel;
+					v1.destptr += v1.scaleXstep * _out.bytesPerPixel;
 					skip_column = false;
 				} else
 					skip_column = true;
 				v1.scaleXindex += v1.scaleXstep;
 				dst = v1.destptr;
-				mask = _vm->getMaskBuffer(v1.x - (_vm->_virtscr[kMainVirtScreen].xstart & 7), v1.y, _zbuf);
+				mask = v1.mask_ptr + v1.x / 8;
 			}
 		StartPos:;
 		} while (--len);
 	} while (1);
 }
 
+bool AkosRenderer::codec1_cachedDecode(Codec1 &v1) {
+	// Hit testing stops at the first hit and follows skipped columns,
+	// leave it to codec1_genericDecode()
+	if (!_celCacheEnabled || _actorHitMode || _shadow_mode == 2)
+		return false;
+
+	const DecodedCel *cel = getDecodedCel(v1);
+	if (!cel)
+		return false;
+
+	const int bytesPerPixel = _out.bytesPerPixel;
+	int i;
+
+	// Step through the columns and rows the same way codec1_genericDecode()
+	// does, keeping the ones which get drawn
+	_celColumns.resize(0);
+	int x = v1.x;
+	int scaleXindex = v1.scaleXindex;
+	bool skip_column = false;
+	for (i = 0; i < v1.skip_width; i++) {
+		if (i > 0) {
+			if (_scaleX == 255 || v1.scaletable[scaleXindex] < _scaleX) {
+				x += v1.scaleXstep;
+				if (x < 0 || x >= v1.boundsRect.right)
+					break;
+				skip_column = false;
+			} else
+				skip_column = true;
+			scaleXindex += v1.scaleXstep;
+		}
+		if (skip_column || x < 0 || x >= v1.boundsRect.right)
+			continue;
+
+		CelColumn col;
+		col.src = v1.skipCols + i;
+		col.dst = x * bytesPerPixel;
+		col.mask = v1.mask_ptr + x / 8;
+		col.maskbit = revBitMask(x & 7);
+		_celColumns.push_back(col);
+	}
+
+	_celRows.resize(0);
+	const byte *scaleytab = &v1.scaletable[v1.scaleYindex];
+	int drawn = 0;
+	for (i = 0; i < _height; i++) {
+		if (_scaleY == 255 || *scaleytab++ < _scaleY) {
+			const int y = v1.y + drawn;
+			if (y >= v1.boundsRect.top && y < v1.boundsRect.bottom) {
+				CelRow row;
+				row.src = i * cel->width;
+				row.dst = y * _out.pitch;
+				row.mask = drawn * _numStrips;
+				_celRows.push_back(row);
+			}
+			drawn++;
+		}
+	}
+
+	const uint numColumns = _celColumns.size();
+	const CelColumn *columns = _celColumns.begin();
+
+	for (uint r = 0; r < _celRows.size(); r++) {
+		const CelRow &row = _celRows[r];
+		const byte *src = cel->pixels + row.src;
+		byte *dstRow = (byte *)_out.pixels + row.dst;
+
+		if (_shadow_mode == 0 && bytesPerPixel == 1) {
+			for (uint c = 0; c < numColumns; c++) {
+				const byte color = src[columns[c].src];
+				if (color && !(columns[c].mask[row.mask] & columns[c].maskbit))
+					dstRow[columns[c].dst] = _palette[color];
+			}
+			continue;
+		}
+
+		for (uint c = 0; c < numColumns; c++) {
+			const byte color = src[columns[c].src];
+			if (!color || (columns[c].mask[row.mask] & columns[c].maskbit))
+				continue;
+
+			byte *dst = dstRow + columns[c].dst;
+			uint16 pcolor = _palette[color];
+			if (_shadow_mode == 1) {
+				if (pcolor == 13)
+					pcolor = _shadow_table[*dst];
+			} else if (_shadow_mode == 3) {
+				if (_vm->_game.features & GF_16BIT_COLOR) {
+					uint16 srcColor = (pcolor >> 1) & 0x7DEF;
+					uint16 dstColor = (READ_UINT16(dst) >> 1) & 0x7DEF;
+					pcolor = srcColor + dstColor;
+				} else if (_vm->_game.heversion >= 90) {
+					pcolor = (pcolor << 8) + *dst;
+					pcolor = xmap[pcolor];
+				} else if (pcolor < 8) {
+					pcolor = (pcolor << 8) + *dst;
+					pcolor = _shadow_table[pcolor];
+				}
+			}
+			if (bytesPerPixel == 2) {
+				WRITE_UINT16(dst, pcolor);
+			} else {
+				*dst = pcolor;
+			}
+		}
+	}
+
+	return true;
+}
+
 // This is exact duplicate of smallCostumeScaleTable[] in costume.cpp
 // See FIXME below for explanation
 const byte smallCostumeScaleTableAKOS[256] = {
@@ -942,6 +1051,8 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 		return 0;
 
 	v1.replen = 0;
+	v1.celptr = _srcptr;
+	v1.skipCols = 0;
 
 	if (_mirror) {
 		if (!use_scaling)
@@ -998,7 +1109,12 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 	v1.destptr = (byte *)_out.pixels + v1.y * _out.pitch + v1.x * _vm->_bytesPerPixel;
 
-	codec1_genericDecode(v1);
+	// The mask of column x is at mask_ptr + x / 8, as the virtual screen
+	// starts with a whole strip once its xstart & 7 is taken off
+	v1.mask_ptr = _vm->getMaskBuffer(-(_vm->_virtscr[kMainVirtScreen].xstart & 7), v1.y, _zbuf);
+
+	if (!codec1_cachedDecode(v1))
+		codec1_genericDecode(v1);
 
 	return drawFlag;
 }
@@ -59,7 +59,78 @@ byte BaseCostumeRenderer::drawCostume(const VirtScreen &vs, int numStrips, const
 	return result;
 }
 
+void BaseCostumeRenderer::flushCelCache() {
+	for (CelCache::iterator it = _celCache.begin(); it != _celCache.end(); ++it) {
+		free(it->_value->pixels);
+		delete it->_value;
+	}
+	_celCache.clear();
+	_celCacheSize = 0;
+}
+
+const BaseCostumeRenderer::DecodedCel *BaseCostumeRenderer::getDecodedCel(const Codec1 &v1) {
+	// When codec1_ignorePakCols() stops on the first pixel of a 256 pixel
+	// run, replen is left at 0 and the renderers skip the rest of that run.
+	// The decoded cel can't reproduce that.
+	if (v1.skipCols && !v1.replen)
+		return NULL;
+
+	CelCache::iterator it = _celCache.find(v1.celptr);
+	if (it != _celCache.end()) {
+		DecodedCel *cel = it->_value;
+		if (cel->width == _width && cel->height == _height && cel->shr == v1.shr)
+			return cel;
+		_celCacheSize -= cel->width * cel->height;
+		free(cel->pixels);
+		delete cel;
+		_celCache.erase(v1.celptr);
+	}
+
+	const int size = _width * _height;
+	if (size <= 0 || size > kCelCacheMaxSize)
+		return NULL;
+	if (_celCacheSize + size > kCelCacheMaxSize)
+		flushCelCache();
+
+	DecodedCel *cel = new DecodedCel;
+	cel->width = _width;
+	cel->height = _height;
+	cel->shr = v1.shr;
+	cel->pixels = (byte *)malloc(size);
+	assert(cel->pixels);
+
+	// Same RLE as in the renderers: the runs go down the columns, and a run
+	// length of 0 is followed by the real length, where 0 means 256
+	const byte *src = v1.celptr;
+	int x = 0, y = 0;
+	int left = size;
+	while (left > 0) {
+		byte len = *src++;
+		const byte color = len >> v1.shr;
+		len &= v1.mask;
+		if (!len)
+			len = *src++;
+		int run = len ? len : 256;
+		if (run > left)
+			run = left;
+		left -= run;
+
+		while (run--) {
+			cel->pixels[y * _width + x] = color;
+			if (++y == _height) {
+				y = 0;
+				x++;
+			}
+		}
+	}
+
+	_celCache[v1.celptr] = cel;
+	_celCacheSize += size;
+	return cel;
+}
+
 void BaseCostumeRenderer::codec1_ignorePakCols(Codec1 &v1, int num) {
+	v1.skipCols = num;
 	num *= _height;
 
 	do {
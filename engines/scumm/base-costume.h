@@ -27,6 +27,8 @@
 #define SCUMM_BASE_COSTUME_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
 #include "scumm/actor.h"		// for CostumeData
 
 namespace Scumm {
@@ -125,8 +127,23 @@ public:
 		// These ones aren't accessed from ARM code.
 		Common::Rect boundsRect;
 		int scaleXindex, scaleYindex;
+		const byte *celptr;	// start of the cel data, before any skipped columns
+		int skipCols;
 	};
 
+	/**
+	 * A codec 1 cel decoded from its column-wise RLE data into a row-major
+	 * image of color indices, 0 being transparent. Drawing it again only
+	 * needs the scaling, clipping and masking of the pixels.
+	 */
+	struct DecodedCel {
+		int width, height;
+		byte shr;
+		byte *pixels;
+	};
+
+	bool _celCacheEnabled;
+
 	BaseCostumeRenderer(ScummEngine *scumm) {
 		_actorID = 0;
 		_shadow_mode = 0;
@@ -144,8 +161,10 @@ public:
 		_width = _height = 0;
 		_skipLimbs = 0;
 		_paletteNum = 0;
+		_celCacheEnabled = true;
+		_celCacheSize = 0;
 	}
-	virtual ~BaseCostumeRenderer() {}
+	virtual ~BaseCostumeRenderer() { flushCelCache(); }
 
 	virtual void setPalette(uint16 *palette) = 0;
 	virtual void setFacing(const Actor *a) = 0;
@@ -154,10 +173,48 @@ public:
 
 	byte drawCostume(const VirtScreen &vs, int numStrips, const Actor *a, bool drawToBackBuf);
 
+	/** Drops all decoded cels, called when costume resources go away. */
+	void flushCelCache();
+	int getCelCacheEntries() const { return _celCache.size(); }
+	int getCelCacheSize() const { return _celCacheSize; }
+
 protected:
 	virtual byte drawLimb(const Actor *a, int limb) = 0;
 
 	void codec1_ignorePakCols(Codec1 &v1, int num);
+	const DecodedCel *getDecodedCel(const Codec1 &v1);
+
+	/** A destination column of a decoded cel, with its mask position. */
+	struct CelColumn {
+		int src;
+		int dst;
+		const byte *mask;
+		byte maskbit;
+	};
+
+	/** A destination row of a decoded cel. */
+	struct CelRow {
+		int src;
+		int dst;
+		int mask;
+	};
+
+	// Step tables of the cel being drawn, kept to avoid reallocating them
+	Common::Array<CelColumn> _celColumns;
+	Common::Array<CelRow> _celRows;
+
+private:
+	enum {
+		kCelCacheMaxSize = 512 * 1024
+	};
+
+	struct CelPtrHash {
+		uint operator()(const byte *p) const { return (uint)(size_t)p; }
+	};
+
+	typedef Common::HashMap<const byte *, DecodedCel *, CelPtrHash> CelCache;
+	CelCache _celCache;
+	int _celCacheSize;
 };
 
 } // End of namespace Scumm
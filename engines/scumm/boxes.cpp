@@ -574,6 +574,31 @@ bool ScummEngine::checkXYInBoxBounds(int boxnum, int x, int y) {
 }
 
 BoxCoords ScummEngine::getBoxCoordinates(int boxnum) {
+	Common::Array<BoxCoords> &coords = _boxCache->coords;
+	if (coords.empty()) {
+		const int numOfBoxes = getNumBoxes();
+		for (int i = 0; i < numOfBoxes; i++)
+			coords.push_back(readBoxCoordinates(i));
+	}
+
+	if (boxnum >= 0 && boxnum < (int)coords.size())
+		return coords[boxnum];
+
+	// Out of range boxes are handled by the workarounds in getBoxBaseAddr()
+	return readBoxCoordinates(boxnum);
+}
+
+BoxGate ScummEngine::getBoxGate(int box1, int box2) {
+	const uint16 key = (box1 << 8) | box2;
+	if (_boxCache->gates.contains(key))
+		return _boxCache->gates[key];
+
+	BoxGate &gate = _boxCache->gates[key];
+	getGates(getBoxCoordinates(box1), getBoxCoordinates(box2), gate.gateA, gate.gateB);
+	return gate;
+}
+
+BoxCoords ScummEngine::readBoxCoordinates(int boxnum) {
 	BoxCoords tmp, *box = &tmp;
 	Box *bp = getBoxBaseAddr(boxnum);
 	assert(bp);
@@ -701,10 +726,7 @@ byte *ScummEngine::getBoxMatrixBaseAddr() {
  * If there is no connection -1 is return.
  */
 int ScummEngine::getNextBox(byte from, byte to) {
-	const byte *boxm;
-	byte i;
 	const int numOfBoxes = getNumBoxes();
-	int dest = -1;
 
 	if (from == to)
 		return to;
@@ -718,32 +740,68 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	assert(from < numOfBoxes);
 	assert(to < numOfBoxes);
 
-	boxm = getBoxMatrixBaseAddr();
+	if (_game.version >= 1 && _game.version <= 2) {
+		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
+		// The first numOfBoxes bytes contain indices to the start of the corresponding
+		// row (although that seems unnecessary to me - the value is easily computable.
+		const byte *boxm = getBoxMatrixBaseAddr();
+		boxm += numOfBoxes + boxm[from];
+		return (int8)boxm[to];
+	}
+
+	// WORKAROUND: We have to add this special case to fix the scene in Indy3
+	// where Indy meets Hitler in Berlin. See bug #770690 and also bug #774783.
+	if ((_game.id == GID_INDY3) && _roomResource == 46 && from == 1 && to == 0)
+		return 0;
+
+	if (_boxCache->numBoxes != (uint)numOfBoxes)
+		buildNextBoxTable();
+
+	return _boxCache->nextBox[from * numOfBoxes + to];
+}
+
+/**
+ * Computes the getNextBox() results for all pairs of boxes.
+ */
+void ScummEngine::buildNextBoxTable() {
+	const int numOfBoxes = getNumBoxes();
+	Common::Array<int8> &nextBox = _boxCache->nextBox;
+	int from, to;
+
+	nextBox.resize(numOfBoxes * numOfBoxes);
+	for (from = 0; from < numOfBoxes; from++) {
+		for (to = 0; to < numOfBoxes; to++)
+			nextBox[from * numOfBoxes + to] = (from == to) ? to : -1;
+	}
+	_boxCache->numBoxes = numOfBoxes;
 
 	if (_game.version == 0) {
 		// calculate shortest paths
 		byte *itineraryMatrix = (byte *)malloc(numOfBoxes * numOfBoxes);
 		calcItineraryMatrix(itineraryMatrix, numOfBoxes);
 
-		dest = to;
-		do {
-			dest = itineraryMatrix[numOfBoxes * from + dest];
-		} while (dest != Actor::kInvalidBox && !areBoxesNeighbours(from, dest));
+		for (from = 0; from < numOfBoxes; from++) {
+			for (to = 0; to < numOfBoxes; to++) {
+				if (from == to)
+					continue;
 
-		if (dest == Actor::kInvalidBox)
-			dest = -1;
+				int dest = to;
+				do {
+					dest = itineraryMatrix[numOfBoxes * from + dest];
+				} while (dest != Actor::kInvalidBox && !areBoxesNeighbours(from, dest));
+
+				if (dest != Actor::kInvalidBox)
+					nextBox[from * numOfBoxes + to] = dest;
+			}
+		}
 
 		free(itineraryMatrix);
-		return dest;
-	} else if (_game.version <= 2) {
-		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
-		// The first numOfBoxes bytes contain indices to the start of the corresponding
-		// row (although that seems unnecessary to me - the value is easily computable.
-		boxm += numOfBoxes + boxm[from];
-		return (int8)boxm[to];
+		return;
 	}
 
-	// WORKAROUND #1: It seems that in some cases, the box matrix is corrupt
+	const byte *boxm = getBoxMatrixBaseAddr();
+
+	// WORKAROUND: It seems that in some cases, the box matrix is corrupt
 	// (more precisely, is too short) in the datafiles already. In
 	// particular this seems to be the case in room 46 of Indy3 EGA (see
 	// also bug #770690). This didn't cause problems in the original
@@ -756,30 +814,24 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	// resource, and abort the search once we reach the end.
 	const byte *end = boxm + getResourceSize(rtMatrix, 1);
 
-	// WORKAROUND #2: In addition to the above, we have to add this special
-	// case to fix the scene in Indy3 where Indy meets Hitler in Berlin.
-	// See bug #770690 and also bug #774783.
-	if ((_game.id == GID_INDY3) && _roomResource == 46 && from == 1 && to == 0)
-		return 0;
-
-	// Skip up to the matrix data for box 'from'
-	for (i = 0; i < from && boxm < end; i++) {
-		while (boxm < end && *boxm != 0xFF)
+	// For each box there is a list of byte triples, terminated by 0xFF. Each
+	// triple gives the next box on the way to a range of boxes; for boxes in
+	// several ranges, the last one counts. See also createBoxMatrix().
+	for (from = 0; from < numOfBoxes; from++) {
+		while (boxm < end && boxm[0] != 0xFF) {
+			for (to = boxm[0]; to <= boxm[1] && to < numOfBoxes; to++) {
+				if (to != from)
+					nextBox[from * numOfBoxes + to] = (int8)boxm[2];
+			}
 			boxm += 3;
-		boxm++;
-	}
+		}
 
-	// Now search for the entry for box 'to'
-	while (boxm < end && boxm[0] != 0xFF) {
-		if (boxm[0] <= to && to <= boxm[1])
-			dest = (int8)boxm[2];
-		boxm += 3;
+		if (boxm >= end) {
+			debug(0, "The box matrix apparently is truncated (room %d)", _roomResource);
+			break;
+		}
+		boxm++;
 	}
-
-	if (boxm >= end)
-		debug(0, "The box matrix apparently is truncated (room %d)", _roomResource);
-
-	return dest;
 }
 
 /*
@@ -1196,10 +1248,9 @@ bool ScummEngine_v0::areBoxesNeighbours(int box1nr, int box2nr) {
 }
 
 void Actor_v3::findPathTowardsOld(byte box1, byte box2, byte finalBox, Common::Point &p2, Common::Point &p3) {
-	Common::Point gateA[2];
-	Common::Point gateB[2];
-
-	getGates(_vm->getBoxCoordinates(box1), _vm->getBoxCoordinates(box2), gateA, gateB);
+	const BoxGate gate = _vm->getBoxGate(box1, box2);
+	const Common::Point *gateA = gate.gateA;
+	const Common::Point *gateB = gate.gateB;
 
 	p2.x = 32000;
 	p3.x = 32000;
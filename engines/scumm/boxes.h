@@ -26,6 +26,8 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -52,6 +54,35 @@ struct BoxCoords {			/* Box coordinates */
 	Common::Point lr;
 };
 
+/** The gate between two neighbouring boxes, see getGates(). */
+struct BoxGate {
+	Common::Point gateA[2];
+	Common::Point gateB[2];
+};
+
+/**
+ * Walkbox data of the current room which is otherwise recomputed for every
+ * actor walking through the room. Everything in here is derived from the
+ * box (rtMatrix 2) and box matrix (rtMatrix 1) resources, and is dropped
+ * whenever one of these is freed or replaced, e.g. by a room change or by
+ * createBoxMatrix().
+ */
+struct BoxCache {
+	Common::Array<BoxCoords> coords;	///< Coordinates of all boxes, indexed by box number
+	Common::Array<int8> nextBox;	///< getNextBox() results, indexed by from * numBoxes + to
+	uint numBoxes;	///< Number of boxes covered by nextBox
+	Common::HashMap<uint16, BoxGate> gates;	///< Gates between boxes, keyed by box1 << 8 | box2
+
+	BoxCache() : numBoxes(0) {}
+
+	void clear() {
+		coords.clear();
+		nextBox.clear();
+		numBoxes = 0;
+		gates.clear();
+	}
+};
+
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
 } // End of namespace Scumm
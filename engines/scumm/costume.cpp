@@ -240,6 +240,8 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		return 0;
 
 	v1.replen = 0;
+	v1.celptr = _srcptr;
+	v1.skipCols = 0;
 
 	if (_mirror) {
 		if (!use_scaling)
@@ -461,6 +463,9 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	}
 #endif /* USE_ARM_COSTUME_ASM */
 
+	if (proc3_cached(v1))
+		return;
+
 	y = v1.y;
 	src = _srcptr;
 	dst = v1.destptr;
@@ -524,6 +529,88 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	} while (1);
 }
 
+bool ClassicCostumeRenderer::proc3_cached(Codec1 &v1) {
+	if (!_celCacheEnabled || !v1.mask_ptr)
+		return false;
+
+	const DecodedCel *cel = getDecodedCel(v1);
+	if (!cel)
+		return false;
+
+	int i;
+
+	// Step through the columns and rows the same way proc3() does. When a
+	// column isn't scaled in, the next one is drawn over it, so the columns
+	// have to stay in this order.
+	_celColumns.resize(0);
+	for (i = 0; i < v1.skip_width; i++) {
+		if (i > 0) {
+			if (_scaleX == 255 || v1.scaletable[_scaleIndexX] < _scaleX) {
+				v1.x += v1.scaleXstep;
+				if (v1.x < 0 || v1.x >= _out.w)
+					break;
+			}
+			_scaleIndexX += v1.scaleXstep;
+		}
+		if (v1.x < 0 || v1.x >= _out.w)
+			continue;
+
+		CelColumn col;
+		col.src = v1.skipCols + i;
+		col.dst = v1.x;
+		col.mask = v1.mask_ptr + v1.x / 8;
+		col.maskbit = revBitMask(v1.x & 7);
+		_celColumns.push_back(col);
+	}
+
+	_celRows.resize(0);
+	byte scaleIndexY = _scaleIndexY;
+	int drawn = 0;
+	for (i = 0; i < _height; i++) {
+		if (_scaleY == 255 || v1.scaletable[scaleIndexY++] < _scaleY) {
+			const int y = v1.y + drawn;
+			if (y >= 0 && y < _out.h) {
+				CelRow row;
+				row.src = i * cel->width;
+				row.dst = y * _out.pitch;
+				row.mask = drawn * _numStrips;
+				_celRows.push_back(row);
+			}
+			drawn++;
+		}
+	}
+
+	const uint numColumns = _celColumns.size();
+	const CelColumn *columns = _celColumns.begin();
+	const bool plain = !(_shadow_mode & 0x20) && !_shadow_table;
+
+	for (uint r = 0; r < _celRows.size(); r++) {
+		const CelRow &row = _celRows[r];
+		const byte *src = cel->pixels + row.src;
+		byte *dstRow = (byte *)_out.pixels + row.dst;
+
+		for (uint c = 0; c < numColumns; c++) {
+			const byte color = src[columns[c].src];
+			if (!color || (columns[c].mask[row.mask] & columns[c].maskbit))
+				continue;
+
+			byte *dst = dstRow + columns[c].dst;
+			if (plain) {
+				*dst = _palette[color];
+			} else if (_shadow_mode & 0x20) {
+				*dst = _shadow_table[*dst];
+			} else {
+				uint pcolor = _palette[color];
+				if (pcolor == 13)
+					pcolor = _shadow_table[*dst];
+				*dst = pcolor;
+			}
+		}
+	}
+
+	return true;
+}
+
 void ClassicCostumeRenderer::proc3_ami(Codec1 &v1) {
 	const byte *mask, *src;
 	byte *dst;
@@ -105,6 +105,7 @@ protected:
 	byte drawLimb(const Actor *a, int limb);
 
 	void proc3(Codec1 &v1);
+	bool proc3_cached(Codec1 &v1);
 	void proc3_ami(Codec1 &v1);
 
 	void procC64(Codec1 &v1, int actor);
@@ -31,8 +31,12 @@
 #include "common/util.h"
 
 #include "scumm/actor.h"
+#include "scumm/base-costume.h"
 #include "scumm/boxes.h"
 #include "scumm/debugger.h"
+#ifdef ENABLE_HE
+#include "scumm/he/intern_he.h"
+#endif
 #include "scumm/imuse/imuse.h"
 #include "scumm/object.h"
 #include "scumm/scumm.h"
@@ -101,6 +105,15 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
 	DCmd_Register("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+
+	DCmd_Register("costcache", WRAP_METHOD(ScummDebugger, Cmd_CostumeCache));
+	DCmd_Register("resources", WRAP_METHOD(ScummDebugger, Cmd_Resources));
+	DCmd_Register("stripcache", WRAP_METHOD(ScummDebugger, Cmd_StripCache));
+
+#ifdef ENABLE_HE
+	if (_vm->_game.heversion >= 71)
+		DCmd_Register("wizcache",  WRAP_METHOD(ScummDebugger, Cmd_WizCache));
+#endif
 }
 
 ScummDebugger::~ScummDebugger() {
@@ -868,4 +881,122 @@ bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	return false;
 }
 
+bool ScummDebugger::Cmd_CostumeCache(int argc, const char **argv) {
+	BaseCostumeRenderer *renderer = _vm->_costumeRenderer;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			renderer->_celCacheEnabled = true;
+		} else if (!strcmp(argv[1], "off")) {
+			renderer->_celCacheEnabled = false;
+			renderer->flushCelCache();
+		} else if (!strcmp(argv[1], "flush")) {
+			renderer->flushCelCache();
+		} else {
+			DebugPrintf("Syntax: costcache [on|off|flush]\n");
+			return true;
+		}
+	}
+
+	DebugPrintf("Decoded costume cel cache is %s\n", renderer->_celCacheEnabled ? "on" : "off");
+	DebugPrintf("Cels: %d, size: %d bytes\n", renderer->getCelCacheEntries(), renderer->getCelCacheSize());
+	return true;
+}
+
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "reset")) {
+			res->resetStats();
+		} else {
+			DebugPrintf("Syntax: resources [reset]\n");
+			return true;
+		}
+	}
+
+	const ResourceStats &stats = res->getStats();
+	DebugPrintf("Allocated: %d bytes, budget: %d bytes\n", res->getAllocatedSize(), res->getHeapThreshold());
+	DebugPrintf("Loaded: %d (%d bytes)\n", stats.loads, stats.loadedBytes);
+	DebugPrintf("Reloaded after expiry: %d (%d bytes)\n", stats.reloads, stats.reloadedBytes);
+	DebugPrintf("Expired: %d (%d bytes)\n", stats.expired, stats.expiredBytes);
+	return true;
+}
+
+bool ScummDebugger::Cmd_StripCache(int argc, const char **argv) {
+	Gdi *gdi = _vm->_gdi;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			gdi->_stripCacheEnabled = true;
+		} else if (!strcmp(argv[1], "off")) {
+			gdi->_stripCacheEnabled = false;
+			gdi->flushStripCache();
+		} else if (!strcmp(argv[1], "flush")) {
+			gdi->flushStripCache();
+		} else if (!strcmp(argv[1], "reset")) {
+			gdi->resetStripCacheStats();
+		} else if (!strcmp(argv[1], "bench")) {
+			// Redraw the visible room background, once decoding every
+			// strip and once using the cache
+			const int iterations = (argc > 2) ? atoi(argv[2]) : 100;
+			const bool enabled = gdi->_stripCacheEnabled;
+			uint32 time[2];
+
+			for (int pass = 0; pass < 2; pass++) {
+				gdi->_stripCacheEnabled = (pass == 1);
+				gdi->flushStripCache();
+				const uint32 start = g_system->getMillis();
+				for (int i = 0; i < iterations; i++)
+					_vm->redrawBGStrip(0, gdi->_numStrips);
+				time[pass] = g_system->getMillis() - start;
+			}
+			gdi->_stripCacheEnabled = enabled;
+			if (!enabled)
+				gdi->flushStripCache();
+			_vm->_bgNeedsRedraw = true;
+
+			DebugPrintf("%d redraws of room %d: %d ms decoding, %d ms cached\n", iterations, _vm->_currentRoom, time[0], time[1]);
+			return true;
+		} else {
+			DebugPrintf("Syntax: stripcache [on|off|flush|reset|bench [iterations]]\n");
+			return true;
+		}
+	}
+
+	DebugPrintf("Room background strip cache is %s\n", gdi->_stripCacheEnabled ? "on" : "off");
+	DebugPrintf("Strips: %d, size: %d bytes\n", gdi->getStripCacheEntries(), gdi->getStripCacheSize());
+	DebugPrintf("Hits: %d, misses: %d\n", gdi->getStripCacheHits(), gdi->getStripCacheMisses());
+	return true;
+}
+
+#ifdef ENABLE_HE
+bool ScummDebugger::Cmd_WizCache(int argc, const char **argv) {
+	Wiz *wiz = ((ScummEngine_v71he *)_vm)->_wiz;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			wiz->_spanCacheEnabled = true;
+		} else if (!strcmp(argv[1], "off")) {
+			wiz->_spanCacheEnabled = false;
+			wiz->flushSpanCache();
+		} else if (!strcmp(argv[1], "flush")) {
+			wiz->flushSpanCache();
+		} else if (!strcmp(argv[1], "reset")) {
+			wiz->resetSpanCacheStats();
+		} else {
+			DebugPrintf("Syntax: wizcache [on|off|flush|reset]\n");
+			return true;
+		}
+	}
+
+	const WizSpanCacheStats &stats = wiz->getSpanCacheStats();
+	DebugPrintf("Decoded wiz image cache is %s\n", wiz->_spanCacheEnabled ? "on" : "off");
+	DebugPrintf("Images: %d, size: %d bytes\n", wiz->getSpanCacheEntries(), wiz->getSpanCacheSize());
+	DebugPrintf("Hits: %d, misses: %d\n", stats.hits, stats.misses);
+	DebugPrintf("Flushed: %d, evicted: %d\n", stats.flushes, stats.evictions);
+	return true;
+}
+#endif
+
 } // End of namespace Scumm
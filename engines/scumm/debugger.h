@@ -70,6 +70,14 @@ private:
 
 	bool Cmd_ResetCursors(int argc, const char **argv);
 
+	bool Cmd_CostumeCache(int argc, const char **argv);
+	bool Cmd_Resources(int argc, const char **argv);
+	bool Cmd_StripCache(int argc, const char **argv);
+
+#ifdef ENABLE_HE
+	bool Cmd_WizCache(int argc, const char **argv);
+#endif
+
 	void printBox(int box);
 	void drawBox(int box);
 };
@@ -48,6 +48,9 @@ public:
 	virtual int32 size() const = 0;
 	virtual bool seek(int32 offs, int whence = SEEK_SET) = 0;
 
+	// The data is encrypted, or comes from a sub file or disk image
+	const byte *getDataPtr() const { return 0; }
+
 // Unused
 #if 0
 	virtual bool eos() const = 0;
@@ -210,9 +210,20 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	_stripCacheImage = 0;
+	_stripCacheHeight = 0;
+	_stripCacheZBuffers = 0;
+	_stripCacheSize = 0;
+	_stripCacheHits = _stripCacheMisses = 0;
+
+	// The decoders of older games depend on the room palette, HE games
+	// draw over their room images. Only cache where it is safe.
+	_stripCacheEnabled = (vm->_game.version >= 5 && vm->_game.version <= 7 && vm->_game.heversion == 0);
 }
 
 Gdi::~Gdi() {
+	flushStripCache();
 }
 
 GdiNES::GdiNES(ScummEngine *vm) : Gdi(vm) {
@@ -266,6 +277,7 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	flushStripCache();
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -1780,6 +1792,8 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		limit = numstrip;
 	if (limit > _numStrips - sx)
 		limit = _numStrips - sx;
+
+	const bool useCache = canCacheStrips(ptr, vs, y, height, flag, numzbuf, zplane_list) && stripnr >= 0 && stripnr + limit <= (int)_stripCache.size();
 	for (int k = 0; k < limit; ++k, ++stripnr, ++sx, ++x) {
 		if (y < vs->tdirty[sx])
 			vs->tdirty[sx] = y;
@@ -1794,11 +1808,27 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		else
 			dstPtr = (byte *)vs->pixels + y * vs->pitch + (x * 8 * vs->bytesPerPixel);
 
-		transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		const byte *cached = useCache ? _stripCache[stripnr] : 0;
+		if (cached) {
+			_stripCacheHits++;
+			drawCachedStrip(cached, dstPtr, vs->pitch, x, y, height, numzbuf);
+		} else {
+			transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+
+			// COMI and HE games only uses flag value
+			if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
+				transpStrip = true;
+
+			decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag, tmsk_ptr);
 
-		// COMI and HE games only uses flag value
-		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
-			transpStrip = true;
+			// Transparent strips leave parts of the old screen contents
+			// in place, so they are decoded again every time
+			if (useCache) {
+				_stripCacheMisses++;
+				if (!transpStrip)
+					storeCachedStrip(stripnr, dstPtr, vs->pitch, x, y, height, numzbuf);
+			}
+		}
 
 		if (vs->hasTwoBuffers) {
 			byte *frontBuf = (byte *)vs->pixels + y * vs->pitch + (x * 8 * vs->bytesPerPixel);
@@ -1808,8 +1838,6 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 				clear8Col(frontBuf, vs->pitch, height, vs->bytesPerPixel);
 		}
 
-		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag, tmsk_ptr);
-
 #if 0
 		// HACK: blit mask(s) onto normal screen. Useful to debug masking
 		for (int i = 0; i < numzbuf; i++) {
@@ -1836,6 +1864,86 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	}
 }
 
+bool Gdi::canCacheStrips(const byte *ptr, const VirtScreen *vs, int y, int height, byte flag, int numzbuf, const byte *zplane_list[9]) {
+	// Only the room background is cached. It's the only bitmap drawn
+	// with no flags into the back buffer of the main virtual screen, at
+	// its full height.
+	if (!_stripCacheEnabled || flag || _objectMode || vs->number != kMainVirtScreen || !vs->hasTwoBuffers ||
+		y != 0 || height != vs->h || vs->bytesPerPixel != 1)
+		return false;
+
+	// Missing Z-planes keep their old mask contents
+	for (int i = 1; i < numzbuf; i++)
+		if (!zplane_list[i])
+			return false;
+
+	if (ptr != _stripCacheImage || height != _stripCacheHeight || numzbuf != _stripCacheZBuffers) {
+		flushStripCache();
+		_stripCacheImage = ptr;
+		_stripCacheHeight = height;
+		_stripCacheZBuffers = numzbuf;
+		_stripCache.resize(_vm->_roomWidth / 8);
+		for (uint i = 0; i < _stripCache.size(); i++)
+			_stripCache[i] = 0;
+	}
+	return true;
+}
+
+void Gdi::storeCachedStrip(int stripnr, const byte *dstPtr, int pitch, int x, int y, int height, int numzbuf) {
+	const uint32 size = height * (8 + MAX(numzbuf - 1, 0));
+	byte *data = (byte *)malloc(size);
+	if (!data)
+		return;
+
+	byte *dst = data;
+	for (int h = 0; h < height; h++) {
+		memcpy(dst, dstPtr, 8);
+		dst += 8;
+		dstPtr += pitch;
+	}
+	for (int i = 1; i < numzbuf; i++) {
+		const byte *mask_ptr = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++) {
+			*dst++ = *mask_ptr;
+			mask_ptr += _numStrips;
+		}
+	}
+
+	_stripCache[stripnr] = data;
+	_stripCacheSize += size;
+}
+
+void Gdi::drawCachedStrip(const byte *data, byte *dstPtr, int pitch, int x, int y, int height, int numzbuf) {
+	for (int h = 0; h < height; h++) {
+		memcpy(dstPtr, data, 8);
+		data += 8;
+		dstPtr += pitch;
+	}
+	for (int i = 1; i < numzbuf; i++) {
+		byte *mask_ptr = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++) {
+			*mask_ptr = *data++;
+			mask_ptr += _numStrips;
+		}
+	}
+}
+
+void Gdi::flushStripCache() {
+	for (uint i = 0; i < _stripCache.size(); i++)
+		free(_stripCache[i]);
+	_stripCache.clear();
+	_stripCacheImage = 0;
+	_stripCacheSize = 0;
+}
+
+uint Gdi::getStripCacheEntries() const {
+	uint num = 0;
+	for (uint i = 0; i < _stripCache.size(); i++)
+		if (_stripCache[i])
+			num++;
+	return num;
+}
+
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
 	// Do some input verification and make sure the strip/strip offset
@@ -27,6 +27,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -195,6 +196,22 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/**
+	 * Decoded strips of the room background: 8 columns of pixels followed
+	 * by the column of each Z-plane mask except the first. Only opaque
+	 * strips drawn at full height are kept, see drawBitmap().
+	 */
+	const byte *_stripCacheImage;
+	int _stripCacheHeight;
+	int _stripCacheZBuffers;
+	Common::Array<byte *> _stripCache;
+	uint32 _stripCacheSize;
+	uint32 _stripCacheHits, _stripCacheMisses;
+
+	bool canCacheStrips(const byte *ptr, const VirtScreen *vs, int y, int height, byte flag, int numzbuf, const byte *zplane_list[9]);
+	void storeCachedStrip(int stripnr, const byte *dstPtr, int pitch, int x, int y, int height, int numzbuf);
+	void drawCachedStrip(const byte *data, byte *dstPtr, int pitch, int x, int y, int height, int numzbuf);
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -266,6 +283,15 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	/** Set to false to always decode the room background, e.g. for benchmarking. */
+	bool _stripCacheEnabled;
+	void flushStripCache();
+	uint getStripCacheEntries() const;
+	uint32 getStripCacheSize() const { return _stripCacheSize; }
+	uint32 getStripCacheHits() const { return _stripCacheHits; }
+	uint32 getStripCacheMisses() const { return _stripCacheMisses; }
+	void resetStripCacheStats() { _stripCacheHits = _stripCacheMisses = 0; }
+
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
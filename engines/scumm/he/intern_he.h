@@ -190,6 +190,8 @@ protected:
 
 	virtual void clearDrawQueues();
 
+	virtual void resourceChanged(int type, int i);
+
 	int getStringCharWidth(byte chr);
 	virtual int setupStringArray(int size);
 	void appendSubstring(int dst, int src, int len2, int len);
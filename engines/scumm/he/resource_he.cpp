@@ -1213,6 +1213,12 @@ void ScummEngine_v70he::readGlobalObjects() {
 }
 
 #ifdef ENABLE_HE
+void ScummEngine_v71he::resourceChanged(int type, int i) {
+	ScummEngine_v70he::resourceChanged(type, i);
+	if (type == rtImage)
+		_wiz->flushSpanCache(i);
+}
+
 void ScummEngine_v99he::readMAXS(int blockSize) {
 	if (blockSize == 52) {
 		debug(0, "ScummEngine_v99he readMAXS: MAXS has blocksize %d", blockSize);
@@ -43,6 +43,14 @@ Wiz::Wiz(ScummEngine_v71he *vm) : _vm(vm) {
 	memset(&_polygons, 0, sizeof(_polygons));
 	_cursorImage = false;
 	_rectOverrideEnabled = false;
+	_spanCacheEnabled = true;
+	_spanCacheSize = 0;
+	_spanCacheCounter = 0;
+	resetSpanCacheStats();
+}
+
+Wiz::~Wiz() {
+	flushSpanCache();
 }
 
 void Wiz::clearWizBuffer() {
@@ -945,6 +953,199 @@ template void Wiz::decompressWizImage<kWizXMap>(uint8 *dst, int dstPitch, int ds
 template void Wiz::decompressWizImage<kWizRMap>(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
 template void Wiz::decompressWizImage<kWizCopy>(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
 
+void Wiz::flushSpanCache(int resNum) {
+	Common::Array<uint32> keys;
+	for (SpanCache::const_iterator it = _spanCache.begin(); it != _spanCache.end(); ++it) {
+		if (resNum == -1 || (int)(it->_key >> 16) == resNum)
+			keys.push_back(it->_key);
+	}
+	for (uint i = 0; i < keys.size(); ++i) {
+		WizSpanImage *img = _spanCache[keys[i]];
+		_spanCacheSize -= img->size;
+		delete img;
+		_spanCache.erase(keys[i]);
+	}
+	_spanCacheStats.flushes += keys.size();
+}
+
+void Wiz::resetSpanCacheStats() {
+	memset(&_spanCacheStats, 0, sizeof(_spanCacheStats));
+}
+
+const WizSpanImage *Wiz::getSpanImage(int resNum, int state, const uint8 *wizd, int width, int height) {
+	const uint32 key = (resNum << 16) | (state & 0xFFFF);
+
+	WizSpanImage *img = _spanCache.getVal(key, 0);
+	if (img && img->wizd == wizd && img->width == width && img->height == height) {
+		img->lastUsed = ++_spanCacheCounter;
+		++_spanCacheStats.hits;
+		return img;
+	}
+	++_spanCacheStats.misses;
+
+	if (img) {
+		_spanCacheSize -= img->size;
+	} else {
+		img = new WizSpanImage();
+		_spanCache[key] = img;
+	}
+	img->wizd = wizd;
+	img->width = width;
+	img->height = height;
+	decodeSpanImage(img, wizd);
+	img->lastUsed = ++_spanCacheCounter;
+	_spanCacheSize += img->size;
+
+	// Drop the least recently drawn images, but never the one just decoded
+	while (_spanCacheSize > kSpanCacheMaxSize && _spanCache.size() > 1) {
+		SpanCache::iterator oldest = _spanCache.end();
+		for (SpanCache::iterator it = _spanCache.begin(); it != _spanCache.end(); ++it) {
+			if (oldest == _spanCache.end() || it->_value->lastUsed < oldest->_value->lastUsed)
+				oldest = it;
+		}
+		const uint32 oldestKey = oldest->_key;
+		_spanCacheSize -= oldest->_value->size;
+		delete oldest->_value;
+		_spanCache.erase(oldestKey);
+		++_spanCacheStats.evictions;
+	}
+
+	return img;
+}
+
+void Wiz::decodeSpanImage(WizSpanImage *img, const uint8 *src) {
+	// This reads the data exactly like decompressWizImage() does for an
+	// unclipped image, so drawing the spans gives the same result.
+	const uint8 *dataPtr = src, *dataPtrNext;
+	const int w = img->width;
+
+	img->rows.resize(img->height + 1);
+	img->spans.clear();
+	img->pixels.clear();
+
+	for (int y = 0; y < img->height; ++y) {
+		img->rows[y] = img->spans.size();
+		uint16 lineSize = READ_LE_UINT16(dataPtr); dataPtr += 2;
+		dataPtrNext = dataPtr + lineSize;
+		if (lineSize != 0) {
+			int x = 0;
+			while (x < w) {
+				uint8 code = *dataPtr++;
+				if (code & 1) {
+					x += code >> 1;
+					continue;
+				}
+
+				int len = MIN<int>((code >> 2) + 1, w - x);
+				WizSpan *span = NULL;
+				if (img->spans.size() > img->rows[y]) {
+					span = &img->spans.back();
+					if (span->x + span->len != x)
+						span = NULL;
+				}
+				if (!span) {
+					WizSpan newSpan;
+					newSpan.x = x;
+					newSpan.len = 0;
+					newSpan.offset = img->pixels.size();
+					img->spans.push_back(newSpan);
+					span = &img->spans.back();
+				}
+				span->len += len;
+				x += len;
+
+				if (code & 2) {
+					const uint8 color = *dataPtr++;
+					while (len--)
+						img->pixels.push_back(color);
+				} else {
+					for (int i = 0; i < len; ++i)
+						img->pixels.push_back(dataPtr[i]);
+					dataPtr += (code >> 2) + 1;
+				}
+			}
+		}
+		dataPtr = dataPtrNext;
+	}
+	img->rows[img->height] = img->spans.size();
+
+	img->size = sizeof(WizSpanImage) + img->rows.size() * sizeof(uint32) + img->spans.size() * sizeof(WizSpan) + img->pixels.size();
+}
+
+template <int type>
+void Wiz::drawSpanImage(uint8 *dst, int dstPitch, int dstType, const WizSpanImage *img, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	const int h = srcRect.height();
+	const int w = srcRect.width();
+	if (h <= 0 || w <= 0)
+		return;
+
+	if (flags & kWIFFlipY) {
+		dst += (h - 1) * dstPitch;
+		dstPitch = -dstPitch;
+	}
+	int dstInc = bitDepth;
+	if (flags & kWIFFlipX) {
+		dst += (w - 1) * bitDepth;
+		dstInc = -bitDepth;
+	}
+
+	for (int y = srcRect.top; y < srcRect.bottom; ++y) {
+		const WizSpan *span = img->spans.begin() + img->rows[y];
+		const WizSpan *spanEnd = img->spans.begin() + img->rows[y + 1];
+		for (; span != spanEnd && span->x < srcRect.right; ++span) {
+			const int x1 = MAX<int>(span->x, srcRect.left);
+			const int x2 = MIN<int>(span->x + span->len, srcRect.right);
+			if (x1 >= x2)
+				continue;
+
+			const uint8 *dataPtr = &img->pixels[span->offset + x1 - span->x];
+			uint8 *dstPtr = dst + (x1 - srcRect.left) * dstInc;
+			int len = x2 - x1;
+			if (type == kWizCopy && bitDepth == 1 && dstInc == 1) {
+				memcpy(dstPtr, dataPtr, len);
+			} else {
+				while (len--) {
+					write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
+					dataPtr++;
+					dstPtr += dstInc;
+				}
+			}
+		}
+		dst += dstPitch;
+	}
+}
+
+void Wiz::copyCachedWizImage(uint8 *dst, int resNum, int state, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	Common::Rect r1, r2;
+	if (calcClipRects(dstw, dsth, srcx, srcy, srcw, srch, rect, r1, r2)) {
+		if (flags & kWIFFlipY) {
+			const int dy = (srcy < 0) ? srcy : (srch - r1.height());
+			r1.translate(0, dy);
+		}
+		if (flags & kWIFFlipX) {
+			const int dx = (srcx < 0) ? srcx : (srcw - r1.width());
+			r1.translate(dx, 0);
+		}
+		if (!Common::Rect(srcw, srch).contains(r1)) {
+			// Flipped images clipped on their left or top side end up with
+			// a source rectangle outside of the image, leave those to the
+			// decoder so that they are drawn as they always were.
+			copyWizImage(dst, src, dstPitch, dstType, dstw, dsth, srcx, srcy, srcw, srch, rect, flags, palPtr, xmapPtr, bitDepth);
+			return;
+		}
+
+		dst += r2.top * dstPitch + r2.left * bitDepth;
+		const WizSpanImage *img = getSpanImage(resNum, state, src, srcw, srch);
+		if (xmapPtr) {
+			drawSpanImage<kWizXMap>(dst, dstPitch, dstType, img, r1, flags, palPtr, xmapPtr, bitDepth);
+		} else if (palPtr) {
+			drawSpanImage<kWizRMap>(dst, dstPitch, dstType, img, r1, flags, palPtr, NULL, bitDepth);
+		} else {
+			drawSpanImage<kWizCopy>(dst, dstPitch, dstType, img, r1, flags, NULL, NULL, bitDepth);
+		}
+	}
+}
+
 template <int type>
 void Wiz::decompressRawWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, int srcPitch, int w, int h, int transColor, const uint8 *palPtr, uint8 bitDepth) {
 	if (type == kWizRMap) {
@@ -1531,6 +1732,8 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 			getWizImageDim(dstResNum, 0, cw, ch);
 			dstPitch = cw * _vm->_bytesPerPixel;
 			dstType = kDstResource;
+			// The image gets drawn into without being marked as modified
+			flushSpanCache(dstResNum);
 		} else {
 			VirtScreen *pvs = &_vm->_virtscr[kMainVirtScreen];
 			if (flags & kWIFMarkBufferDirty) {
@@ -1584,6 +1787,8 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 			dst = _vm->getMaskBuffer(0, 0, 1);
 			dstPitch /= _vm->_bytesPerPixel;
 			copyWizImageWithMask(dst, wizd, dstPitch, cw, ch, x1, y1, width, height, &rScreen, 0, 1);
+		} else if (_spanCacheEnabled) {
+			copyCachedWizImage(dst, resNum, state, wizd, dstPitch, dstType, cw, ch, x1, y1, width, height, &rScreen, flags, palPtr, xmapPtr, _vm->_bytesPerPixel);
 		} else {
 			copyWizImage(dst, wizd, dstPitch, dstType, cw, ch, x1, y1, width, height, &rScreen, flags, palPtr, xmapPtr, _vm->_bytesPerPixel);
 		}
@@ -1704,6 +1909,80 @@ struct PolygonDrawData {
 	}
 };
 
+enum {
+	kPolygonRow8Bit,
+	kPolygonRow16Bit,
+	kPolygonRow16BitLE
+};
+
+/**
+ * Draws one row of a transformed wiz image. The source position moves by
+ * a constant 16.16 fixed point step per destination pixel. The last pixel
+ * of the row isn't drawn.
+ */
+template <int type>
+static void drawWizPolygonRow(uint8 *dstPtr, const uint8 *src, int wizW, int wizH, int32 w, int32 x_acc, int32 y_acc, int32 x_step, int32 y_step, int transColor) {
+	if (w <= 1)
+		return;
+
+	// The source coordinates are linear along the row, so both ends being
+	// inside the image puts the whole row inside it
+	const int32 x_end = x_acc + x_step * (w - 2);
+	const int32 y_end = y_acc + y_step * (w - 2);
+	assert((x_acc >> 16) >= 0 && (x_acc >> 16) < wizW && (y_acc >> 16) >= 0 && (y_acc >> 16) < wizH);
+	assert((x_end >> 16) >= 0 && (x_end >> 16) < wizW && (y_end >> 16) >= 0 && (y_end >> 16) < wizH);
+
+	// Compared as int, so a transparent color of -1 never matches
+	while (--w) {
+		const int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
+		x_acc += x_step;
+		y_acc += y_step;
+		if (type == kPolygonRow8Bit) {
+			const uint8 color = src[src_offs];
+			if (color != transColor)
+				*dstPtr = color;
+			dstPtr++;
+		} else {
+			const uint16 color = READ_LE_UINT16(src + src_offs * 2);
+			if (color != transColor) {
+				if (type == kPolygonRow16Bit)
+					WRITE_UINT16(dstPtr, color);
+				else
+					WRITE_LE_UINT16(dstPtr, color);
+			}
+			dstPtr += 2;
+		}
+	}
+}
+
+typedef void (*PolygonRowProc)(uint8 *, const uint8 *, int, int, int32, int32, int32, int32, int32, int);
+
+struct PolygonTileJob {
+	const PolygonDrawData *pdd;
+	PolygonRowProc drawRow;
+	uint8 *dst;
+	const uint8 *src;
+	int wizW, wizH;
+	int transColor;
+	int tileRows;
+};
+
+/**
+ * Draws one band of rows of a polygon. The bands don't share any
+ * destination pixels, so they can be drawn in any order and at the same
+ * time.
+ */
+static void drawWizPolygonTile(void *refCon, uint tile) {
+	const PolygonTileJob *job = (const PolygonTileJob *)refCon;
+	const int first = tile * job->tileRows;
+	const int last = MIN(first + job->tileRows, job->pdd->rAreasNum);
+
+	const PolygonDrawData::ResultArea *pra = &job->pdd->ra[first];
+	for (int i = first; i < last; ++i, ++pra) {
+		job->drawRow(job->dst + pra->dst_offs, job->src, job->wizW, job->wizH, pra->w, pra->x_s, pra->y_s, pra->x_step, pra->y_step, job->transColor);
+	}
+}
+
 void Wiz::captureWizPolygon(int resNum, int maskNum, int maskState, int id1, int id2, int compType) {
 	debug(0, "captureWizPolygon: resNum %d, maskNum %d maskState %d, id1 %d id2 %d compType %d", resNum, maskNum, maskState, id1, id2, compType);
 
@@ -1847,6 +2126,7 @@ void Wiz::drawWizPolygonTransform(int resNum, int state, Common::Point *wp, int
 		getWizImageDim(dstResNum, 0, dstw, dsth);
 		dstpitch = dstw * _vm->_bytesPerPixel;
 		dstType = kDstResource;
+		flushSpanCache(dstResNum);
 	} else {
 		if (flags & kWIFMarkBufferDirty) {
 			dst = pvs->getPixels(0, 0);
@@ -1874,7 +2154,12 @@ void Wiz::drawWizPolygonTransform(int resNum, int state, Common::Point *wp, int
 }
 
 void Wiz::drawWizPolygonImage(uint8 *dst, const uint8 *src, const uint8 *mask, int dstpitch, int dstType, int dstw, int dsth, int wizW, int wizH, Common::Rect &bound, Common::Point *wp, uint8 bitDepth) {
-	int i, transColor = (_vm->VAR_WIZ_TCOLOR != 0xFF) ? _vm->VAR(_vm->VAR_WIZ_TCOLOR) : 5;
+	int transColor = (_vm->VAR_WIZ_TCOLOR != 0xFF) ? _vm->VAR(_vm->VAR_WIZ_TCOLOR) : 5;
+	rasterizeWizPolygon(dst, src, dstpitch, dstType, dstw, dsth, wizW, wizH, bound, wp, bitDepth, transColor, &_jobRunner);
+}
+
+void Wiz::rasterizeWizPolygon(uint8 *dst, const uint8 *src, int dstpitch, int dstType, int dstw, int dsth, int wizW, int wizH, Common::Rect &bound, const Common::Point *wp, uint8 bitDepth, int transColor, Common::JobRunner *jobRunner) {
+	int i;
 
 	Common::Point bbox[4];
 	bbox[0].x = 0;
@@ -1944,7 +2229,7 @@ void Wiz::drawWizPolygonImage(uint8 *dst, const uint8 *src, const uint8 *mask, i
 				int16 width = ppa->xmax - ppa->xmin + 1;
 				pra->x_step = ((ppa->x2 - ppa->x1) << 16) / width;
 				pra->y_step = ((ppa->y2 - ppa->y1) << 16) / width;
-				pra->dst_offs = yoff + x1 * _vm->_bytesPerPixel;
+				pra->dst_offs = yoff + x1 * bitDepth;
 				pra->w = w;
 				pra->x_s = ppa->x1 << 16;
 				pra->y_s = ppa->y1 << 16;
@@ -1962,27 +2247,38 @@ void Wiz::drawWizPolygonImage(uint8 *dst, const uint8 *src, const uint8 *mask, i
 		++y_start;
 	}
 
-	pra = &pdd.ra[0];
-	for (i = 0; i < pdd.rAreasNum; ++i, ++pra) {
-		uint8 *dstPtr = dst + pra->dst_offs;
-		int32 w = pra->w;
-		int32 x_acc = pra->x_s;
-		int32 y_acc = pra->y_s;
-		while (--w) {
-			int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
-			assert(src_offs < wizW * wizH);
-			x_acc += pra->x_step;
-			y_acc += pra->y_step;
-			if (bitDepth == 2) {
-				if (transColor == -1 || transColor != READ_LE_UINT16(src + src_offs * 2)) {
-					writeColor(dstPtr, dstType, READ_LE_UINT16(src + src_offs * 2));
-				}
-			} else {
-				if (transColor == -1 || transColor != src[src_offs])
-					*dstPtr = src[src_offs];
-			}
-			dstPtr += bitDepth;
-		}
+	// Pick the row renderer once instead of checking the pixel format
+	// and destination type for every pixel
+	PolygonRowProc drawRow;
+	if (bitDepth == 2) {
+		if (dstType == kDstScreen || dstType == kDstCursor)
+			drawRow = drawWizPolygonRow<kPolygonRow16Bit>;
+		else if (dstType == kDstMemory || dstType == kDstResource)
+			drawRow = drawWizPolygonRow<kPolygonRow16BitLE>;
+		else
+			error("drawWizPolygonImage: Unknown dstType %d", dstType);
+	} else {
+		drawRow = drawWizPolygonRow<kPolygonRow8Bit>;
+	}
+
+	PolygonTileJob job;
+	job.pdd = &pdd;
+	job.drawRow = drawRow;
+	job.dst = dst;
+	job.src = src;
+	job.wizW = wizW;
+	job.wizH = wizH;
+	job.transColor = transColor;
+	job.tileRows = kPolygonTileRows;
+
+	// Each destination row appears once, so the bands can be drawn by
+	// different threads
+	const uint tiles = (pdd.rAreasNum + kPolygonTileRows - 1) / kPolygonTileRows;
+	if (jobRunner) {
+		jobRunner->run(drawWizPolygonTile, &job, tiles);
+	} else {
+		for (uint tile = 0; tile < tiles; ++tile)
+			drawWizPolygonTile(&job, tile);
 	}
 
 	bound.left = xmin_p;
@@ -26,6 +26,9 @@
 #if !defined(SCUMM_HE_WIZ_HE_H) && defined(ENABLE_HE)
 #define SCUMM_HE_WIZ_HE_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/jobrunner.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -149,6 +152,40 @@ enum DstSurface {
  	kDstCursor   = 3
 };
 
+/**
+ * A horizontal run of opaque pixels in a decoded wiz image.
+ */
+struct WizSpan {
+	uint16 x;
+	uint16 len;
+	uint32 offset;	///< Offset of the span's pixels in WizSpanImage::pixels
+};
+
+/**
+ * A compressed (type 1) wiz image decoded into spans of opaque pixels. The
+ * pixels are kept untranslated so that palette, remap and xmap changes don't
+ * affect the decoded image.
+ */
+struct WizSpanImage {
+	const uint8 *wizd;	///< The WIZD data the spans were decoded from
+	int width, height;
+	Common::Array<uint32> rows;	///< Index of the first span of each row, plus an end marker
+	Common::Array<WizSpan> spans;
+	Common::Array<uint8> pixels;
+	uint32 size;	///< Approximate memory used by the image, in bytes
+	uint32 lastUsed;
+};
+
+/**
+ * Statistics of the decoded wiz image cache, shown by the debugger.
+ */
+struct WizSpanCacheStats {
+	uint32 hits;	///< Draws which used an already decoded image
+	uint32 misses;	///< Draws which had to decode the image first
+	uint32 flushes;	///< Decoded images dropped because their resource changed
+	uint32 evictions;	///< Decoded images dropped to stay within the size limit
+};
+
 class ScummEngine_v71he;
 
 class Wiz {
@@ -163,6 +200,7 @@ public:
 	WizPolygon _polygons[NUM_POLYGONS];
 
 	Wiz(ScummEngine_v71he *vm);
+	~Wiz();
 
 	void clearWizBuffer();
 	Common::Rect _rectOverride;
@@ -195,6 +233,16 @@ public:
 
 	void flushWizBuffer();
 
+	/** Drops the decoded images of the given image resource, or all of them if resNum is -1. */
+	void flushSpanCache(int resNum = -1);
+	uint getSpanCacheEntries() const { return _spanCache.size(); }
+	uint32 getSpanCacheSize() const { return _spanCacheSize; }
+	const WizSpanCacheStats &getSpanCacheStats() const { return _spanCacheStats; }
+	void resetSpanCacheStats();
+
+	/** Set to false to always decode compressed images while drawing them. */
+	bool _spanCacheEnabled;
+
 	void getWizImageSpot(int resId, int state, int32 &x, int32 &y);
 	void loadWizCursor(int resId, int palette);
 
@@ -211,6 +259,13 @@ public:
 	void drawWizPolygonTransform(int resNum, int state, Common::Point *wp, int flags, int shadow, int dstResNum, int palette);
 	void drawWizPolygonImage(uint8 *dst, const uint8 *src, const uint8 *mask, int dstpitch, int dstType, int dstw, int dsth, int wizW, int wizH, Common::Rect &bound, Common::Point *wp, uint8 bitDepth);
 
+	/**
+	 * Draws a wiz image mapped onto the quad wp. Polygons covering more
+	 * than one band of kPolygonTileRows rows are drawn band by band through
+	 * jobRunner, unless it's NULL.
+	 */
+	static void rasterizeWizPolygon(uint8 *dst, const uint8 *src, int dstpitch, int dstType, int dstw, int dsth, int wizW, int wizH, Common::Rect &bound, const Common::Point *wp, uint8 bitDepth, int transColor, Common::JobRunner *jobRunner);
+
 #ifdef USE_RGB_COLOR
 	static void copyMaskWizImage(uint8 *dst, const uint8 *src, const uint8 *mask, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *palPtr);
 #endif
@@ -241,6 +296,24 @@ public:
 
 private:
 	ScummEngine_v71he *_vm;
+
+	enum {
+		kSpanCacheMaxSize = 4 * 1024 * 1024,
+		kPolygonTileRows = 32
+	};
+
+	typedef Common::HashMap<uint32, WizSpanImage *> SpanCache;
+	SpanCache _spanCache;
+	uint32 _spanCacheSize;
+	uint32 _spanCacheCounter;
+	WizSpanCacheStats _spanCacheStats;
+
+	Common::JobRunner _jobRunner;
+
+	const WizSpanImage *getSpanImage(int resNum, int state, const uint8 *wizd, int width, int height);
+	void decodeSpanImage(WizSpanImage *img, const uint8 *src);
+	void copyCachedWizImage(uint8 *dst, int resNum, int state, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
+	template<int type> static void drawSpanImage(uint8 *dst, int dstPitch, int dstType, const WizSpanImage *img, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
 };
 
 } // End of namespace Scumm
@@ -438,4 +438,55 @@ void IMuseDigital::switchToNextRegion(Track *track) {
 	debug(5, "SwToNeReg(trackId:%d) - end of func", track->trackId);
 }
 
+int IMuseDigital::predictNextRegion(Track *track) {
+	// Same choice as switchToNextRegion(), without the side effects
+	ImuseDigiSndMgr::SoundDesc *soundDesc = track->soundDesc;
+	int region = track->curRegion + 1;
+	if (region == _sound->getNumRegions(soundDesc))
+		return -1;
+
+	int jumpId = _sound->getJumpIdByRegionAndHookId(soundDesc, region, track->curHookId);
+	if (jumpId != -1 && _sound->getJumpHookId(soundDesc, jumpId) == track->curHookId)
+		region = _sound->getRegionIdByJumpId(soundDesc, jumpId);
+
+	return region;
+}
+
+void IMuseDigital::readAheadTracks() {
+	Common::StackLock lock(_mutex, "IMuseDigital::readAheadTracks()");
+
+	if (_pause)
+		return;
+
+	for (int l = 0; l < MAX_DIGITAL_TRACKS + MAX_DIGITAL_FADETRACKS; l++) {
+		Track *track = _track[l];
+		if (!track->used || !track->stream || track->souStreamUsed || !track->soundDesc)
+			continue;
+
+		// Decode the data of the next two callbacks, so the callback itself
+		// finds it in the bundle block cache
+		int32 size = 2 * track->feedSize / _callbackFps;
+		int32 offset = track->regionOffset;
+		int region = track->curRegion;
+		if (region == -1) {
+			region = predictNextRegion(track);
+			offset = 0;
+		}
+		if (region == -1 || size <= 0)
+			continue;
+
+		if (_sound->getBits(track->soundDesc) == 12) {
+			offset = (offset * 3) / 4;
+			size = (size * 3) / 4;
+		}
+
+		int32 done = _sound->readAhead(track->soundDesc, region, offset, size);
+		if (done < size && track->trackId < MAX_DIGITAL_TRACKS && region == track->curRegion) {
+			region = predictNextRegion(track);
+			if (region != -1)
+				_sound->readAhead(track->soundDesc, region, 0, size - done);
+		}
+	}
+}
+
 } // End of namespace Scumm
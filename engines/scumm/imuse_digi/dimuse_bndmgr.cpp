@@ -150,6 +150,8 @@ BundleMgr::BundleMgr(BundleDirCache *cache) {
 	_fileBundleId = -1;
 	_file = new ScummFile();
 	_compInputBuff = NULL;
+	_blockCounter = 0;
+	flushBlockCache();
 }
 
 BundleMgr::~BundleMgr() {
@@ -194,8 +196,7 @@ bool BundleMgr::open(const char *filename, bool &compressed, bool errorFlag) {
 	_indexTable = _cache->getIndexTable(slot);
 	assert(_bundleTable);
 	_compTableLoaded = false;
-	_outputSize = 0;
-	_lastBlock = -1;
+	flushBlockCache();
 
 	return true;
 }
@@ -207,8 +208,7 @@ void BundleMgr::close() {
 		_numFiles = 0;
 		_numCompItems = 0;
 		_compTableLoaded = false;
-		_lastBlock = -1;
-		_outputSize = 0;
+		flushBlockCache();
 		_curSampleId = -1;
 		free(_compTable);
 		_compTable = NULL;
@@ -247,6 +247,62 @@ bool BundleMgr::loadCompTable(int32 index) {
 	return true;
 }
 
+void BundleMgr::flushBlockCache() {
+	for (int i = 0; i < NUM_CACHED_BLOCKS; i++) {
+		_blockCache[i].block = -1;
+		_blockCache[i].size = 0;
+		_blockCache[i].lastUsed = 0;
+	}
+}
+
+const BundleMgr::CachedBlock *BundleMgr::getBlock(int32 index, int32 block) {
+	CachedBlock *slot = &_blockCache[0];
+	for (int i = 0; i < NUM_CACHED_BLOCKS; i++) {
+		if (_blockCache[i].block == block) {
+			_blockCache[i].lastUsed = ++_blockCounter;
+			return &_blockCache[i];
+		}
+		if (_blockCache[i].lastUsed < slot->lastUsed)
+			slot = &_blockCache[i];
+	}
+
+	// CMI hack: one more zero byte at the end of input buffer
+	_compInputBuff[_compTable[block].size] = 0;
+	_file->seek(_bundleTable[index].offset + _compTable[block].offset, SEEK_SET);
+	_file->read(_compInputBuff, _compTable[block].size);
+	slot->size = BundleCodecs::decompressCodec(_compTable[block].codec, _compInputBuff, slot->data, _compTable[block].size);
+	if (slot->size > 0x2000) {
+		error("_outputSize: %d", slot->size);
+	}
+	slot->block = block;
+	slot->lastUsed = ++_blockCounter;
+	return slot;
+}
+
+void BundleMgr::getBlockRange(int32 offset, int32 size, int headerSize, int &firstBlock, int &lastBlock) {
+	firstBlock = (offset + headerSize) / 0x2000;
+	lastBlock = (offset + headerSize + size - 1) / 0x2000;
+
+	// Clip last_block by the total number of blocks (= "comp items")
+	if ((lastBlock >= _numCompItems) && (_numCompItems > 0))
+		lastBlock = _numCompItems - 1;
+}
+
+void BundleMgr::readAheadByCurIndex(int32 offset, int32 size, int headerSize) {
+	if (!_file->isOpen() || _curSampleId == -1 || !_compTableLoaded || size <= 0)
+		return;
+
+	int firstBlock, lastBlock;
+	getBlockRange(offset, size, headerSize, firstBlock, lastBlock);
+
+	// Leave room for the blocks which are being played right now
+	if (lastBlock - firstBlock >= NUM_CACHED_BLOCKS / 2)
+		lastBlock = firstBlock + NUM_CACHED_BLOCKS / 2 - 1;
+
+	for (int i = firstBlock; i <= lastBlock; i++)
+		getBlock(_curSampleId, i);
+}
+
 int32 BundleMgr::decompressSampleByCurIndex(int32 offset, int32 size, byte **compFinal, int headerSize, bool headerOutside) {
 	return decompressSampleByIndex(_curSampleId, offset, size, compFinal, headerSize, headerOutside);
 }
@@ -273,12 +329,7 @@ int32 BundleMgr::decompressSampleByIndex(int32 index, int32 offset, int32 size,
 			return 0;
 	}
 
-	firstBlock = (offset + headerSize) / 0x2000;
-	lastBlock = (offset + headerSize + size - 1) / 0x2000;
-
-	// Clip last_block by the total number of blocks (= "comp items")
-	if ((lastBlock >= _numCompItems) && (_numCompItems > 0))
-		lastBlock = _numCompItems - 1;
+	getBlockRange(offset, size, headerSize, firstBlock, lastBlock);
 
 	int32 blocksFinalSize = 0x2000 * (1 + lastBlock - firstBlock);
 	*compFinal = (byte *)malloc(blocksFinalSize);
@@ -288,19 +339,9 @@ int32 BundleMgr::decompressSampleByIndex(int32 index, int32 offset, int32 size,
 	skip = (offset + headerSize) % 0x2000;
 
 	for (i = firstBlock; i <= lastBlock; i++) {
-		if (_lastBlock != i) {
-			// CMI hack: one more zero byte at the end of input buffer
-			_compInputBuff[_compTable[i].size] = 0;
-			_file->seek(_bundleTable[index].offset + _compTable[i].offset, SEEK_SET);
-			_file->read(_compInputBuff, _compTable[i].size);
-			_outputSize = BundleCodecs::decompressCodec(_compTable[i].codec, _compInputBuff, _compOutputBuff, _compTable[i].size);
-			if (_outputSize > 0x2000) {
-				error("_outputSize: %d", _outputSize);
-			}
-			_lastBlock = i;
-		}
+		const CachedBlock *block = getBlock(index, i);
 
-		outputSize = _outputSize;
+		outputSize = block->size;
 
 		if (headerOutside) {
 			outputSize -= skip;
@@ -317,7 +358,7 @@ int32 BundleMgr::decompressSampleByIndex(int32 index, int32 offset, int32 size,
 
 		assert(finalSize + outputSize <= blocksFinalSize);
 
-		memcpy(*compFinal + finalSize, _compOutputBuff + skip, outputSize);
+		memcpy(*compFinal + finalSize, block->data + skip, outputSize);
 		finalSize += outputSize;
 
 		size -= outputSize;
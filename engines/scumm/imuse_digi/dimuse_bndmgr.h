@@ -76,6 +76,20 @@ private:
 		int32 codec;
 	};
 
+	enum {
+		NUM_CACHED_BLOCKS = 8
+	};
+
+	// Decompressed blocks are kept around, since region jumps make the
+	// music go back to blocks which have been played before. Blocks which
+	// are about to be played get decompressed in advance by readAhead().
+	struct CachedBlock {
+		int32 block;		// number of the block, -1 if the slot is unused
+		int32 size;			// decompressed size
+		uint32 lastUsed;
+		byte data[0x2000];
+	};
+
 	BundleDirCache *_cache;
 	BundleDirCache::AudioTable *_bundleTable;
 	BundleDirCache::IndexNode *_indexTable;
@@ -87,12 +101,14 @@ private:
 	BaseScummFile *_file;
 	bool _compTableLoaded;
 	int _fileBundleId;
-	byte _compOutputBuff[0x2000];
 	byte *_compInputBuff;
-	int _outputSize;
-	int _lastBlock;
+	CachedBlock _blockCache[NUM_CACHED_BLOCKS];
+	uint32 _blockCounter;
 
 	bool loadCompTable(int32 index);
+	void flushBlockCache();
+	const CachedBlock *getBlock(int32 index, int32 block);
+	void getBlockRange(int32 offset, int32 size, int headerSize, int &firstBlock, int &lastBlock);
 
 public:
 
@@ -105,6 +121,7 @@ public:
 	int32 decompressSampleByName(const char *name, int32 offset, int32 size, byte **compFinal, bool headerOutside);
 	int32 decompressSampleByIndex(int32 index, int32 offset, int32 size, byte **compFinal, int header_size, bool headerOutside);
 	int32 decompressSampleByCurIndex(int32 offset, int32 size, byte **compFinal, int headerSize, bool headerOutside);
+	void readAheadByCurIndex(int32 offset, int32 size, int headerSize);
 };
 
 namespace BundleCodecs {
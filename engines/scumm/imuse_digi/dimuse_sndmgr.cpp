@@ -731,4 +731,26 @@ int32 ImuseDigiSndMgr::getDataFromRegion(SoundDesc *soundDesc, int region, byte
 	return size;
 }
 
+int32 ImuseDigiSndMgr::readAhead(SoundDesc *soundDesc, int region, int32 offset, int32 size) {
+	debug(6, "readAhead() region:%d, offset:%d, size:%d", region, offset, size);
+	assert(checkForProperHandle(soundDesc));
+	assert(offset >= 0 && size >= 0);
+	assert(region >= 0 && region < soundDesc->numRegions);
+
+	int32 region_offset = soundDesc->region[region].offset;
+	int32 region_length = soundDesc->region[region].length;
+	int32 offset_data = soundDesc->offsetData;
+	int32 start = region_offset - offset_data;
+
+	if (offset + size + offset_data > region_length)
+		size = region_length - offset_data - offset;
+	if (size <= 0)
+		return 0;
+
+	if ((soundDesc->bundle) && (!soundDesc->compressed))
+		soundDesc->bundle->readAheadByCurIndex(start + offset, size, soundDesc->offsetData);
+
+	return size;
+}
+
 } // End of namespace Scumm
@@ -149,6 +149,13 @@ public:
 	void getSyncSizeAndPtrById(SoundDesc *soundDesc, int number, int32 &sync_size, byte **sync_ptr);
 
 	int32 getDataFromRegion(SoundDesc *soundDesc, int region, byte **buf, int32 offset, int32 size);
+
+	/**
+	 * Decompresses the bundle blocks of a region ahead of getDataFromRegion(),
+	 * so that the mixer callback finds them already decoded.
+	 * @return the number of bytes of the region covered by the range
+	 */
+	int32 readAhead(SoundDesc *soundDesc, int region, int32 offset, int32 size);
 };
 
 } // End of namespace Scumm
@@ -28,6 +28,8 @@
 #include "common/config-manager.h"
 #endif
 
+#include "scumm/base-costume.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/dialogs.h"
 #include "scumm/file.h"
@@ -50,7 +52,8 @@ enum {
 	RF_USAGE = 0x7F,
 	RF_USAGE_MAX = RF_USAGE,
 
-	RS_MODIFIED = 0x10
+	RS_MODIFIED = 0x10,
+	RS_EXPIRED = 0x20
 };
 
 
@@ -537,6 +540,7 @@ void ResourceManager::allocResTypeData(int id, uint32 tag, int num_, const char
 	address[id] = (byte **)calloc(num_, sizeof(void *));
 	flags[id] = (byte *)calloc(num_, sizeof(byte));
 	status[id] = (byte *)calloc(num_, sizeof(byte));
+	usage[id] = (ResUsage *)calloc(num_, sizeof(ResUsage));
 
 	if (mode_) {
 		roomno[id] = (byte *)calloc(num_, sizeof(byte));
@@ -767,22 +771,65 @@ void ResourceManager::increaseExpireCounter() {
 }
 
 void ResourceManager::increaseResourceCounter() {
-	int i, j;
-	byte counter;
+	// Resources used from now on are younger than all the others; those
+	// used before can be expired
+	_generation++;
+}
 
-	for (i = rtFirst; i <= rtLast; i++) {
-		for (j = num[i]; --j >= 0;) {
-			counter = flags[i][j] & RF_USAGE;
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(i, j, counter + 1);
-			}
-		}
+void ResourceManager::setResourceCounter(int type, int idx, byte flag) {
+	if (!usage[type][idx].linked)
+		return;
+
+	unlinkUsage(type, idx);
+	if (flag >= RF_USAGE_MAX) {
+		// Scripts mark resources they don't need anymore, these go first
+		ResUsage &u = usage[type][idx];
+		const uint32 key = (type << 16) | idx;
+
+		u.prev = _lruTail;
+		u.next = 0;
+		u.generation = 0;
+		u.linked = true;
+		if (_lruTail)
+			usage[_lruTail >> 16][_lruTail & 0xFFFF].next = key;
+		else
+			_mruHead = key;
+		_lruTail = key;
+	} else {
+		linkUsage(type, idx);
 	}
 }
 
-void ResourceManager::setResourceCounter(int type, int idx, byte flag) {
-	flags[type][idx] &= ~RF_USAGE;
-	flags[type][idx] |= flag;
+void ResourceManager::linkUsage(int type, int idx) {
+	ResUsage &u = usage[type][idx];
+	const uint32 key = (type << 16) | idx;
+
+	u.prev = 0;
+	u.next = _mruHead;
+	u.generation = _generation;
+	u.linked = true;
+	if (_mruHead)
+		usage[_mruHead >> 16][_mruHead & 0xFFFF].prev = key;
+	else
+		_lruTail = key;
+	_mruHead = key;
+}
+
+void ResourceManager::unlinkUsage(int type, int idx) {
+	ResUsage &u = usage[type][idx];
+	if (!u.linked)
+		return;
+
+	if (u.prev)
+		usage[u.prev >> 16][u.prev & 0xFFFF].next = u.next;
+	else
+		_mruHead = u.next;
+	if (u.next)
+		usage[u.next >> 16][u.next & 0xFFFF].prev = u.prev;
+	else
+		_lruTail = u.prev;
+	u.prev = u.next = 0;
+	u.linked = false;
 }
 
 /* 2 bytes safety area to make "precaching" of bytes in the gdi drawer easier */
@@ -816,7 +863,20 @@ byte *ResourceManager::createResource(int type, int idx, uint32 size) {
 
 	address[type][idx] = (byte *)ptr;
 	((MemBlkHeader *)ptr)->size = size;
-	setResourceCounter(type, idx, 1);
+
+	// Only resources which can be loaded again are expired
+	if (mode[type]) {
+		linkUsage(type, idx);
+
+		_stats.loads++;
+		_stats.loadedBytes += size;
+		if (status[type][idx] & RS_EXPIRED) {
+			status[type][idx] &= ~RS_EXPIRED;
+			_stats.reloads++;
+			_stats.reloadedBytes += size;
+		}
+	}
+
 	return (byte *)ptr + sizeof(MemBlkHeader);	/* skip header */
 }
 
@@ -824,6 +884,7 @@ ResourceManager::ResourceManager(ScummEngine *vm) {
 	memset(this, 0, sizeof(ResourceManager));
 	_vm = vm;
 //	_allocatedSize = 0;
+	_generation = 1;
 }
 
 ResourceManager::~ResourceManager() {
@@ -856,6 +917,8 @@ void ResourceManager::nukeResource(int type, int idx) {
 	ptr = address[type][idx];
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", resTypeFromId(type), idx);
+		_vm->resourceChanged(type, idx);
+		unlinkUsage(type, idx);
 		address[type][idx] = 0;
 		flags[type][idx] = 0;
 		status[type][idx] &= ~RS_MODIFIED;
@@ -907,6 +970,15 @@ bool ResourceManager::isLocked(int type, int i) const {
 	return (flags[type][i] & RF_LOCK) != 0;
 }
 
+void ScummEngine::resourceChanged(int type, int i) {
+	if (type == rtMatrix)
+		_boxCache->clear();
+	else if (type == rtCostume && _costumeRenderer)
+		_costumeRenderer->flushCelCache();
+	else if ((type == rtRoom || type == rtRoomImage) && _gdi)
+		_gdi->flushStripCache();
+}
+
 bool ScummEngine::isResourceInUse(int type, int i) const {
 	if (!_res->validateResource("isResourceInUse", type, i))
 		return false;
@@ -942,6 +1014,7 @@ void ResourceManager::setModified(int type, int i) {
 	if (!validateResource("Modified", type, i))
 		return;
 	status[type][i] |= RS_MODIFIED;
+	_vm->resourceChanged(type, i);
 }
 
 bool ResourceManager::isModified(int type, int i) const {
@@ -951,10 +1024,6 @@ bool ResourceManager::isModified(int type, int i) const {
 }
 
 void ResourceManager::expireResources(uint32 size) {
-	int i, j;
-	byte flag;
-	byte best_counter;
-	int best_type, best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -967,32 +1036,35 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = 0;
-		best_counter = 2;
-
-		for (i = rtFirst; i <= rtLast; i++)
-			if (mode[i]) {
-				for (j = num[i]; --j >= 0;) {
-					flag = flags[i][j];
-					if (!(flag & RF_LOCK) && flag >= best_counter && address[i][j] && !_vm->isResourceInUse(i, j)) {
-						best_counter = flag;
-						best_type = i;
-						best_res = j;
-					}
-				}
-			}
-
-		if (!best_type)
-			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+	// Expire the least recently used resources until the heap is back
+	// down to the lower threshold, so that the next resources fit without
+	// expiring again. Resources used since the last
+	// increaseResourceCounter() call are kept, their pointers may still be
+	// in use.
+	uint32 key = _lruTail;
+	while (key && size + _allocatedSize > _minHeapThreshold) {
+		const int type = key >> 16;
+		const int idx = key & 0xFFFF;
+		key = usage[type][idx].prev;
+
+		if ((flags[type][idx] & RF_LOCK) || usage[type][idx].generation == _generation || _vm->isResourceInUse(type, idx))
+			continue;
+
+		_stats.expired++;
+		_stats.expiredBytes += ((MemBlkHeader *)address[type][idx])->size;
+		nukeResource(type, idx);
+		status[type][idx] |= RS_EXPIRED;
+	}
 
 	increaseResourceCounter();
 
 	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
 }
 
+void ResourceManager::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
 void ResourceManager::freeResources() {
 	int i, j;
 	for (i = rtFirst; i <= rtLast; i++) {
@@ -1003,6 +1075,7 @@ void ResourceManager::freeResources() {
 		free(address[i]);
 		free(flags[i]);
 		free(status[i]);
+		free(usage[i]);
 		free(roomno[i]);
 		free(roomoffs[i]);
 
@@ -39,6 +39,7 @@
 #include "graphics/cursorman.h"
 
 #include "scumm/akos.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/costume.h"
 #include "scumm/debugger.h"
@@ -132,6 +133,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_gdi = new Gdi(this);
 	}
 	_res = new ResourceManager(this);
+	_boxCache = new BoxCache();
 
 	// Convert MD5 checksum back into a digest
 	for (int i = 0; i < 16; ++i) {
@@ -609,6 +611,7 @@ ScummEngine::~ScummEngine() {
 
 	delete _costumeLoader;
 	delete _costumeRenderer;
+	_costumeRenderer = NULL;	// resources are freed later on, see resourceChanged()
 
 	_textSurface.free();
 
@@ -643,6 +646,7 @@ ScummEngine::~ScummEngine() {
 	delete _debugger;
 
 	delete _res;
+	delete _boxCache;
 	delete _gdi;
 }
 
@@ -1282,7 +1286,11 @@ void ScummEngine::setupScumm() {
 		maxHeapThreshold = 550000;
 	}
 
-	_res->setHeapThreshold(400000, maxHeapThreshold);
+	// Allow the user to trade memory for fewer reloads from the data files
+	if (ConfMan.hasKey("scumm_heap_size"))
+		maxHeapThreshold = MAX(ConfMan.getInt("scumm_heap_size"), 256) * 1024;
+
+	_res->setHeapThreshold(MIN(400000, maxHeapThreshold), maxHeapThreshold);
 
 	free(_compositeBuf);
 	_compositeBuf = (byte *)malloc(_screenWidth * _textSurfaceMultiplier * _screenHeight * _textSurfaceMultiplier * _bytesPerPixelOutput);
@@ -2397,6 +2405,7 @@ void ScummEngine_v7::scummLoop_handleSound() {
 		// In CoMI and the Dig the full (non-demo) version invoke IMuseDigital::refreshScripts
 		if ((_game.id == GID_DIG || _game.id == GID_CMI) && !(_game.features & GF_DEMO))
 			_imuseDigital->refreshScripts();
+		_imuseDigital->readAheadTracks();
 	}
 	if (_smixer) {
 		_smixer->flush();
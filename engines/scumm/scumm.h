@@ -93,6 +93,8 @@ class Serializer;
 class Sound;
 
 struct Box;
+struct BoxCache;
+struct BoxGate;
 struct BoxCoords;
 struct FindObjectInRoom;
 
@@ -367,6 +369,15 @@ enum {
 	RES_INVALID_OFFSET = 0xFFFFFFFF
 };
 
+/**
+ * Loading and expiry statistics of the resource heap, for the debugger.
+ */
+struct ResourceStats {
+	uint32 loads, loadedBytes;
+	uint32 reloads, reloadedBytes;
+	uint32 expired, expiredBytes;
+};
+
 /**
  * The 'resource manager' class. Currently doesn't really deserve to be called
  * a 'class', at least until somebody gets around to OOfying this more.
@@ -377,6 +388,17 @@ class ResourceManager {
 protected:
 	ScummEngine *_vm;
 
+	/**
+	 * Position of a loaded resource in the list of resources which can be
+	 * expired, ordered from the most to the least recently used one. The
+	 * links are encoded as type << 16 | index.
+	 */
+	struct ResUsage {
+		uint32 prev, next;
+		uint32 generation;	///< value of _generation when last used, 0 to expire first
+		bool linked;
+	};
+
 public:
 	byte mode[rtNumTypes];
 	uint16 num[rtNumTypes];
@@ -386,6 +408,7 @@ public:
 protected:
 	byte *flags[rtNumTypes];
 	byte *status[rtNumTypes];
+	ResUsage *usage[rtNumTypes];
 public:
 	byte *roomno[rtNumTypes];
 	uint32 *roomoffs[rtNumTypes];
@@ -396,11 +419,17 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	uint32 _generation;
+	uint32 _mruHead, _lruTail;
+	ResourceStats _stats;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
+	uint32 getHeapThreshold() const { return _maxHeapThreshold; }
+	uint32 getAllocatedSize() const { return _allocatedSize; }
 
 	void allocResTypeData(int id, uint32 tag, int num, const char *name, int mode);
 	void freeResources();
@@ -422,11 +451,16 @@ public:
 	void increaseResourceCounter();
 
 	void resourceStats();
+	const ResourceStats &getStats() const { return _stats; }
+	void resetStats();
 
 //protected:
 	bool validateResource(const char *str, int type, int index) const;
 protected:
 	void expireResources(uint32 size);
+
+	void linkUsage(int type, int idx);
+	void unlinkUsage(int type, int idx);
 };
 
 /**
@@ -823,6 +857,9 @@ protected:
 	int readSoundResourceSmallHeader(int index);
 	bool isResourceInUse(int type, int i) const;
 
+	/** Called when a resource is freed or its data is modified. */
+	virtual void resourceChanged(int type, int i);
+
 	virtual void setupRoomSubBlocks();
 	virtual void resetRoomSubBlocks();
 
@@ -1189,6 +1226,7 @@ public:
 	bool checkXYInBoxBounds(int box, int x, int y);
 
 	BoxCoords getBoxCoordinates(int boxnum);
+	BoxGate getBoxGate(int box1, int box2);
 
 	byte getMaskFromBox(int box);
 	Box *getBoxBaseAddr(int box);
@@ -1213,6 +1251,10 @@ protected:
 	void createBoxMatrix();
 	virtual bool areBoxesNeighbours(int i, int j);
 
+	BoxCache *_boxCache;
+	BoxCoords readBoxCoordinates(int boxnum);
+	void buildNextBoxTable();
+
 	/* String class */
 public:
 	CharsetRenderer *_charset;
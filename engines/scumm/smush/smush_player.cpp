@@ -27,6 +27,7 @@
 
 #include "common/config-manager.h"
 #include "common/file.h"
+#include "common/memstream.h"
 #include "common/system.h"
 #include "common/util.h"
 
@@ -243,6 +244,14 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm) {
 	_paused = false;
 	_pauseStartTime = 0;
 	_pauseTime = 0;
+
+	for (int i = 0; i < kPrefetchFrames; i++) {
+		_prefetch[i].chunk = NULL;
+		_prefetch[i].pixels = NULL;
+	}
+	_prefetchHead = 0;
+	_prefetchCount = 0;
+	_decodedFrame = NULL;
 }
 
 SmushPlayer::~SmushPlayer() {
@@ -289,6 +298,12 @@ void SmushPlayer::release() {
 	delete _strings;
 	_strings = NULL;
 
+	flushPrefetch();
+	for (int i = 0; i < kPrefetchFrames; i++) {
+		free(_prefetch[i].pixels);
+		_prefetch[i].pixels = NULL;
+	}
+
 	delete _base;
 	_base = NULL;
 
@@ -745,34 +760,43 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		_height = _vm->_screenHeight;
 	}
 
+	if (_decodedFrame) {
+		// Decoded by prefetchFrame(), the codec state already includes it
+		memcpy(_dst, _decodedFrame, width * height);
+	} else {
+		decodeCodec(_dst, codec, src, left, top, width, height);
+	}
+
+	if (_storeFrame) {
+		if (_frameBuffer == NULL) {
+			_frameBuffer = (byte *)malloc(_width * _height);
+		}
+		memcpy(_frameBuffer, _dst, _width * _height);
+		_storeFrame = false;
+	}
+}
+
+void SmushPlayer::decodeCodec(byte *dst, int codec, const uint8 *src, int left, int top, int width, int height) {
 	switch (codec) {
 	case 1:
 	case 3:
-		smush_decode_codec1(_dst, src, left, top, width, height, _vm->_screenWidth);
+		smush_decode_codec1(dst, src, left, top, width, height, _vm->_screenWidth);
 		break;
 	case 37:
 		if (!_codec37)
 			_codec37 = new Codec37Decoder(width, height);
 		if (_codec37)
-			_codec37->decode(_dst, src);
+			_codec37->decode(dst, src);
 		break;
 	case 47:
 		if (!_codec47)
 			_codec47 = new Codec47Decoder(width, height);
 		if (_codec47)
-			_codec47->decode(_dst, src);
+			_codec47->decode(dst, src);
 		break;
 	default:
 		error("Invalid codec for frame object : %d", codec);
 	}
-
-	if (_storeFrame) {
-		if (_frameBuffer == NULL) {
-			_frameBuffer = (byte *)malloc(_width * _height);
-		}
-		memcpy(_frameBuffer, _dst, _width * _height);
-		_storeFrame = false;
-	}
 }
 
 #ifdef USE_ZLIB
@@ -813,6 +837,9 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 		return;
 	}
 
+	if (_prefetchCount > 0 && _prefetch[_prefetchHead].fobjOffset == b.pos())
+		_decodedFrame = _prefetch[_prefetchHead].pixels;
+
 	int codec = b.readUint16LE();
 	int left = b.readUint16LE();
 	int top = b.readUint16LE();
@@ -822,6 +849,12 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	b.readUint16LE();
 	b.readUint16LE();
 
+	if (_decodedFrame) {
+		decodeFrameObject(codec, NULL, left, top, width, height);
+		_decodedFrame = NULL;
+		return;
+	}
+
 	int32 chunk_size = subSize - 14;
 	byte *chunk_buffer = (byte *)malloc(chunk_size);
 	assert(chunk_buffer);
@@ -1006,6 +1039,7 @@ void SmushPlayer::parseNextFrame() {
 			_skipPalette = true;
 		}
 
+		flushPrefetch();
 		_base->seek(_seekPos + 8, SEEK_SET);
 		_frame = _seekFrame;
 		_startFrame = _frame;
@@ -1016,6 +1050,22 @@ void SmushPlayer::parseNextFrame() {
 
 	assert(_base);
 
+	if (_prefetchCount > 0) {
+		PrefetchedFrame &pf = _prefetch[_prefetchHead];
+		Common::MemoryReadStream b(pf.chunk, pf.size);
+
+		debug(3, "Chunk: FRME (prefetched, %s)", pf.fobjOffset != -1 ? "decoded" : "not decoded");
+		handleFrame(pf.size, b);
+
+		free(pf.chunk);
+		pf.chunk = NULL;
+		_prefetchHead = (_prefetchHead + 1) % kPrefetchFrames;
+		_prefetchCount--;
+
+		_vm->_imuseDigital->flushTracks();
+		return;
+	}
+
 	const uint32 subType = _base->readUint32BE();
 	const int32 subSize = _base->readUint32BE();
 	const int32 subOffset = _base->pos();
@@ -1047,6 +1097,91 @@ void SmushPlayer::parseNextFrame() {
 	_vm->_imuseDigital->flushTracks();
 }
 
+void SmushPlayer::prefetchFrame() {
+	// Frames are read ahead in file order, and frame objects are only decoded
+	// ahead as long as no earlier frame object is left to decode, so that the
+	// codecs see the same sequence of frames as without prefetching. The
+	// other chunks, audio included, are still handled when the frame is shown.
+	if (_insanity || _seekPos >= 0 || !_base || _prefetchCount == kPrefetchFrames)
+		return;
+	if (_prefetchCount > 0 && _prefetch[(_prefetchHead + _prefetchCount - 1) % kPrefetchFrames].undecoded)
+		return;
+
+	const int32 start = _base->pos();
+	const uint32 subType = _base->readUint32BE();
+	const int32 subSize = _base->readUint32BE();
+
+	if (_base->pos() >= (int32)_baseSize || subType != MKID_BE('FRME') || subSize < 0) {
+		_base->seek(start, SEEK_SET);
+		return;
+	}
+
+	PrefetchedFrame &pf = _prefetch[(_prefetchHead + _prefetchCount) % kPrefetchFrames];
+	pf.chunk = (byte *)malloc(subSize);
+	assert(pf.chunk);
+	pf.size = _base->read(pf.chunk, subSize);
+	pf.fobjOffset = -1;
+	pf.undecoded = false;
+	_base->seek(start + 8 + subSize, SEEK_SET);
+	_prefetchCount++;
+
+	// Look for the frame objects, the same way handleFrame() walks the chunk
+	int numObjects = 0;
+	int32 fobjOffset = -1, fobjSize = 0;
+	int32 pos = 0;
+	while (pos + 8 <= pf.size) {
+		const uint32 type = READ_BE_UINT32(pf.chunk + pos);
+		const int32 size = READ_BE_UINT32(pf.chunk + pos + 4);
+		if (size < 0)
+			break;
+		if (type == MKID_BE('FOBJ') || type == MKID_BE('ZFOB')) {
+			numObjects++;
+			if (type == MKID_BE('FOBJ')) {
+				fobjOffset = pos + 8;
+				fobjSize = size;
+			}
+		}
+		pos += 8 + size + (size & 1);
+	}
+
+	if (numObjects == 0)
+		return;
+	pf.undecoded = true;
+	if (numObjects != 1 || fobjOffset == -1 || fobjSize < 14 || fobjOffset + fobjSize > pf.size)
+		return;
+
+	const byte *fobj = pf.chunk + fobjOffset;
+	const int codec = READ_LE_UINT16(fobj);
+	const int left = READ_LE_UINT16(fobj + 2);
+	const int top = READ_LE_UINT16(fobj + 4);
+	const int width = READ_LE_UINT16(fobj + 6);
+	const int height = READ_LE_UINT16(fobj + 8);
+
+	// Only frame objects which overwrite the whole screen can be decoded
+	// into a separate buffer
+	if ((codec != 37 && codec != 47) || width != _vm->_screenWidth || height != _vm->_screenHeight)
+		return;
+	if ((codec == 37 && _codec37 && _codec37->getFrameSize() != width * height) ||
+		(codec == 47 && _codec47 && _codec47->getFrameSize() != width * height))
+		return;
+
+	if (!pf.pixels)
+		pf.pixels = (byte *)malloc(_vm->_screenWidth * _vm->_screenHeight);
+	decodeCodec(pf.pixels, codec, fobj + 14, left, top, width, height);
+	pf.fobjOffset = fobjOffset;
+	pf.undecoded = false;
+}
+
+void SmushPlayer::flushPrefetch() {
+	while (_prefetchCount > 0) {
+		free(_prefetch[_prefetchHead].chunk);
+		_prefetch[_prefetchHead].chunk = NULL;
+		_prefetchHead = (_prefetchHead + 1) % kPrefetchFrames;
+		_prefetchCount--;
+	}
+	_prefetchHead = 0;
+}
+
 void SmushPlayer::setPalette(const byte *palette) {
 	memcpy(_pal, palette, 0x300);
 	setDirtyColors(0, 255);
@@ -1206,6 +1341,9 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			else
 				skipFrame = false;
 			timerCallback();
+		} else {
+			// The next frame isn't due yet, use the time to prepare it
+			prefetchFrame();
 		}
 
 		_vm->scummLoop_handleSound();
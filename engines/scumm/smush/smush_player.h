@@ -41,6 +41,23 @@ class Codec47Decoder;
 class SmushPlayer {
 	friend class Insane;
 private:
+	enum {
+		kPrefetchFrames = 3
+	};
+
+	/**
+	 * A FRME chunk read ahead of its presentation time. If it holds a
+	 * single full screen codec 37/47 frame object, that object is
+	 * decoded ahead as well.
+	 */
+	struct PrefetchedFrame {
+		byte *chunk;
+		int32 size;
+		int32 fobjOffset;	///< position of the decoded frame object in the chunk, or -1
+		bool undecoded;		///< true if it contains frame objects left to decode
+		byte *pixels;
+	};
+
 	ScummEngine_v7 *_vm;
 	int32 _nbframes;
 	SmushMixer *_smixer;
@@ -85,6 +102,10 @@ private:
 	bool _middleAudio;
 	bool _skipPalette;
 
+	PrefetchedFrame _prefetch[kPrefetchFrames];
+	int _prefetchHead, _prefetchCount;
+	const byte *_decodedFrame;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm);
 	~SmushPlayer();
@@ -114,6 +135,8 @@ protected:
 private:
 	SmushFont *getFont(int font);
 	void parseNextFrame();
+	void prefetchFrame();
+	void flushPrefetch();
 	void init(int32 spped);
 	void setupAnim(const char *file);
 	void updateScreen();
@@ -121,6 +144,7 @@ private:
 
 	bool readString(const char *file);
 	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height);
+	void decodeCodec(byte *dst, int codec, const uint8 *src, int left, int top, int width, int height);
 	void handleAnimHeader(int32 subSize, Common::SeekableReadStream &);
 	void handleFrame(int32 frameSize, Common::SeekableReadStream &);
 	void handleNewPalette(int32 subSize, Common::SeekableReadStream &);
@@ -93,6 +93,7 @@ protected:
 	Audio::AudioStream *_bgSoundStream;
 
 	bool playVideo();
+	uint32 copyFrameToScreen(const Graphics::Surface *frame, uint16 x, uint16 y);
 	void performPostProcessing(byte *screen);
 
 	byte findBlackPalIndex();
@@ -280,8 +280,10 @@ bool MoviePlayer::playVideo() {
 	while (!_vm->shouldQuit() && !_decoder->endOfVideo()) {
 		if (_decoder->needsUpdate()) {
 			const Graphics::Surface *frame = _decoder->decodeNextFrame();
-			if (frame)
-				_vm->_system->copyRectToScreen((byte *)frame->pixels, frame->pitch, x, y, frame->w, frame->h);
+			if (frame) {
+				uint32 bytesCopied = copyFrameToScreen(frame, x, y);
+				debug(9, "MoviePlayer: Copied %d bytes of frame %d", bytesCopied, _decoder->getCurFrame());
+			}
 
 			if (_decoder->hasDirtyPalette()) {
 				_decoder->setSystemPalette();
@@ -329,6 +331,36 @@ bool MoviePlayer::playVideo() {
 	return !_vm->shouldQuit();
 }
 
+uint32 MoviePlayer::copyFrameToScreen(const Graphics::Surface *frame, uint16 x, uint16 y) {
+	Common::List<Common::Rect> rects;
+
+	if (_decoder->hasDirtyRects()) {
+		rects = _decoder->getDirtyRects();
+
+		// Restore the frame beneath the subtitles, in case they are removed
+		if (_textSurface) {
+			const SpriteInfo &textSprite = _movieTexts[_currentMovieText]._textSprite;
+			int16 textHeight = Sword2Engine::isPsx() ? textSprite.h * 2 : textSprite.h;
+
+			Common::Rect textRect(_textX - x, _textY - y, _textX - x + textSprite.w, _textY - y + textHeight);
+			textRect.clip(frame->w, frame->h);
+			if (!textRect.isEmpty())
+				rects.push_back(textRect);
+		}
+	} else {
+		rects.push_back(Common::Rect(frame->w, frame->h));
+	}
+
+	uint32 bytesCopied = 0;
+
+	for (Common::List<Common::Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it) {
+		_vm->_system->copyRectToScreen((const byte *)frame->getBasePtr(it->left, it->top), frame->pitch, x + it->left, y + it->top, it->width(), it->height());
+		bytesCopied += it->width() * it->height() * frame->bytesPerPixel;
+	}
+
+	return bytesCopied;
+}
+
 byte MoviePlayer::findBlackPalIndex() {
 	return _black;
 }
@@ -361,6 +393,8 @@ MoviePlayer *makeMoviePlayer(const char *name, Sword2Engine *vm, Audio::Mixer *s
 
 	if (Common::File::exists(filename)) {
 		Video::SmackerDecoder *smkDecoder = new Video::SmackerDecoder(snd);
+		// The cutscenes are files of their own, nothing else reads them
+		smkDecoder->setBackgroundReading(true);
 		return new MoviePlayer(vm, snd, system, bgSoundHandle, smkDecoder, kVideoDecoderSMK);
 	}
 
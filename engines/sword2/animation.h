@@ -98,6 +98,7 @@ protected:
 
 	void performPostProcessing(byte *screen);
 	bool playVideo();
+	uint32 copyFrameToScreen(const Graphics::Surface *frame, uint16 x, uint16 y);
 
 	void openTextObject(uint32 index);
 	void closeTextObject(uint32 index, byte *screen);
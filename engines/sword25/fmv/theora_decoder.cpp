@@ -40,7 +40,7 @@
 
 #ifdef USE_THEORADEC
 #include "common/system.h"
-#include "graphics/conversion.h"
+#include "graphics/yuv_to_rgb.h"
 #include "sound/decoders/raw.h"
 #include "sword25/kernel/common.h"
 
@@ -431,7 +431,7 @@ const Graphics::Surface *TheoraDecoder::decodeNextFrame() {
 		th_decode_ycbcr_out(_theoraDecode, yuv);
 
 		// Convert YUV data to RGB data
-		translateYUVtoRGBA(yuv, _theoraInfo, (byte *)_surface->getBasePtr(0, 0), _surface->pitch * _surface->h);
+		translateYUVtoRGBA(yuv);
 		
 		_videobufReady = false;
 	}
@@ -486,8 +486,7 @@ Audio::QueuingAudioStream *TheoraDecoder::createAudioStream() {
 	return Audio::makeQueuingAudioStream(_vorbisInfo.rate, _vorbisInfo.channels);
 }
 
-	void TheoraDecoder::translateYUVtoRGBA(th_ycbcr_buffer &YUVBuffer, const th_info &theoraInfo, byte *pixelData, int pixelsSize) {
-
+void TheoraDecoder::translateYUVtoRGBA(th_ycbcr_buffer &YUVBuffer) {
 	// Width and height of all buffers have to be divisible by 2.
 	assert((YUVBuffer[0].width & 1)   == 0);
 	assert((YUVBuffer[0].height & 1)  == 0);
@@ -499,45 +498,19 @@ Audio::QueuingAudioStream *TheoraDecoder::createAudioStream() {
 	assert(YUVBuffer[2].width  == YUVBuffer[0].width >> 1);
 	assert(YUVBuffer[1].height == YUVBuffer[0].height >> 1);
 	assert(YUVBuffer[2].height == YUVBuffer[0].height >> 1);
+	assert(YUVBuffer[1].stride == YUVBuffer[2].stride);
 
-	const byte *ySrc0 = YUVBuffer[0].data;
-	const byte *ySrc1 = YUVBuffer[0].data + YUVBuffer[0].stride;
-	const byte *uSrc  = YUVBuffer[1].data;
-	const byte *vSrc  = YUVBuffer[2].data;
-	byte *dst0  = &pixelData[0];
-	byte *dst1  = &pixelData[0] + (YUVBuffer[0].width << 2);
-
-	for (int h = 0; h < YUVBuffer[0].height / 2; ++h) {
-		for (int w = 0; w < YUVBuffer[0].width / 2; ++w) {
-			byte r, g, b;
-			int u = *uSrc++;
-			int v = *vSrc++;
-			int y;
-
-			for (int i = 0; i < 2; i++) {
-				y = *ySrc0++;		
-				Graphics::YUV2RGB(y, u, v, r, g, b);
-				*dst0++ = b;
-				*dst0++ = g;
-				*dst0++ = r;
-				*dst0++ = 255;
-
-				y = *ySrc1++;
-				Graphics::YUV2RGB(y, u, v, r, g, b);
-				*dst1++ = b;
-				*dst1++ = g;
-				*dst1++ = r;
-				*dst1++ = 255;
-			}
-		}
+	// The frames are stored as B, G, R, A bytes
+#ifdef SCUMM_BIG_ENDIAN
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 8, 16, 24, 0);
+#else
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+#endif
 
-		dst0  += YUVBuffer[0].width << 2;
-		dst1  += YUVBuffer[0].width << 2;
-		ySrc0 += (YUVBuffer[0].stride << 1) - YUVBuffer[0].width;
-		ySrc1 += (YUVBuffer[0].stride << 1) - YUVBuffer[0].width;
-		uSrc  += YUVBuffer[1].stride - YUVBuffer[1].width;
-		vSrc  += YUVBuffer[2].stride - YUVBuffer[2].width;
-	}
+	Graphics::convertYUV420ToRGB((byte *)_surface->pixels, _surface->pitch, format,
+			YUVBuffer[0].data, YUVBuffer[1].data, YUVBuffer[2].data,
+			MIN<int>(YUVBuffer[0].width, _surface->w), MIN<int>(YUVBuffer[0].height, _surface->h),
+			YUVBuffer[0].stride, YUVBuffer[1].stride);
 }
 
 } // End of namespace Sword25
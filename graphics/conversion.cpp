@@ -26,8 +26,6 @@
 
 namespace Graphics {
 
-// TODO: YUV to RGB conversion function
-
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src, int dstpitch, int srcpitch,
 						int w, int h, const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
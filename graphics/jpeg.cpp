@@ -23,9 +23,9 @@
  *
  */
 
-#include "graphics/conversion.h"
 #include "graphics/jpeg.h"
 #include "graphics/pixelformat.h"
+#include "graphics/yuv_to_rgb.h"
 
 #include "common/endian.h"
 #include "common/util.h"
@@ -33,6 +33,11 @@
 
 namespace Graphics {
 
+// Precision of the fixed point IDCT basis
+#define IDCT_CONST_BITS 13
+// Extra precision kept between the row and column passes of the IDCT
+#define IDCT_PASS1_BITS 2
+
 // Order used to traverse the quantization tables
 static const uint8 _zigZagOrder[64] = {
 	0,   1,  8, 16,  9,  2,  3, 10,
@@ -61,13 +66,15 @@ JPEG::JPEG() :
 		_huff[i].codes = NULL;
 	}
 
-	// Initialize sqrt_2 and cosine lookups
-	_sqrt_2 = sqrt(2.0f);
-	debug(2, "JPEG: _sqrt_2: %f", _sqrt_2);
-
-	for(byte i = 0; i < 32; i++) {
-		_cosine_32[i] = cos(i * PI / 16);
-		debug(2, "JPEG: _cosine_32[%d]: %f", i, _cosine_32[i]);
+	// Initialize the IDCT basis: C(u) * cos((2x + 1) * u * PI / 16) for
+	// sample x and frequency u, with C(0) = 1 / sqrt(2) and C(u) = 1
+	for (int x = 0; x < 8; x++) {
+		for (int u = 0; u < 8; u++) {
+			double c = cos((2 * x + 1) * u * PI / 16);
+			if (u == 0)
+				c /= sqrt(2.0);
+			_idctCos[x * 8 + u] = (int32)floor(c * (1 << IDCT_CONST_BITS) + 0.5);
+		}
 	}
 }
 
@@ -92,14 +99,21 @@ Surface *JPEG::getSurface(const PixelFormat &format) {
 	Graphics::Surface *output = new Graphics::Surface();
 	output->create(yComponent->w, yComponent->h, format.bytesPerPixel);
 
+	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(format);
+
 	for (uint16 i = 0; i < output->h; i++) {
-		for (uint16 j = 0; j < output->w; j++) {
-			byte r = 0, g = 0, b = 0;
-			YUV2RGB(*((byte *)yComponent->getBasePtr(j, i)), *((byte *)uComponent->getBasePtr(j, i)), *((byte *)vComponent->getBasePtr(j, i)), r, g, b);
-			if (format.bytesPerPixel == 2)
-				*((uint16 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-			else
-				*((uint32 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
+		const byte *y = (const byte *)yComponent->getBasePtr(0, i);
+		const byte *u = (const byte *)uComponent->getBasePtr(0, i);
+		const byte *v = (const byte *)vComponent->getBasePtr(0, i);
+
+		if (format.bytesPerPixel == 2) {
+			uint16 *dst = (uint16 *)output->getBasePtr(0, i);
+			for (uint16 j = 0; j < output->w; j++)
+				*dst++ = lookup->convert(*y++, *u++, *v++);
+		} else {
+			uint32 *dst = (uint32 *)output->getBasePtr(0, i);
+			for (uint16 j = 0; j < output->w; j++)
+				*dst++ = lookup->convert(*y++, *u++, *v++);
 		}
 	}
 
@@ -342,11 +356,38 @@ bool JPEG::readDHT() {
 			curCode++;
 			cur++;
 		}
+
+		buildHuffLookup(_huff[tableNum]);
 	}
 
 	return true;
 }
 
+void JPEG::buildHuffLookup(HuffmanTable &table) {
+	for (int size = 0; size <= 16; size++) {
+		table.maxCode[size] = -1;
+		table.valOffset[size] = 0;
+	}
+	memset(table.lookup, 0, sizeof(table.lookup));
+
+	// The codes are sorted by size, and consecutive within each size
+	for (int i = 0; i < table.count; i++) {
+		const uint8 size = table.sizes[i];
+		const uint16 code = table.codes[i];
+
+		if (table.maxCode[size] < 0)
+			table.valOffset[size] = i - code;
+		table.maxCode[size] = code;
+
+		// Every byte starting with a short code decodes to it
+		if (size <= 8 && code < (1 << size)) {
+			const int first = code << (8 - size);
+			for (int j = 0; j < (1 << (8 - size)); j++)
+				table.lookup[first + j] = (size << 8) | table.values[i];
+		}
+	}
+}
+
 // Marker 0xDA (Start Of Scan)
 bool JPEG::readSOS() {
 	debug(5, "JPEG: readSOS");
@@ -501,18 +542,53 @@ bool JPEG::readMCU(uint16 xMCU, uint16 yMCU) {
 	return ok;
 }
 
-float JPEG::idct(int x, int y, int weight, int fx, int fy) {
-	byte vx_in = ((int32)((2 * x) + 1) * fx) % 32;
-	byte vy_in = ((int32)((2 * y) + 1) * fy) % 32;
-	float ret = (float)weight * _cosine_32[vx_in] * _cosine_32[vy_in];
+void JPEG::idct(const int16 *in, byte *out) const {
+	// Separable fixed point IDCT: transform the rows, then the columns.
+	// Rows and columns without AC coefficients are constant.
+	int32 tmp[64];
 
-	if (fx == 0)
-		ret /= _sqrt_2;
+	for (int v = 0; v < 8; v++) {
+		const int16 *row = in + v * 8;
+		int32 *t = tmp + v * 8;
 
-	if (fy == 0)
-		ret /= _sqrt_2;
+		if (!(row[1] | row[2] | row[3] | row[4] | row[5] | row[6] | row[7])) {
+			const int32 dc = (row[0] * _idctCos[0] + (1 << (IDCT_CONST_BITS - IDCT_PASS1_BITS - 1))) >> (IDCT_CONST_BITS - IDCT_PASS1_BITS);
+			for (int x = 0; x < 8; x++)
+				t[x] = dc;
+			continue;
+		}
 
-	return ret;
+		for (int x = 0; x < 8; x++) {
+			const int32 *c = _idctCos + x * 8;
+			int32 sum = 0;
+			for (int u = 0; u < 8; u++)
+				sum += c[u] * row[u];
+			t[x] = (sum + (1 << (IDCT_CONST_BITS - IDCT_PASS1_BITS - 1))) >> (IDCT_CONST_BITS - IDCT_PASS1_BITS);
+		}
+	}
+
+	// The column pass includes the final division by 4 (and 2 more bits
+	// of the pass 1 precision). Shifting rounds down, like the
+	// truncation of the former floating point implementation.
+	const int shift = IDCT_CONST_BITS + IDCT_PASS1_BITS + 2;
+	for (int x = 0; x < 8; x++) {
+		const int32 *col = tmp + x;
+
+		if (!(col[8] | col[16] | col[24] | col[32] | col[40] | col[48] | col[56])) {
+			const byte val = CLIP<int32>(((col[0] * _idctCos[0]) >> shift) + 128, 0, 255);
+			for (int y = 0; y < 8; y++)
+				out[y * 8 + x] = val;
+			continue;
+		}
+
+		for (int y = 0; y < 8; y++) {
+			const int32 *c = _idctCos + y * 8;
+			int32 sum = 0;
+			for (int v = 0; v < 8; v++)
+				sum += c[v] * col[v * 8];
+			out[y * 8 + x] = CLIP<int32>((sum >> shift) + 128, 0, 255);
+		}
+	}
 }
 
 bool JPEG::readDataUnit(uint16 x, uint16 y) {
@@ -530,39 +606,30 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 
 	// Calculate the DCT coefficients from the input sequence
 	int16 DCT[64];
+	bool hasAC = false;
 	for (uint8 i = 0; i < 64; i++) {
 		// Dequantize
 		int16 val = readData[i];
 		int16 quant = _quant[_currentComp->quantTableSelector][i];
 		val *= quant;
 
+		if (i && val)
+			hasAC = true;
+
 		// Store the normalized coefficients, undoing the Zig-Zag
 		DCT[_zigZagOrder[i]] = val;
 	}
 
-	// Shortcut the IDCT for DC component
-	float result[64];
-	for (uint8 i = 0; i < 64; i++)
-		result[i] = DCT[0] / 2;
-
-	// Apply the IDCT (PAG31)
-	for (int i = 1; i < 64; i++) {
-		if (DCT[i])
-			for (int _y = 0; _y < 8; _y++)
-				for (int _x = 0; _x < 8; _x++)
-					result[_y * 8 + _x] += idct(_x, _y, DCT[i], i % 8, i / 8);
-	}
-
-	// Level shift to make the values unsigned
-	// Divide by 4 is final part of IDCT
-	for (int i = 0; i < 64; i++) {
-		result[i] = result[i] / 4 + 128;
-
-		if (result[i] < 0)
-			result[i] = 0;
+	// The DC component has always been halved with an integer division
+	DCT[0] = (DCT[0] / 2) * 2;
 
-		if (result[i] > 255)
-			result[i] = 255;
+	byte result[64];
+	if (hasAC) {
+		idct(DCT, result);
+	} else {
+		// Shortcut the IDCT for blocks with just a DC component
+		const byte val = CLIP<int>(((DCT[0] / 2) >> 2) + 128, 0, 255);
+		memset(result, val, 64);
 	}
 
 	// Paint the component surface
@@ -580,7 +647,7 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 
 			for (uint8 i = 0; i < 8; i++) {
 				for (uint16 sH = 0; sH < scalingH; sH++) {
-					*ptr = (byte)(result[j * 8 + i]);
+					*ptr = result[j * 8 + i];
 					ptr++;
 				}
 			}
@@ -632,12 +699,12 @@ void JPEG::readAC(int16 *out) {
 }
 
 int16 JPEG::readSignedBits(uint8 numBits) {
-	uint16 ret = 0;
 	if (numBits > 16) error("requested %d bits", numBits); //XXX
+	if (numBits == 0)
+		return 0;
 
 	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	uint16 ret = readBits(numBits);
 
 	// Extend sign bits (PAG109)
 	if (!(ret >> (numBits - 1)))
@@ -648,35 +715,52 @@ int16 JPEG::readSignedBits(uint8 numBits) {
 	return ret;
 }
 
-// TODO: optimize?
 uint8 JPEG::readHuff(uint8 table) {
-	bool foundCode = false;
-	uint8 val = 0;
-
-	uint8 cur = 0;
-	uint8 codeSize = 1;
-	uint16 code = readBit();
-	while (!foundCode) {
-		// Prepare a code of the current size
-		while (codeSize < _huff[table].sizes[cur]) {
-			code = (code << 1) + readBit();
-			codeSize++;
-		}
+	const HuffmanTable &huff = _huff[table];
 
-		// Compare the codes of the current size
-		while (!foundCode && (codeSize == _huff[table].sizes[cur])) {
-			if (code == _huff[table].codes[cur]) {
-				// Found the code
-				val = _huff[table].values[cur];
-				foundCode = true;
-			} else {
-				// Continue reading
-				cur++;
-			}
-		}
+	// Make sure the current byte has bits left, without consuming any
+	if (_bitsNumber == 0) {
+		readBit();
+		_bitsNumber++;
 	}
 
-	return val;
+	// Look up short codes in the bits left in the current byte. Input
+	// isn't read ahead, the stream has to stop right after the scan data.
+	const uint16 entry = huff.lookup[(_bitsData << (8 - _bitsNumber)) & 0xFF];
+	const uint8 size = entry >> 8;
+	if (entry && size <= _bitsNumber) {
+		_bitsNumber -= size;
+		return entry & 0xFF;
+	}
+
+	// Longer codes are decoded bit by bit
+	int32 code = 0;
+	for (int codeSize = 1; codeSize <= 16; codeSize++) {
+		code = (code << 1) + readBit();
+		if (code <= huff.maxCode[codeSize])
+			return huff.values[huff.valOffset[codeSize] + code];
+	}
+
+	warning("JPEG: Invalid Huffman code");
+	return 0;
+}
+
+uint16 JPEG::readBits(uint8 numBits) {
+	uint16 ret = 0;
+	while (numBits > 0) {
+		if (_bitsNumber == 0) {
+			// Read a new byte
+			ret = (ret << 1) + readBit();
+			numBits--;
+		} else {
+			// Take as many bits as possible from the current byte
+			const uint8 n = MIN(numBits, _bitsNumber);
+			_bitsNumber -= n;
+			ret = (ret << n) + ((_bitsData >> _bitsNumber) & ((1 << n) - 1));
+			numBits -= n;
+		}
+	}
+	return ret;
 }
 
 uint8 JPEG::readBit() {
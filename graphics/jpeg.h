@@ -94,6 +94,14 @@ private:
 		uint8 *values;
 		uint8 *sizes;
 		uint16 *codes;
+
+		// Largest code of each size, -1 if there's none
+		int32 maxCode[17];
+		// Index of the first value of each size, minus its code
+		int32 valOffset[17];
+		// Value and size of the codes up to 8 bits, indexed by the next
+		// 8 bits of input. 0 when the code is longer.
+		uint16 lookup[256];
 	} _huff[2 * JPEG_MAX_HUFF_TABLES];
 
 	// Marker read functions
@@ -111,15 +119,16 @@ private:
 	int16 readSignedBits(uint8 numBits);
 
 	// Huffman decoding
+	void buildHuffLookup(HuffmanTable &table);
 	uint8 readHuff(uint8 table);
 	uint8 readBit();
+	uint16 readBits(uint8 numBits);
 	uint8 _bitsData;
 	uint8 _bitsNumber;
 
-	float _sqrt_2;
-	float _cosine_32[32];
-	// Discrete Cosine Transformation
-	float idct(int x, int y, int weight, int fx, int fy);
+	// Inverse Discrete Cosine Transformation
+	int32 _idctCos[64];
+	void idct(const int16 *in, byte *out) const;
 };
 
 } // End of Graphics namespace
@@ -22,7 +22,8 @@ MODULE_OBJS := \
 	surface.o \
 	thumbnail.o \
 	VectorRenderer.o \
-	VectorRendererSpec.o
+	VectorRendererSpec.o \
+	yuv_to_rgb.o
 
 ifdef USE_SCALERS
 MODULE_OBJS += \
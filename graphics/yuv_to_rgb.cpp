@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ */
+
+#include "graphics/yuv_to_rgb.h"
+
+#include "common/util.h"
+
+DECLARE_SINGLETON(Graphics::YUVToRGBManager);
+
+namespace Graphics {
+
+YUVToRGBLookup::YUVToRGBLookup(const PixelFormat &format) {
+	_format = format;
+
+	int16 *vToR = &_colorTab[0 * 256];
+	int16 *vToG = &_colorTab[1 * 256];
+	int16 *uToG = &_colorTab[2 * 256];
+	int16 *uToB = &_colorTab[3 * 256];
+
+	uint32 *rToPix = &_rgbToPix[0 * 768];
+	uint32 *gToPix = &_rgbToPix[1 * 768];
+	uint32 *bToPix = &_rgbToPix[2 * 768];
+
+	// The same coefficients as in YUV2RGB(). The green part of U and V
+	// is rounded separately there, so it can be split up as well.
+	for (int i = 0; i < 256; i++) {
+		vToR[i] = ((1357 * (i - 128)) >> 10) + 0 * 768 + 256;
+		vToG[i] = -((691 * (i - 128)) >> 10) + 1 * 768 + 256;
+		uToG[i] = -((333 * (i - 128)) >> 10);
+		uToB[i] = ((1715 * (i - 128)) >> 10) + 2 * 768 + 256;
+	}
+
+	// Set up entries 0-255 of the component tables, and spread out the
+	// ends to the rest so that no clipping is needed
+	for (int i = 0; i < 768; i++) {
+		const byte c = CLIP<int>(i - 256, 0, 255);
+		rToPix[i] = format.RGBToColor(c, 0, 0);
+		gToPix[i] = format.RGBToColor(0, c, 0);
+		bToPix[i] = format.RGBToColor(0, 0, c);
+	}
+}
+
+YUVToRGBManager::YUVToRGBManager() {
+}
+
+YUVToRGBManager::~YUVToRGBManager() {
+	for (Common::List<YUVToRGBLookup *>::iterator it = _lookups.begin(); it != _lookups.end(); ++it)
+		delete *it;
+}
+
+const YUVToRGBLookup *YUVToRGBManager::getLookup(const PixelFormat &format) {
+	Common::StackLock lock(_mutex);
+
+	for (Common::List<YUVToRGBLookup *>::iterator it = _lookups.begin(); it != _lookups.end(); ++it)
+		if ((*it)->getFormat() == format)
+			return *it;
+
+	YUVToRGBLookup *lookup = new YUVToRGBLookup(format);
+	_lookups.push_back(lookup);
+	return lookup;
+}
+
+/**
+ * Converts lines of Y samples which share the same U and V samples. The
+ * chroma part of the lookup is done once for every group of pixels.
+ */
+struct YUVToRGBConverter {
+	template<typename PixelInt, int xShift>
+	static void convertLine(PixelInt *dst, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width) {
+		const int16 *colorTab = lookup->_colorTab;
+		const uint32 *rgbToPix = lookup->_rgbToPix;
+		const int group = 1 << xShift;
+
+		for (int x = 0; x < width; x += group) {
+			const byte u = *uSrc++;
+			const byte v = *vSrc++;
+			const int16 cr_r  = colorTab[0 * 256 + v];
+			const int16 crb_g = colorTab[1 * 256 + v] + colorTab[2 * 256 + u];
+			const int16 cb_b  = colorTab[3 * 256 + u];
+
+			const int n = MIN(group, width - x);
+			for (int i = 0; i < n; i++) {
+				const uint32 *L = &rgbToPix[*ySrc++];
+				*dst++ = L[cr_r] | L[crb_g] | L[cb_b];
+			}
+		}
+	}
+
+	template<typename PixelInt, int shift>
+	static void convert(byte *dst, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yWidth, int yHeight, int yPitch, int uvPitch) {
+		for (int h = 0; h < yHeight; h++) {
+			convertLine<PixelInt, shift>((PixelInt *)dst, lookup, ySrc, uSrc, vSrc, yWidth);
+
+			dst += dstPitch;
+			ySrc += yPitch;
+			if ((h & ((1 << shift) - 1)) == (1 << shift) - 1) {
+				uSrc += uvPitch;
+				vSrc += uvPitch;
+			}
+		}
+	}
+};
+
+template<int shift>
+static void convertYUVToRGB(byte *dst, int dstPitch, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+							int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(format);
+
+	if (format.bytesPerPixel == 2)
+		YUVToRGBConverter::convert<uint16, shift>(dst, dstPitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else if (format.bytesPerPixel == 4)
+		YUVToRGBConverter::convert<uint32, shift>(dst, dstPitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		error("Unsupported YUV to RGB destination bytes per pixel %d", format.bytesPerPixel);
+}
+
+void convertYUV420ToRGB(byte *dst, int dstPitch, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convertYUVToRGB<1>(dst, dstPitch, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void convertYUV410ToRGB(byte *dst, int dstPitch, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convertYUVToRGB<2>(dst, dstPitch, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_H
+#define GRAPHICS_YUV_TO_RGB_H
+
+#include "common/scummsys.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * Lookup tables converting YUV colors into colors of one pixel format.
+ * The result is the same as YUV2RGB() followed by RGBToColor(), the
+ * clipping is done by the tables.
+ */
+class YUVToRGBLookup {
+public:
+	YUVToRGBLookup(const PixelFormat &format);
+
+	const PixelFormat &getFormat() const { return _format; }
+
+	/** Convert a single YUV color into the pixel format. */
+	uint32 convert(byte y, byte u, byte v) const {
+		const uint32 *L = &_rgbToPix[y];
+		return L[_colorTab[v]] | L[_colorTab[256 + v] + _colorTab[512 + u]] | L[_colorTab[768 + u]];
+	}
+
+private:
+	friend struct YUVToRGBConverter;
+
+	PixelFormat _format;
+
+	/**
+	 * Offsets into _rgbToPix for V to red, V to green, U to green and
+	 * U to blue. The red, green and blue offsets include the start of the
+	 * part of _rgbToPix for that component.
+	 */
+	int16 _colorTab[4 * 256];
+
+	/**
+	 * The red, green and blue parts of a color, for each component value
+	 * between -256 and 511. Values outside of 0..255 are clipped.
+	 */
+	uint32 _rgbToPix[3 * 768];
+};
+
+/**
+ * Keeps the lookup tables of every used pixel format around until shutdown.
+ * Video decoders running in a timer callback may use them too, so the
+ * tables are created under a lock and never freed while in use.
+ */
+class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
+public:
+	/** Return the lookup tables for a pixel format, building them if needed. */
+	const YUVToRGBLookup *getLookup(const PixelFormat &format);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	YUVToRGBManager();
+	~YUVToRGBManager();
+
+	Common::List<YUVToRGBLookup *> _lookups;
+	Common::Mutex _mutex;
+};
+
+/**
+ * Convert a YUV 4:2:0 image, with one U and V sample for every 2x2 block
+ * of Y samples, to RGB.
+ *
+ * @param dst		the buffer receiving the converted image
+ * @param dstPitch	width in bytes of one full line of the dest buffer
+ * @param format	the pixel format of the dest buffer, 2 or 4 bytes per pixel
+ * @param ySrc		the Y plane
+ * @param uSrc		the U plane
+ * @param vSrc		the V plane
+ * @param yWidth	the width of the Y plane, and of the converted image
+ * @param yHeight	the height of the Y plane, and of the converted image
+ * @param yPitch	width in bytes of one full line of the Y plane
+ * @param uvPitch	width in bytes of one full line of the U and V planes
+ */
+void convertYUV420ToRGB(byte *dst, int dstPitch, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yWidth, int yHeight, int yPitch, int uvPitch);
+
+/**
+ * Convert a YUV 4:1:0 image, with one U and V sample for every 4x4 block
+ * of Y samples, to RGB. The parameters are the same as those of
+ * convertYUV420ToRGB().
+ */
+void convertYUV410ToRGB(byte *dst, int dstPitch, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+						int yWidth, int yHeight, int yPitch, int uvPitch);
+
+} // End of namespace Graphics
+
+/** Shortcut for accessing the YUV to RGB manager. */
+#define YUVToRGBMan (::Graphics::YUVToRGBManager::instance())
+
+#endif // GRAPHICS_YUV_TO_RGB_H
@@ -0,0 +1,76 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/jobrunner.h"
+
+#include "../video/helper.h"
+
+struct JobRunnerTestBatch {
+	int runs[64];
+	int count;
+	int timerCount;
+};
+
+static void jobRunnerTestProc(void *refCon, uint job) {
+	JobRunnerTestBatch *batch = (JobRunnerTestBatch *)refCon;
+	batch->runs[job]++;
+	batch->count++;
+	if (((JobTestSystem *)g_system)->isInTimer())
+		batch->timerCount++;
+}
+
+class JobRunnerTestSuite : public CxxTest::TestSuite {
+	JobTestSystem _system;
+
+	void runBatch(Common::JobRunner &runner, uint count) {
+		JobRunnerTestBatch batch;
+		memset(&batch, 0, sizeof(batch));
+
+		runner.run(jobRunnerTestProc, &batch, count);
+
+		TS_ASSERT_EQUALS(batch.count, (int)count);
+		for (uint i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(batch.runs[i], 1);
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_run() {
+		Common::JobRunner runner;
+
+		runBatch(runner, 0);
+		runBatch(runner, 1);
+		runBatch(runner, 2);
+		runBatch(runner, 64);
+	}
+
+	void test_timer() {
+		Common::JobRunner runner;
+		JobRunnerTestBatch batch;
+		memset(&batch, 0, sizeof(batch));
+
+		// The caller runs the first job, then the timer callback gets to
+		// run and takes over the others
+		runner.run(jobRunnerTestProc, &batch, 8);
+		TS_ASSERT_EQUALS(batch.count, 8);
+		TS_ASSERT_EQUALS(batch.timerCount, 7);
+		for (int i = 0; i < 8; i++)
+			TS_ASSERT_EQUALS(batch.runs[i], 1);
+	}
+
+	void test_runners() {
+		Common::JobRunner *runner1 = new Common::JobRunner();
+		Common::JobRunner runner2;
+
+		runBatch(*runner1, 16);
+		runBatch(runner2, 16);
+		delete runner1;
+		runBatch(runner2, 16);
+	}
+};
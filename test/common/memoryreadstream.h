@@ -84,4 +84,13 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(ms.pos(), 7);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_data_ptr() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		TS_ASSERT_EQUALS(ms.getDataPtr(), (const byte *)contents);
+		ms.seek(3);
+		TS_ASSERT_EQUALS(ms.getDataPtr(), (const byte *)contents);
+	}
 };
@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/bufferedstream.h"
+
+class ReadAheadSeekableReadStreamTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_traverse() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::ReadAheadSeekableReadStream ras(&ms, DisposeAfterUse::NO, 2, 4);
+
+		byte i, b;
+		for (i = 0; i < 10; ++i) {
+			TS_ASSERT(!ras.eos());
+
+			TS_ASSERT_EQUALS(i, ras.pos());
+
+			ras.read(&b, 1);
+			TS_ASSERT_EQUALS(i, b);
+		}
+
+		TS_ASSERT(!ras.eos());
+
+		TS_ASSERT_EQUALS((uint)0, ras.read(&b, 1));
+		TS_ASSERT(ras.eos());
+	}
+
+	void test_seek() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::ReadAheadSeekableReadStream ras(&ms, DisposeAfterUse::NO, 2, 4);
+		byte b;
+
+		TS_ASSERT_EQUALS(ras.pos(), 0);
+
+		ras.seek(1, SEEK_SET);
+		TS_ASSERT_EQUALS(ras.pos(), 1);
+		b = ras.readByte();
+		TS_ASSERT_EQUALS(b, 1);
+
+		ras.seek(5, SEEK_CUR);
+		TS_ASSERT_EQUALS(ras.pos(), 7);
+		b = ras.readByte();
+		TS_ASSERT_EQUALS(b, 7);
+
+		ras.seek(-3, SEEK_CUR);
+		TS_ASSERT_EQUALS(ras.pos(), 5);
+		b = ras.readByte();
+		TS_ASSERT_EQUALS(b, 5);
+
+		ras.seek(0, SEEK_END);
+		TS_ASSERT_EQUALS(ras.pos(), 10);
+		TS_ASSERT(!ras.eos());
+		b = ras.readByte();
+		TS_ASSERT(ras.eos());
+
+		ras.seek(-8, SEEK_END);
+		TS_ASSERT_EQUALS(ras.pos(), 2);
+		TS_ASSERT(!ras.eos());
+		b = ras.readByte();
+		TS_ASSERT_EQUALS(b, 2);
+	}
+
+	void test_read_across_windows() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::ReadAheadSeekableReadStream ras(&ms, DisposeAfterUse::NO, 2, 4);
+		byte buf[10];
+
+		TS_ASSERT_EQUALS((uint)3, ras.read(buf, 3));
+		TS_ASSERT_EQUALS((uint)6, ras.read(buf + 3, 6));
+		TS_ASSERT_EQUALS(ras.pos(), 9);
+		TS_ASSERT_EQUALS((uint)1, ras.read(buf + 9, 5));
+		TS_ASSERT(ras.eos());
+
+		for (int i = 0; i < 10; ++i)
+			TS_ASSERT_EQUALS(buf[i], i);
+	}
+
+	void test_window_size() {
+		byte contents[64];
+		for (int i = 0; i < 64; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, 64);
+
+		Common::ReadAheadSeekableReadStream ras(&ms, DisposeAfterUse::NO, 4, 16);
+
+		// The window grows while reading sequentially...
+		TS_ASSERT_EQUALS(ras.readByte(), 0);
+		TS_ASSERT_EQUALS(ras.getWindowSize(), (uint32)8);
+		ras.seek(8, SEEK_SET);
+		TS_ASSERT_EQUALS(ras.readByte(), 8);
+		TS_ASSERT_EQUALS(ras.getWindowSize(), (uint32)16);
+		ras.seek(24, SEEK_SET);
+		TS_ASSERT_EQUALS(ras.readByte(), 24);
+		TS_ASSERT_EQUALS(ras.getWindowSize(), (uint32)16);
+		TS_ASSERT_EQUALS(ras.getStallCount(), (uint32)3);
+
+		// ...and starts over after seeking elsewhere
+		ras.seek(50, SEEK_SET);
+		TS_ASSERT_EQUALS(ras.readByte(), 50);
+		TS_ASSERT_EQUALS(ras.getWindowSize(), (uint32)4);
+		TS_ASSERT_EQUALS(ras.getStallCount(), (uint32)4);
+	}
+
+	void test_large_read() {
+		byte contents[64];
+		for (int i = 0; i < 64; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, 64);
+
+		Common::ReadAheadSeekableReadStream ras(&ms, DisposeAfterUse::NO, 4, 8);
+		byte buf[40];
+
+		TS_ASSERT_EQUALS(ras.readByte(), 0);
+		TS_ASSERT_EQUALS((uint)40, ras.read(buf, 40));
+		TS_ASSERT_EQUALS(ras.pos(), 41);
+		for (int i = 0; i < 40; ++i)
+			TS_ASSERT_EQUALS(buf[i], i + 1);
+
+		TS_ASSERT_EQUALS(ras.readByte(), 41);
+		TS_ASSERT(!ras.eos());
+	}
+};
@@ -0,0 +1,64 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+// The engine libraries refer to the plugin managers and the version strings
+// of base/, which can't be linked without all static plugins. The engine
+// tests don't use them, these only satisfy the linker.
+
+#include "base/plugins.h"
+#include "base/version.h"
+
+#include "engines/metaengine.h"
+#include "sound/musicplugin.h"
+
+const char *gScummVMVersion = "test";
+const char *gScummVMBuildDate = "";
+const char *gScummVMVersionDate = "test";
+const char *gScummVMFullVersion = "ScummVM test";
+const char *gScummVMFeatures = "";
+
+const char *Plugin::getName() const {
+	return _pluginObject->getName();
+}
+
+DECLARE_SINGLETON(EngineManager);
+
+GameDescriptor EngineManager::findGame(const Common::String &gameName, const EnginePlugin **plugin) const {
+	if (plugin)
+		*plugin = 0;
+	return GameDescriptor();
+}
+
+const EnginePlugin::List &EngineManager::getPlugins() const {
+	static const EnginePlugin::List plugins;
+	return plugins;
+}
+
+DECLARE_SINGLETON(MusicManager);
+
+const MusicPlugin::List &MusicManager::getPlugins() const {
+	static const MusicPlugin::List plugins;
+	return plugins;
+}
@@ -0,0 +1,308 @@
+#include <cxxtest/TestSuite.h>
+
+#include "scumm/akos.h"
+#include "scumm/costume.h"
+
+/*
+ * The codec 1 renderers draw cels either from their RLE data or from
+ * decoded, cached images. Both ways are run on the same synthetic cels,
+ * positions, scales, masks and shadow modes, and have to give the same
+ * screen. The renderers are set up the way their codec1() and
+ * mainRoutine() do, without an engine.
+ */
+enum {
+	kCostumeTestWidth = 64,
+	kCostumeTestHeight = 48,
+	kCostumeTestStrips = kCostumeTestWidth / 8,
+	kCostumeTestMaskMargin = 64
+};
+
+struct CostumeTestCel {
+	int width, height;
+	byte mask, shr;
+	Common::Array<byte> data;
+};
+
+struct CostumeTestShadow {
+	byte mode;
+	bool table;
+};
+
+struct CostumeTestLayout {
+	int x, y;
+	bool mirror;
+	byte scaleX, scaleY;
+	int scaleIndexX, scaleIndexY;
+};
+
+class CostumeTestClassicRenderer : public Scumm::ClassicCostumeRenderer {
+public:
+	CostumeTestClassicRenderer() : Scumm::ClassicCostumeRenderer(0) {}
+
+	void draw(Graphics::Surface &out, const byte *mask, const CostumeTestCel &cel, const CostumeTestLayout &layout,
+			const byte *scaletable, const uint16 *palette, byte shadowMode, byte *shadowTable) {
+		Codec1 v1;
+
+		_out = out;
+		_numStrips = kCostumeTestStrips;
+		_width = cel.width;
+		_height = cel.height;
+		_srcptr = cel.data.begin();
+		_mirror = layout.mirror;
+		_scaleX = layout.scaleX;
+		_scaleY = layout.scaleY;
+		_scaleIndexX = layout.scaleIndexX;
+		_scaleIndexY = layout.scaleIndexY;
+		_shadow_mode = shadowMode;
+		_shadow_table = shadowTable;
+		memcpy(_palette, palette, sizeof(_palette));
+
+		v1.scaletable = scaletable;
+		v1.mask = cel.mask;
+		v1.shr = cel.shr;
+		v1.x = layout.x;
+		v1.y = layout.y;
+		v1.skip_width = _width;
+		v1.scaleXstep = _mirror ? 1 : -1;
+		v1.replen = 0;
+		v1.celptr = _srcptr;
+		v1.skipCols = 0;
+
+		// Columns off the screen are skipped in the cel data
+		int skip = _mirror ? -v1.x : v1.x - (_out.w - 1);
+		if (skip > 0) {
+			v1.skip_width -= skip;
+			if (v1.skip_width <= 0)
+				return;
+			codec1_ignorePakCols(v1, skip);
+			v1.x = _mirror ? 0 : _out.w - 1;
+		}
+
+		v1.destptr = (byte *)_out.pixels + v1.y * _out.pitch + v1.x;
+		v1.mask_ptr = mask + v1.y * _numStrips;
+		proc3(v1);
+	}
+};
+
+class CostumeTestAkosRenderer : public Scumm::AkosRenderer {
+public:
+	CostumeTestAkosRenderer() : Scumm::AkosRenderer(0) {}
+
+	void draw(Graphics::Surface &out, const byte *mask, const CostumeTestCel &cel, const CostumeTestLayout &layout,
+			const Common::Rect &bounds, const byte *scaletable, const uint16 *palette, byte shadowMode, byte *shadowTable) {
+		Codec1 v1;
+
+		_out = out;
+		_numStrips = kCostumeTestStrips;
+		_width = cel.width;
+		_height = cel.height;
+		_srcptr = cel.data.begin();
+		_mirror = layout.mirror;
+		_scaleX = layout.scaleX;
+		_scaleY = layout.scaleY;
+		_shadow_mode = shadowMode;
+		_shadow_table = shadowTable;
+		memcpy(_palette, palette, sizeof(_palette));
+
+		v1.scaletable = scaletable;
+		v1.mask = cel.mask;
+		v1.shr = cel.shr;
+		v1.x = layout.x;
+		v1.y = layout.y;
+		v1.boundsRect = bounds;
+		v1.scaleXindex = layout.scaleIndexX;
+		v1.scaleYindex = layout.scaleIndexY;
+		v1.skip_width = _width;
+		v1.scaleXstep = _mirror ? 1 : -1;
+		v1.replen = 0;
+		v1.celptr = _srcptr;
+		v1.skipCols = 0;
+
+		int skip = _mirror ? bounds.left - v1.x : v1.x - (bounds.right - 1);
+		if (skip > 0) {
+			v1.skip_width -= skip;
+			if (v1.skip_width <= 0)
+				return;
+			codec1_ignorePakCols(v1, skip);
+			v1.x = _mirror ? bounds.left : bounds.right - 1;
+		}
+
+		v1.destptr = (byte *)_out.pixels + v1.y * _out.pitch + v1.x;
+		v1.mask_ptr = mask + v1.y * _numStrips;
+		if (!codec1_cachedDecode(v1))
+			codec1_genericDecode(v1);
+	}
+};
+
+class CostumeRendererTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	byte _screen[3][kCostumeTestWidth * kCostumeTestHeight];
+	byte _background[kCostumeTestWidth * kCostumeTestHeight];
+	byte _maskStorage[(kCostumeTestHeight + 2 * kCostumeTestMaskMargin) * kCostumeTestStrips];
+	byte _scaletable[768];
+	uint16 _palette[256];
+	byte _shadowTable[256 * 256];
+
+	uint nextRandom(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 16) & 0x7FFF) % max;
+	}
+
+	// Runs of up to the mask length in one byte, and longer ones with an
+	// extra length byte, 0 meaning 256
+	void createCel(CostumeTestCel &cel, int width, int height, byte mask, byte shr) {
+		cel.width = width;
+		cel.height = height;
+		cel.mask = mask;
+		cel.shr = shr;
+		cel.data.clear();
+
+		for (int left = width * height; left > 0; ) {
+			const byte color = nextRandom(3) ? nextRandom(256 >> shr) : 0;
+			int run;
+
+			if (nextRandom(4)) {
+				run = 1 + nextRandom(mask);
+				cel.data.push_back((color << shr) | run);
+			} else {
+				run = 1 + nextRandom(256);
+				cel.data.push_back(color << shr);
+				cel.data.push_back(run & 0xFF);
+			}
+			left -= run;
+		}
+	}
+
+	void setUpScreen(byte *screen, Graphics::Surface &out) {
+		memcpy(screen, _background, sizeof(_background));
+		out.pixels = screen;
+		out.w = kCostumeTestWidth;
+		out.h = kCostumeTestHeight;
+		out.pitch = kCostumeTestWidth;
+		out.bytesPerPixel = 1;
+	}
+
+	const byte *setUpMask(bool masked) {
+		for (uint i = 0; i < sizeof(_maskStorage); i++)
+			_maskStorage[i] = (masked && nextRandom(3) == 0) ? nextRandom(256) : 0;
+		return _maskStorage + kCostumeTestMaskMargin * kCostumeTestStrips;
+	}
+
+	// Draws the cel without and twice with the cache, the second time
+	// from the cached image
+	template<class Renderer>
+	int checkLayout(Renderer &renderer, const CostumeTestCel &cel, const CostumeTestLayout &layout, const byte *mask,
+			const Common::Rect &bounds, const CostumeTestShadow &shadow) {
+		Graphics::Surface out[3];
+		int changed = 0;
+
+		for (int i = 0; i < 3; i++) {
+			setUpScreen(_screen[i], out[i]);
+			renderer._celCacheEnabled = (i > 0);
+			draw(renderer, out[i], mask, cel, layout, bounds, shadow);
+		}
+
+		TS_ASSERT_SAME_DATA(_screen[1], _screen[0], sizeof(_background));
+		TS_ASSERT_SAME_DATA(_screen[2], _screen[0], sizeof(_background));
+
+		for (uint i = 0; i < sizeof(_background); i++)
+			if (_screen[0][i] != _background[i])
+				changed++;
+
+		return changed;
+	}
+
+	void draw(CostumeTestClassicRenderer &renderer, Graphics::Surface &out, const byte *mask, const CostumeTestCel &cel,
+			const CostumeTestLayout &layout, const Common::Rect &bounds, const CostumeTestShadow &shadow) {
+		renderer.draw(out, mask, cel, layout, _scaletable, _palette, shadow.mode, shadow.table ? _shadowTable : 0);
+	}
+
+	void draw(CostumeTestAkosRenderer &renderer, Graphics::Surface &out, const byte *mask, const CostumeTestCel &cel,
+			const CostumeTestLayout &layout, const Common::Rect &bounds, const CostumeTestShadow &shadow) {
+		renderer.draw(out, mask, cel, layout, bounds, _scaletable, _palette, shadow.mode, shadow.table ? _shadowTable : 0);
+	}
+
+	template<class Renderer>
+	void checkRenderer(Renderer &renderer, const Common::Rect &bounds, const CostumeTestShadow *shadows, int numShadows) {
+		static const int sizes[][2] = { { 1, 1 }, { 7, 5 }, { 23, 37 }, { 40, 12 } };
+		static const byte scales[][2] = { { 255, 255 }, { 0x80, 0xC0 }, { 0x30, 255 }, { 255, 0x50 } };
+		const int xs[] = { bounds.left - 15, bounds.left + 2, 30, bounds.right - 3, bounds.right + 10 };
+		const int ys[] = { bounds.top - 20, 10, bounds.bottom - 6 };
+		int changed = 0, cached = 0;
+
+		for (int s = 0; s < ARRAYSIZE(sizes); s++) {
+			CostumeTestCel cel;
+			if (s & 1)
+				createCel(cel, sizes[s][0], sizes[s][1], 7, 3);
+			else
+				createCel(cel, sizes[s][0], sizes[s][1], 15, 4);
+
+			for (int m = 0; m < 2; m++) {
+				const byte *mask = setUpMask(m);
+
+				for (int sc = 0; sc < ARRAYSIZE(scales); sc++) {
+					for (int mirror = 0; mirror < 2; mirror++) {
+						for (int sh = 0; sh < numShadows; sh++) {
+							for (int p = 0; p < ARRAYSIZE(xs) * ARRAYSIZE(ys); p++) {
+								CostumeTestLayout layout;
+								layout.x = xs[p % ARRAYSIZE(xs)];
+								layout.y = ys[p / ARRAYSIZE(xs)];
+								layout.mirror = mirror;
+								layout.scaleX = scales[sc][0];
+								layout.scaleY = scales[sc][1];
+								layout.scaleIndexX = 128 + nextRandom(128);
+								layout.scaleIndexY = 128 + nextRandom(128);
+
+								changed += checkLayout(renderer, cel, layout, mask, bounds, shadows[sh]);
+							}
+						}
+					}
+				}
+			}
+
+			cached += renderer.getCelCacheEntries();
+			renderer.flushCelCache();
+		}
+
+		// Make sure something got drawn, and through the cache
+		TS_ASSERT_LESS_THAN(0, changed);
+		TS_ASSERT_LESS_THAN(0, cached);
+	}
+
+	public:
+	void setUp() {
+		_seed = 1;
+
+		for (uint i = 0; i < sizeof(_background); i++)
+			_background[i] = nextRandom(256);
+		for (uint i = 0; i < sizeof(_scaletable); i++)
+			_scaletable[i] = nextRandom(256);
+		for (uint i = 0; i < sizeof(_shadowTable); i++)
+			_shadowTable[i] = nextRandom(256);
+
+		// Some colors are the shadow color 13, the rest stay below 8 to go
+		// through the shadow table in AKOS shadow mode 3
+		for (int i = 0; i < 256; i++)
+			_palette[i] = nextRandom(4) ? nextRandom(8) : 13;
+	}
+
+	void test_classic() {
+		// Without a shadow table, with color 13 through the table, and with
+		// everything through the table
+		static const CostumeTestShadow shadows[] = { { 0x00, false }, { 0x00, true }, { 0x20, true } };
+		CostumeTestClassicRenderer renderer;
+
+		checkRenderer(renderer, Common::Rect(kCostumeTestWidth, kCostumeTestHeight), shadows, ARRAYSIZE(shadows));
+	}
+
+	void test_akos() {
+		// Shadow mode 3 depends on the game version, which needs an engine
+		static const CostumeTestShadow shadows[] = { { 0, false }, { 1, true } };
+		CostumeTestAkosRenderer renderer;
+
+		// Drawn to the whole screen, and clipped like with _clipOverride
+		checkRenderer(renderer, Common::Rect(kCostumeTestWidth, kCostumeTestHeight), shadows, ARRAYSIZE(shadows));
+		checkRenderer(renderer, Common::Rect(5, 3, 57, 41), shadows, ARRAYSIZE(shadows));
+	}
+};
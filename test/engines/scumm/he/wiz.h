@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "scumm/he/wiz_he.h"
+
+#include "../../../video/helper.h"
+
+/*
+ * A synthetic wiz image mapped onto quads which are moved, scaled, rotated,
+ * mirrored and clipped, drawn in 8 and 16 bits. The MD5 sums are of the
+ * images drawn by the per pixel loop the rasterizer replaced, with 16 bit
+ * pixels stored little endian.
+ */
+enum {
+	kWizTestSrcWidth = 37,
+	kWizTestSrcHeight = 29,
+	kWizTestDstWidth = 160,
+	kWizTestDstHeight = 120,
+	kWizTestTransColor = 5
+};
+
+struct WizTestQuad {
+	const char *name;
+	Common::Point verts[4];
+	Common::Rect bound;
+	const char *md5[3];	///< 8 bit, 16 bit screen and 16 bit memory
+};
+
+static const WizTestQuad wiz_test_quads[] = {
+	{ "moved", { Common::Point(10, 12), Common::Point(46, 12), Common::Point(46, 40), Common::Point(10, 40) }, Common::Rect(10, 12, 47, 41),
+		{ "abaecf39698c4e16d81ee2cb71e14cf6", "7f4e7836cf02f826cc2be0c99a07a8d9", "7f4e7836cf02f826cc2be0c99a07a8d9" } },
+	{ "scaled", { Common::Point(4, 2), Common::Point(150, 2), Common::Point(150, 110), Common::Point(4, 110) }, Common::Rect(4, 2, 151, 111),
+		{ "54d0d073bc4917e227e1aca49dec52c2", "7138dbf9ea7d752e1aa67bce6b05baa8", "7138dbf9ea7d752e1aa67bce6b05baa8" } },
+	{ "rotated", { Common::Point(60, 5), Common::Point(120, 40), Common::Point(85, 100), Common::Point(25, 65) }, Common::Rect(25, 5, 121, 101),
+		{ "4a50ea7037c835089ae68b3e3d25eec7", "f90bfeee1097db4f7c822e27df6294fb", "f90bfeee1097db4f7c822e27df6294fb" } },
+	{ "mirrored", { Common::Point(140, 20), Common::Point(70, 20), Common::Point(70, 90), Common::Point(140, 90) }, Common::Rect(70, 20, 141, 91),
+		{ "4a81bb76e31932762ba953ca81aa1cf5", "9058518a57a3d155cf751dc467982dcd", "9058518a57a3d155cf751dc467982dcd" } },
+	{ "clipped", { Common::Point(-30, -25), Common::Point(100, -10), Common::Point(180, 140), Common::Point(-20, 130) }, Common::Rect(-30, -25, 181, 141),
+		{ "288a23e0c3e518516140f699a4135249", "fa19c8c7fbb8b956704d3b878e712713", "fa19c8c7fbb8b956704d3b878e712713" } }
+};
+
+class WizPolygonTestSuite : public CxxTest::TestSuite {
+	JobTestSystem _system;
+
+	byte _src8[kWizTestSrcWidth * kWizTestSrcHeight];
+	byte _src16[kWizTestSrcWidth * kWizTestSrcHeight * 2];
+	byte _dst[2][kWizTestDstWidth * kWizTestDstHeight * 2];
+
+	void fillBackground(byte *dst, int bitDepth) {
+		for (int i = 0; i < kWizTestDstWidth * kWizTestDstHeight * bitDepth; i++)
+			dst[i] = (i * 7) & 0xFF;
+	}
+
+	// Screen pixels are in native byte order, stored little endian for the
+	// MD5 sum
+	Common::String drawQuad(const WizTestQuad &quad, int mode, Common::JobRunner *jobRunner, byte *dst) {
+		const int bitDepth = mode ? 2 : 1;
+		const int dstType = (mode == 1) ? Scumm::kDstScreen : Scumm::kDstMemory;
+		Common::Rect bound;
+
+		fillBackground(dst, bitDepth);
+		Scumm::Wiz::rasterizeWizPolygon(dst, mode ? _src16 : _src8, kWizTestDstWidth * bitDepth, dstType, kWizTestDstWidth, kWizTestDstHeight,
+				kWizTestSrcWidth, kWizTestSrcHeight, bound, quad.verts, bitDepth, kWizTestTransColor, jobRunner);
+		TS_ASSERT_EQUALS(bound, quad.bound);
+
+		if (mode == 1) {
+			for (int i = 0; i < kWizTestDstWidth * kWizTestDstHeight; i++)
+				WRITE_LE_UINT16(dst + i * 2, READ_UINT16(dst + i * 2));
+		}
+
+		Common::MemoryReadStream stream(dst, kWizTestDstWidth * kWizTestDstHeight * bitDepth);
+		return Common::computeStreamMD5AsString(stream);
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+
+		// Some pixels of either depth are transparent, and the 16 bit ones
+		// differ in both bytes
+		uint32 seed = 1;
+		for (int i = 0; i < kWizTestSrcWidth * kWizTestSrcHeight; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint16 color = (seed >> 16) & 0x7FFF;
+			_src8[i] = (color & 7) ? (color & 0xFF) : kWizTestTransColor;
+			WRITE_LE_UINT16(_src16 + i * 2, (color & 7) ? color : (uint16)kWizTestTransColor);
+		}
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_polygons() {
+		Common::JobRunner jobRunner;
+
+		for (int q = 0; q < ARRAYSIZE(wiz_test_quads); q++) {
+			const WizTestQuad &quad = wiz_test_quads[q];
+			for (int mode = 0; mode < 3; mode++) {
+				const int size = kWizTestDstWidth * kWizTestDstHeight * (mode ? 2 : 1);
+
+				// Drawn in one go, and band by band through the job runner
+				const Common::String md5 = drawQuad(quad, mode, 0, _dst[0]);
+				TS_ASSERT_EQUALS(drawQuad(quad, mode, &jobRunner, _dst[1]), md5);
+				TS_ASSERT_SAME_DATA(_dst[1], _dst[0], size);
+				TSM_ASSERT_EQUALS(quad.name, md5, quad.md5[mode]);
+			}
+		}
+	}
+};
@@ -0,0 +1,208 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/jpeg.h"
+#include "graphics/surface.h"
+
+#include "common/memstream.h"
+
+/*
+ * A 32x16 baseline JPEG with 4:2:0 subsampling, quality 75, showing a
+ * noisy ramp, a sine wave and a checker pattern in its color channels.
+ */
+static const byte jpeg_test_image[] = {
+	0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+	0x00, 0x01, 0x00, 0x00, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x08, 0x06, 0x06, 0x07, 0x06, 0x05, 0x08,
+	0x07, 0x07, 0x07, 0x09, 0x09, 0x08, 0x0a, 0x0c, 0x14, 0x0d, 0x0c, 0x0b, 0x0b, 0x0c, 0x19, 0x12,
+	0x13, 0x0f, 0x14, 0x1d, 0x1a, 0x1f, 0x1e, 0x1d, 0x1a, 0x1c, 0x1c, 0x20, 0x24, 0x2e, 0x27, 0x20,
+	0x22, 0x2c, 0x23, 0x1c, 0x1c, 0x28, 0x37, 0x29, 0x2c, 0x30, 0x31, 0x34, 0x34, 0x34, 0x1f, 0x27,
+	0x39, 0x3d, 0x38, 0x32, 0x3c, 0x2e, 0x33, 0x34, 0x32, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x09, 0x09,
+	0x09, 0x0c, 0x0b, 0x0c, 0x18, 0x0d, 0x0d, 0x18, 0x32, 0x21, 0x1c, 0x21, 0x32, 0x32, 0x32, 0x32,
+	0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+	0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+	0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0xff, 0xc0,
+	0x00, 0x11, 0x08, 0x00, 0x10, 0x00, 0x20, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+	0x01, 0xff, 0xc4, 0x00, 0x1f, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+	0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05,
+	0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21,
+	0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23,
+	0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17,
+	0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a,
+	0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+	0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+	0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+	0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7,
+	0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5,
+	0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1,
+	0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xc4, 0x00, 0x1f, 0x01, 0x00, 0x03,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x11, 0x00,
+	0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00,
+	0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13,
+	0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15,
+	0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27,
+	0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+	0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+	0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+	0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+	0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4,
+	0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2,
+	0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9,
+	0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0xc9,
+	0xf1, 0x0c, 0x84, 0x6a, 0x76, 0x9a, 0x3d, 0xb6, 0x5d, 0x32, 0x03, 0x00, 0x31, 0x8c, 0x56, 0xb7,
+	0x88, 0xa6, 0xfe, 0xc9, 0xb0, 0xb4, 0xd1, 0x6d, 0xd8, 0x3b, 0x4a, 0x00, 0x60, 0x38, 0xc7, 0xf9,
+	0xcd, 0x63, 0xf8, 0x42, 0x23, 0xfd, 0xa7, 0x75, 0xac, 0xdc, 0x9d, 0xe8, 0x09, 0x20, 0x93, 0x8c,
+	0x63, 0xff, 0x00, 0xd7, 0x5a, 0x3a, 0x22, 0x36, 0xa7, 0xe2, 0xc9, 0xaf, 0x64, 0xfd, 0xe4, 0x29,
+	0xc8, 0xec, 0x38, 0xff, 0x00, 0xf5, 0xd6, 0xb5, 0x52, 0xc3, 0x34, 0x9f, 0xb8, 0xa8, 0x2b, 0xbf,
+	0xb5, 0xec, 0xe5, 0x2f, 0xfd, 0x2f, 0x9f, 0xff, 0x00, 0x25, 0x38, 0x32, 0xee, 0x5a, 0x6d, 0x47,
+	0x75, 0x4d, 0x5d, 0xf9, 0xc9, 0xff, 0x00, 0x91, 0xb9, 0xa8, 0x48, 0x3c, 0x2f, 0xe1, 0x88, 0x2c,
+	0x23, 0x01, 0xa5, 0xb8, 0x00, 0x36, 0x38, 0xc5, 0x52, 0xd5, 0xe5, 0x1e, 0x11, 0xf0, 0x4c, 0x7e,
+	0x72, 0xb0, 0xb8, 0xbc, 0xf3, 0x31, 0xb7, 0x19, 0x20, 0x0e, 0x39, 0xf4, 0x24, 0xa9, 0x23, 0xfa,
+	0x8a, 0x7e, 0xe3, 0xaa, 0xf8, 0xbd, 0x22, 0xcf, 0x99, 0x6f, 0x13, 0x67, 0xd3, 0x18, 0xaa, 0xde,
+	0x35, 0x92, 0x3b, 0x8d, 0x6e, 0xdf, 0x4b, 0xb7, 0x82, 0x06, 0x8a, 0x39, 0xf2, 0xcd, 0x8c, 0x95,
+	0xf9, 0x41, 0x2d, 0xb4, 0x77, 0xc9, 0x03, 0x9e, 0x3e, 0xee, 0x78, 0x3c, 0x71, 0xd1, 0x8f, 0xb2,
+	0xa9, 0x08, 0x4f, 0xdc, 0xe4, 0xf7, 0xa5, 0xd7, 0xd9, 0x5f, 0x6f, 0xf1, 0xf3, 0xfc, 0xf9, 0x4f,
+	0x7f, 0x15, 0x4d, 0xcb, 0x05, 0xec, 0xa4, 0xfe, 0x2f, 0x7a, 0x5e, 0x76, 0x69, 0xd9, 0xf6, 0xdb,
+	0xba, 0x5d, 0xcf, 0xff, 0xd9,
+};
+
+/*
+ * The Y, Cb and Cr planes of the image, as decoded by the floating point
+ * IDCT that JPEG used before it switched to fixed point.
+ */
+static const byte jpeg_test_reference[3 * 32 * 16] = {
+	 83, 129, 146, 142, 137, 102,  69,  77,  69, 110, 161, 172, 194, 159, 124,  88,
+	 59,  94, 133, 173, 212, 212, 173, 138,  99,  74, 124, 151, 136, 228, 173, 120,
+	108, 142, 147, 134, 123,  90,  64,  75,  90, 126, 166, 169, 181, 145, 111,  79,
+	 78, 113, 149, 184, 212, 203, 160, 124,  86, 104, 114, 175, 238, 158, 152, 108,
+	123, 144, 138, 116,  99,  75,  66,  87, 102, 136, 166, 162, 161, 127, 101,  82,
+	 86, 125, 164, 192, 207, 189, 147, 119,  79, 105, 138, 172, 213, 159, 121,  94,
+	141, 151, 137, 105,  77,  58,  68, 100, 119, 152, 173, 158, 135, 102,  85,  85,
+	 97, 142, 181, 196, 190, 160, 125, 109,  91, 125, 155, 208, 181, 141, 178,  64,
+	169, 168, 146, 103,  60,  40,  63, 101, 153, 184, 188, 159, 110,  74,  64,  80,
+	129, 174, 205, 198, 165, 121,  93,  91, 121,  91, 190, 227, 189, 102, 149,  36,
+	174, 161, 134,  90,  46,  34,  68, 109, 176, 199, 187, 150,  90,  62,  62,  93,
+	159, 196, 215, 192, 144,  97,  79,  90, 141, 110, 212, 216, 143,  96,  50,  26,
+	166, 139, 107,  73,  42,  47,  90, 130, 180, 192, 164, 128,  73,  64,  74, 115,
+	176, 202, 207, 177, 131,  90,  81,  99, 150, 217, 202, 233, 103,  75,  51,  25,
+	172, 134,  97,  68,  48,  63, 110, 146, 184, 185, 143, 109,  60,  63,  79, 123,
+	190, 205, 199, 165, 122,  86,  80,  99, 167, 205, 236, 227,  91,  62,  38,  28,
+	132,  93,  59,  34,  72,  94, 146, 183, 172, 148, 111,  69,  88,  88, 123, 159,
+	180, 185, 168, 143, 119,  93, 104, 150, 159, 139, 132, 201, 109,  52,  44,  66,
+	115,  75,  44,  32,  77, 105, 152, 180, 172, 141,  98,  57,  80,  92, 136, 174,
+	185, 179, 153, 128, 111,  96, 114, 158, 199, 178, 207, 162, 141,  79,  48, 129,
+	 91,  53,  31,  38,  91, 131, 171, 189, 152, 119,  77,  49,  79, 111, 159, 196,
+	181, 162, 128, 105, 100, 106, 138, 183, 194, 203, 191, 162, 133, 108, 137,  70,
+	 80,  47,  34,  54, 101, 145, 176, 183, 135, 104,  68,  55,  86, 128, 170, 195,
+	184, 155, 116,  91,  89, 110, 154, 198, 209, 200, 173, 136, 127,  40,  53, 102,
+	 79,  54,  50,  75, 103, 141, 160, 156, 137, 106,  72,  69,  90, 134, 165, 178,
+	194, 159, 118,  90,  83, 107, 156, 194, 226, 233,  89, 150,  48,  31,  45, 158,
+	 70,  56,  65, 102, 116, 150, 155, 140, 128, 100,  73,  81,  96, 146, 171, 175,
+	182, 146, 114,  94,  89, 119, 167, 195, 222, 204, 115, 109,  94,  18, 157, 112,
+	 59,  53,  75, 126, 134, 163, 153, 122, 102,  84,  73,  98, 112, 165, 182, 177,
+	158, 122, 100,  95, 103, 140, 184, 198, 210, 182, 144, 116, 108,  58,  71, 137,
+	 58,  55,  81, 137, 139, 162, 136,  93,  85,  77,  80, 116, 127, 175, 181, 166,
+	148, 110,  93,  97, 112, 152, 188, 192, 205, 170,  63, 116,  31, 123, 123, 138,
+	 87,  87,  64,  64, 179, 179, 225, 225,  85,  85,  48,  48, 152, 152, 196, 196,
+	 80,  80,  67,  67, 130, 130, 168, 168, 102, 102,  70,  70, 131, 131, 186, 186,
+	 87,  87,  64,  64, 179, 179, 225, 225,  85,  85,  48,  48, 152, 152, 196, 196,
+	 80,  80,  67,  67, 130, 130, 168, 168, 102, 102,  70,  70, 131, 131, 186, 186,
+	 64,  64,  73,  73, 187, 187, 209, 209,  75,  75,  61,  61, 170, 170, 207, 207,
+	 75,  75,  70,  70, 147, 147, 176, 176,  87,  87,  57,  57, 135, 135, 190, 190,
+	 64,  64,  73,  73, 187, 187, 209, 209,  75,  75,  61,  61, 170, 170, 207, 207,
+	 75,  75,  70,  70, 147, 147, 176, 176,  87,  87,  57,  57, 135, 135, 190, 190,
+	147, 147, 185, 185, 132, 132,  95,  95, 149, 149, 148, 148, 100, 100, 109, 109,
+	155, 155, 135, 135,  62,  62,  77,  77, 173, 173, 152, 152,  84,  84, 106, 106,
+	147, 147, 185, 185, 132, 132,  95,  95, 149, 149, 148, 148, 100, 100, 109, 109,
+	155, 155, 135, 135,  62,  62,  77,  77, 173, 173, 152, 152,  84,  84, 106, 106,
+	161, 161, 217, 217, 133, 133,  65,  65, 148, 148, 172, 172, 100, 100,  81,  81,
+	127, 127, 145, 145,  97,  97,  87,  87, 146, 146, 130, 130,  91,  91, 130, 130,
+	161, 161, 217, 217, 133, 133,  65,  65, 148, 148, 172, 172, 100, 100,  81,  81,
+	127, 127, 145, 145,  97,  97,  87,  87, 146, 146, 130, 130,  91,  91, 130, 130,
+	 63,  63, 119, 119, 212, 212, 163, 163,  41,  41, 100, 100, 207, 207, 176, 176,
+	 45,  45,  61,  61, 191, 191, 189, 189,  26,  26,  49,  49, 194, 194, 208, 208,
+	 63,  63, 119, 119, 212, 212, 163, 163,  41,  41, 100, 100, 207, 207, 176, 176,
+	 45,  45,  61,  61, 191, 191, 189, 189,  26,  26,  49,  49, 194, 194, 208, 208,
+	102, 102, 127, 127, 183, 183, 151, 151,  71,  71, 117, 117, 183, 183, 144, 144,
+	 42,  42,  88,  88, 202, 202, 174, 174,  24,  24,  50,  50, 185, 185, 207, 207,
+	102, 102, 127, 127, 183, 183, 151, 151,  71,  71, 117, 117, 183, 183, 144, 144,
+	 42,  42,  88,  88, 202, 202, 174, 174,  24,  24,  50,  50, 185, 185, 207, 207,
+	219, 219, 205, 205,  85,  85,  61,  61, 189, 189, 194, 194,  78,  78,  38,  38,
+	159, 159, 177, 177,  84,  84,  41,  41, 144, 144, 178, 178, 110, 110,  88,  88,
+	219, 219, 205, 205,  85,  85,  61,  61, 189, 189, 194, 194,  78,  78,  38,  38,
+	159, 159, 177, 177,  84,  84,  41,  41, 144, 144, 178, 178, 110, 110,  88,  88,
+	221, 221, 190, 190,  64,  64,  61,  61, 209, 209, 200, 200,  71,  71,  45,  45,
+	178, 178, 197, 197,  78,  78,  25,  25, 153, 153, 189, 189,  97,  97,  66,  66,
+	221, 221, 190, 190,  64,  64,  61,  61, 209, 209, 200, 200,  71,  71,  45,  45,
+	178, 178, 197, 197,  78,  78,  25,  25, 153, 153, 189, 189,  97,  97,  66,  66,
+	 74,  74,  59,  59,  90,  90, 139, 139, 132, 132,  95,  95, 109, 109, 157, 157,
+	181, 181, 135, 135, 121, 121, 174, 174, 189, 189, 225, 225,  71,  71,  62,  62,
+	 74,  74,  59,  59,  90,  90, 139, 139, 132, 132,  95,  95, 109, 109, 157, 157,
+	181, 181, 135, 135, 121, 121, 174, 174, 189, 189, 225, 225,  71,  71,  62,  62,
+	 57,  57,  61,  61, 114, 114, 142, 142, 103, 103,  93,  93, 137, 137, 166, 166,
+	160, 160, 125, 125, 114, 114, 190, 190, 214, 214, 190, 190,  34,  34,  95,  95,
+	 57,  57,  61,  61, 114, 114, 142, 142, 103, 103,  93,  93, 137, 137, 166, 166,
+	160, 160, 125, 125, 114, 114, 190, 190, 214, 214, 190, 190,  34,  34,  95,  95,
+	 43,  43,  76,  76, 140, 140, 133, 133,  73,  73, 100, 100, 166, 166, 168, 168,
+	116, 116, 127, 127, 182, 182, 207, 207, 124, 124, 121, 121,  77,  77, 142, 142,
+	 43,  43,  76,  76, 140, 140, 133, 133,  73,  73, 100, 100, 166, 166, 168, 168,
+	116, 116, 127, 127, 182, 182, 207, 207, 124, 124, 121, 121,  77,  77, 142, 142,
+	 48,  48, 107, 107, 144, 144, 104, 104,  70,  70, 121, 121, 170, 170, 153, 153,
+	107, 107, 127, 127, 166, 166, 203, 203, 171, 171, 144, 144,  76,  76, 125, 125,
+	 48,  48, 107, 107, 144, 144, 104, 104,  70,  70, 121, 121, 170, 170, 153, 153,
+	107, 107, 127, 127, 166, 166, 203, 203, 171, 171, 144, 144,  76,  76, 125, 125,
+	 72,  72, 136, 136, 124, 124,  71,  71,  92,  92, 146, 146, 150, 150, 127, 127,
+	129, 129, 157, 157, 174, 174, 164, 164, 138, 138, 151, 151, 126, 126, 138, 138,
+	 72,  72, 136, 136, 124, 124,  71,  71,  92,  92, 146, 146, 150, 150, 127, 127,
+	129, 129, 157, 157, 174, 174, 164, 164, 138, 138, 151, 151, 126, 126, 138, 138,
+	 97,  97, 137, 137,  95,  95,  56,  56, 117, 117, 159, 159, 130, 130, 108, 108,
+	118, 118, 158, 158, 202, 202, 172, 172, 131, 131, 182, 182, 174, 174,  82,  82,
+	 97,  97, 137, 137,  95,  95,  56,  56, 117, 117, 159, 159, 130, 130, 108, 108,
+	118, 118, 158, 158, 202, 202, 172, 172, 131, 131, 182, 182, 174, 174,  82,  82,
+	109, 109, 111, 111,  73,  73,  67,  67, 129, 129, 155, 155, 125, 125, 105, 105,
+	125, 125, 177, 177, 200, 200, 168, 168, 135, 135, 124, 124, 142, 142, 149, 149,
+	109, 109, 111, 111,  73,  73,  67,  67, 129, 129, 155, 155, 125, 125, 105, 105,
+	125, 125, 177, 177, 200, 200, 168, 168, 135, 135, 124, 124, 142, 142, 149, 149,
+	111, 111,  83,  83,  63,  63,  84,  84, 129, 129, 147, 147, 129, 129, 109, 109,
+	161, 161, 154, 154, 167, 167, 157, 157, 145, 145, 165, 165, 169, 169,  84,  84,
+	111, 111,  83,  83,  63,  63,  84,  84, 129, 129, 147, 147, 129, 129, 109, 109,
+	161, 161, 154, 154, 167, 167, 157, 157, 145, 145, 165, 165, 169, 169,  84,  84,
+};
+
+class JPEGTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_read() {
+		Common::MemoryReadStream stream(jpeg_test_image, sizeof(jpeg_test_image));
+		Graphics::JPEG jpeg;
+
+		TS_ASSERT(jpeg.read(&stream));
+		TS_ASSERT_EQUALS(jpeg.getWidth(), 32);
+		TS_ASSERT_EQUALS(jpeg.getHeight(), 16);
+	}
+
+	void test_idct_accuracy() {
+		Common::MemoryReadStream stream(jpeg_test_image, sizeof(jpeg_test_image));
+		Graphics::JPEG jpeg;
+		TS_ASSERT(jpeg.read(&stream));
+
+		// The fixed point IDCT may round differently, but by 1 at most
+		const byte *reference = jpeg_test_reference;
+		for (int c = 1; c <= 3; c++) {
+			Graphics::Surface *component = jpeg.getComponent(c);
+			TS_ASSERT(component);
+			if (!component)
+				return;
+
+			TS_ASSERT_EQUALS(component->w, 32);
+			TS_ASSERT_EQUALS(component->h, 16);
+
+			for (int y = 0; y < 16; y++) {
+				for (int x = 0; x < 32; x++) {
+					const int diff = *(const byte *)component->getBasePtr(x, y) - *reference++;
+					TS_ASSERT_LESS_THAN_EQUALS(diff, 1);
+					TS_ASSERT_LESS_THAN_EQUALS(-1, diff);
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/conversion.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../video/helper.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	// The manager creates its lookups under a lock
+	VideoTestSystem _system;
+
+	static uint32 referenceColor(const Graphics::PixelFormat &format, byte y, byte u, byte v) {
+		byte r, g, b;
+		Graphics::YUV2RGB(y, u, v, r, g, b);
+		return format.RGBToColor(r, g, b);
+	}
+
+	void checkLookup(const Graphics::PixelFormat &format) {
+		Graphics::YUVToRGBLookup lookup(format);
+		uint32 mismatches = 0, firstMismatch = 0;
+
+		for (int y = 0; y < 256; y++)
+			for (int u = 0; u < 256; u++)
+				for (int v = 0; v < 256; v++)
+					if (lookup.convert(y, u, v) != referenceColor(format, y, u, v) && !mismatches++)
+						firstMismatch = (y << 16) | (u << 8) | v;
+
+		// The first differing color is given as 0xYYUUVV
+		TS_ASSERT_EQUALS(mismatches, 0u);
+		TS_ASSERT_EQUALS(firstMismatch, 0u);
+	}
+
+	template<typename PixelInt>
+	void checkImage(const Graphics::PixelFormat &format, int shift) {
+		const int w = 13, h = 7;
+		const int uvW = (w + (1 << shift) - 1) >> shift;
+		const int uvH = (h + (1 << shift) - 1) >> shift;
+		byte yPlane[w * h], uPlane[7 * 4], vPlane[7 * 4];
+		PixelInt image[w * h];
+
+		for (int i = 0; i < w * h; i++)
+			yPlane[i] = i * 37;
+		for (int i = 0; i < uvW * uvH; i++) {
+			uPlane[i] = i * 71 + 3;
+			vPlane[i] = 250 - i * 53;
+		}
+
+		if (shift == 1)
+			Graphics::convertYUV420ToRGB((byte *)image, w * sizeof(PixelInt), format, yPlane, uPlane, vPlane, w, h, w, uvW);
+		else
+			Graphics::convertYUV410ToRGB((byte *)image, w * sizeof(PixelInt), format, yPlane, uPlane, vPlane, w, h, w, uvW);
+
+		for (int y = 0; y < h; y++) {
+			for (int x = 0; x < w; x++) {
+				const int uv = (y >> shift) * uvW + (x >> shift);
+				TS_ASSERT_EQUALS((uint32)image[y * w + x], referenceColor(format, yPlane[y * w + x], uPlane[uv], vPlane[uv]));
+			}
+		}
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_lookup_565() {
+		checkLookup(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_lookup_8888() {
+		checkLookup(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	}
+
+	void test_convert_420() {
+		checkImage<uint16>(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), 1);
+		checkImage<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 1);
+	}
+
+	void test_convert_410() {
+		checkImage<uint16>(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), 2);
+		checkImage<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 2);
+	}
+};
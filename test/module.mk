@@ -5,8 +5,17 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/sound/*.h
-TEST_LIBS    := sound/libsound.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/sound/*.h $(srcdir)/test/video/*.h
+TEST_LIBS    := video/libvideo.a sound/libsound.a graphics/libgraphics.a common/libcommon.a
+
+# Engine tests need the engine linked in statically
+ifeq ($(ENABLE_SCUMM), STATIC_PLUGIN)
+TESTS        += $(srcdir)/test/engines/scumm/*.h
+ifdef ENABLE_HE
+TESTS        += $(srcdir)/test/engines/scumm/he/*.h
+endif
+TEST_LIBS    := test/engines/base.o engines/scumm/libscumm.a engines/libengines.a gui/libgui.a $(TEST_LIBS)
+endif
 
 #
 TEST_FLAGS   := --runner=StdioPrinter
@@ -29,7 +38,7 @@ endif
 test: test/runner
 	./test/runner
 test/runner: test/runner.cpp $(TEST_LIBS)
-	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_LDFLAGS) $(TEST_CFLAGS) -o $@ $+
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
 test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
@@ -37,6 +46,6 @@ test/runner.cpp: $(TESTS)
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/engines/base.o
 
 .PHONY: test clean-test
@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/codecs/cinepak.h"
+
+#include "common/array.h"
+#include "common/memstream.h"
+
+#include "helper.h"
+
+/*
+ * Two synthetic 64x48 frames of three strips, with random codebooks and
+ * vectors of all chunk types. In the first frame the later strips use the
+ * codebooks of the earlier ones, and the last strip loads a codebook in
+ * between two vector chunks. In the second one the strips keep their own
+ * codebooks, and draw over the first frame.
+ */
+enum {
+	kCinepakTestWidth = 64,
+	kCinepakTestHeight = 48
+};
+
+struct CinepakTestChunk {
+	byte id;
+	uint16 size;
+};
+
+/**
+ * MD5 sums of the frames in 8, 16 and 32 bits, as drawn by the decoder
+ * before it drew the strips through a job runner. The screen is always 8
+ * bits without RGB color support.
+ */
+static const char *cinepak_test_md5[3][2] = {
+	{ "4208a6218d20d3781fb795934e34e68a", "388f6da0492574e1117e16e70f194c47" },
+	{ "926be1f58cacaa3355f5abb767b25c59", "6b4ebdbd26f35fa8050d9fd65e642a29" },
+	{ "3bd1aeff04a58937b81aedae694c8a58", "2f196ed959ad3a43d3a8497a8e9e8e44" }
+};
+
+/** A stream the decoder can't use the data of in place. */
+class CinepakTestStream : public Common::MemoryReadStream {
+public:
+	CinepakTestStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size) {}
+	const byte *getDataPtr() const { return 0; }
+};
+
+class CinepakDecoderTestSuite : public CxxTest::TestSuite {
+	JobTestSystem _system;
+	uint32 _seed;
+	Common::Array<byte> _frames[2];
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xFF;
+	}
+
+	static void writeUint16(Common::Array<byte> &data, uint16 value) {
+		data.push_back(value >> 8);
+		data.push_back(value & 0xFF);
+	}
+
+	static void writeUint24(Common::Array<byte> &data, uint32 value) {
+		data.push_back(value >> 16);
+		writeUint16(data, value & 0xFFFF);
+	}
+
+	// Strips of 16 rows, each a list of chunks terminated by a zero size
+	void createFrame(Common::Array<byte> &frame, byte flags, const CinepakTestChunk *chunks) {
+		frame.clear();
+		frame.push_back(flags);
+		writeUint24(frame, 0);
+		writeUint16(frame, kCinepakTestWidth);
+		writeUint16(frame, kCinepakTestHeight);
+		writeUint16(frame, kCinepakTestHeight / 16);
+
+		for (int strip = 0; strip < kCinepakTestHeight / 16; strip++, chunks++) {
+			Common::Array<byte> data;
+			for (; chunks->size; chunks++) {
+				data.push_back(chunks->id);
+				writeUint24(data, chunks->size + 4);
+				for (int i = 0; i < chunks->size; i++)
+					data.push_back(nextRandom());
+			}
+
+			writeUint16(frame, 0x1000);
+			writeUint16(frame, data.size() + 12);
+			writeUint16(frame, 0);
+			writeUint16(frame, 0);
+			writeUint16(frame, 16);
+			writeUint16(frame, kCinepakTestWidth);
+			for (uint i = 0; i < data.size(); i++)
+				frame.push_back(data[i]);
+		}
+
+		// The frame length has to match the size to not be taken for Sega's
+		frame[1] = frame.size() >> 16;
+		frame[2] = (frame.size() >> 8) & 0xFF;
+		frame[3] = frame.size() & 0xFF;
+	}
+
+	void checkFrames(int bitsPerPixel, const char *const *md5) {
+		Video::CinepakDecoder decoder(bitsPerPixel);
+		Video::CinepakDecoder streamDecoder(bitsPerPixel);
+
+		for (int i = 0; i < 2; i++) {
+			Common::MemoryReadStream frame(_frames[i].begin(), _frames[i].size());
+			const Graphics::Surface *surface = decoder.decodeImage(&frame);
+			TS_ASSERT(surface);
+			const Common::String sum = computeSurfaceMD5(surface);
+			TS_ASSERT_EQUALS(sum, md5[i]);
+
+			CinepakTestStream streamFrame(_frames[i].begin(), _frames[i].size());
+			TS_ASSERT_EQUALS(computeSurfaceMD5(streamDecoder.decodeImage(&streamFrame)), sum);
+		}
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+		_seed = 1;
+
+		// Full and partial codebooks in color and greyscale, and vectors
+		// too short for a whole strip
+		static const CinepakTestChunk frame0[] = {
+			{ 0x20, 1536 }, { 0x22, 1536 }, { 0x30, 300 }, { 0, 0 },
+			{ 0x21, 300 }, { 0x31, 200 }, { 0, 0 },
+			{ 0x32, 40 }, { 0x23, 200 }, { 0x30, 300 }, { 0, 0 }
+		};
+		static const CinepakTestChunk frame1[] = {
+			{ 0x24, 1024 }, { 0x26, 1024 }, { 0x31, 150 }, { 0, 0 },
+			{ 0x25, 200 }, { 0x30, 300 }, { 0, 0 },
+			{ 0x27, 100 }, { 0x31, 100 }, { 0, 0 }
+		};
+		createFrame(_frames[0], 0, frame0);
+		createFrame(_frames[1], 1, frame1);
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_8bit() {
+		checkFrames(8, cinepak_test_md5[0]);
+	}
+
+	void test_16bit() {
+#ifdef USE_RGB_COLOR
+		_system.setScreenFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		checkFrames(16, cinepak_test_md5[1]);
+#endif
+	}
+
+	void test_32bit() {
+#ifdef USE_RGB_COLOR
+		_system.setScreenFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		checkFrames(24, cinepak_test_md5[2]);
+#endif
+	}
+};
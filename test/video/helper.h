@@ -0,0 +1,168 @@
+#ifndef TEST_VIDEO_HELPER_H
+#define TEST_VIDEO_HELPER_H
+
+#include "common/system.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/timer.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+
+/**
+ *The decoders ask the system for the time and for mutexes. This system
+ *implements those with a fixed time and no locking, and nothing else.
+ */
+class VideoTestSystem : public OSystem {
+public:
+	const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return false; }
+	int getGraphicsMode() const { return 0; }
+	void resetGraphicsScale() {}
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	void setPalette(const byte *colors, uint start, uint num) {}
+	void grabPalette(byte *colors, uint start, uint num) {}
+	void copyRectToScreen(const byte *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
+	void clearOverlay() {}
+	void grabOverlay(OverlayColor *buf, int pitch) {}
+	void copyRectToOverlay(const OverlayColor *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const byte *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, int cursorTargetScale, const Graphics::PixelFormat *format) {}
+	void getTimeAndDate(TimeDate &t) const {}
+	Common::EventManager *getEventManager() { return 0; }
+	Audio::Mixer *getMixer() { return 0; }
+	AudioCDManager *getAudioCDManager() { return 0; }
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	Common::SaveFileManager *getSavefileManager() { return 0; }
+	FilesystemFactory *getFilesystemFactory() { return 0; }
+	Common::SeekableReadStream *createConfigReadStream() { return 0; }
+	Common::WriteStream *createConfigWriteStream() { return 0; }
+
+	uint32 getMillis() { return 0; }
+	void delayMillis(uint msecs) {}
+	Common::TimerManager *getTimerManager() { return 0; }
+
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+};
+
+/**
+ * Returns the MD5 sum of the pixels of a surface, stored little endian so
+ * that the sums don't depend on the byte order.
+ */
+static inline Common::String computeSurfaceMD5(const Graphics::Surface *surface) {
+	Common::Array<byte> pixels;
+	for (int y = 0; y < surface->h; y++) {
+		const byte *src = (const byte *)surface->getBasePtr(0, y);
+		for (int x = 0; x < surface->w; x++, src += surface->bytesPerPixel) {
+			uint32 color;
+			if (surface->bytesPerPixel == 1)
+				color = *src;
+			else if (surface->bytesPerPixel == 2)
+				color = READ_UINT16(src);
+			else
+				color = READ_UINT32(src);
+
+			for (int i = 0; i < surface->bytesPerPixel; i++)
+				pixels.push_back((color >> (i * 8)) & 0xFF);
+		}
+	}
+
+	Common::MemoryReadStream stream(pixels.begin(), pixels.size());
+	return Common::computeStreamMD5AsString(stream);
+}
+
+/**
+ * A system whose timer callbacks run when a mutex is locked while no other
+ * one is, every other time. Job runners then get jobs taken over by their
+ * timer callback in between their own ones, as if it ran in a separate
+ * thread.
+ */
+class JobTestSystem : public VideoTestSystem {
+	class JobTestTimerManager : public Common::TimerManager {
+	public:
+		struct Slot {
+			TimerProc proc;
+			void *refCon;
+		};
+
+		Common::List<Slot> _slots;
+
+		bool installTimerProc(TimerProc proc, int32 interval, void *refCon) {
+			Slot slot = { proc, refCon };
+			_slots.push_back(slot);
+			return true;
+		}
+
+		void removeTimerProc(TimerProc proc) {
+			for (Common::List<Slot>::iterator it = _slots.begin(); it != _slots.end(); ) {
+				if (it->proc == proc)
+					it = _slots.erase(it);
+				else
+					++it;
+			}
+		}
+	};
+
+	JobTestTimerManager _timer;
+	int _lockDepth;
+	uint _locks;
+	bool _inTimer;
+#ifdef USE_RGB_COLOR
+	Graphics::PixelFormat _screenFormat;
+#endif
+
+public:
+	JobTestSystem() : _lockDepth(0), _locks(0), _inTimer(false) {
+#ifdef USE_RGB_COLOR
+		_screenFormat = Graphics::PixelFormat::createFormatCLUT8();
+#endif
+	}
+
+	Common::TimerManager *getTimerManager() { return &_timer; }
+
+#ifdef USE_RGB_COLOR
+	/** Sets the format the decoders convert to */
+	void setScreenFormat(const Graphics::PixelFormat &format) { _screenFormat = format; }
+	Graphics::PixelFormat getScreenFormat() const { return _screenFormat; }
+#endif
+
+	/** Returns whether the timer callbacks are running */
+	bool isInTimer() const { return _inTimer; }
+
+	void lockMutex(MutexRef mutex) {
+		if (_lockDepth == 0 && !_inTimer && (++_locks & 1)) {
+			_inTimer = true;
+			for (Common::List<JobTestTimerManager::Slot>::iterator it = _timer._slots.begin(); it != _timer._slots.end(); ++it)
+				it->proc(it->refCon);
+			_inTimer = false;
+		}
+		_lockDepth++;
+	}
+
+	void unlockMutex(MutexRef mutex) {
+		_lockDepth--;
+	}
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/codecs/indeo3.h"
+
+#include "common/array.h"
+#include "common/memstream.h"
+
+#include "helper.h"
+
+/*
+ * Two synthetic 64x48 frames. Each plane is split into two strips coded
+ * with corrections to the row above. In the second frame, the first strip
+ * is predicted from the first frame through a motion vector instead. The
+ * corrections are picked so that every row of four pixels takes either
+ * one or two bytes, and no run length codes.
+ */
+enum {
+	kIndeo3TestWidth = 64,
+	kIndeo3TestHeight = 48
+};
+
+/**
+ * MD5 sums of the frames, unscaled and scaled to twice the size, as drawn
+ * by the decoder before it decoded the planes through a job runner. The
+ * frames are converted to 16 bits, so without RGB color support there's
+ * nothing to check.
+ */
+static const char *indeo3_test_md5[2][2] = {
+	{ "ce95d434102fb348e54406bebcfbfcae", "cdac97510dfc4aefc0467aa2dc242b07" },
+	{ "9ac621e439e09353a720160a29112228", "c2108f8e4094890b148996b137dd2db3" }
+};
+
+class Indeo3DecoderTestSuite : public CxxTest::TestSuite {
+	JobTestSystem _system;
+	uint32 _seed;
+	Common::Array<byte> _frames[2];
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xFF;
+	}
+
+	static void writeUint16(Common::Array<byte> &data, uint16 value) {
+		data.push_back(value & 0xFF);
+		data.push_back(value >> 8);
+	}
+
+	static void writeUint32(Common::Array<byte> &data, uint32 value) {
+		writeUint16(data, value & 0xFFFF);
+		writeUint16(data, value >> 16);
+	}
+
+	// Corrections below the threshold of the table take an extra byte,
+	// those from 248 on are special codes
+	void addCorrections(Common::Array<byte> &data, int width, int height, int threshold) {
+		for (int i = 0; i < width * height / 4; i++) {
+			const byte correction = nextRandom() % 248;
+			data.push_back(correction);
+			if (correction < threshold)
+				data.push_back(nextRandom());
+		}
+	}
+
+	// Split in two strips. The first one is coded with table 3, and in the
+	// inter frame from the previous frame one row up. The second one uses
+	// table 10, which also rescales the row above.
+	void addPlane(Common::Array<byte> &frame, uint32 offsetPos, int width, int height, bool inter) {
+		const int firstHeight = (height > 8) ? ((height + 8) >> 4) << 3 : 4;
+		const uint32 offset = frame.size() - 16;
+
+		frame[offsetPos + 0] = offset & 0xFF;
+		frame[offsetPos + 1] = (offset >> 8) & 0xFF;
+		frame[offsetPos + 2] = (offset >> 16) & 0xFF;
+		frame[offsetPos + 3] = offset >> 24;
+
+		// The motion vectors, as rows and columns, come first
+		writeUint32(frame, 2);
+		frame.push_back(0);
+		frame.push_back(0);
+		frame.push_back(0xFF);
+		frame.push_back(0);
+
+		if (inter) {
+			frame.push_back(0x3E);
+			frame.push_back(1);
+		} else {
+			frame.push_back(0x2E);
+		}
+		frame.push_back(0x03);
+		addCorrections(frame, width, firstHeight, 115);
+
+		frame.push_back(0xC0);
+		frame.push_back(0x0A);
+		addCorrections(frame, width, height - firstHeight, 133);
+	}
+
+	void createFrame(Common::Array<byte> &frame, bool inter) {
+		const int chromaWidth = ((kIndeo3TestWidth >> 2) + 3) & ~3;
+		const int chromaHeight = ((kIndeo3TestHeight >> 2) + 3) & ~3;
+
+		frame.clear();
+		frame.resize(48);
+		for (uint i = 0; i < frame.size(); i++)
+			frame[i] = 0;
+
+		// Flag 0x200 swaps the current and the reference frame
+		if (inter)
+			frame[19] = 0x02;
+		frame[28] = kIndeo3TestHeight;
+		frame[30] = kIndeo3TestWidth;
+
+		addPlane(frame, 32, kIndeo3TestWidth, kIndeo3TestHeight, inter);
+		addPlane(frame, 36, chromaWidth, chromaHeight, inter);
+		addPlane(frame, 40, chromaWidth, chromaHeight, inter);
+
+		// The header words XORed spell FRMH, the third one is the size
+		const uint32 size = frame.size();
+		const uint32 id0 = MKID_BE('FRMH') ^ size;
+		for (int i = 0; i < 4; i++) {
+			frame[i] = (id0 >> (i * 8)) & 0xFF;
+			frame[8 + i] = (size >> (i * 8)) & 0xFF;
+		}
+	}
+
+	void checkFrames(int scale, const char *const *md5) {
+#if defined(USE_INDEO3) && defined(USE_RGB_COLOR)
+		Video::Indeo3Decoder decoder(kIndeo3TestWidth * scale, kIndeo3TestHeight * scale);
+
+		for (int i = 0; i < 2; i++) {
+			Common::MemoryReadStream frame(_frames[i].begin(), _frames[i].size());
+			TS_ASSERT(Video::Indeo3Decoder::isIndeo3(frame));
+
+			frame.seek(0);
+			const Graphics::Surface *surface = decoder.decodeImage(&frame);
+			TS_ASSERT(surface);
+			TS_ASSERT_EQUALS(computeSurfaceMD5(surface), md5[i]);
+		}
+#endif
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+#ifdef USE_RGB_COLOR
+		_system.setScreenFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+#endif
+
+		_seed = 1;
+		createFrame(_frames[0], false);
+		createFrame(_frames[1], true);
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_frames() {
+		checkFrames(1, indeo3_test_md5[0]);
+	}
+
+	void test_scaled_frames() {
+		checkFrames(2, indeo3_test_md5[1]);
+	}
+};
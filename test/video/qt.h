@@ -0,0 +1,387 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/qt_decoder.h"
+
+#include "sound/mixer_intern.h"
+
+#include "common/memstream.h"
+
+#include "helper.h"
+
+/*
+ * A synthetic movie of six 8x4 8 bit QuickTime RLE frames with key frames at
+ * 0 and 3, and an 8000 Hz 16 bit mono 'twos' track. Both tracks use a time
+ * scale of 8000. Key frames fill whole lines with a color of their own, the
+ * other frames only the left half of each line, so the right half shows which
+ * key frame the decoder started from.
+ *
+ * The first audio sample takes no time, and the whole last time-to-sample
+ * entry lasts 2^32 units. Audio sample i has the value i + 1.
+ */
+static const uint32 qt_test_frameCount = 6;
+static const uint32 qt_test_frameSize = 34;
+static const uint32 qt_test_frameTimes[] = { 0, 100, 200, 250, 300, 350, 550 };
+
+static const uint32 qt_test_videoSTTS[][2] = { { 2, 100 }, { 3, 50 }, { 1, 200 } };
+static const uint32 qt_test_audioSTTS[][2] = { { 1, 0 }, { 299, 1 }, { 256, 0x1000000 } };
+
+static const uint32 qt_test_audioSamples = 556;
+static const uint32 qt_test_audioChunkSamples = 100;
+
+class QuickTimeDecoderTestSuite : public CxxTest::TestSuite {
+	// The decoder plays the audio through the mixer
+	class QuickTimeTestSystem : public VideoTestSystem {
+	public:
+		Audio::MixerImpl *_mixer;
+
+		QuickTimeTestSystem() : _mixer(0) {}
+
+		Audio::Mixer *getMixer() { return _mixer; }
+	};
+
+	QuickTimeTestSystem _system;
+
+	static bool isKeyFrame(uint32 frame) {
+		return frame == 0 || frame == 3;
+	}
+
+	static byte frameColor(uint32 frame) {
+		return 0x10 + frame * 0x21;
+	}
+
+	static void writeAtom(Common::WriteStream &out, uint32 type, Common::MemoryWriteStreamDynamic &content) {
+		out.writeUint32BE(content.size() + 8);
+		out.writeUint32BE(type);
+		out.write(content.getData(), content.size());
+	}
+
+	static void writeMatrix(Common::WriteStream &out) {
+		static const uint32 matrix[] = { 0x10000, 0, 0, 0, 0x10000, 0, 0, 0, 0x40000000 };
+
+		for (int i = 0; i < 9; i++)
+			out.writeUint32BE(matrix[i]);
+	}
+
+	static void writeSTTS(Common::WriteStream &out, const uint32 (*entries)[2], uint32 count) {
+		Common::MemoryWriteStreamDynamic stts(DisposeAfterUse::YES);
+		stts.writeUint32BE(0);
+		stts.writeUint32BE(count);
+		for (uint32 i = 0; i < count; i++) {
+			stts.writeUint32BE(entries[i][0]);
+			stts.writeUint32BE(entries[i][1]);
+		}
+		writeAtom(out, MKID_BE('stts'), stts);
+	}
+
+	static void writeTrack(Common::WriteStream &out, uint32 handlerType, Common::MemoryWriteStreamDynamic &stbl) {
+		Common::MemoryWriteStreamDynamic tkhd(DisposeAfterUse::YES);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(1);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(qt_test_frameTimes[qt_test_frameCount]);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(0);
+		tkhd.writeUint32BE(0);
+		writeMatrix(tkhd);
+		tkhd.writeUint32BE(8 << 16);
+		tkhd.writeUint32BE(4 << 16);
+
+		Common::MemoryWriteStreamDynamic mdhd(DisposeAfterUse::YES);
+		mdhd.writeUint32BE(0);
+		mdhd.writeUint32BE(0);
+		mdhd.writeUint32BE(0);
+		mdhd.writeUint32BE(8000);
+		mdhd.writeUint32BE(qt_test_frameTimes[qt_test_frameCount]);
+		mdhd.writeUint32BE(0);
+
+		Common::MemoryWriteStreamDynamic hdlr(DisposeAfterUse::YES);
+		hdlr.writeUint32BE(0);
+		hdlr.writeUint32BE(MKID_BE('mhlr'));
+		hdlr.writeUint32BE(handlerType);
+		hdlr.writeUint32BE(0);
+		hdlr.writeUint32BE(0);
+		hdlr.writeUint32BE(0);
+
+		Common::MemoryWriteStreamDynamic minf(DisposeAfterUse::YES);
+		writeAtom(minf, MKID_BE('stbl'), stbl);
+
+		Common::MemoryWriteStreamDynamic mdia(DisposeAfterUse::YES);
+		writeAtom(mdia, MKID_BE('mdhd'), mdhd);
+		writeAtom(mdia, MKID_BE('hdlr'), hdlr);
+		writeAtom(mdia, MKID_BE('minf'), minf);
+
+		Common::MemoryWriteStreamDynamic trak(DisposeAfterUse::YES);
+		writeAtom(trak, MKID_BE('tkhd'), tkhd);
+		writeAtom(trak, MKID_BE('mdia'), mdia);
+
+		writeAtom(out, MKID_BE('trak'), trak);
+	}
+
+	static void writeVideoTrack(Common::WriteStream &out, uint32 dataOffset) {
+		Common::MemoryWriteStreamDynamic stbl(DisposeAfterUse::YES);
+
+		Common::MemoryWriteStreamDynamic stsd(DisposeAfterUse::YES);
+		stsd.writeUint32BE(0);
+		stsd.writeUint32BE(1);
+		stsd.writeUint32BE(102);
+		stsd.writeUint32BE(MKID_BE('rle '));
+		stsd.writeUint32BE(0);
+		stsd.writeUint16BE(0);
+		stsd.writeUint16BE(1);
+		for (int i = 0; i < 4; i++)
+			stsd.writeUint32BE(0);
+		stsd.writeUint16BE(8);
+		stsd.writeUint16BE(4);
+		stsd.writeUint32BE(72 << 16);
+		stsd.writeUint32BE(72 << 16);
+		stsd.writeUint32BE(0);
+		stsd.writeUint16BE(1);
+		for (int i = 0; i < 8; i++)
+			stsd.writeUint32BE(0);
+		stsd.writeUint16BE(8);
+		stsd.writeUint16BE(0);
+		stsd.writeUint32BE(0);
+		stsd.writeUint16BE(0);
+		stsd.writeUint16BE(0);
+		stsd.writeUint32BE(0);
+		stsd.writeUint32BE(0);
+		writeAtom(stbl, MKID_BE('stsd'), stsd);
+
+		writeSTTS(stbl, qt_test_videoSTTS, ARRAYSIZE(qt_test_videoSTTS));
+
+		Common::MemoryWriteStreamDynamic stss(DisposeAfterUse::YES);
+		stss.writeUint32BE(0);
+		stss.writeUint32BE(2);
+		stss.writeUint32BE(1);
+		stss.writeUint32BE(4);
+		writeAtom(stbl, MKID_BE('stss'), stss);
+
+		Common::MemoryWriteStreamDynamic stsc(DisposeAfterUse::YES);
+		stsc.writeUint32BE(0);
+		stsc.writeUint32BE(1);
+		stsc.writeUint32BE(1);
+		stsc.writeUint32BE(1);
+		stsc.writeUint32BE(1);
+		writeAtom(stbl, MKID_BE('stsc'), stsc);
+
+		Common::MemoryWriteStreamDynamic stsz(DisposeAfterUse::YES);
+		stsz.writeUint32BE(0);
+		stsz.writeUint32BE(qt_test_frameSize);
+		stsz.writeUint32BE(qt_test_frameCount);
+		writeAtom(stbl, MKID_BE('stsz'), stsz);
+
+		Common::MemoryWriteStreamDynamic stco(DisposeAfterUse::YES);
+		stco.writeUint32BE(0);
+		stco.writeUint32BE(qt_test_frameCount);
+		for (uint32 i = 0; i < qt_test_frameCount; i++)
+			stco.writeUint32BE(dataOffset + i * qt_test_frameSize);
+		writeAtom(stbl, MKID_BE('stco'), stco);
+
+		writeTrack(out, MKID_BE('vide'), stbl);
+	}
+
+	static void writeAudioTrack(Common::WriteStream &out, uint32 dataOffset) {
+		Common::MemoryWriteStreamDynamic stbl(DisposeAfterUse::YES);
+		uint32 chunkCount = (qt_test_audioSamples + qt_test_audioChunkSamples - 1) / qt_test_audioChunkSamples;
+
+		Common::MemoryWriteStreamDynamic stsd(DisposeAfterUse::YES);
+		stsd.writeUint32BE(0);
+		stsd.writeUint32BE(1);
+		stsd.writeUint32BE(36);
+		stsd.writeUint32BE(MKID_BE('twos'));
+		stsd.writeUint32BE(0);
+		stsd.writeUint16BE(0);
+		stsd.writeUint16BE(1);
+		stsd.writeUint16BE(0);
+		stsd.writeUint16BE(0);
+		stsd.writeUint32BE(0);
+		stsd.writeUint16BE(1);
+		stsd.writeUint16BE(16);
+		stsd.writeUint16BE(0);
+		stsd.writeUint16BE(0);
+		stsd.writeUint32BE(8000 << 16);
+		writeAtom(stbl, MKID_BE('stsd'), stsd);
+
+		writeSTTS(stbl, qt_test_audioSTTS, ARRAYSIZE(qt_test_audioSTTS));
+
+		Common::MemoryWriteStreamDynamic stsc(DisposeAfterUse::YES);
+		stsc.writeUint32BE(0);
+		stsc.writeUint32BE(2);
+		stsc.writeUint32BE(1);
+		stsc.writeUint32BE(qt_test_audioChunkSamples);
+		stsc.writeUint32BE(1);
+		stsc.writeUint32BE(chunkCount);
+		stsc.writeUint32BE(qt_test_audioSamples - (chunkCount - 1) * qt_test_audioChunkSamples);
+		stsc.writeUint32BE(1);
+		writeAtom(stbl, MKID_BE('stsc'), stsc);
+
+		Common::MemoryWriteStreamDynamic stsz(DisposeAfterUse::YES);
+		stsz.writeUint32BE(0);
+		stsz.writeUint32BE(1);
+		stsz.writeUint32BE(qt_test_audioSamples);
+		writeAtom(stbl, MKID_BE('stsz'), stsz);
+
+		Common::MemoryWriteStreamDynamic stco(DisposeAfterUse::YES);
+		stco.writeUint32BE(0);
+		stco.writeUint32BE(chunkCount);
+		for (uint32 i = 0; i < chunkCount; i++)
+			stco.writeUint32BE(dataOffset + i * qt_test_audioChunkSamples * 2);
+		writeAtom(stbl, MKID_BE('stco'), stco);
+
+		writeTrack(out, MKID_BE('soun'), stbl);
+	}
+
+	static void writeMOOV(Common::WriteStream &out, uint32 dataOffset) {
+		Common::MemoryWriteStreamDynamic mvhd(DisposeAfterUse::YES);
+		mvhd.writeUint32BE(0);
+		mvhd.writeUint32BE(0);
+		mvhd.writeUint32BE(0);
+		mvhd.writeUint32BE(8000);
+		mvhd.writeUint32BE(qt_test_frameTimes[qt_test_frameCount]);
+		mvhd.writeUint32BE(0x10000);
+		mvhd.writeUint16BE(0x100);
+		for (int i = 0; i < 5; i++)
+			mvhd.writeUint16BE(0);
+		writeMatrix(mvhd);
+		for (int i = 0; i < 6; i++)
+			mvhd.writeUint32BE(0);
+		mvhd.writeUint32BE(3);
+
+		Common::MemoryWriteStreamDynamic moov(DisposeAfterUse::YES);
+		writeAtom(moov, MKID_BE('mvhd'), mvhd);
+		writeVideoTrack(moov, dataOffset);
+		writeAudioTrack(moov, dataOffset + qt_test_frameCount * qt_test_frameSize);
+
+		writeAtom(out, MKID_BE('moov'), moov);
+	}
+
+	static Common::SeekableReadStream *createMovie() {
+		// The chunk offsets depend on the size of the movie atom
+		Common::MemoryWriteStreamDynamic sizeCheck(DisposeAfterUse::YES);
+		writeMOOV(sizeCheck, 0);
+
+		Common::MemoryWriteStreamDynamic mdat(DisposeAfterUse::YES);
+
+		for (uint32 i = 0; i < qt_test_frameCount; i++) {
+			mdat.writeUint32BE(qt_test_frameSize);
+			mdat.writeUint16BE(0);
+
+			for (int y = 0; y < 4; y++) {
+				// Repeat four pixels twice, or copy four pixels
+				mdat.writeByte(1);
+				mdat.writeByte(isKeyFrame(i) ? 0xFE : 0x01);
+				mdat.writeUint32BE(frameColor(i) * 0x01010101);
+				mdat.writeByte(0xFF);
+			}
+		}
+
+		for (uint32 i = 0; i < qt_test_audioSamples; i++)
+			mdat.writeUint16BE(i + 1);
+
+		Common::MemoryWriteStreamDynamic movie;
+		writeMOOV(movie, sizeCheck.size() + 8);
+		writeAtom(movie, MKID_BE('mdat'), mdat);
+
+		return new Common::MemoryReadStream(movie.getData(), movie.size(), DisposeAfterUse::YES);
+	}
+
+	static void copyFrame(const Graphics::Surface *surface, byte *pixels) {
+		for (int y = 0; y < surface->h; y++)
+			memcpy(pixels + y * surface->w, surface->getBasePtr(0, y), surface->w);
+	}
+
+	static bool compareFrame(const Graphics::Surface *surface, const byte *pixels) {
+		for (int y = 0; y < surface->h; y++)
+			if (memcmp(pixels + y * surface->w, surface->getBasePtr(0, y), surface->w))
+				return false;
+
+		return true;
+	}
+
+	void checkAudioAfterSeek(Video::QuickTimeDecoder &decoder, uint32 frame, int16 firstSample) {
+		decoder.seekToFrame(frame);
+
+		int16 buffer[2 * 16];
+		_system._mixer->mixCallback((byte *)buffer, sizeof(buffer));
+
+		for (int i = 0; i < 16; i++) {
+			TS_ASSERT_EQUALS(buffer[i * 2], firstSample + i);
+			TS_ASSERT_EQUALS(buffer[i * 2 + 1], firstSample + i);
+		}
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+		_system._mixer = new Audio::MixerImpl(&_system, 8000);
+		_system._mixer->setReady(true);
+	}
+
+	void tearDown() {
+		delete _system._mixer;
+		_system._mixer = 0;
+		g_system = 0;
+	}
+
+	void test_seek_to_frame() {
+		Video::QuickTimeDecoder decoder;
+		byte frames[qt_test_frameCount][8 * 4];
+
+		TS_ASSERT(decoder.load(createMovie()));
+		TS_ASSERT_EQUALS(decoder.getWidth(), 8);
+		TS_ASSERT_EQUALS(decoder.getHeight(), 4);
+		TS_ASSERT_EQUALS(decoder.getFrameCount(), qt_test_frameCount);
+
+		for (uint32 i = 0; i < qt_test_frameCount; i++) {
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			TS_ASSERT(surface);
+			copyFrame(surface, frames[i]);
+		}
+
+		// Go back and forth, so that a frame decoded from the wrong key
+		// frame shows the right half of another one
+		static const uint32 seekFrames[] = { 1, 5, 2, 4, 0, 3, 2 };
+
+		for (uint32 i = 0; i < ARRAYSIZE(seekFrames); i++) {
+			decoder.seekToFrame(seekFrames[i]);
+
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			TS_ASSERT(surface);
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), (int32)seekFrames[i]);
+			TS_ASSERT(compareFrame(surface, frames[seekFrames[i]]));
+		}
+	}
+
+	void test_seek_to_time() {
+		Video::QuickTimeDecoder decoder;
+
+		TS_ASSERT(decoder.load(createMovie()));
+
+		// Each time lands on the frame shown at that time
+		for (uint32 i = 0; i < qt_test_frameCount; i++) {
+			uint32 times[] = { qt_test_frameTimes[i], qt_test_frameTimes[i + 1] - 1 };
+
+			for (int j = 0; j < 2; j++) {
+				decoder.seekToTime(Video::VideoTimestamp(times[j], 8000));
+				decoder.decodeNextFrame();
+				TS_ASSERT_EQUALS(decoder.getCurFrame(), (int32)i);
+			}
+		}
+	}
+
+	void test_seek_audio() {
+		Video::QuickTimeDecoder decoder;
+
+		TS_ASSERT(decoder.load(createMovie()));
+
+		// Frame 3 starts 250 units in, past the sample without a duration
+		checkAudioAfterSeek(decoder, 3, 252);
+
+		// Frame 4 starts in the last entry, which is too long for 32 bits
+		checkAudioAfterSeek(decoder, 4, 301);
+		checkAudioAfterSeek(decoder, 5, 301);
+	}
+};
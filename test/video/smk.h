@@ -0,0 +1,389 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/smk_decoder.h"
+
+#include "common/md5.h"
+#include "common/memstream.h"
+
+#include "helper.h"
+
+/*
+ * Synthetic Smacker files of three 32x16 frames without palette or audio.
+ * The Huffman trees are random, with codes of up to 14 and 16 bits, and
+ * one of the four block trees is empty. The frame data is random as well.
+ * The first one is an SMK2 file, the second one an SMK4 file with Y
+ * doubling.
+ */
+static const byte smk_test_smk2[] = {
+	0x53, 0x4d, 0x4b, 0x32, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+	0x3c, 0xf6, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x4c, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00,
+	0x20, 0x00, 0x00, 0x00, 0x2c, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00,
+	0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0x53, 0x10, 0x1e, 0x8c, 0xf6, 0xe0, 0xd2, 0x5e,
+	0xd4, 0x7b, 0x78, 0x19, 0xad, 0x6f, 0xaa, 0x1f, 0xe3, 0x21, 0x96, 0x30, 0x5f, 0x64, 0x5d, 0xae,
+	0x4a, 0xc6, 0x0a, 0xc0, 0x69, 0x5a, 0x18, 0x9e, 0x15, 0xe1, 0x00, 0x16, 0xba, 0x56, 0x58, 0xf1,
+	0xae, 0xa8, 0x1c, 0x80, 0x0b, 0xe5, 0x67, 0x9c, 0x2e, 0x84, 0x72, 0xfa, 0x5d, 0xf8, 0x71, 0x7e,
+	0xdc, 0xb5, 0x71, 0x24, 0x98, 0xd9, 0x7c, 0x03, 0x11, 0xed, 0x96, 0x3e, 0x04, 0x92, 0xdd, 0x82,
+	0x01, 0xc7, 0xb7, 0x91, 0x20, 0x1e, 0x41, 0xac, 0x8b, 0xc4, 0x0a, 0x12, 0xc4, 0x60, 0x81, 0xc0,
+	0xc8, 0xd5, 0x98, 0xf6, 0x92, 0x80, 0x14, 0xc7, 0x87, 0x13, 0x35, 0x4c, 0xa4, 0x1c, 0x5a, 0x9e,
+	0x9a, 0x17, 0x11, 0xbc, 0xdd, 0x61, 0x12, 0xa1, 0xa5, 0xb9, 0x47, 0xdd, 0xb8, 0xcf, 0x5a, 0xbe,
+	0x54, 0x7a, 0x36, 0xa9, 0xab, 0x5f, 0xa5, 0xd0, 0x59, 0x4e, 0xa4, 0x4d, 0xb3, 0xb5, 0xf0, 0xd4,
+	0x63, 0x48, 0x7e, 0x1a, 0xda, 0xfb, 0xb8, 0xcc, 0x8f, 0x3b, 0x9d, 0xf4, 0x2e, 0xe7, 0xb6, 0xd7,
+	0x36, 0xd5, 0xf2, 0x3e, 0x47, 0x76, 0xdc, 0xf3, 0xd7, 0x1c, 0x73, 0xfe, 0x59, 0x71, 0x5d, 0xb8,
+	0x6f, 0xcb, 0x66, 0x96, 0x52, 0xe5, 0x38, 0xfc, 0xab, 0xca, 0x5a, 0xdc, 0x8f, 0x67, 0xab, 0xa4,
+	0x31, 0x73, 0x92, 0x7c, 0x44, 0x4e, 0xff, 0xf9, 0x67, 0xff, 0x0d, 0xef, 0xa3, 0x0f, 0xd4, 0xb1,
+	0x0d, 0xae, 0x65, 0x1e, 0x41, 0x5a, 0xf0, 0xf1, 0x13, 0x52, 0xf0, 0xd6, 0x9a, 0x27, 0x9a, 0xfe,
+	0x5b, 0x63, 0x0d, 0xc9, 0x37, 0xde, 0x31, 0xb9, 0x8d, 0x3e, 0xbb, 0x94, 0x97, 0x80, 0xd2, 0x1e,
+	0x43, 0xfd, 0xed, 0x45, 0x73, 0xfc, 0x6c, 0xca, 0xd2, 0xbd, 0x0c, 0x3a, 0x9f, 0x40, 0x78, 0x8b,
+	0x39, 0x3e, 0x26, 0x53, 0x12, 0x14, 0xdf, 0x36, 0xe2, 0xd7, 0x6c, 0x2a, 0xa3, 0x76, 0xce, 0x74,
+	0x31, 0x2d, 0xf0, 0x09, 0x7b, 0x1b, 0x2e, 0x23, 0xcb, 0xf3, 0x63, 0xb7, 0x1c, 0xb9, 0x6c, 0x0e,
+	0x43, 0xdd, 0x40, 0x2d, 0x01, 0x97, 0x14, 0x97, 0x4f, 0xd9, 0x59, 0xc2, 0x84, 0x68, 0xa9, 0xd0,
+	0x59, 0xfb, 0xbf, 0xc3, 0xd2, 0xb5, 0x5e, 0xc9, 0x81, 0x6b, 0x31, 0xd4, 0x55, 0x46, 0x38, 0xd5,
+	0x99, 0x44, 0x28, 0x8f, 0xd7, 0xae, 0x47, 0x1a, 0x64, 0x01, 0x6a, 0x32, 0xcc, 0xa6, 0xb4, 0x37,
+	0x6a, 0x61, 0x89, 0x1e, 0xe2, 0x11, 0xb1, 0x13, 0xf1, 0x9f, 0xa1, 0x85, 0x18, 0x6d, 0x4b, 0xa4,
+	0xe1, 0xa4, 0x0e, 0xc4, 0xab, 0x37, 0xff, 0xda, 0x57, 0xa2, 0xed, 0x7e, 0xea, 0x83, 0xf0, 0x40,
+	0x65, 0xa5, 0xf4, 0x3f, 0x11, 0xf8, 0x9f, 0x1d, 0xc3, 0x29, 0x41, 0x62, 0x86, 0xc5, 0xb1, 0x42,
+	0xba, 0x76, 0x82, 0x4f, 0xb5, 0x89, 0x56, 0x96, 0xc7, 0x7a, 0xa7, 0x5c, 0x5d, 0x94, 0x17, 0xc9,
+	0x47, 0x9e, 0x05, 0x62, 0x74, 0x7f, 0xc1, 0x8e, 0x1e, 0xb0, 0xa4, 0x78, 0xe5, 0x31, 0xd0, 0x2f,
+	0x62, 0xa2, 0x30, 0x32, 0x9e, 0x6d, 0xbf, 0xef, 0x42, 0x77, 0xf5, 0x5c, 0x66, 0xba, 0x06, 0xc6,
+	0x4b, 0xaa, 0xc2, 0x7c, 0x16, 0xa7, 0x4a, 0x35, 0xe1, 0xe3, 0x5c, 0x6a, 0xc5, 0x45, 0x93, 0x43,
+	0x34, 0x21, 0xc9, 0x0e, 0x46, 0x65, 0xc0, 0xea, 0xab, 0xa0, 0x87, 0xf3, 0x4c, 0x10, 0x4a, 0x2d,
+	0x37, 0x6f, 0xc1, 0x74, 0x83, 0x46, 0x09, 0xa2, 0xf5, 0xba, 0x0a, 0x30, 0x55, 0x0f, 0x2f, 0x64,
+	0x1a, 0xee, 0xa4, 0x25, 0xe5, 0x02, 0x91, 0xa3, 0x14, 0x85, 0x0c, 0x6e, 0x9d, 0xd6, 0xc5, 0xf1,
+	0xf1, 0xf0, 0x4f, 0x87, 0xdd, 0x0b, 0x1d, 0xc8, 0xee, 0x27, 0xf5, 0xeb, 0xcc, 0xf9, 0xd3, 0xc9,
+	0xd5, 0xda, 0xee, 0x98, 0x82, 0xae, 0xc8, 0x19, 0x2a, 0xac, 0xea, 0xf0, 0x73, 0xda, 0x42, 0x34,
+	0x31, 0xce, 0x74, 0x61, 0x4e, 0xc7, 0x57, 0xd2, 0x55, 0x89, 0x26, 0xd5, 0x77, 0x3c, 0x87, 0xb3,
+	0x64, 0xf2, 0xdf, 0x19, 0xf4, 0xd5, 0x7e, 0x66, 0x28, 0x76, 0x5f, 0x87, 0x53, 0x37, 0xba, 0x50,
+	0x24, 0x41, 0x36, 0xb0, 0xd1, 0xc1, 0xb3, 0x4b, 0x71, 0xeb, 0xa7, 0x3c, 0x7b, 0x92, 0x83, 0x02,
+	0x02, 0xad, 0xee, 0xc9, 0x04, 0xf6, 0x52, 0xd5, 0x58, 0x54, 0xa4, 0x44, 0x77, 0xbc, 0x36, 0xc7,
+	0xd2, 0xe6, 0xbc, 0xb3, 0x5e, 0xc1, 0x6c, 0x39, 0x02, 0xd2, 0xfe, 0x96, 0x4e, 0x44, 0x13, 0x1e,
+	0x5d, 0x14, 0x4c, 0x4e, 0x94, 0x30, 0x60, 0xac, 0xb5, 0x7f, 0x49, 0x94, 0x90, 0x74, 0x84, 0xff,
+	0x1a, 0xe7, 0xcd, 0xc5, 0x7d, 0xf6, 0x16, 0x03, 0x4a, 0x79, 0x0e, 0x1b, 0xf9, 0xb3, 0x76, 0xec,
+	0xcc, 0x5a, 0x84, 0xe8, 0xfc, 0xce, 0x82, 0x53, 0x61, 0x80, 0xab, 0x40, 0xaf, 0x4a, 0x3b, 0x66,
+	0x77, 0x81, 0x2c, 0xf4, 0xfa, 0x71, 0x32, 0x73, 0xe3, 0xb1, 0x10, 0x28, 0x9e, 0x68, 0x3a, 0xab,
+	0x6c, 0xb8, 0x82, 0x55, 0xb3, 0x3f, 0x9a, 0xf3, 0xfe, 0x8a, 0xd7, 0xc4, 0x44, 0x94, 0xfd, 0xff,
+	0xf5, 0xcb, 0x3f, 0xf8, 0x07, 0x97, 0xa2, 0x98, 0x96, 0x8a, 0x54, 0x49, 0xeb, 0xfb, 0xae, 0x03,
+	0x72, 0x55, 0x73, 0x43, 0xc2, 0x1f, 0x08, 0xd2, 0x6d, 0x99, 0xdd, 0xa4, 0xec, 0x22, 0x42, 0x5b,
+	0x2e, 0x04, 0xf3, 0xa8, 0x24, 0x27, 0x84, 0x73, 0xa3, 0x78, 0x54, 0x94, 0xb5, 0xe8, 0x4a, 0x64,
+	0xe4, 0x45, 0xad, 0x14, 0x6f, 0x5e, 0x53, 0x6a, 0xe3, 0xc2, 0xd1, 0x51, 0x6e, 0x7f, 0xa8, 0x12,
+	0xc8, 0x9a, 0x30, 0x75, 0x2b, 0x1b, 0x38, 0x15, 0x1d, 0x2e, 0x6b, 0x55, 0xd7, 0x1e, 0xc1, 0x9d,
+	0xae, 0xb9, 0xd3, 0x46, 0x02, 0xfc, 0x74, 0x5c, 0x86, 0xb9, 0xdb, 0x16, 0x7a, 0x6e, 0x91, 0xdb,
+	0xb8, 0x83, 0x5f, 0x74, 0x94, 0x69, 0xb3, 0x64, 0xee, 0x90, 0x1d, 0x66, 0x16, 0xf0, 0xa0, 0xc1,
+	0x38, 0x29, 0x9a, 0x98, 0x42, 0x45, 0xc1, 0x9d, 0xfe, 0x52, 0xf0, 0x63, 0x52, 0x6b, 0x3b, 0x17,
+	0xe0, 0x47, 0xa3, 0x44, 0xd3, 0xb6, 0x64, 0xbd, 0x2f, 0x75, 0x60, 0x42, 0x95, 0x7b, 0x45, 0xc3,
+	0x69, 0x91, 0x07, 0x7a, 0xf2, 0x94, 0x7e, 0x4e, 0x8d, 0xc2, 0x46, 0xa7, 0xa2, 0xef, 0x76, 0x5a,
+	0x57, 0x5c, 0xab, 0xdd, 0xb0, 0x08, 0x62, 0x2b, 0x05, 0x77, 0x01, 0xcb, 0xdf, 0xad, 0x27, 0xd5,
+	0x80, 0x77, 0x96, 0x1b, 0xa8, 0x74, 0x74, 0x78, 0x2b, 0xe2, 0x83, 0x2c, 0xc3, 0x44, 0xf8, 0x23,
+	0x71, 0xc2, 0xa3, 0xe7, 0x9d, 0x1a, 0xd1, 0xfc, 0x3e, 0x8b, 0xdf, 0x0a, 0x5a, 0x66, 0xc9, 0x14,
+	0xae, 0x77, 0x61, 0x53, 0x08, 0x03, 0x34, 0x17, 0x41, 0x7f, 0xfd, 0x59, 0x02, 0xfa, 0x07, 0x43,
+	0xf2, 0xc2, 0xcf, 0x7d, 0xb4, 0xd4, 0x3b, 0xbb, 0x9f, 0x26, 0xe6, 0xfd, 0x88, 0x0a, 0xb8, 0xeb,
+	0x2f, 0x2a, 0x94, 0x79, 0x69, 0x60, 0xb0, 0x46, 0x0f, 0x1f, 0xd6, 0x45, 0x13, 0x91, 0xb3, 0x93,
+	0xf7, 0x5c, 0x50, 0xb2, 0xbf, 0x88, 0x08, 0xc5, 0x29, 0x08, 0x7d, 0x51, 0xc2, 0x76, 0xde, 0xed,
+	0x40, 0x48, 0xb1, 0xc1, 0x2e, 0x7a, 0xf8, 0xdd, 0x10, 0x49, 0xf5, 0xde, 0xd1, 0x0a, 0x3e, 0x5e,
+	0xa4, 0xae, 0x6f, 0xdf, 0x2e, 0x25, 0x68, 0x46, 0xf0, 0x8d, 0x93, 0x8b, 0x7b, 0xa4, 0x00, 0x02,
+	0xb4, 0x0b, 0xcb, 0xbb, 0xa5, 0x3d, 0x6e, 0xfb, 0x54, 0x2c, 0x5a, 0xb7, 0x68, 0x94, 0xfa, 0x57,
+	0x8b, 0xa0, 0x21, 0x37, 0x1f, 0xc5, 0x09, 0x0c, 0x33, 0x22, 0xf2, 0xc0, 0xb4, 0x19, 0xf0, 0x6b,
+	0x07, 0x77, 0x07, 0xa6, 0xd1, 0xf9, 0x45, 0x76, 0xb6, 0x00, 0x46, 0x30, 0x1c, 0x1b, 0xc7, 0x53,
+	0xc0, 0x0a, 0x83, 0xf8, 0x80, 0x76, 0x28, 0x7f, 0xe3, 0xf7, 0x85, 0x1a, 0x7e, 0xf3, 0xc4, 0xd5,
+	0xad, 0x09, 0x66, 0xaf, 0x17, 0x7e, 0x0d, 0x21, 0x91, 0x7d, 0xd3, 0xb0, 0xe8, 0x53, 0xbc, 0x9e,
+	0x4c, 0x9c, 0xcb, 0x84, 0xf1, 0xe0, 0xa4, 0x95, 0x8c, 0x0a, 0x2c, 0xe6, 0xd3, 0xcc, 0x7c, 0x6a,
+	0x75, 0x42, 0x48, 0x7b, 0x90, 0x3a, 0x45, 0x1f, 0x75, 0x25, 0x34, 0xaa, 0xca, 0x1f, 0xa4, 0xf5,
+	0x4c, 0x62, 0x1c, 0x93, 0xc6, 0x3f, 0x16, 0x80, 0xf6, 0x5c, 0x67, 0x0d, 0x83, 0x3f, 0x0c, 0x46,
+	0x11, 0xb1, 0xed, 0x88, 0xc4, 0x52, 0x04, 0x4b, 0x0b, 0xfa, 0x84, 0xf2, 0x26, 0x76, 0xeb, 0x86,
+	0x3a, 0x93, 0x37, 0x8d, 0x74, 0x20, 0x72, 0xff, 0x3e, 0x9a, 0x7e, 0xab, 0xc2, 0x8d, 0xb2, 0x7d,
+	0xbc, 0xc1, 0x76, 0xfc, 0x91, 0x50, 0x4d, 0xf6, 0x22, 0x4d, 0xa8, 0x26, 0x69, 0x69, 0xd6, 0xb0,
+	0x9c, 0x62, 0x1a, 0xbb, 0xc3, 0x10, 0xa3, 0x50, 0x6b, 0x4e, 0xd6, 0x31, 0x2d, 0x1a, 0xa8, 0xce,
+	0xb7, 0x09, 0xb4, 0xed, 0x30, 0x78, 0xac, 0xb1, 0xa6, 0x18, 0x51, 0xdc, 0x9a, 0x56, 0x1e, 0x22,
+	0x90, 0x88, 0x72, 0x66, 0x0d, 0x49, 0xd7, 0x03, 0x37, 0x28, 0xf1, 0xeb, 0x3c, 0x18, 0xcb, 0xfc,
+	0x5b, 0x7d, 0x7e, 0xd9, 0x47, 0xb7, 0x17, 0xee, 0x3d, 0xbb, 0xb0, 0x06, 0x4b, 0xd9, 0x9f, 0xf9,
+	0xbd, 0xe9, 0x47, 0x3f, 0x5d, 0x9f, 0x9e, 0x03, 0x06, 0x61, 0x4f, 0xda, 0x76, 0x78, 0x71, 0xe8,
+	0xa7, 0x7e, 0x53, 0xcf, 0xcd, 0x1f, 0x76, 0xee, 0x2a, 0x34, 0x70, 0x4d, 0x00, 0xfa, 0x1a, 0xff,
+	0x52, 0x05, 0x39, 0x5e, 0x3a, 0x9c, 0xaa, 0x3e, 0x85, 0x71, 0x03, 0x31, 0x3b, 0x9d, 0xa7, 0x22,
+	0x0b, 0x33, 0x2c, 0xc9, 0xa0, 0x26, 0x96, 0xc2, 0x68, 0xa5, 0x19, 0x0d, 0xc4, 0x9d, 0x2e, 0x01,
+	0xb6, 0x8d, 0x46, 0x22, 0xb4, 0x8e, 0xa1, 0x23, 0xd2, 0x81, 0x9f, 0xa9, 0x94, 0x09, 0xb1, 0xb5,
+	0x16, 0x3b, 0xa4, 0x49, 0x43, 0x11, 0xe2, 0xa1, 0xa3, 0x41, 0x83, 0x80, 0x51, 0x4b, 0x73, 0xf1,
+	0x5b, 0x56, 0x23, 0x7f, 0xb3, 0xd6, 0xc5, 0x9b, 0x23, 0xc5, 0x3f, 0x8b, 0x8a, 0x0d, 0x0c, 0xd1,
+	0x24, 0xe2, 0x12, 0x17, 0x8d, 0xcb, 0x10, 0xe3, 0x0a, 0x46, 0xf1, 0x4c, 0x7a, 0x53, 0xeb, 0x43,
+	0xee, 0xa4, 0xf2, 0xde, 0xf3, 0x66, 0xaa, 0xc6, 0x2f, 0x31, 0x89, 0x90, 0xeb, 0x7e, 0xec, 0x04,
+	0x83, 0x15, 0xd1, 0x6d, 0x9a, 0x1d, 0x61, 0xcb, 0xb8, 0x00, 0xcf, 0xb6, 0xd9, 0x61, 0xad, 0xb9,
+	0x74, 0xd6, 0xd9, 0xd5, 0xb1, 0x05, 0x4f, 0x82, 0x7b, 0x06, 0x05, 0x39, 0x09, 0x3a, 0xba, 0xb7,
+	0x8e, 0x51, 0xb3, 0xa2, 0x4c, 0xcc, 0x07, 0xca, 0xb8, 0xa0, 0xa8, 0x12, 0x5b, 0xae, 0x0d, 0xd3,
+	0x45, 0xba, 0x37, 0x27, 0x98, 0x97, 0xc8, 0x26, 0xac, 0x40, 0x92, 0xd9, 0x3d, 0xce, 0xe6, 0x4d,
+	0x72, 0x68, 0x3f, 0x78, 0xd6, 0xc8, 0xbb, 0x11, 0x0e, 0x53, 0x1c, 0x0d, 0x2e, 0x93, 0x15, 0x6e,
+	0x59, 0x6a, 0x12, 0xd4, 0x2c, 0x13, 0x6e, 0x69, 0x0d, 0xaa, 0xf4, 0x73, 0x51, 0xa6, 0x3f, 0xe8,
+	0x92, 0x4b, 0x6f, 0x71, 0xea, 0xa9, 0x6e, 0x15, 0x5a, 0x25, 0xa0, 0x97, 0x57, 0x54, 0x6b, 0x4d,
+	0x99, 0x7c, 0xa0, 0xb0, 0x36, 0xf6, 0xa0, 0x9f, 0xf1, 0xa6, 0x32, 0x63, 0xd8, 0x70, 0x46, 0x34,
+	0x61, 0x0d, 0x9a, 0x50, 0xf6, 0x4c, 0x55, 0xbc, 0x6d, 0x62, 0xf6, 0x1e, 0xdb, 0xfc, 0xc8, 0x5f,
+	0x15, 0xb3, 0xf6, 0xcc, 0xca, 0x5c, 0x39, 0xee, 0xf9, 0x2d, 0x9a, 0x3d, 0x10, 0x78, 0x4a, 0x04,
+	0x95, 0x87, 0x62, 0xc0, 0xfa, 0xb0, 0x08, 0x3a, 0xa7, 0xf6, 0x0e, 0xbc, 0xab, 0x15, 0x54, 0x43,
+	0x42, 0x8e, 0x4c, 0xd3, 0x6f, 0x50, 0xf8, 0x93, 0x6d, 0x44, 0xc5, 0x76, 0x58, 0xc1, 0x81, 0x0d,
+	0x18, 0x6f, 0x85, 0xf6, 0x02, 0xdc, 0xf5, 0x9e, 0x7d, 0xd4, 0x32, 0xbc, 0xcb, 0x92, 0x9b, 0x08,
+	0x22, 0xdd, 0x71, 0x61, 0x32, 0xc8, 0xdc, 0x13, 0x3a, 0x53, 0x3e, 0x91, 0x23, 0x77, 0x26, 0xd8,
+	0xe6, 0x2b, 0xfd, 0xcf, 0x27, 0x8b, 0x8f, 0x73, 0x14, 0xf4, 0x86, 0x0a, 0x4f, 0x15, 0xce, 0x00,
+	0xe7, 0x45, 0x77, 0xbc, 0x3c, 0x87, 0x99, 0x28, 0xe6, 0xcd, 0xc6, 0xff, 0x34, 0x4c, 0xa2, 0x09,
+	0xeb, 0xb5, 0xd9, 0x90, 0x32, 0x8a, 0x7c, 0x97, 0xbe, 0x08, 0xfb, 0x33, 0x30, 0x87, 0xeb, 0xae,
+	0x1f, 0x5c, 0x6b, 0x9b, 0x79, 0x48, 0x9c, 0x20, 0xd5, 0x13, 0xd6, 0x68, 0xe9, 0x4a, 0xb3, 0xe4,
+	0x0b, 0x07, 0xd7, 0x2f, 0x8e, 0x40, 0xce, 0x51, 0x25, 0x92, 0xed, 0x5e, 0x0b, 0xc2, 0x12, 0x5a,
+	0xd0, 0x3f, 0x6a, 0xce, 0x88, 0xa6, 0xb4, 0xaf, 0xd5, 0xc5, 0x25, 0xbb, 0xf5, 0x88, 0x3b, 0x9a,
+	0x40, 0x45, 0x4b, 0x53, 0xce, 0x23, 0xcf, 0x90, 0xfa, 0x2c, 0x40, 0x37, 0x0c, 0xda, 0x00, 0x2f,
+	0x36, 0x35, 0xce, 0x3e, 0xe3, 0xa4, 0xfa, 0x7f, 0xc2, 0x08, 0xa1, 0xfa, 0x7b, 0x26, 0x4a, 0x46,
+	0x47, 0x4e, 0xfc, 0xf4, 0xd2, 0xa9, 0x58, 0xc2, 0xf0, 0x10, 0x25, 0xdd, 0x6f, 0x1b, 0x0a, 0x83,
+	0xd2, 0x72, 0x46, 0x0e, 0x6f, 0x6e, 0x75, 0x1f, 0x1e, 0xbe, 0x82, 0x95, 0xdd, 0x9f, 0x22, 0x0d,
+	0xc4, 0x1a, 0x15, 0x71, 0x3a, 0x60, 0x05, 0x83, 0xa4, 0x6b, 0xf2, 0x24, 0x2f, 0x79, 0x48, 0x3e,
+	0xb3, 0x4b, 0x8b, 0x73, 0x4c, 0xec, 0x0e, 0x56, 0x7f, 0xd9, 0x62, 0x1f, 0x30, 0xaf, 0x71, 0xeb,
+	0xad, 0xd8, 0x7d, 0xd5, 0x31, 0xe2, 0xab, 0xc1, 0xcb, 0xb9, 0xdc, 0x30, 0xd1, 0xcc, 0x62, 0x98,
+	0x81, 0xb9, 0x90, 0x6e, 0x2f, 0xb3, 0x26, 0x28, 0x72, 0x61, 0xcd, 0x16, 0x1d, 0x07, 0xe8, 0x95,
+	0x80, 0x6c, 0xd3, 0x9e, 0xf7, 0x94, 0x9c, 0x81, 0x23, 0xf6, 0x48, 0x48, 0x8e, 0x9f, 0x95, 0x84,
+	0x24, 0xb8, 0x5b, 0xb0, 0x46, 0x2a, 0xaa, 0x94, 0x2b, 0x02, 0x95, 0x56, 0x26, 0x6c, 0x17, 0xc9,
+	0x0e, 0xdb, 0x5c, 0x9d, 0xed, 0xac, 0x3c, 0x7c, 0xab, 0x4b, 0x84, 0x82, 0x22, 0xd4, 0x4e, 0xec,
+	0x81, 0xc1, 0x36, 0xe7, 0x7a, 0x45, 0xdd, 0x64, 0xb4, 0xf2, 0x6b, 0x2a, 0x05, 0x38, 0x5b, 0x44,
+	0xc1, 0x87, 0x40, 0x7d, 0xa2, 0x48, 0xa4, 0x63, 0x6f, 0xf6, 0x0c, 0x38, 0xc0, 0x84, 0x9e, 0x9f,
+	0x82, 0x8a, 0xb8, 0x66, 0xff, 0x91, 0x41, 0x60, 0x20, 0xc6, 0xdd, 0x43, 0xc8, 0x99, 0x24, 0xa2,
+	0x31, 0x1e, 0x81, 0x76, 0x81, 0x64, 0x8d, 0xa6, 0xed, 0x89, 0x18, 0x93, 0x33, 0x2f, 0x71, 0x6c,
+	0x7b, 0xdf, 0x0f, 0xd5, 0x6b, 0x6c, 0x8d, 0x7e, 0x4a, 0x13, 0x67, 0x0f, 0xd4, 0xa7, 0xc3, 0x3d,
+	0x3c, 0x4c, 0x24, 0x8e, 0x17, 0x0e, 0xaa, 0xe2, 0x3c, 0xcc, 0x9e, 0x75, 0x70, 0x05, 0x92, 0x2b,
+	0x2f, 0xc7, 0x56, 0x78, 0x09, 0x8e, 0xbd, 0x81, 0xa8, 0x06, 0x05, 0x65, 0x39, 0x8b, 0x82, 0x9c,
+	0x25, 0x67, 0x36, 0xb9, 0x5d, 0x56, 0xc7, 0x05, 0x08, 0x02, 0x49, 0x27, 0x03, 0x62, 0xb0, 0xf1,
+	0xd4, 0x7e, 0xa7, 0x71, 0xe7, 0xb4, 0x88, 0x48, 0xcb, 0xae, 0x30, 0x0f, 0x05, 0xce, 0x98, 0x3c,
+	0x45, 0xd7, 0x38, 0x9e, 0x02, 0x45, 0x8f, 0x71, 0xc0, 0x44, 0xb3, 0x69, 0x9e, 0x44, 0xa1, 0xe6,
+	0x6b, 0x1b, 0xe9, 0xad, 0xe9, 0x1e, 0x6d, 0x2d, 0x11, 0x43, 0x72, 0x21, 0xf7, 0x2d, 0xfd, 0xa0,
+	0xc7, 0xfc, 0xbe, 0x3b, 0xef, 0xfc, 0xd7, 0xe9, 0x8b, 0x54, 0xdb, 0x22, 0xc4, 0x56, 0x0b, 0x5c,
+	0x20, 0x32, 0x13, 0x45, 0x6b, 0x57, 0xe9, 0x22, 0x86, 0x7c, 0x0e, 0xf3, 0xd1, 0x7e, 0x54, 0xea,
+	0xc6, 0x28, 0xda, 0xa1, 0x3b, 0x7a, 0x81, 0x82, 0xe1, 0x5e, 0xe0, 0xd5, 0x01, 0xbf, 0x08, 0xdf,
+	0xf3, 0xb9, 0xf1, 0x9b, 0x0a, 0x66, 0x22, 0xc4, 0x2d, 0x4e, 0x13, 0x08, 0xa2, 0x58, 0xc4, 0x51,
+	0x51, 0x4f, 0xf8, 0xbd, 0xe1, 0x6c, 0xbc, 0xa6, 0xbb, 0xc3, 0x6a, 0x9d, 0x36, 0x16, 0x34, 0x55,
+	0x64, 0x26, 0x1c, 0x55, 0x87, 0x40, 0x84, 0x33, 0x93, 0xe0, 0x1c, 0xa7, 0x8c, 0xd2, 0x7a, 0x5d,
+	0x7e, 0x36, 0x78, 0x2b, 0x75, 0x74, 0xce, 0xb0, 0xf8, 0xac, 0x4a, 0xc8, 0x48, 0x56, 0xe9, 0xf6,
+	0x40, 0x77, 0xb2, 0x67, 0x18, 0x04, 0x2e, 0xb2, 0xcd, 0xcd, 0x19, 0x9f, 0xf3, 0x1a, 0x34, 0x2c,
+	0xcc, 0x93, 0x80, 0x3f, 0xce, 0xc0, 0xb9, 0x4a, 0xf6, 0x1d, 0xc7, 0x69, 0xe2, 0xb8, 0xa9, 0x28,
+	0xb3, 0x92, 0xf6, 0xc7, 0x4e, 0x93, 0x8b, 0x11, 0x6d, 0x45, 0x92, 0x53, 0x54, 0x25, 0x9f, 0xf8,
+	0x25, 0x70, 0x8d, 0x23, 0xde, 0xb4, 0xda, 0x02, 0x1e, 0x36, 0x48, 0x4b, 0x32, 0x84, 0x72, 0x7a,
+	0x36, 0xa0, 0xef, 0x80, 0x28, 0xf8, 0xf6, 0xb5, 0x69, 0xe4, 0xff, 0xac, 0x8e, 0x73, 0x19, 0x53,
+	0x72, 0x8e, 0xae, 0x94, 0x48, 0xcb, 0xd7, 0x7b, 0x57, 0x3c, 0x05, 0x84, 0x6a, 0x13, 0xd7, 0xae,
+	0x18, 0x4b, 0x1d, 0xbd, 0x4e, 0x17, 0xaa, 0x59, 0x82, 0xb4, 0xaf, 0x54, 0x00, 0xbd, 0xa3, 0x10,
+	0x3e, 0x48, 0x7b, 0x7d, 0x02, 0x36, 0x4b, 0xf8, 0x95, 0x5d, 0x39, 0xe3, 0xca, 0x20, 0x93, 0x21,
+	0x37, 0x5b, 0x0b, 0xa4, 0xf0, 0x9d, 0x23, 0xc5, 0xf3, 0xd9, 0xda, 0xaf, 0x51, 0x48, 0xe2, 0x12,
+	0x2d, 0x57, 0x3f, 0xb2, 0xf0, 0xc3, 0xbb, 0x17, 0x7e, 0xfa, 0x3b, 0x84, 0x3c, 0x3d, 0x85, 0x18,
+	0x26, 0x57, 0x16, 0x3a, 0x71, 0xfc, 0x41, 0x8a, 0x61, 0x78, 0xe5, 0x6c, 0x71, 0xa5, 0x43, 0x5c,
+	0x6f, 0x4c, 0x12, 0xa8, 0x41, 0x6b, 0xaf, 0x4c, 0x76, 0xf3, 0xc3, 0xb5, 0xc0, 0xa2, 0x01, 0x01,
+	0x79, 0x6c, 0x2c, 0xdf, 0xc0, 0xcb, 0x3a, 0xf0, 0x4a, 0xa9, 0xad, 0xe0, 0xbe, 0xa6, 0xc1, 0xfc,
+	0x2b, 0x24, 0xa4, 0xdc, 0x15, 0x9b, 0x20, 0x8c, 0x42, 0x49, 0xbe, 0x60, 0xe0, 0x68, 0x51, 0x64,
+	0x48,
+};
+
+static const byte smk_test_smk4[] = {
+	0x53, 0x4d, 0x4b, 0x34, 0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+	0x3c, 0xf6, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x4f, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x4c, 0x01, 0x00, 0x00,
+	0x2c, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00,
+	0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2e, 0x0f, 0xb8, 0xad, 0xe6, 0x61, 0x1a, 0xf8, 0x74,
+	0x9e, 0x07, 0x8d, 0xc4, 0x4e, 0x6b, 0x98, 0xe5, 0x94, 0xcf, 0x1b, 0x13, 0xce, 0xcb, 0xed, 0x02,
+	0x79, 0x8f, 0xf7, 0xb6, 0x50, 0xf6, 0x30, 0x47, 0x77, 0x92, 0x03, 0x98, 0x54, 0xbd, 0x12, 0x0b,
+	0x2a, 0x4f, 0xa5, 0x55, 0x38, 0x22, 0x75, 0x94, 0x58, 0x41, 0x23, 0x51, 0x6a, 0xde, 0x71, 0xda,
+	0xb9, 0x0a, 0x3d, 0x44, 0x24, 0x52, 0xa0, 0x38, 0x12, 0x7f, 0xa3, 0x67, 0x4f, 0x9e, 0xf6, 0x9f,
+	0xb6, 0x3c, 0x89, 0x7c, 0x92, 0x06, 0xa5, 0xaf, 0x7c, 0x4f, 0x43, 0x11, 0x9f, 0x48, 0x50, 0x54,
+	0xa4, 0x39, 0x56, 0x79, 0x33, 0xca, 0xf4, 0xf4, 0x28, 0xde, 0xd3, 0xad, 0x7d, 0x24, 0xaa, 0xa9,
+	0xa4, 0xca, 0xa9, 0x91, 0xe3, 0x4a, 0xcf, 0xb3, 0x72, 0x98, 0xcb, 0x0e, 0x58, 0xf9, 0x9e, 0x21,
+	0x75, 0x17, 0xa5, 0x3b, 0x79, 0xd7, 0xf7, 0xc9, 0xa2, 0xf3, 0x0b, 0xeb, 0xe4, 0x3e, 0xd3, 0xb7,
+	0xa5, 0x67, 0xb7, 0x5f, 0x9e, 0xbb, 0xab, 0x56, 0x43, 0x56, 0xa3, 0x04, 0x31, 0x80, 0xed, 0x9a,
+	0x45, 0x5c, 0x68, 0xb8, 0x87, 0x1d, 0x19, 0xfd, 0x61, 0x88, 0x49, 0x9d, 0x3b, 0xc4, 0x0b, 0x20,
+	0xe7, 0x72, 0x14, 0x96, 0x6a, 0xfd, 0x4e, 0x65, 0xdc, 0x79, 0xe0, 0x4a, 0xfd, 0x2f, 0x68, 0xe2,
+	0xfd, 0x88, 0xbe, 0x11, 0x58, 0x69, 0x1c, 0x39, 0x9a, 0x79, 0xf1, 0xc3, 0x7c, 0x8d, 0x8d, 0x5f,
+	0x6c, 0xaf, 0x78, 0xb0, 0x58, 0xa3, 0xd4, 0x8f, 0xab, 0x9d, 0xf7, 0x84, 0xb2, 0x65, 0x90, 0x08,
+	0x29, 0x4a, 0x75, 0xb4, 0x5c, 0xf3, 0x7b, 0x0a, 0x27, 0x1f, 0xbe, 0x1d, 0xf1, 0x74, 0xc5, 0x20,
+	0x10, 0x4e, 0x69, 0x47, 0x32, 0x50, 0x5b, 0x75, 0x87, 0x19, 0x11, 0x88, 0xca, 0x0b, 0xb6, 0xc2,
+	0xd4, 0x41, 0xad, 0x46, 0xd0, 0x20, 0x00, 0x20, 0xd0, 0x60, 0xf5, 0xe0, 0x2e, 0xbc, 0xa9, 0x38,
+	0x58, 0x0c, 0x97, 0x9f, 0x58, 0x45, 0x72, 0xe6, 0x4a, 0x7a, 0xcf, 0x63, 0xa9, 0xcc, 0x86, 0xef,
+	0x62, 0xc5, 0x1d, 0x18, 0x8d, 0x9d, 0x6e, 0xb6, 0x5d, 0x18, 0xb1, 0x21, 0x18, 0x4e, 0xe6, 0xdf,
+	0xd1, 0x59, 0x37, 0xa5, 0x18, 0x4a, 0xd3, 0x2c, 0x50, 0x42, 0x46, 0xf5, 0xac, 0xd3, 0x80, 0xda,
+	0x4a, 0x47, 0x50, 0x82, 0xec, 0xfa, 0x1c, 0xf4, 0xf8, 0xed, 0xc3, 0x58, 0xc4, 0x7f, 0xb7, 0x86,
+	0xcf, 0x92, 0x10, 0xfa, 0x14, 0x45, 0x50, 0xab, 0xf6, 0x37, 0x14, 0x56, 0xba, 0x75, 0x18, 0xfc,
+	0xe6, 0x12, 0xa4, 0x25, 0x33, 0xa8, 0xed, 0x4e, 0xe1, 0x86, 0x59, 0x4b, 0xae, 0x8b, 0xcc, 0xc7,
+	0x79, 0xc8, 0x0d, 0xcf, 0x6b, 0x97, 0x81, 0xc2, 0x30, 0x8a, 0x86, 0x22, 0x01, 0xed, 0xa4, 0x7d,
+	0x56, 0x2f, 0x72, 0x32, 0xbf, 0xc6, 0x23, 0xe7, 0x34, 0x47, 0x1f, 0x8e, 0xf8, 0x18, 0x8d, 0x22,
+	0x47, 0x1e, 0x4d, 0xb8, 0xe6, 0xf1, 0x54, 0xb5, 0xfd, 0x47, 0x6f, 0x7a, 0x6f, 0xdb, 0xd9, 0x27,
+	0x1c, 0x97, 0x85, 0x6d, 0x39, 0x27, 0x4b, 0xf9, 0x5a, 0xe0, 0x34, 0xcb, 0x12, 0xb1, 0x83, 0x25,
+	0xee, 0xec, 0x1c, 0xad, 0xbb, 0x3d, 0xf5, 0x5f, 0xb1, 0x23, 0x45, 0x8b, 0xa5, 0x77, 0xe4, 0x0d,
+	0x9e, 0x71, 0xca, 0x10, 0x40, 0xc9, 0x99, 0xea, 0x16, 0x6c, 0xf1, 0xf3, 0x36, 0x77, 0xb6, 0x96,
+	0x07, 0x04, 0x24, 0xcd, 0xee, 0x1d, 0x0d, 0x14, 0xda, 0xa3, 0xb9, 0x76, 0x43, 0x9d, 0x49, 0x57,
+	0x70, 0x36, 0x43, 0x36, 0xbf, 0x11, 0x4e, 0x82, 0x90, 0x35, 0xef, 0x5f, 0x6e, 0x01, 0x7e, 0x3a,
+	0xf0, 0x6e, 0x07, 0x34, 0xfb, 0x41, 0x45, 0x5d, 0x7c, 0x7e, 0xc0, 0xf3, 0x80, 0x6f, 0xdb, 0xa6,
+	0x03, 0xb5, 0x60, 0xf4, 0xae, 0x7c, 0x3d, 0xfb, 0x5c, 0x5d, 0x35, 0xeb, 0x91, 0x26, 0x35, 0x07,
+	0xa4, 0x7a, 0xdb, 0xac, 0x50, 0x75, 0x09, 0xb7, 0xfb, 0x47, 0xd0, 0xef, 0x85, 0x94, 0xcf, 0x6f,
+	0x90, 0xb5, 0x1b, 0x7d, 0x42, 0x1f, 0x98, 0x2e, 0x7f, 0xe3, 0x25, 0x88, 0xa7, 0x37, 0xe4, 0x28,
+	0x69, 0x47, 0x69, 0x2b, 0xb1, 0x5e, 0x3b, 0x1c, 0xd6, 0xe7, 0xb4, 0x23, 0x56, 0x67, 0x9e, 0x18,
+	0xd8, 0x23, 0xe0, 0xdf, 0x38, 0xe3, 0x24, 0x44, 0xdf, 0xb0, 0x3a, 0x29, 0xa5, 0xd2, 0x32, 0x00,
+	0x23, 0x35, 0x08, 0xe4, 0xe1, 0xa6, 0x0e, 0x29, 0x28, 0x49, 0xaf, 0xd7, 0x7a, 0xd0, 0xc0, 0xce,
+	0xb6, 0xe5, 0x5c, 0xf6, 0xfc, 0x60, 0x76, 0x50, 0x45, 0xc2, 0x19, 0x35, 0x2e, 0x51, 0xdd, 0xd9,
+	0xa7, 0x1a, 0xc5, 0xbd, 0xcd, 0x97, 0x63, 0x16, 0xc2, 0x8a, 0xd0, 0xfc, 0x50, 0x01, 0x07, 0xfa,
+	0xad, 0x98, 0xd7, 0xbe, 0x34, 0xcd, 0xce, 0x17, 0xc7, 0x13, 0x8d, 0xa7, 0xf8, 0xd4, 0x46, 0x9a,
+	0x2c, 0xc5, 0xca, 0x4b, 0x86, 0x91, 0xad, 0xea, 0x90, 0x08, 0xa7, 0xf4, 0xf9, 0x53, 0x58, 0x4e,
+	0x2d, 0x0b, 0xec, 0x3c, 0xc9, 0xdd, 0x29, 0xb3, 0xee, 0x1d, 0xa6, 0x98, 0x3f, 0x7c, 0x25, 0x39,
+	0xa9, 0xaa, 0x11, 0x6b, 0xef, 0x25, 0x45, 0x80, 0x54, 0xd4, 0x9b, 0x17, 0x3f, 0x00, 0xad, 0xb0,
+	0xe0, 0x40, 0x4f, 0x30, 0x1e, 0x6c, 0x59, 0x92, 0x20, 0x2c, 0x65, 0xda, 0x3f, 0xd2, 0xd3, 0x51,
+	0x5c, 0x69, 0x9c, 0x4c, 0x52, 0xbb, 0x89, 0x8d, 0xf3, 0x5c, 0x0a, 0x64, 0xf3, 0xa0, 0xde, 0x2e,
+	0x33, 0x92, 0xc8, 0xf3, 0x28, 0xbf, 0x2e, 0xfc, 0x36, 0x28, 0xb9, 0x6c, 0x0e, 0x51, 0x28, 0xfa,
+	0xc8, 0xfb, 0xad, 0xdf, 0x7a, 0x7c, 0xc6, 0x05, 0x20, 0x89, 0x02, 0x4f, 0xfa, 0x39, 0xdb, 0x55,
+	0x73, 0x7d, 0x17, 0x9d, 0x0f, 0x1e, 0x14, 0x4e, 0x59, 0xeb, 0xea, 0xcb, 0xcf, 0x02, 0x16, 0x9c,
+	0x94, 0xb2, 0x1d, 0x79, 0x02, 0x37, 0x98, 0x26, 0x07, 0x28, 0x1f, 0x38, 0xbc, 0x24, 0xdb, 0xb6,
+	0xba, 0x0a, 0xe1, 0xf6, 0x02, 0x9e, 0xfa, 0x3d, 0x45, 0xa8, 0xbe, 0xd5, 0x50, 0x56, 0x4f, 0x2a,
+	0xe2, 0x24, 0x68, 0x76, 0xa6, 0x07, 0x87, 0xd7, 0x55, 0xd6, 0x7f, 0x8d, 0xd7, 0xa9, 0x1b, 0x38,
+	0x64, 0x8d, 0xfe, 0x93, 0x76, 0x45, 0x38, 0x48, 0x95, 0x21, 0x0f, 0xf0, 0x80, 0x57, 0x90, 0x08,
+	0x1a, 0x3c, 0xd5, 0x4e, 0x80, 0xe7, 0xee, 0x11, 0x93, 0x71, 0xe6, 0x5b, 0x94, 0xea, 0x39, 0x9d,
+	0x82, 0x7a, 0xb7, 0x41, 0x26, 0x70, 0x22, 0x75, 0x1d, 0x7c, 0x23, 0x9f, 0x28, 0xfa, 0xc9, 0x05,
+	0x60, 0x0b, 0x71, 0x0e, 0x42, 0x33, 0x13, 0x47, 0x43, 0x14, 0x94, 0x78, 0x74, 0x1c, 0xbf, 0x1d,
+	0xd4, 0xc0, 0x1b, 0x55, 0x77, 0xb0, 0xf4, 0x02, 0xc8, 0xfd, 0x1c, 0xeb, 0xbd, 0x9d, 0x04, 0x18,
+	0x7b, 0x7d, 0x1b, 0x28, 0xfb, 0x48, 0x2b, 0x2e, 0xd3, 0x5e, 0xd8, 0x3d, 0x28, 0xd3, 0x23, 0xdb,
+	0xd2, 0x53, 0x4b, 0x2b, 0x59, 0x18, 0x5d, 0x1b, 0x8f, 0x3a, 0x4e, 0xc4, 0xe7, 0x97, 0xca, 0xa2,
+	0xe7, 0x36, 0x9d, 0xff, 0x26, 0xe2, 0x2b, 0x56, 0x08, 0x21, 0x65, 0xe0, 0x42, 0xbd, 0x57, 0x6a,
+	0x76, 0x2e, 0xc9, 0xa1, 0x56, 0xf9, 0x26, 0x98, 0x40, 0x00, 0x42, 0x92, 0x77, 0x16, 0x94, 0xea,
+	0xaf, 0x20, 0xbc, 0x42, 0xaf, 0x40, 0x12, 0x69, 0x7a, 0x7a, 0x58, 0x62, 0xa8, 0xe9, 0x8c, 0x23,
+	0x4f, 0xc9, 0xe9, 0xa7, 0xd9, 0x0b, 0xd0, 0xf4, 0xdc, 0x9f, 0x5b, 0x34, 0x8a, 0xb4, 0x68, 0x68,
+	0xce, 0xea, 0x9a, 0xfb, 0xe5, 0xd6, 0xce, 0x47, 0xf1, 0x95, 0xc1, 0xce, 0x83, 0x74, 0xcc, 0x35,
+	0xbe, 0xc1, 0xf2, 0x24, 0xb7, 0xa1, 0x0b, 0x26, 0x8c, 0xd0, 0xcc, 0x8d, 0x1e, 0xb8, 0x93, 0xdd,
+	0x59, 0xc1, 0xc5, 0xb0, 0x7f, 0xd6, 0xa4, 0x34, 0x68, 0x6e, 0xea, 0x91, 0x30, 0xd9, 0xdc, 0xc7,
+	0xb3, 0x2b, 0xa1, 0x1f, 0x07, 0x25, 0x49, 0x73, 0x32, 0x3a, 0xb5, 0x17, 0x3d, 0xcc, 0xe6, 0x90,
+	0x33, 0x0e, 0xcf, 0x35, 0x9c, 0xdc, 0x1a, 0x31, 0x90, 0x5e, 0xba, 0x50, 0x95, 0xbf, 0x92, 0x5e,
+	0x34, 0x4b, 0x9e, 0xbf, 0x4f, 0x3c, 0x5d, 0xef, 0x33, 0x3e, 0x6a, 0x23, 0xf3, 0xf4, 0x12, 0xd8,
+	0x44, 0xa6, 0x01, 0x6f, 0x93, 0x3c, 0xb4, 0xc9, 0xb4, 0xab, 0x94, 0xc0, 0xa3, 0xca, 0x2a, 0x28,
+	0xd1, 0xa5, 0x5c, 0xfe, 0x9c, 0xbb, 0xa1, 0xf5, 0x88, 0xb0, 0xdc, 0x3b, 0x23, 0xf6, 0xc8, 0x9a,
+	0xa0, 0xf2, 0x53, 0x4f, 0xd2, 0x96, 0x5f, 0x86, 0xbd, 0x18, 0xbe, 0x70, 0xc4, 0x64, 0x70, 0x4a,
+	0x20, 0xd6, 0x70, 0x86, 0x5c, 0xb8, 0xc9, 0xb5, 0x2f, 0x78, 0x99, 0x25, 0x76, 0x6c, 0xa8, 0x74,
+	0xd8, 0x6a, 0x68, 0x5a, 0xd1, 0xde, 0x19, 0x43, 0x1c, 0x0a, 0x3d, 0x23, 0x3d, 0x43, 0x28, 0x4b,
+	0x46, 0x5c, 0x33, 0xf1, 0x61, 0xa3, 0x5d, 0x90, 0x26, 0x7b, 0x6b, 0x3b, 0x2b, 0xbf, 0x1c, 0xd6,
+	0x2f, 0x0d, 0x14, 0x95, 0x6c, 0x4b, 0xe9, 0xb7, 0xd9, 0x7b, 0x4f, 0xe1, 0x77, 0xee, 0xa2, 0x56,
+	0x96, 0x72, 0x78, 0xa4, 0x6b, 0xe1, 0x57, 0xdc, 0x74, 0xb9, 0x6f, 0xd9, 0x52, 0x27, 0xf6, 0x0b,
+	0xba, 0x00, 0xf8, 0x29, 0x0b, 0x19, 0xf8, 0x5e, 0xc5, 0xc1, 0x34, 0x56, 0x82, 0x8f, 0x73, 0x2f,
+	0x2e, 0xec, 0xdf, 0x7d, 0x91, 0xfe, 0x2a, 0x14, 0x12, 0xca, 0xb0, 0x83, 0xf4, 0x02, 0x36, 0x8d,
+	0xb0, 0x0c, 0xe8, 0xd2, 0xfe, 0x34, 0x7b, 0x5b, 0x37, 0x68, 0xf9, 0x3c, 0xf6, 0xae, 0x64, 0x99,
+	0x98, 0xb6, 0xc6, 0x67, 0xe5, 0xc9, 0x0d, 0xa7, 0xca, 0x2b, 0x55, 0x2c, 0x52, 0x65, 0x45, 0xfa,
+	0xfd, 0x03, 0x8d, 0x36, 0x69, 0x28, 0x9a, 0x6c, 0x7c, 0x84, 0x51, 0x6d, 0x26, 0x29, 0x59, 0x7e,
+	0x03, 0xf7, 0xbe, 0x87, 0xf9, 0xa4, 0xf8, 0xb7, 0x60, 0x15, 0xd1, 0xda, 0x95, 0x69, 0x11, 0x68,
+	0x15, 0x74, 0x2b, 0x14, 0x7a, 0x92, 0xb2, 0x06, 0x2a, 0x0c, 0xa0, 0x93, 0xeb, 0x48, 0x4a, 0xa1,
+	0xfd, 0xa6, 0x1c, 0x1b, 0x14, 0x5a, 0xb5, 0x9a, 0x00, 0x24, 0x9e, 0x3a, 0xb2, 0xe0, 0x2f, 0x4f,
+	0x1f, 0xe7, 0x13, 0x2d, 0x49, 0xe2, 0x34, 0xb8, 0xa0, 0x9e, 0xb4, 0x7d, 0x14, 0x5e, 0xdc, 0x13,
+	0x3b, 0x86, 0xc9, 0xd9, 0x6d, 0x98, 0xb9, 0xa6, 0xcb, 0x9a, 0x2e, 0xca, 0x59, 0xb4, 0xc2, 0x89,
+	0xcc, 0x94, 0xaa, 0x11, 0x84, 0x7d, 0xc5, 0x0f, 0x5d, 0xb4, 0xbe, 0x8f, 0x56, 0x94, 0xea, 0x95,
+	0x7e, 0x71, 0xc5, 0x4e, 0xb4, 0x1c, 0xd9, 0xb3, 0x3e, 0x0f, 0xe0, 0x20, 0xe4, 0xb6, 0x9a, 0x19,
+	0x7a, 0x20, 0xe5, 0x1d, 0x5a, 0xb3, 0xbd, 0x2f, 0xe9, 0x95, 0xcb, 0x67, 0x0a, 0x3d, 0xf0, 0x8c,
+	0x2e, 0x90, 0x74, 0x92, 0x26, 0x7f, 0x83, 0x7f, 0x21, 0x92, 0xde, 0x31, 0xa5, 0xb9, 0x10, 0xb9,
+	0x86, 0x6b, 0xd2, 0x55, 0x45, 0x3f, 0x8d, 0x33, 0x36, 0x6b, 0xb3, 0x09, 0xe3, 0xbd, 0x50, 0xb8,
+	0x7a, 0xa9, 0x4c, 0x7d, 0x4f, 0x89, 0xfe, 0x6f, 0x34, 0xc9, 0xfd, 0xec, 0x23, 0x54, 0x54, 0xea,
+	0x76, 0xc6, 0x8f, 0xde, 0xf9, 0x2d, 0x9f, 0x9a, 0x0f, 0xde, 0x01, 0xea, 0x78, 0x98, 0xdd, 0x96,
+	0x9a, 0x32, 0x9e, 0xa7, 0xf2, 0x47, 0xb1, 0x55, 0x33, 0x94, 0x69, 0x2d, 0x21, 0x87, 0x88, 0x86,
+	0x51, 0x2e, 0xf2, 0x6c, 0x06, 0x43, 0x7a, 0x85, 0x65, 0xfd, 0x30, 0xb7, 0x75, 0xe4, 0xea, 0xec,
+	0x37, 0xc1, 0xdc, 0x5e, 0x2d, 0x25, 0x22, 0x1b, 0x7c, 0xba, 0x56, 0x5f, 0xa5, 0x24, 0xe5, 0x9b,
+	0xce, 0xca, 0xe9, 0xe5, 0xd3, 0xce, 0x50, 0x31, 0xa2, 0x82, 0xf8, 0x99, 0xaa, 0xb4, 0xe1, 0x86,
+	0x96, 0x99, 0x52, 0x3f, 0x87, 0x00, 0x38, 0xf0, 0x1b, 0xcc, 0x13, 0xf2, 0xb8, 0x66, 0xb5, 0x07,
+	0x56, 0x7f, 0x8c, 0x8a, 0x0b, 0x7f, 0xe2, 0xf2, 0x33, 0x03, 0x08, 0x5e, 0xe0, 0xbe, 0xf2, 0xa5,
+	0x11, 0xab, 0xcb, 0xc6, 0x9e, 0xe0, 0x22, 0x53, 0xe5, 0x35, 0x8a, 0x59, 0xd6, 0x5f, 0x4d, 0x04,
+	0x32, 0xe7, 0x72, 0x84, 0x6f, 0x4c, 0x22, 0xa2, 0x8b, 0x66, 0x78, 0x68, 0x66, 0xd3, 0xee, 0x7f,
+	0x24, 0xe8, 0x66, 0xa0, 0x3d, 0x70, 0x84, 0xc0, 0x23, 0x8d, 0x39, 0x72, 0x1c, 0x02, 0x2f, 0xdc,
+	0x0a, 0x24, 0x3f, 0x58, 0x71, 0x14, 0x2c, 0x19, 0x04, 0x97, 0x3e, 0xe7, 0xb9, 0x0f, 0xac, 0x44,
+	0x52, 0xd8, 0x34, 0x1e, 0x9d, 0x28, 0x6c, 0xb1, 0xdd, 0x54, 0x5d, 0x4c, 0x84, 0x24, 0xe0, 0xb9,
+	0x40, 0x3d, 0x78, 0x3e, 0x6a, 0x33, 0xf8, 0x6c, 0x0b, 0xb6, 0xbe, 0x43, 0xeb, 0x66, 0xb3, 0x4e,
+	0x60, 0x54, 0xb5, 0xbe, 0x9b, 0xc0, 0xbc, 0x84, 0xc6, 0x4a, 0xb1, 0x8f, 0x4d, 0x68, 0xee, 0xeb,
+	0x4a, 0x8e, 0x8d, 0xb8, 0xeb, 0xbc, 0x41, 0x9e, 0x34, 0x9e, 0x46, 0x11, 0x74, 0x12, 0x54, 0x0a,
+	0x73, 0x38, 0x36, 0x9e, 0xb0, 0x7d, 0xda, 0xf2, 0xca, 0xa3, 0xac, 0xd0, 0xfe, 0x14, 0xac, 0x16,
+	0x94, 0x2a, 0xee, 0xa1, 0xc9, 0x28, 0xd8, 0x42, 0x8e, 0x6a, 0x7b, 0xbc, 0xb5, 0xa5, 0xe4, 0x2d,
+	0x08, 0x2f, 0x87, 0xc2, 0x05, 0x56, 0x37, 0x73, 0x16, 0x8c, 0x23, 0xb8, 0xe8, 0xd5, 0x5d, 0x0c,
+	0xd7, 0xd6, 0x4a, 0xfe, 0xf4, 0xbe, 0xef, 0xdf, 0x3b, 0xf4, 0xdc, 0x8f, 0x5c, 0x7c, 0x97, 0x3d,
+	0x00, 0x56, 0xe5, 0x5d, 0x61, 0x30, 0x46, 0xe3, 0x08, 0xdf, 0xd4, 0xf0, 0x50, 0x88, 0x9a, 0x0f,
+	0x80, 0x9b, 0xdd, 0x9f, 0xd5, 0x71, 0x45, 0x2a, 0x0a, 0x8e, 0x97, 0xfc, 0xa7, 0xd4, 0xb6, 0x35,
+	0x10, 0x60, 0x37, 0xb8, 0x20, 0x71, 0xde, 0xd8, 0x3a, 0xe3, 0x43, 0x6f, 0x2a, 0x4d, 0xfc, 0xc6,
+	0x09, 0x25, 0x5e, 0x95, 0xc1, 0x70, 0xde, 0x6e, 0xf9, 0x94, 0xc4, 0x17, 0x7c, 0xd2, 0x3d, 0xb6,
+	0x39, 0xb5, 0x4e, 0x37, 0x70, 0xd4, 0xb4, 0xcd, 0x90, 0x73, 0x21, 0x4f, 0xe5, 0x17, 0x0d, 0x1d,
+	0xd2, 0xf8, 0xb8, 0xa1, 0xc3, 0xef, 0xf6, 0x5c, 0xe0, 0x55, 0x0d, 0x23, 0x8f, 0xb1, 0x41, 0xbb,
+	0xb1, 0x52, 0x43, 0x32, 0x47, 0x62, 0x2b, 0xf4, 0x72, 0xde, 0xd8, 0x4b, 0x8c, 0x4f, 0xf9, 0x78,
+	0x05, 0xc3, 0x34, 0x91, 0x7d, 0xd6, 0xd9, 0xca, 0xa7, 0xc9, 0x1d, 0x28, 0x89, 0x22, 0x8f, 0xca,
+	0x48, 0xdc, 0xa8, 0xaa, 0x6d, 0x34, 0xab, 0x8d, 0xc9, 0x7d, 0x3d, 0x47, 0x51, 0xc3, 0x8f, 0x5a,
+	0xe3, 0xbe, 0x4b, 0xe7, 0x97, 0xa4, 0x00, 0xc0, 0x27, 0x27, 0xe7, 0x4a, 0x8e, 0x1b, 0xbe, 0x20,
+	0x5a, 0x5f, 0x5f, 0x22, 0xe8, 0x49, 0x79, 0x78, 0x27, 0x5c, 0x74, 0x4d, 0x38, 0x30, 0x4e, 0x84,
+	0x19, 0xe3, 0x07, 0x6c, 0x51, 0xea, 0x44, 0xd5, 0xfa, 0x61, 0x0c, 0x8b, 0x98, 0x2a, 0xce, 0xd2,
+	0x85, 0xef, 0x16, 0x32, 0x88, 0x8b, 0xdb, 0xf3, 0x1d, 0x7b, 0x06, 0xa9, 0x76, 0x44, 0xa4, 0x51,
+	0x1b, 0x63, 0x36, 0xb1, 0x9e, 0xbf, 0x9f, 0x4d, 0xf7, 0xb5, 0x2a, 0xf7, 0x40, 0xe4, 0xe5, 0x81,
+	0x95, 0xeb, 0x74, 0xb0, 0x36, 0xee, 0xc2, 0xe6, 0xf4, 0x5d, 0xd1, 0x90, 0x59, 0x04, 0xa6, 0xdf,
+	0x61, 0xf8, 0x78, 0x02, 0x80, 0xc6, 0x04, 0x95, 0x10, 0xa6, 0x41, 0x6e, 0x9c, 0xea, 0x57, 0x24,
+	0xdb, 0x6d, 0xe4, 0x2a, 0xbb, 0x96, 0x17, 0x1a, 0xae, 0xaf, 0xd6, 0xa6, 0xab, 0x09, 0x18, 0xb1,
+	0xfb, 0x08, 0xa4, 0xd7, 0xb2, 0x56, 0x58, 0x3b, 0x28, 0x5d, 0x4f, 0xa3, 0xb9, 0x41, 0xa5, 0x96,
+	0x66, 0xf8, 0x4d, 0x25, 0x46, 0xb5, 0xb2, 0x01, 0x78, 0x12, 0x65, 0xbb, 0x5b, 0x96, 0xc8, 0xdd,
+	0xdc, 0xc9, 0x1d, 0xb2, 0xa6, 0xc2, 0x1b, 0xa5, 0xa5, 0x8c, 0x60, 0x8e, 0x63, 0x78, 0xc3, 0x72,
+	0x7a, 0xcd, 0xac, 0xb7, 0x53, 0x36, 0xca, 0xd4, 0x3f, 0xcd, 0x49, 0x24, 0x8d, 0x8f, 0x8d, 0xd0,
+	0xb8, 0xa4, 0xcf, 0x72, 0x8c, 0xa7, 0x89, 0x79, 0x6b, 0xc4, 0xbe, 0x03, 0x58, 0x82, 0x79, 0x94,
+	0x0b, 0x24, 0xb8, 0xf6, 0x2b, 0x5d, 0x38, 0x53, 0x51, 0x96, 0xfa, 0x47, 0xb8, 0x42, 0xc6, 0x1e,
+	0x05, 0xa7, 0xe0, 0x76, 0x7c, 0xe6, 0xff, 0x25, 0x82, 0xfa, 0x67, 0x64, 0x46, 0x79, 0x05, 0x96,
+	0x87, 0x2d, 0xcd, 0x3e, 0x01, 0xc8, 0xe0, 0xe5, 0x8c, 0x85, 0x0d, 0xf0, 0xec, 0xb5, 0x0f, 0x4e,
+	0x65, 0x36, 0xb6, 0x9f, 0xbc, 0x35, 0x00, 0xa0, 0x02, 0xa9, 0x57, 0x13, 0x3b, 0x39, 0x08, 0xaf,
+	0xf1, 0xd6, 0x8b, 0x7d, 0x92, 0x03, 0x8f, 0xf5, 0x1a, 0xfc, 0x94, 0x93, 0x78, 0x19, 0x65, 0x85,
+	0xdf, 0x0d, 0xef, 0x78, 0x0f, 0x67, 0x03, 0xf3, 0xb8, 0x98, 0xb9, 0x26, 0xcc, 0x79, 0x30, 0xef,
+	0x07, 0xb7, 0x79, 0x55, 0xe0, 0x01, 0xa3, 0x46, 0x15, 0xad, 0xc7, 0x00, 0xd8, 0x8b, 0x22, 0x82,
+	0x6b, 0x40, 0x4b, 0xc2, 0x9f, 0xc1, 0x36, 0x34, 0xe1, 0x65, 0xbf, 0x2f, 0xeb, 0x84, 0xba, 0x7a,
+	0x49, 0xea, 0xa3, 0xd6, 0x87, 0x2a, 0xfa, 0x28, 0x78, 0x67, 0x7f, 0xc5, 0xe0, 0xd8, 0x0d, 0x56,
+	0x1d, 0x5b, 0x8c, 0x6a, 0x22, 0xd3, 0x51, 0x87, 0xa2, 0xbb, 0x12, 0x8c, 0xb6, 0x72, 0x61, 0x4b,
+	0xaa, 0x95, 0x21, 0x78, 0x3b, 0x00, 0x0a, 0x33, 0x69, 0x41, 0x7e, 0xc5, 0x82, 0xe1, 0x60, 0x2d,
+	0x13, 0x87, 0x42, 0x3a, 0x7d, 0xb2, 0xef, 0xc3, 0x7c, 0x73, 0xdb, 0x30, 0x89, 0x42, 0x3f, 0x8e,
+	0xde, 0x1b, 0x36, 0x02, 0x2d, 0x3d, 0x7f, 0x5b, 0xd4, 0x72, 0x13, 0x06, 0x77, 0x46, 0x68, 0x1f,
+	0x43, 0x4e, 0x8e, 0xa1, 0x99, 0xce, 0x7f, 0xc9, 0x15, 0x11, 0xef, 0x91, 0x4c, 0x67, 0xa2, 0xb8,
+	0xd8, 0x08, 0x79, 0x7d, 0xce, 0x7b, 0xfd, 0x90, 0x4e, 0xaa, 0xfe, 0xf6, 0x6d, 0x63, 0x39, 0xcb,
+	0x32, 0x3c, 0x05, 0x18, 0xb4, 0x97,
+};
+
+/*
+ * MD5 sums of the frames, as drawn by the decoder before it read ahead bits
+ * and looked up 12 bit codes at once.
+ */
+static const char *smk_test_smk2_md5[] = {
+	"b28df6b4041b4995cb93dbe656e22f77",
+	"c0e24cb5d15f4cb74a57873b425b0bef",
+	"93d59ee602c292790e05a9d2844a3583"
+};
+
+static const char *smk_test_smk4_md5[] = {
+	"02d7432cda4b71ad894bae3e95a7e997",
+	"0fd0a0685c4b41229168b6f38f1ff9e7",
+	"e507b683b6357793d8b8b06a29b6c7d0"
+};
+
+class SmackerDecoderTestSuite : public CxxTest::TestSuite {
+	VideoTestSystem _system;
+
+	void checkFrames(const byte *data, uint32 size, uint16 height, const char *const *md5) {
+		Video::SmackerDecoder decoder(0);
+
+		TS_ASSERT(decoder.load(new Common::MemoryReadStream(data, size)));
+		TS_ASSERT_EQUALS(decoder.getWidth(), 32);
+		TS_ASSERT_EQUALS(decoder.getHeight(), height);
+		TS_ASSERT_EQUALS(decoder.getFrameCount(), 3u);
+
+		for (int i = 0; i < 3 && !decoder.endOfVideo(); i++) {
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			Common::MemoryReadStream pixels((const byte *)frame->pixels, frame->h * frame->pitch);
+			TS_ASSERT_EQUALS(Common::computeStreamMD5AsString(pixels), md5[i]);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_smk2() {
+		checkFrames(smk_test_smk2, sizeof(smk_test_smk2), 16, smk_test_smk2_md5);
+	}
+
+	void test_smk4_y_doubled() {
+		checkFrames(smk_test_smk4, sizeof(smk_test_smk4), 32, smk_test_smk4_md5);
+	}
+};
@@ -0,0 +1,228 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/threaded_decoder.h"
+
+#include "common/timer.h"
+
+#include "helper.h"
+
+/*
+ * A decoder of ten 4x2 frames, 100 ms apart, which are filled with their
+ * frame number. Every third frame changes the first palette entry to its
+ * frame number. The time is set by the test.
+ */
+class ThreadedTestDecoder : public Video::SeekableVideoDecoder {
+public:
+	uint32 _time;
+
+	ThreadedTestDecoder() : _time(0), _loaded(false), _dirtyPalette(false) {
+		_surface.create(4, 2, 1);
+		memset(_palette, 0, sizeof(_palette));
+	}
+
+	~ThreadedTestDecoder() {
+		_surface.free();
+	}
+
+	uint16 getWidth() const { return 4; }
+	uint16 getHeight() const { return 2; }
+	uint32 getFrameCount() const { return 10; }
+	uint32 getElapsedTime() const { return _time; }
+
+	bool load(Common::SeekableReadStream *stream) {
+		delete stream;
+		_loaded = true;
+		return true;
+	}
+
+	void close() {
+		_loaded = false;
+		reset();
+	}
+
+	bool isVideoLoaded() const { return _loaded; }
+
+	const Graphics::Surface *decodeNextFrame() {
+		_curFrame++;
+		memset(_surface.pixels, _curFrame, _surface.w * _surface.h);
+
+		if (_curFrame % 3 == 0) {
+			_palette[0] = _curFrame;
+			_dirtyPalette = true;
+		}
+
+		return &_surface;
+	}
+
+	Graphics::PixelFormat getPixelFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+
+	const byte *getPalette() {
+		_dirtyPalette = false;
+		return _palette;
+	}
+
+	bool hasDirtyPalette() const { return _dirtyPalette; }
+
+	uint32 getTimeToNextFrame() const {
+		uint32 dueTime = (_curFrame + 1) * 100;
+		return (dueTime > _time) ? dueTime - _time : 0;
+	}
+
+	void seekToFrame(uint32 frame) {
+		_curFrame = frame - 1;
+	}
+
+	void seekToTime(Video::VideoTimestamp time) {
+		seekToFrame(time.getUnitsInScale(1000) / 100);
+	}
+
+private:
+	bool _loaded;
+	Graphics::Surface _surface;
+	byte _palette[256 * 3];
+	bool _dirtyPalette;
+};
+
+class ThreadedVideoDecoderTestSuite : public CxxTest::TestSuite {
+	// The timer callback only runs when the test calls it
+	class ThreadedTestTimerManager : public Common::TimerManager {
+	public:
+		TimerProc _proc;
+		void *_refCon;
+
+		ThreadedTestTimerManager() : _proc(0), _refCon(0) {}
+
+		bool installTimerProc(TimerProc proc, int32 interval, void *refCon) {
+			_proc = proc;
+			_refCon = refCon;
+			return true;
+		}
+
+		void removeTimerProc(TimerProc proc) {
+			if (_proc == proc)
+				_proc = 0;
+		}
+	};
+
+	class ThreadedTestSystem : public VideoTestSystem {
+	public:
+		ThreadedTestTimerManager _timer;
+
+		Common::TimerManager *getTimerManager() { return &_timer; }
+	};
+
+	ThreadedTestSystem _system;
+
+	void runTimer(int count) {
+		for (int i = 0; i < count; i++) {
+			TS_ASSERT(_system._timer._proc);
+			if (_system._timer._proc)
+				_system._timer._proc(_system._timer._refCon);
+		}
+	}
+
+	void checkFrame(Video::ThreadedVideoDecoder &decoder, int32 frame) {
+		const Graphics::Surface *surface = decoder.decodeNextFrame();
+
+		TS_ASSERT(surface);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+		if (surface)
+			TS_ASSERT_EQUALS(*(const byte *)surface->pixels, frame);
+	}
+
+	public:
+	void setUp() {
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		g_system = 0;
+	}
+
+	void test_frame_order() {
+		ThreadedTestDecoder *wrapped = new ThreadedTestDecoder();
+		Video::ThreadedVideoDecoder decoder(wrapped, 4);
+
+		TS_ASSERT(decoder.load(0));
+
+		// Nothing is decoded ahead until the first frame was shown
+		runTimer(2);
+		TS_ASSERT_EQUALS(wrapped->getCurFrame(), -1);
+		checkFrame(decoder, 0);
+
+		// The queue holds four frames at most
+		runTimer(6);
+		TS_ASSERT_EQUALS(wrapped->getCurFrame(), 4);
+
+		for (int32 i = 1; i < 10; i++) {
+			checkFrame(decoder, i);
+			runTimer(1);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+	}
+
+	void test_seek_flushes_queue() {
+		ThreadedTestDecoder *wrapped = new ThreadedTestDecoder();
+		Video::ThreadedVideoDecoder decoder(wrapped, 4);
+
+		TS_ASSERT(decoder.load(0));
+		checkFrame(decoder, 0);
+		runTimer(4);
+
+		decoder.seekToFrame(7);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 6);
+		checkFrame(decoder, 7);
+		runTimer(4);
+
+		decoder.seekToTime(Video::VideoTimestamp(250));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 1);
+		checkFrame(decoder, 2);
+		runTimer(1);
+		checkFrame(decoder, 3);
+		checkFrame(decoder, 4);
+	}
+
+	void test_no_dropped_frames() {
+		ThreadedTestDecoder *wrapped = new ThreadedTestDecoder();
+		Video::ThreadedVideoDecoder decoder(wrapped, 4);
+
+		TS_ASSERT(decoder.load(0));
+		checkFrame(decoder, 0);
+		runTimer(4);
+
+		// Late frames are shown anyway by default
+		wrapped->_time = 450;
+		checkFrame(decoder, 1);
+		TS_ASSERT_EQUALS(decoder.getDroppedFrameCount(), 0u);
+		TS_ASSERT_EQUALS(decoder.getLateFrameCount(), 1u);
+	}
+
+	void test_drop_late_frames() {
+		ThreadedTestDecoder *wrapped = new ThreadedTestDecoder();
+		Video::ThreadedVideoDecoder decoder(wrapped, 4);
+
+		decoder.setDropLateFrames(true);
+		TS_ASSERT(decoder.load(0));
+		checkFrame(decoder, 0);
+		TS_ASSERT(decoder.hasDirtyPalette());
+		TS_ASSERT_EQUALS(decoder.getPalette()[0], 0);
+		TS_ASSERT(!decoder.hasDirtyPalette());
+
+		// Frames 1 to 4 are due at 100 to 400 ms
+		runTimer(4);
+
+		// Frames 1 to 3 are skipped, the palette change of frame 3 is kept
+		wrapped->_time = 450;
+		checkFrame(decoder, 4);
+		TS_ASSERT_EQUALS(decoder.getDroppedFrameCount(), 3u);
+		TS_ASSERT_EQUALS(decoder.getLateFrameCount(), 1u);
+		TS_ASSERT(decoder.hasDirtyPalette());
+		TS_ASSERT_EQUALS(decoder.getPalette()[0], 3);
+
+		// Frames which are not due yet are kept
+		runTimer(4);
+		checkFrame(decoder, 5);
+		TS_ASSERT_EQUALS(decoder.getDroppedFrameCount(), 3u);
+	}
+};
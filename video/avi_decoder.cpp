@@ -337,8 +337,13 @@ const Graphics::Surface *AviDecoder::decodeNextFrame() {
 		const Graphics::Surface *frame = NULL;
 		while (_fileStream->pos() < startPos + (int32)listSize) {
 			const Graphics::Surface *temp = decodeNextFrame();
-			if (temp)
+			if (temp) {
+				// Only the last frame is returned, with the changes of all
+				if (frame)
+					setFullDirtyRect(temp->w, temp->h);
+
 				frame = temp;
+			}
 		}
 
 		return frame;
@@ -360,6 +365,14 @@ const Graphics::Surface *AviDecoder::decodeNextFrame() {
 		const Graphics::Surface *surface = _videoCodec->decodeImage(frameData);
 		delete frameData;
 		_fileStream->skip(chunkSize & 1); // Alignment
+
+		if (surface) {
+			if (_curFrame == 0 || !_videoCodec->hasDirtyRects())
+				setFullDirtyRect(surface->w, surface->h);
+			else
+				_dirtyRects = _videoCodec->getDirtyRects();
+		}
+
 		return surface;
 	} else if (getStreamType(nextTag) == 'pc') {
 		// Palette Change
@@ -25,6 +25,8 @@
 
 #include "video/codecs/cinepak.h"
 
+#include "common/endian.h"
+#include "common/memstream.h"
 #include "common/system.h"
 
 // Code here partially based off of ffmpeg ;)
@@ -38,20 +40,12 @@ inline static void CPYUV2RGB(byte y, byte u, byte v, byte &r, byte &g, byte &b)
 	b = CLIP<int>(y + 2 * (u - 128), 0, 255);
 }
 
-#define PUT_PIXEL(offset, lum, u, v) \
-	if (_pixelFormat.bytesPerPixel != 1) { \
-		CPYUV2RGB(lum, u, v, r, g, b); \
-		if (_pixelFormat.bytesPerPixel == 2) \
-			*((uint16 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-		else \
-			*((uint32 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-	} else \
-		*((byte *)_curFrame.surface->pixels + offset) = lum
-
 CinepakDecoder::CinepakDecoder(int bitsPerPixel) : Codec() {
 	_curFrame.surface = NULL;
 	_curFrame.strips = NULL;
 	_y = 0;
+	_frameBuffer = 0;
+	_frameBufferSize = 0;
 
 	if (bitsPerPixel == 8)
 		_pixelFormat = Graphics::PixelFormat::createFormatCLUT8();
@@ -66,9 +60,27 @@ CinepakDecoder::~CinepakDecoder() {
 	}
 
 	delete[] _curFrame.strips;
+	delete[] _frameBuffer;
 }
 
 const Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream *stream) {
+	// The vectors are drawn from the chunk data in place once the whole
+	// frame has been read, so a frame which isn't in memory is read first
+	if (stream->getDataPtr())
+		return decodeFrame(stream);
+
+	const uint32 size = stream->size() - stream->pos();
+	if (size > _frameBufferSize) {
+		delete[] _frameBuffer;
+		_frameBufferSize = size;
+		_frameBuffer = new byte[_frameBufferSize];
+	}
+
+	Common::MemoryReadStream frame(_frameBuffer, stream->read(_frameBuffer, size));
+	return decodeFrame(&frame);
+}
+
+const Graphics::Surface *CinepakDecoder::decodeFrame(Common::SeekableReadStream *stream) {
 	_curFrame.flags = stream->readByte();
 	_curFrame.length = (stream->readByte() << 16) + stream->readUint16BE();
 	_curFrame.width = stream->readUint16BE();
@@ -95,6 +107,9 @@ const Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream
 	// Reset the y variable.
 	_y = 0;
 
+	for (uint16 i = 0; i < _curFrame.stripCount; i++)
+		_curFrame.strips[i].vectorChunks.clear();
+
 	for (uint16 i = 0; i < _curFrame.stripCount; i++) {
 		if (i > 0 && !(_curFrame.flags & 1)) { // Use codebooks from last strip
 			for (uint16 j = 0; j < 256; j++) {
@@ -126,27 +141,36 @@ const Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream
 			chunkSize += stream->readUint16BE() - 4;
 
 			int32 startPos = stream->pos();
+			uint32 dataSize = chunkSize;
+			CinepakVectorChunk vectors;
 
 			switch (chunkID) {
 			case 0x20:
 			case 0x21:
 			case 0x24:
 			case 0x25:
-				loadCodebook(stream, i, 4, chunkID, chunkSize);
+				// Vectors read before have to be drawn with the old codebook
+				drawStrip(i);
+				loadCodebook(readChunk(stream, dataSize), i, 4, chunkID, dataSize);
 				break;
 			case 0x22:
 			case 0x23:
 			case 0x26:
 			case 0x27:
-				loadCodebook(stream, i, 1, chunkID, chunkSize);
+				drawStrip(i);
+				loadCodebook(readChunk(stream, dataSize), i, 1, chunkID, dataSize);
 				break;
 			case 0x30:
 			case 0x31:
 			case 0x32:
-				decodeVectors(stream, i, chunkID, chunkSize);
+				vectors.id = chunkID;
+				vectors.data = readChunk(stream, dataSize);
+				vectors.size = dataSize;
+				_curFrame.strips[i].vectorChunks.push_back(vectors);
 				break;
 			default:
 				warning("Unknown Cinepak chunk ID %02x", chunkID);
+				drawStrips();
 				return _curFrame.surface;
 			}
 
@@ -157,35 +181,45 @@ const Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream
 		_y = _curFrame.strips[i].rect.bottom;
 	}
 
+	drawStrips();
 	return _curFrame.surface;
 }
 
-void CinepakDecoder::loadCodebook(Common::SeekableReadStream *stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize) {
+const byte *CinepakDecoder::readChunk(Common::SeekableReadStream *stream, uint32 &chunkSize) {
+	// Don't go beyond the end of the frame with broken chunk sizes
+	chunkSize = MIN<uint32>(chunkSize, stream->size() - stream->pos());
+	return stream->getDataPtr() + stream->pos();
+}
+
+void CinepakDecoder::loadCodebook(const byte *data, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize) {
 	CinepakCodebook *codebook = (codebookType == 1) ? _curFrame.strips[strip].v1_codebook : _curFrame.strips[strip].v4_codebook;
 
-	int32 startPos = stream->pos();
+	const byte *src = data;
+	const byte *end = data + chunkSize;
 	uint32 flag = 0, mask = 0;
+	byte r = 0, g = 0, b = 0;
 
 	for (uint16 i = 0; i < 256; i++) {
 		if ((chunkID & 0x01) && !(mask >>= 1)) {
-			if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+			if (end - src < 4)
 				break;
 
-			flag  = stream->readUint32BE();
+			flag  = READ_BE_UINT32(src);
 			mask  = 0x80000000;
+			src += 4;
 		}
 
 		if (!(chunkID & 0x01) || (flag & mask)) {
 			byte n = (chunkID & 0x04) ? 4 : 6;
-			if ((stream->pos() - startPos + n) > (int32)chunkSize)
+			if (end - src < n)
 				break;
 
 			for (byte j = 0; j < 4; j++)
-				codebook[i].y[j] = stream->readByte();
+				codebook[i].y[j] = src[j];
 
 			if (n == 6) {
-				codebook[i].u  = stream->readByte() + 128;
-				codebook[i].v  = stream->readByte() + 128;
+				codebook[i].u  = src[4] + 128;
+				codebook[i].v  = src[5] + 128;
 			} else {
 				// This codebook type indicates either greyscale or
 				// palettized video. For greyscale, default us to
@@ -193,100 +227,136 @@ void CinepakDecoder::loadCodebook(Common::SeekableReadStream *stream, uint16 str
 				codebook[i].u  = 128;
 				codebook[i].v  = 128;
 			}
+
+			src += n;
+
+			// Convert the pixels once here, rather than each time they are drawn
+			for (byte j = 0; j < 4; j++) {
+				if (_pixelFormat.bytesPerPixel != 1) {
+					CPYUV2RGB(codebook[i].y[j], codebook[i].u, codebook[i].v, r, g, b);
+					codebook[i].color[j] = _pixelFormat.RGBToColor(r, g, b);
+				} else
+					codebook[i].color[j] = codebook[i].y[j];
+			}
 		}
 	}
 }
 
-void CinepakDecoder::decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize) {
+/**
+ * Draw the vectors of one strip. A V1 vector is a codebook entry whose
+ * pixels are scaled to 2x2 each, a V4 vector consists of four entries, one
+ * for each 2x2 quarter of the block.
+ */
+template<typename PixelInt>
+static void decodeStripVectors(PixelInt *dest, uint16 width, const CinepakStrip &strip, const byte *data, byte chunkID, uint32 chunkSize) {
+	const byte *src = data;
+	const byte *end = data + chunkSize;
 	uint32 flag = 0, mask = 0;
-	uint32 iy[4];
-	int32 startPos = stream->pos();
-	byte r = 0, g = 0, b = 0;
 
-	for (uint16 y = _curFrame.strips[strip].rect.top; y < _curFrame.strips[strip].rect.bottom; y += 4) {
-		iy[0] = _curFrame.strips[strip].rect.left + y * _curFrame.width;
-		iy[1] = iy[0] + _curFrame.width;
-		iy[2] = iy[1] + _curFrame.width;
-		iy[3] = iy[2] + _curFrame.width;
+	for (uint16 y = strip.rect.top; y < strip.rect.bottom; y += 4) {
+		PixelInt *row0 = dest + strip.rect.left + y * width;
+		PixelInt *row1 = row0 + width;
+		PixelInt *row2 = row1 + width;
+		PixelInt *row3 = row2 + width;
 
-		for (uint16 x = _curFrame.strips[strip].rect.left; x < _curFrame.strips[strip].rect.right; x += 4) {
+		for (uint16 x = strip.rect.left; x < strip.rect.right; x += 4) {
 			if ((chunkID & 0x01) && !(mask >>= 1)) {
-				if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+				if (end - src < 4)
 					return;
 
-				flag  = stream->readUint32BE();
+				flag  = READ_BE_UINT32(src);
 				mask  = 0x80000000;
+				src += 4;
 			}
 
 			if (!(chunkID & 0x01) || (flag & mask)) {
 				if (!(chunkID & 0x02) && !(mask >>= 1)) {
-					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+					if (end - src < 4)
 						return;
 
-					flag  = stream->readUint32BE();
+					flag  = READ_BE_UINT32(src);
 					mask  = 0x80000000;
+					src += 4;
 				}
 
 				if ((chunkID & 0x02) || (~flag & mask)) {
-					if ((stream->pos() - startPos + 1) > (int32)chunkSize)
+					if (end - src < 1)
 						return;
 
-					// Get the codebook
-					CinepakCodebook codebook = _curFrame.strips[strip].v1_codebook[stream->readByte()];
-
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[0], codebook.u, codebook.v);
+					const uint32 *color = strip.v1_codebook[*src++].color;
 
-					PUT_PIXEL(iy[0] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[1], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[2], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					row0[0] = row0[1] = row1[0] = row1[1] = (PixelInt)color[0];
+					row0[2] = row0[3] = row1[2] = row1[3] = (PixelInt)color[1];
+					row2[0] = row2[1] = row3[0] = row3[1] = (PixelInt)color[2];
+					row2[2] = row2[3] = row3[2] = row3[3] = (PixelInt)color[3];
 				} else if (flag & mask) {
-					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+					if (end - src < 4)
 						return;
 
-					CinepakCodebook codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					const uint32 *color = strip.v4_codebook[src[0]].color;
+					row0[0] = (PixelInt)color[0];
+					row0[1] = (PixelInt)color[1];
+					row1[0] = (PixelInt)color[2];
+					row1[1] = (PixelInt)color[3];
+
+					color = strip.v4_codebook[src[1]].color;
+					row0[2] = (PixelInt)color[0];
+					row0[3] = (PixelInt)color[1];
+					row1[2] = (PixelInt)color[2];
+					row1[3] = (PixelInt)color[3];
+
+					color = strip.v4_codebook[src[2]].color;
+					row2[0] = (PixelInt)color[0];
+					row2[1] = (PixelInt)color[1];
+					row3[0] = (PixelInt)color[2];
+					row3[1] = (PixelInt)color[3];
+
+					color = strip.v4_codebook[src[3]].color;
+					row2[2] = (PixelInt)color[0];
+					row2[3] = (PixelInt)color[1];
+					row3[2] = (PixelInt)color[2];
+					row3[3] = (PixelInt)color[3];
+
+					src += 4;
 				}
 			}
 
-			for (byte i = 0; i < 4; i++)
-				iy[i] += 4;
+			row0 += 4;
+			row1 += 4;
+			row2 += 4;
+			row3 += 4;
 		}
 	}
 }
 
+void CinepakDecoder::decodeVectors(const byte *data, uint16 strip, byte chunkID, uint32 chunkSize) {
+	if (_pixelFormat.bytesPerPixel == 1)
+		decodeStripVectors<uint8>((uint8 *)_curFrame.surface->pixels, _curFrame.width, _curFrame.strips[strip], data, chunkID, chunkSize);
+	else if (_pixelFormat.bytesPerPixel == 2)
+		decodeStripVectors<uint16>((uint16 *)_curFrame.surface->pixels, _curFrame.width, _curFrame.strips[strip], data, chunkID, chunkSize);
+	else
+		decodeStripVectors<uint32>((uint32 *)_curFrame.surface->pixels, _curFrame.width, _curFrame.strips[strip], data, chunkID, chunkSize);
+}
+
+void CinepakDecoder::drawStrip(uint16 strip) {
+	Common::Array<CinepakVectorChunk> &vectorChunks = _curFrame.strips[strip].vectorChunks;
+
+	for (uint i = 0; i < vectorChunks.size(); i++)
+		decodeVectors(vectorChunks[i].data, strip, vectorChunks[i].id, vectorChunks[i].size);
+
+	vectorChunks.clear();
+}
+
+/**
+ * Draw the vectors of all strips. Each strip has its own codebooks and
+ * rows, so the strips can be drawn at the same time.
+ */
+void CinepakDecoder::drawStrips() {
+	_jobRunner.run(drawStripProc, this, _curFrame.stripCount);
+}
+
+void CinepakDecoder::drawStripProc(void *refCon, uint strip) {
+	((CinepakDecoder *)refCon)->drawStrip(strip);
+}
+
 } // End of namespace Video
@@ -27,6 +27,8 @@
 #define VIDEO_CODECS_CINEPAK_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/jobrunner.h"
 #include "common/stream.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
@@ -39,6 +41,13 @@ namespace Video {
 struct CinepakCodebook {
 	byte y[4];
 	byte u, v;
+	uint32 color[4];	///< The four pixels, in the pixel format of the decoder
+};
+
+struct CinepakVectorChunk {
+	byte id;
+	uint32 size;
+	const byte *data;
 };
 
 struct CinepakStrip {
@@ -46,6 +55,7 @@ struct CinepakStrip {
 	uint16 length;
 	Common::Rect rect;
 	CinepakCodebook v1_codebook[256], v4_codebook[256];
+	Common::Array<CinepakVectorChunk> vectorChunks;	///< The vectors read but not drawn yet
 };
 
 struct CinepakFrame {
@@ -72,8 +82,18 @@ private:
 	int32 _y;
 	Graphics::PixelFormat _pixelFormat;
 
-	void loadCodebook(Common::SeekableReadStream *stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
-	void decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize);
+	byte *_frameBuffer;
+	uint32 _frameBufferSize;
+	Common::JobRunner _jobRunner;
+
+	const Graphics::Surface *decodeFrame(Common::SeekableReadStream *stream);
+	const byte *readChunk(Common::SeekableReadStream *stream, uint32 &chunkSize);
+	void loadCodebook(const byte *data, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
+	void decodeVectors(const byte *data, uint16 strip, byte chunkID, uint32 chunkSize);
+	void drawStrip(uint16 strip);
+	void drawStrips();
+
+	static void drawStripProc(void *refCon, uint strip);
 };
 
 } // End of namespace Video
@@ -26,6 +26,9 @@
 #ifndef VIDEO_CODECS_CODEC_H
 #define VIDEO_CODECS_CODEC_H
 
+#include "common/list.h"
+#include "common/rect.h"
+
 #include "graphics/surface.h"
 #include "graphics/pixelformat.h"
 
@@ -46,6 +49,19 @@ public:
 	virtual bool containsPalette() const { return false; }
 	virtual const byte *getPalette() { return 0; }
 	virtual bool hasDirtyPalette() const { return false; }
+
+	/**
+	 * Returns if the codec keeps track of the areas each image changes
+	 */
+	virtual bool hasDirtyRects() const { return false; }
+
+	/**
+	 * Returns the areas of the surface the last decodeImage() call changed
+	 */
+	const Common::List<Common::Rect> &getDirtyRects() const { return _dirtyRects; }
+
+protected:
+	Common::List<Common::Rect> _dirtyRects;
 };
 
 } // End of namespace Video
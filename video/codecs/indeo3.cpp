@@ -38,7 +38,7 @@
 #include "common/frac.h"
 #include "common/file.h"
 
-#include "graphics/conversion.h"
+#include "graphics/yuv_to_rgb.h"
 
 #include "video/codecs/indeo3.h"
 
@@ -169,6 +169,36 @@ void Indeo3Decoder::allocFrames() {
 	}
 }
 
+/**
+ * Convert one row of the frame. The first and last pixel of each chroma
+ * block are interpolated with the chroma samples left respectively right
+ * of the block in the row near, the others with the sample of the block.
+ */
+template<typename PixelInt>
+static void convertRow(PixelInt *dest, uint32 scaleWidth, const byte *srcY, const byte *srcU, const byte *srcV,
+		const byte *nearU, const byte *nearV, uint32 width, uint32 chromaWidth, const Graphics::YUVToRGBLookup *lookup) {
+
+	for (uint32 x = 0; x < width; x += 4) {
+		const uint32 c  = x >> 2;
+		const uint32 cP = (c > 0) ? c - 1 : 0;
+		const uint32 cN = MIN<int32>(c + 1, chromaWidth - 1);
+
+		const uint32 u = srcU[c];
+		const uint32 v = srcV[c];
+
+		const byte pixelU[4] = { (byte)((u + nearU[cP]) / 2), (byte)((u + nearU[c]) / 2), (byte)((u + nearU[c]) / 2), (byte)((u + nearU[cN]) / 2) };
+		const byte pixelV[4] = { (byte)((v + nearV[cP]) / 2), (byte)((v + nearV[c]) / 2), (byte)((v + nearV[c]) / 2), (byte)((v + nearV[cN]) / 2) };
+
+		const uint32 n = MIN<uint32>(width - x, 4);
+		for (uint32 i = 0; i < n; i++) {
+			const PixelInt color = (PixelInt)lookup->convert(srcY[x + i], pixelU[i], pixelV[i]);
+
+			for (uint32 sW = 0; sW < scaleWidth; sW++)
+				*dest++ = color;
+		}
+	}
+}
+
 const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *stream) {
 	// Not Indeo 3? Fail
 	if (!isIndeo3(*stream))
@@ -239,29 +269,56 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 		return 0;
 	}
 
-	byte *hdr_pos = inData;
+	FrameChunks chunks;
+	chunks.decoder = this;
+	chunks.fflags2 = flags2;
+	chunks.hdr = inData;
+
 	byte *buf_pos;
+	PlaneChunk *plane;
 
 	// Luminance Y
 	stream->seek(offsY);
 	buf_pos = inData + offsY + 4 - hPos;
 	offs = stream->readUint32LE();
-	decodeChunk(_cur_frame->Ybuf, _ref_frame->Ybuf, fWidth, fHeight,
-			buf_pos + offs * 2, flags2, hdr_pos, buf_pos, MIN<int>(fWidth, 160));
+	plane = &chunks.planes[0];
+	plane->cur = _cur_frame->Ybuf;
+	plane->ref = _ref_frame->Ybuf;
+	plane->width = fWidth;
+	plane->height = fHeight;
+	plane->buf1 = buf_pos + offs * 2;
+	plane->buf2 = buf_pos;
+	plane->min_width_160 = MIN<int>(fWidth, 160);
 
 	// Chrominance U
 	stream->seek(offsU);
 	buf_pos = inData + offsU + 4 - hPos;
 	offs = stream->readUint32LE();
-	decodeChunk(_cur_frame->Vbuf, _ref_frame->Vbuf, chromaWidth, chromaHeight,
-			buf_pos + offs * 2, flags2, hdr_pos, buf_pos, MIN<int>(chromaWidth, 40));
+	plane = &chunks.planes[1];
+	plane->cur = _cur_frame->Vbuf;
+	plane->ref = _ref_frame->Vbuf;
+	plane->width = chromaWidth;
+	plane->height = chromaHeight;
+	plane->buf1 = buf_pos + offs * 2;
+	plane->buf2 = buf_pos;
+	plane->min_width_160 = MIN<int>(chromaWidth, 40);
 
 	// Chrominance V
 	stream->seek(offsV);
 	buf_pos = inData + offsV + 4 - hPos;
 	offs = stream->readUint32LE();
-	decodeChunk(_cur_frame->Ubuf, _ref_frame->Ubuf, chromaWidth, chromaHeight,
-			buf_pos + offs * 2, flags2, hdr_pos, buf_pos, MIN<int>(chromaWidth, 40));
+	plane = &chunks.planes[2];
+	plane->cur = _cur_frame->Ubuf;
+	plane->ref = _ref_frame->Ubuf;
+	plane->width = chromaWidth;
+	plane->height = chromaHeight;
+	plane->buf1 = buf_pos + offs * 2;
+	plane->buf2 = buf_pos;
+	plane->min_width_160 = MIN<int>(chromaWidth, 40);
+
+	// Each plane is predicted from the same plane only, so the planes can
+	// be decoded at the same time
+	_jobRunner.run(decodePlaneProc, &chunks, 3);
 
 	delete[] inData;
 
@@ -279,60 +336,37 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 	uint32 scaleWidth  = _surface->w / fWidth;
 	uint32 scaleHeight = _surface->h / fHeight;
 
-	for (uint32 y = 0; y < fHeight; y++) {
-		byte *rowDest = dest;
-
-		for (uint32 sH = 0; sH < scaleHeight; sH++) {
-			for (uint32 x = 0; x < fWidth; x++) {
-				uint32 xP = MAX<int32>((x >> 2) - 1, 0);
-				uint32 xN = MIN<int32>((x >> 2) + 1, chromaWidth - 1);
-
-				byte cY = srcY[x];
-				byte cU = srcU[x >> 2];
-				byte cV = srcV[x >> 2];
-
-				if        (((x % 4) == 0) && ((y % 4) == 0)) {
-					cU = (((uint32) cU) + ((uint32) srcUP[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[xP])) / 2;
-				} else if (((x % 4) == 3) && ((y % 4) == 0)) {
-					cU = (((uint32) cU) + ((uint32) srcUP[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[xN])) / 2;
-				} else if (((x % 4) == 0) && ((y % 4) == 3)) {
-					cU = (((uint32) cU) + ((uint32) srcUN[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[xP])) / 2;
-				} else if (((x % 4) == 3) && ((y % 4) == 3)) {
-					cU = (((uint32) cU) + ((uint32) srcUN[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[xN])) / 2;
-				} else if ( (x % 4) == 0) {
-					cU = (((uint32) cU) + ((uint32) srcU[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcV[xP])) / 2;
-				} else if ( (x % 4) == 3) {
-					cU = (((uint32) cU) + ((uint32) srcU[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcV[xN])) / 2;
-				} else if ( (y % 4) == 0) {
-					cU = (((uint32) cU) + ((uint32) srcUP[x >> 2])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[x >> 2])) / 2;
-				} else if ( (y % 4) == 3) {
-					cU = (((uint32) cU) + ((uint32) srcUN[x >> 2])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[x >> 2])) / 2;
-				}
-
-				byte r = 0, g = 0, b = 0;
-				Graphics::YUV2RGB(cY, cU, cV, r, g, b);
+	// Other depths aren't supported
+	if ((_surface->bytesPerPixel != 1 && _surface->bytesPerPixel != 2) || scaleWidth == 0 || scaleHeight == 0)
+		return _surface;
 
-				const uint32 color = _pixelFormat.RGBToColor(r, g, b);
+	const Graphics::YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(_pixelFormat);
 
-				for (uint32 sW = 0; sW < scaleWidth; sW++, rowDest += _surface->bytesPerPixel) {
-					if      (_surface->bytesPerPixel == 1)
-						*((uint8 *)rowDest) = (uint8)color;
-					else if (_surface->bytesPerPixel == 2)
-						*((uint16 *)rowDest) = (uint16)color;
-				}
-			}
+	const uint32 rowSize = fWidth * scaleWidth * _surface->bytesPerPixel;
 
-			dest += _surface->pitch;
+	for (uint32 y = 0; y < fHeight; y++) {
+		// The first and last rows of a chroma block are interpolated with
+		// the chroma row above respectively below
+		const byte *nearU = srcU;
+		const byte *nearV = srcV;
+		if ((y % 4) == 0) {
+			nearU = srcUP;
+			nearV = srcVP;
+		} else if ((y % 4) == 3) {
+			nearU = srcUN;
+			nearV = srcVN;
 		}
 
+		if (_surface->bytesPerPixel == 1)
+			convertRow<uint8>((uint8 *)dest, scaleWidth, srcY, srcU, srcV, nearU, nearV, fWidth, chromaWidth, lookup);
+		else
+			convertRow<uint16>((uint16 *)dest, scaleWidth, srcY, srcU, srcV, nearU, nearV, fWidth, chromaWidth, lookup);
+
+		for (uint32 sH = 1; sH < scaleHeight; sH++)
+			memcpy(dest + sH * _surface->pitch, dest, rowSize);
+
+		dest += scaleHeight * _surface->pitch;
+
 		srcY += fWidth;
 
 		if ((y & 3) == 3) {
@@ -353,6 +387,14 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 	return _surface;
 }
 
+void Indeo3Decoder::decodePlaneProc(void *refCon, uint plane) {
+	const FrameChunks *chunks = (const FrameChunks *)refCon;
+	const PlaneChunk &chunk = chunks->planes[plane];
+
+	chunks->decoder->decodeChunk(chunk.cur, chunk.ref, chunk.width, chunk.height,
+			chunk.buf1, chunks->fflags2, chunks->hdr, chunk.buf2, chunk.min_width_160);
+}
+
 typedef struct {
 	int32 xpos;
 	int32 ypos;
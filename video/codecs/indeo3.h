@@ -37,6 +37,8 @@
 #ifndef VIDEO_CODECS_INDEO3_H
 #define VIDEO_CODECS_INDEO3_H
 
+#include "common/jobrunner.h"
+
 #include "video/codecs/codec.h"
 
 namespace Video {
@@ -76,15 +78,36 @@ private:
 	YUVBufs *_cur_frame;
 	YUVBufs *_ref_frame;
 
+	/** The arguments of decodeChunk() for one plane. */
+	struct PlaneChunk {
+		byte *cur;
+		byte *ref;
+		int width, height;
+		const byte *buf1;
+		const byte *buf2;
+		int min_width_160;
+	};
+
+	struct FrameChunks {
+		Indeo3Decoder *decoder;
+		PlaneChunk planes[3];
+		uint32 fflags2;
+		const byte *hdr;
+	};
+
 	byte *_ModPred;
 	uint16 *_corrector_type;
 
+	Common::JobRunner _jobRunner;
+
 	void buildModPred();
 	void allocFrames();
 
 	void decodeChunk(byte *cur, byte *ref, int width, int height,
 			const byte *buf1, uint32 fflags2, const byte *hdr,
 			const byte *buf2, int min_width_160);
+
+	static void decodePlaneProc(void *refCon, uint plane);
 };
 
 } // End of namespace Video
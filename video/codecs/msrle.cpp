@@ -62,6 +62,8 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream *stream) {
 	byte *output     = data + ((height - 1) * width);
 	byte *output_end = data + ((height)     * width);
 
+	_dirtyRects.clear();
+
 	while (!stream->eos()) {
 		byte count = stream->readByte();
 		byte value = stream->readByte();
@@ -107,6 +109,8 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream *stream) {
 					continue;
 				}
 
+				addDirtySpan(x, y, value);
+
 				for (int i = 0; i < value; i++)
 					*output++ = stream->readByte();
 
@@ -122,6 +126,8 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream *stream) {
 			if (output + count > output_end)
 				continue;
 
+			addDirtySpan(x, y, count);
+
 			for (int i = 0; i < count; i++, x++)
 				*output++ = value;
 		}
@@ -131,4 +137,39 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream *stream) {
 	warning("MS RLE Codec: No end-of-picture code");
 }
 
+void MSRLEDecoder::addDirtySpan(int x, int y, int count) {
+	const Common::Rect fullRect(_surface->w, _surface->h);
+
+	if (!_dirtyRects.empty() && _dirtyRects.front() == fullRect)
+		return;
+
+	// Broken data may continue on the following lines, redraw everything then
+	if (x + count > _surface->w) {
+		_dirtyRects.clear();
+		_dirtyRects.push_back(fullRect);
+		return;
+	}
+
+	Common::Rect rect(x, y, x + count, y + 1);
+
+	if (!_dirtyRects.empty()) {
+		Common::Rect &last = _dirtyRects.back();
+
+		// Extend the rectangle of the same line
+		if (last.top == rect.top && last.bottom == rect.bottom) {
+			last.extend(rect);
+			return;
+		}
+
+		// Extend the rectangle below with the same columns, the image is
+		// stored bottom up
+		if (last.left == rect.left && last.right == rect.right && last.top == rect.bottom) {
+			last.top = rect.top;
+			return;
+		}
+	}
+
+	_dirtyRects.push_back(rect);
+}
+
 } // End of namespace Video
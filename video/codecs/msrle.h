@@ -37,6 +37,7 @@ public:
 
 	const Graphics::Surface *decodeImage(Common::SeekableReadStream *stream);
 	Graphics::PixelFormat getPixelFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	bool hasDirtyRects() const { return true; }
 
 private:
 	byte _bitsPerPixel;
@@ -44,6 +45,7 @@ private:
 	Graphics::Surface *_surface;
 
 	void decode8(Common::SeekableReadStream *stream);
+	void addDirtySpan(int x, int y, int count);
 };
 
 } // End of namespace Video
@@ -28,7 +28,7 @@
 #include "common/scummsys.h"
 #include "video/codecs/qdm2.h"
 
-#ifdef GRAPHICS_QDM2_H
+#ifdef VIDEO_CODECS_QDM2_H
 
 #include "sound/audiostream.h"
 #include "video/codecs/qdm2data.h"
@@ -99,11 +99,9 @@ struct VLC {
 	int32 table_allocated;
 };
 
-#include "common/pack-start.h"
 struct QDM2FFT {
 	QDM2Complex complex[MPA_MAX_CHANNELS][256];
-} PACKED_STRUCT;
-#include "common/pack-end.h"
+};
 
 enum RDFTransformType {
 	RDFT,
@@ -376,13 +374,7 @@ static inline unsigned int getBits(GetBitContext *s, int n) {
 }
 
 static inline void skipBits(GetBitContext *s, int n) {
-	int reIndex, reCache;
-
-	reIndex = s->index;
-	reCache = 0;
-
-	reCache = READ_LE_UINT32((const uint8 *)s->buffer + (reIndex >> 3)) >> (reIndex & 0x07);
-	s->index = reIndex + n;
+	s->index += n;
 }
 
 #define BITS_LEFT(length, gb) ((length) - getBitsCount((gb)))
@@ -741,12 +733,15 @@ int fftInit(FFTContext *s, int nbits, int inverse) {
 	int i, j, m, n;
 	float alpha, c1, s1, s2;
 
+	s->revtab = NULL;
+	s->exptab = NULL;
+	s->tmpBuf = NULL;
+
 	if (nbits < 2 || nbits > 16)
 		goto fail;
 
 	s->nbits = nbits;
 	n = 1 << nbits;
-	s->tmpBuf = NULL;
 
 	s->exptab = (FFTComplex *)malloc((n / 2) * sizeof(FFTComplex));
 	if (!s->exptab)
@@ -801,9 +796,12 @@ int fftInit(FFTContext *s, int nbits, int inverse) {
 	return 0;
 
  fail:
-	free(&s->revtab);
-	free(&s->exptab);
-	free(&s->tmpBuf);
+	free(s->revtab);
+	s->revtab = NULL;
+	free(s->exptab);
+	s->exptab = NULL;
+	free(s->tmpBuf);
+	s->tmpBuf = NULL;
 	return -1;
 }
 
@@ -1520,7 +1518,8 @@ void initVlcSparse(VLC *vlc, int nb_bits, int nb_codes,
 	                codes, codes_wrap, codes_size,
 	                symbols, symbols_wrap, symbols_size,
 	                0, 0, 4 | 2) < 0) {
-		free(&vlc->table);
+		free(vlc->table);
+		vlc->table = NULL;
 		return; // Error
 	}
 
@@ -1759,9 +1758,19 @@ QDM2Stream::QDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadS
 	memset(_synthBufOffset, 0, sizeof(_synthBufOffset));
 	memset(_sbSamples, 0, sizeof(_sbSamples));
 	memset(_outputBuffer, 0, sizeof(_outputBuffer));
+	memset(_toneLevel, 0, sizeof(_toneLevel));
+	memset(_codingMethod, 0, sizeof(_codingMethod));
+	memset(_toneLevelIdxBase, 0, sizeof(_toneLevelIdxBase));
+	memset(_toneLevelIdxHi1, 0, sizeof(_toneLevelIdxHi1));
+	memset(_toneLevelIdxMid, 0, sizeof(_toneLevelIdxMid));
+	memset(_toneLevelIdxHi2, 0, sizeof(_toneLevelIdxHi2));
+	memset(_toneLevelIdx, 0, sizeof(_toneLevelIdx));
+	memset(_toneLevelIdxTemp, 0, sizeof(_toneLevelIdxTemp));
 	_vlcsInitialized = false;
 	_superblocktype_2_3 = 0;
 	_hasErrors = false;
+	_doSynthFilter = 0;
+	_fftCoefsIndex = 0;
 
 	// Rewind extraData stream from any previous calls...
 	extraData->seek(0, SEEK_SET);
@@ -1913,7 +1922,9 @@ QDM2Stream::QDM2Stream(Common::SeekableReadStream *stream, Common::SeekableReadS
 	rndTableInit();
 	initNoiseSamples();
 
-	_compressedData = new uint8[_packetSize];
+	// The bit reader reads up to four bytes at once, also at the end
+	_compressedData = new uint8[_packetSize + FF_INPUT_BUFFER_PADDING_SIZE];
+	memset(_compressedData + _packetSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
 }
 
 QDM2Stream::~QDM2Stream() {
@@ -2250,67 +2261,67 @@ void QDM2Stream::fill_coding_method_array(sb_int8_array tone_level_idx, sb_int8_
 				}
 				tone_level_idx_temp[ch][sb][0] = tone_level_idx_temp[ch][sb][1];
 			}
-			acc = 0;
-			for (ch = 0; ch < nb_channels; ch++)
-				for (sb = 0; sb < 30; sb++)
-					for (j = 0; j < 64; j++)
-						acc += tone_level_idx_temp[ch][sb][j];
-
-			multres = 0x66666667 * (acc * 10);
-			esp_40 = (multres >> 32) / 8 + ((multres & 0xffffffff) >> 31);
-			for (ch = 0;  ch < nb_channels; ch++)
-				for (sb = 0; sb < 30; sb++)
-					for (j = 0; j < 64; j++) {
-						comp = tone_level_idx_temp[ch][sb][j]* esp_40 * 10;
-						if (comp < 0)
-							comp += 0xff;
-						comp /= 256; // signed shift
-						switch(sb) {
-							case 0:
-								if (comp < 30)
-									comp = 30;
-								comp += 15;
-								break;
-							case 1:
-								if (comp < 24)
-									comp = 24;
-								comp += 10;
-								break;
-							case 2:
-							case 3:
-							case 4:
-								if (comp < 16)
-									comp = 16;
-						}
-						if (comp <= 5)
-							tmp = 0;
-						else if (comp <= 10)
-							tmp = 10;
-						else if (comp <= 16)
-							tmp = 16;
-						else if (comp <= 24)
-							tmp = -1;
-						else
-							tmp = 0;
-						coding_method[ch][sb][j] = ((tmp & 0xfffa) + 30 )& 0xff;
+		acc = 0;
+		for (ch = 0; ch < nb_channels; ch++)
+			for (sb = 0; sb < 30; sb++)
+				for (j = 0; j < 64; j++)
+					acc += tone_level_idx_temp[ch][sb][j];
+
+		multres = 0x66666667 * (acc * 10);
+		esp_40 = (multres >> 32) / 8 + ((multres & 0xffffffff) >> 31);
+		for (ch = 0;  ch < nb_channels; ch++)
+			for (sb = 0; sb < 30; sb++)
+				for (j = 0; j < 64; j++) {
+					comp = tone_level_idx_temp[ch][sb][j]* esp_40 * 10;
+					if (comp < 0)
+						comp += 0xff;
+					comp /= 256; // signed shift
+					switch(sb) {
+						case 0:
+							if (comp < 30)
+								comp = 30;
+							comp += 15;
+							break;
+						case 1:
+							if (comp < 24)
+								comp = 24;
+							comp += 10;
+							break;
+						case 2:
+						case 3:
+						case 4:
+							if (comp < 16)
+								comp = 16;
 					}
+					if (comp <= 5)
+						tmp = 0;
+					else if (comp <= 10)
+						tmp = 10;
+					else if (comp <= 16)
+						tmp = 16;
+					else if (comp <= 24)
+						tmp = -1;
+					else
+						tmp = 0;
+					coding_method[ch][sb][j] = ((tmp & 0xfffa) + 30 )& 0xff;
+				}
+		for (sb = 0; sb < 30; sb++)
+			fix_coding_method_array(sb, nb_channels, coding_method);
+		for (ch = 0; ch < nb_channels; ch++)
 			for (sb = 0; sb < 30; sb++)
-				fix_coding_method_array(sb, nb_channels, coding_method);
-			for (ch = 0; ch < nb_channels; ch++)
-				for (sb = 0; sb < 30; sb++)
-					for (j = 0; j < 64; j++)
-						if (sb >= 10) {
-							if (coding_method[ch][sb][j] < 10)
-								coding_method[ch][sb][j] = 10;
+				for (j = 0; j < 64; j++)
+					if (sb >= 10) {
+						if (coding_method[ch][sb][j] < 10)
+							coding_method[ch][sb][j] = 10;
+					} else {
+						if (sb >= 2) {
+							if (coding_method[ch][sb][j] < 16)
+								coding_method[ch][sb][j] = 16;
 						} else {
-							if (sb >= 2) {
-								if (coding_method[ch][sb][j] < 16)
-									coding_method[ch][sb][j] = 16;
-							} else {
-								if (coding_method[ch][sb][j] < 30)
-									coding_method[ch][sb][j] = 30;
-							}
+							if (coding_method[ch][sb][j] < 30)
+								coding_method[ch][sb][j] = 30;
 						}
+					}
 	} else { // superblocktype_2_3 != 0
 		for (ch = 0; ch < nb_channels; ch++)
 			for (sb = 0; sb < 30; sb++)
@@ -2381,8 +2392,8 @@ void QDM2Stream::synthfilt_build_sb_samples(GetBitContext *gb, int length, int s
 						if (BITS_LEFT(length,gb) >= 10) {
 							if (zero_encoding) {
 								for (k = 0; k < 5; k++) {
-								if ((j + 2 * k) >= 128)
-									break;
+									if ((j + 2 * k) >= 128)
+										break;
 									samples[2 * k] = getBits1(gb) ? dequant_1bit[joined_stereo][2 * getBits1(gb)] : 0;
 								}
 							} else {
@@ -3272,8 +3283,15 @@ int QDM2Stream::readBuffer(int16 *buffer, const int numSamples) {
 	if (decodedSamples > numSamples)
 		decodedSamples = numSamples;
 
-	for (i = 0; i < decodedSamples; i++)
-		buffer[i] = _outputSamples.remove_at(0);
+	if (decodedSamples > 0) {
+		memcpy(buffer, _outputSamples.begin(), decodedSamples * sizeof(int16));
+
+		// Move the samples left to the front at once, rather than removing
+		// the samples read one by one
+		const int32 samplesLeft = _outputSamples.size() - decodedSamples;
+		memmove(_outputSamples.begin(), _outputSamples.begin() + decodedSamples, samplesLeft * sizeof(int16));
+		_outputSamples.resize(samplesLeft);
+	}
 
 	return decodedSamples;
 }
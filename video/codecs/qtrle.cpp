@@ -358,6 +358,8 @@ const Graphics::Surface *QTRLEDecoder::decodeImage(Common::SeekableReadStream *s
 	uint16 start_line = 0;
 	uint16 height = _surface->h;
 
+	_dirtyRects.clear();
+
 	// check if this frame is even supposed to change
 	if (stream->size() < 8)
 		return _surface;
@@ -380,6 +382,12 @@ const Graphics::Surface *QTRLEDecoder::decodeImage(Common::SeekableReadStream *s
 
 	uint32 row_ptr = _surface->w * start_line;
 
+	// Only the lines given in the header change
+	uint16 dirtyTop = MIN<uint32>(start_line, _surface->h);
+	uint16 dirtyBottom = MIN<uint32>(start_line + height, _surface->h);
+	if (dirtyTop < dirtyBottom)
+		_dirtyRects.push_back(Common::Rect(0, dirtyTop, _surface->w, dirtyBottom));
+
 	switch (_bitsPerPixel) {
 		case 1:
 		case 33:
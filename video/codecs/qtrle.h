@@ -38,6 +38,7 @@ public:
 
 	const Graphics::Surface *decodeImage(Common::SeekableReadStream *stream);
 	Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
+	bool hasDirtyRects() const { return true; }
 
 private:
 	byte _bitsPerPixel;
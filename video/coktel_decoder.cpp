@@ -165,10 +165,6 @@ uint16 CoktelDecoder::getDefaultY() const {
 	return _defaultY;
 }
 
-const Common::List<Common::Rect> &CoktelDecoder::getDirtyRects() const {
-	return _dirtyRects;
-}
-
 bool CoktelDecoder::hasPalette() const {
 	return (_features & kFeaturesPalette) != 0;
 }
@@ -292,6 +288,10 @@ bool CoktelDecoder::hasDirtyPalette() const {
 	return (_features & kFeaturesPalette) && _paletteDirty;
 }
 
+bool CoktelDecoder::hasDirtyRects() const {
+	return true;
+}
+
 uint32 CoktelDecoder::deLZ77(byte *dest, const byte *src, uint32 srcSize, uint32 destSize) {
 	uint32 frameLength = READ_LE_UINT32(src);
 	if (frameLength > destSize) {
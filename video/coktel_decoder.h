@@ -93,9 +93,6 @@ public:
 	/** Get the video's default Y position. */
 	uint16 getDefaultY() const;
 
-	/** Return a list of rectangles that changed in the last frame. */
-	const Common::List<Common::Rect> &getDirtyRects() const;
-
 	bool hasPalette() const;
 	virtual bool hasVideo() const;
 
@@ -140,6 +137,8 @@ public:
 	const byte *getPalette();
 	bool  hasDirtyPalette() const;
 
+	bool  hasDirtyRects() const;
+
 	uint32 getStaticTimeToNextFrame() const;
 
 protected:
@@ -183,8 +182,6 @@ protected:
 	bool    _ownSurface;
 	Graphics::Surface _surface;
 
-	Common::List<Common::Rect> _dirtyRects;
-
 	Common::Rational _frameRate;
 
 	// Current sound state
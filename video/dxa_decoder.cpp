@@ -209,6 +209,9 @@ void DXADecoder::decode12(int size) {
 			byte type = *dat++;
 			byte *b2 = _frameBuffer1 + bx + by * _width;
 
+			if (type != 0 && type != 5)
+				addDirtyRect(Common::Rect(bx, by, bx + BLOCKW, by + BLOCKH));
+
 			switch (type) {
 			case 0:
 				break;
@@ -322,6 +325,9 @@ void DXADecoder::decode13(int size) {
 			uint8 type = *codeBuf++;
 			uint8 *b2 = (uint8*)_frameBuffer1 + bx + by * _width;
 
+			if (type != 0)
+				addDirtyRect(Common::Rect(bx, by, bx + BLOCKW, by + BLOCKH));
+
 			switch (type) {
 			case 0:
 				break;
@@ -478,6 +484,8 @@ void DXADecoder::decode13(int size) {
 }
 
 const Graphics::Surface *DXADecoder::decodeNextFrame() {
+	_dirtyRects.clear();
+
 	uint32 tag = _fileStream->readUint32BE();
 	if (tag == MKID_BE('CMAP')) {
 		_fileStream->read(_palette, 256 * 3);
@@ -502,9 +510,11 @@ const Graphics::Surface *DXADecoder::decodeNextFrame() {
 		switch (type) {
 		case 2:
 			decodeZlib(_frameBuffer1, size, _frameSize);
+			setFullDirtyRect(_width, _curHeight);
 			break;
 		case 3:
 			decodeZlib(_frameBuffer2, size, _frameSize);
+			setFullDirtyRect(_width, _curHeight);
 			break;
 		case 12:
 			decode12(size);
@@ -526,6 +536,22 @@ const Graphics::Surface *DXADecoder::decodeNextFrame() {
 		}
 	}
 
+	// The frame buffer only holds every other line of scaled frames, and
+	// the last blocks may reach beyond the frame
+	for (Common::List<Common::Rect>::iterator it = _dirtyRects.begin(); it != _dirtyRects.end(); ) {
+		if (_scaleMode != S_NONE) {
+			it->top *= 2;
+			it->bottom *= 2;
+		}
+
+		it->clip(getWidth(), getHeight());
+
+		if (it->isEmpty())
+			it = _dirtyRects.erase(it);
+		else
+			++it;
+	}
+
 	switch (_scaleMode) {
 	case S_INTERLACED:
 		for (int cy = 0; cy < _curHeight; cy++) {
@@ -553,8 +579,10 @@ const Graphics::Surface *DXADecoder::decodeNextFrame() {
 
 	_curFrame++;
 
-	if (_curFrame == 0)
+	if (_curFrame == 0) {
 		_startTime = g_system->getMillis();
+		setFullDirtyRect(getWidth(), getHeight());
+	}
 
 	return _surface;
 }
@@ -54,6 +54,7 @@ public:
 	Graphics::PixelFormat getPixelFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
 	const byte *getPalette() { _dirtyPalette = false; return _palette; }
 	bool hasDirtyPalette() const { return _dirtyPalette; }
+	bool hasDirtyRects() const { return true; }
 
 	/**
 	 * Get the sound chunk tag of the loaded DXA file
@@ -101,7 +101,7 @@ void FlicDecoder::close() {
 	_surface = 0;
 
 	free(_palette);
-	_dirtyRects.clear();
+	_bufferDirtyRects.clear();
 
 	reset();
 }
@@ -124,8 +124,9 @@ void FlicDecoder::decodeByteRun(uint8 *data) {
 	}
 
 	// Redraw
-	_dirtyRects.clear();
-	_dirtyRects.push_back(Common::Rect(0, 0, getWidth(), getHeight()));
+	setFullDirtyRect(getWidth(), getHeight());
+	_bufferDirtyRects.clear();
+	_bufferDirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
 }
 
 #define OP_PACKETCOUNT   0
@@ -133,6 +134,13 @@ void FlicDecoder::decodeByteRun(uint8 *data) {
 #define OP_LASTPIXEL     2
 #define OP_LINESKIPCOUNT 3
 
+void FlicDecoder::addDeltaRect(const Common::Rect &rect) {
+	addDirtyRect(rect);
+
+	// Only the changed pixels, the buffer may differ in between
+	_bufferDirtyRects.push_back(rect);
+}
+
 void FlicDecoder::decodeDeltaFLC(uint8 *data) {
 	uint16 linesInChunk = READ_LE_UINT16(data); data += 2;
 	uint16 currentLine = 0;
@@ -153,7 +161,7 @@ void FlicDecoder::decodeDeltaFLC(uint8 *data) {
 				break;
 			case OP_LASTPIXEL:
 				*((byte *)_surface->pixels + currentLine * getWidth() + getWidth() - 1) = (opcode & 0xFF);
-				_dirtyRects.push_back(Common::Rect(getWidth() - 1, currentLine, getWidth(), currentLine + 1));
+				addDeltaRect(Common::Rect(getWidth() - 1, currentLine, getWidth(), currentLine + 1));
 				break;
 			case OP_LINESKIPCOUNT:
 				currentLine += -(int16)opcode;
@@ -170,14 +178,14 @@ void FlicDecoder::decodeDeltaFLC(uint8 *data) {
 			if (rleCount > 0) {
 				memcpy((byte *)_surface->pixels + (currentLine * getWidth()) + column, data, rleCount * 2);
 				data += rleCount * 2;
-				_dirtyRects.push_back(Common::Rect(column, currentLine, column + rleCount * 2, currentLine + 1));
+				addDeltaRect(Common::Rect(column, currentLine, column + rleCount * 2, currentLine + 1));
 			} else if (rleCount < 0) {
 				rleCount = -rleCount;
 				uint16 dataWord = READ_UINT16(data); data += 2;
 				for (int i = 0; i < rleCount; ++i) {
 					WRITE_UINT16((byte *)_surface->pixels + currentLine * getWidth() + column + i * 2, dataWord);
 				}
-				_dirtyRects.push_back(Common::Rect(column, currentLine, column + rleCount * 2, currentLine + 1));
+				addDeltaRect(Common::Rect(column, currentLine, column + rleCount * 2, currentLine + 1));
 			} else { // End of cutscene ?
 				return;
 			}
@@ -200,6 +208,8 @@ const Graphics::Surface *FlicDecoder::decodeNextFrame() {
 	uint16 frameType = _fileStream->readUint16LE();
 	uint16 chunkCount = 0;
 
+	_dirtyRects.clear();
+
 	switch (frameType) {
 	case FRAME_TYPE:
 		{
@@ -227,6 +237,7 @@ const Graphics::Surface *FlicDecoder::decodeNextFrame() {
 				delete _surface;
 				_surface = new Graphics::Surface();
 				_surface->create(newWidth, newHeight, 1);
+				setFullDirtyRect(newWidth, newHeight);
 			}
 		}
 		break;
@@ -311,13 +322,13 @@ void FlicDecoder::unpackPalette(uint8 *data) {
 }
 
 void FlicDecoder::copyDirtyRectsToBuffer(uint8 *dst, uint pitch) {
-	for (Common::List<Common::Rect>::const_iterator it = _dirtyRects.begin(); it != _dirtyRects.end(); ++it) {
+	for (Common::List<Common::Rect>::const_iterator it = _bufferDirtyRects.begin(); it != _bufferDirtyRects.end(); ++it) {
 		for (int y = (*it).top; y < (*it).bottom; ++y) {
 			const int x = (*it).left;
 			memcpy(dst + y * pitch + x, (byte *)_surface->pixels + y * getWidth() + x, (*it).right - x);
 		}
 	}
-	_dirtyRects.clear();
+	_bufferDirtyRects.clear();
 }
 
 } // End of namespace Video
@@ -67,8 +67,14 @@ public:
 	uint32 getFrameCount() const { return _frameCount; }
 	Graphics::PixelFormat getPixelFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
 
-	const Common::List<Common::Rect> *getDirtyRects() const { return &_dirtyRects; }
-	void clearDirtyRects() { _dirtyRects.clear(); }
+	bool hasDirtyRects() const { return true; }
+	void clearDirtyRects() { _dirtyRects.clear(); _bufferDirtyRects.clear(); }
+
+	/**
+	 * Copy the areas changed since the last call to a buffer. Unlike
+	 * getDirtyRects(), this includes the changes of all the frames decoded
+	 * in between, so the frames may also be copied in other ways meanwhile.
+	 */
 	void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
 
 	const byte *getPalette() { _paletteChanged = false; return _palette; }
@@ -86,14 +92,16 @@ private:
 
 	void decodeByteRun(uint8 *data);
 	void decodeDeltaFLC(uint8 *data);
+	void addDeltaRect(const Common::Rect &rect);
 	void unpackPalette(uint8 *mem);
 
+	// The areas changed since the last copyDirtyRectsToBuffer() call
+	Common::List<Common::Rect> _bufferDirtyRects;
+
 	Common::SeekableReadStream *_fileStream;
 	Graphics::Surface *_surface;
 	uint32 _frameCount;
 	Common::Rational _frameRate;
-
-	Common::List<Common::Rect> _dirtyRects;
 };
 
 } // End of namespace Video
@@ -67,6 +67,7 @@ QuickTimeDecoder::QuickTimeDecoder() : VideoDecoder() {
 	_audHandle = Audio::SoundHandle();
 	_numStreams = 0;
 	_fd = 0;
+	_prevVideoCodec = 0;
 	_scaledSurface = 0;
 	_scaleFactorX = 1;
 	_scaleFactorY = 1;
@@ -121,18 +122,24 @@ uint32 QuickTimeDecoder::getFrameDuration() {
 	if (_videoStreamIndex < 0)
 		return 0;
 
-	uint32 curFrameIndex = 0;
-	for (int32 i = 0; i < _streams[_videoStreamIndex]->stts_count; i++) {
-		curFrameIndex += _streams[_videoStreamIndex]->stts_data[i].count;
-		if ((uint32)_curFrame < curFrameIndex) {
-			// Ok, now we have what duration this frame has.
-			return _streams[_videoStreamIndex]->stts_data[i].duration;
-		}
-	}
+	MOVStreamContext *st = _streams[_videoStreamIndex];
 
 	// This should never occur
-	error ("Cannot find duration for frame %d", _curFrame);
-	return 0;
+	if (_curFrame < 0 || (uint32)_curFrame >= st->sample_index_sz) {
+		error ("Cannot find duration for frame %d", _curFrame);
+		return 0;
+	}
+
+	return getFrameEndTime(_curFrame) - st->sample_index[_curFrame].time;
+}
+
+uint32 QuickTimeDecoder::getFrameEndTime(uint32 frame) const {
+	const MOVStreamContext *st = _streams[_videoStreamIndex];
+
+	if (frame + 1 < st->sample_index_sz)
+		return st->sample_index[frame + 1].time;
+
+	return st->sample_index_end_time;
 }
 
 Graphics::PixelFormat QuickTimeDecoder::getPixelFormat() const {
@@ -145,10 +152,22 @@ Graphics::PixelFormat QuickTimeDecoder::getPixelFormat() const {
 }
 
 uint32 QuickTimeDecoder::findKeyFrame(uint32 frame) const {
-	for (int i = _streams[_videoStreamIndex]->keyframe_count - 1; i >= 0; i--)
-		if (_streams[_videoStreamIndex]->keyframes[i] <= frame)
-				return _streams[_videoStreamIndex]->keyframes[i];
-	
+	const MOVStreamContext *st = _streams[_videoStreamIndex];
+
+	// The key frames are sorted, search for the first one after the frame
+	uint32 low = 0, high = st->keyframe_count;
+	while (low < high) {
+		uint32 mid = (low + high) / 2;
+
+		if (st->keyframes[mid] <= frame)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low > 0)
+		return st->keyframes[low - 1];
+
 	// If none found, we'll assume the requested frame is a key frame
 	return frame;
 }
@@ -165,16 +184,11 @@ void QuickTimeDecoder::seekToFrame(uint32 frame) {
 	while (_curFrame < (int32)frame - 1)
 		decodeNextFrame();
 
-	// Map out the starting point
-	_nextFrameStartTime = 0;
-	uint32 curFrame = 0;
+	// The next frame doesn't follow the one shown
+	_prevVideoCodec = 0;
 
-	for (int32 i = 0; i < _streams[_videoStreamIndex]->stts_count && curFrame < frame; i++) {
-		for (int32 j = 0; j < _streams[_videoStreamIndex]->stts_data[i].count && curFrame < frame; j++) {
-			curFrame++;
-			_nextFrameStartTime += _streams[_videoStreamIndex]->stts_data[i].duration;
-		}
-	}
+	// Map out the starting point
+	_nextFrameStartTime = _streams[_videoStreamIndex]->sample_index[frame].time;
 
 	// Adjust the video starting point
 	_startTime = g_system->getMillis() - Video::VideoTimestamp(_nextFrameStartTime, _streams[_videoStreamIndex]->time_scale).getUnitsInScale(1000);
@@ -188,45 +202,49 @@ void QuickTimeDecoder::seekToFrame(uint32 frame) {
 		STSDEntry *entry = &_streams[_audioStreamIndex]->stsdEntries[0];
 		_audStream = Audio::makeQueuingAudioStream(entry->sampleRate, entry->channels == 2);
 
-		// First, we need to track down what audio sample we need
+		// First, we need to track down what audio sample we need. Audio
+		// samples are too many to index, but they're mostly of the same
+		// duration, so skip whole time-to-sample entries.
+		uint32 audioTime = Video::VideoTimestamp(_nextFrameStartTime, _streams[_videoStreamIndex]->time_scale).getUnitsInScale(_streams[_audioStreamIndex]->time_scale);
 		uint32 curTime = 0;
 		uint sample = 0;
-		bool done = false;
-		for (int32 i = 0; i < _streams[_audioStreamIndex]->stts_count && !done; i++) {
-			for (int32 j = 0; j < _streams[_audioStreamIndex]->stts_data[i].count; j++) {
-				curTime += _streams[_audioStreamIndex]->stts_data[i].duration;
-
-				if (curTime > Video::VideoTimestamp(_nextFrameStartTime, _streams[_videoStreamIndex]->time_scale).getUnitsInScale(_streams[_audioStreamIndex]->time_scale)) {
-					done = true;
-					break;
-				}
+		for (int32 i = 0; i < _streams[_audioStreamIndex]->stts_count; i++) {
+			uint32 sampleCount = _streams[_audioStreamIndex]->stts_data[i].count;
+			uint32 sampleDuration = _streams[_audioStreamIndex]->stts_data[i].duration;
+
+			// Samples without a duration take no time
+			if (sampleDuration == 0) {
+				sample += sampleCount;
+				continue;
+			}
 
-				sample++;
+			// Compare sample counts rather than times, as the duration of
+			// the whole entry may not fit into 32 bits
+			uint32 samplesLeft = (audioTime - curTime) / sampleDuration;
+
+			if (samplesLeft < sampleCount) {
+				sample += samplesLeft;
+				break;
 			}
+
+			curTime += sampleCount * sampleDuration;
+			sample += sampleCount;
 		}
 
 		// Now to track down what chunk it's in
-		_curAudioChunk = 0;
 		uint32 totalSamples = 0;
-		for (uint32 i = 0; i < _streams[_audioStreamIndex]->sample_to_chunk_sz; i++, _curAudioChunk++) {			
-			int sampleToChunkIndex = -1;
-
-			for (uint32 j = 0; j < _streams[_audioStreamIndex]->sample_to_chunk_sz; j++)
-				if (i >= _streams[_audioStreamIndex]->sample_to_chunk[j].first)
-					sampleToChunkIndex = j;
-
-			assert(sampleToChunkIndex >= 0);
-
-			totalSamples += _streams[_audioStreamIndex]->sample_to_chunk[sampleToChunkIndex].count;
+		for (_curAudioChunk = 0; _curAudioChunk < _streams[_audioStreamIndex]->chunk_count; _curAudioChunk++) {
+			uint32 sampleCount = getAudioChunkSampleCount(_curAudioChunk);
 
-			if (sample < totalSamples) {
-				totalSamples -= _streams[_audioStreamIndex]->sample_to_chunk[sampleToChunkIndex].count;
+			if (sample < totalSamples + sampleCount)
 				break;
-			}
+
+			totalSamples += sampleCount;
 		}
-		
+
 		// Reposition the audio stream
-		readNextAudioChunk();
+		if (_curAudioChunk < _streams[_audioStreamIndex]->chunk_count)
+			readNextAudioChunk();
 		if (sample != totalSamples) {
 			// HACK: Skip a certain amount of samples from the stream
 			// (There's got to be a better way to do this!)
@@ -249,23 +267,19 @@ void QuickTimeDecoder::seekToTime(VideoTimestamp time) {
 	// Convert to the local time scale
 	uint32 localTime = time.getUnitsInScale(_streams[_videoStreamIndex]->time_scale);
 
-	// Try to find the last frame that should have been decoded
-	uint32 frame = 0;
-	uint32 totalDuration = 0;
-	bool done = false;
+	// Try to find the last frame that should have been decoded, the
+	// first one which ends after the time
+	uint32 low = 0, high = _streams[_videoStreamIndex]->sample_index_sz;
+	while (low < high) {
+		uint32 mid = (low + high) / 2;
 
-	for (int32 i = 0; i < _streams[_videoStreamIndex]->stts_count && !done; i++) {
-		for (int32 j = 0; j < _streams[_videoStreamIndex]->stts_data[i].count; j++) {
-			totalDuration += _streams[_videoStreamIndex]->stts_data[i].duration;
-			if (localTime < totalDuration) {
-				done = true;
-				break;
-			}
-			frame++;
-		}
+		if (getFrameEndTime(mid) > localTime)
+			high = mid;
+		else
+			low = mid + 1;
 	}
 
-	seekToFrame(frame);
+	seekToFrame(low);
 }
 
 Codec *QuickTimeDecoder::createCodec(uint32 codecTag, byte bitsPerPixel) {
@@ -372,7 +386,21 @@ const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 		}
 	}
 
-	return scaleSurface(frame);
+	if (!frame)
+		return 0;
+
+	const Graphics::Surface *surface = scaleSurface(frame);
+
+	// After seeking or switching codecs the frame doesn't build on the
+	// previous one, and scaling redraws the whole scaled surface
+	if (_curFrame == 0 || entry->videoCodec != _prevVideoCodec || !entry->videoCodec->hasDirtyRects() || surface != frame)
+		setFullDirtyRect(surface->w, surface->h);
+	else
+		_dirtyRects = entry->videoCodec->getDirtyRects();
+
+	_prevVideoCodec = entry->videoCodec;
+
+	return surface;
 }
 
 const Graphics::Surface *QuickTimeDecoder::scaleSurface(const Graphics::Surface *frame) {
@@ -520,6 +548,8 @@ void QuickTimeDecoder::init() {
 
 	// Initialize video, if present
 	if (_videoStreamIndex >= 0) {
+		buildSampleIndex(_streams[_videoStreamIndex]);
+
 		for (uint32 i = 0; i < _streams[_videoStreamIndex]->stsdEntryCount; i++) {
 			STSDEntry *entry = &_streams[_videoStreamIndex]->stsdEntries[i];
 			entry->videoCodec = createCodec(entry->codecTag, entry->bitsPerSample & 0x1F);
@@ -1246,6 +1276,8 @@ void QuickTimeDecoder::close() {
 	delete _fd;
 	_fd = 0;
 
+	_prevVideoCodec = 0;
+
 	if (_scaledSurface) {
 		_scaledSurface->free();
 		delete _scaledSurface;
@@ -1258,58 +1290,71 @@ void QuickTimeDecoder::close() {
 	VideoDecoder::reset();
 }
 
-Common::SeekableReadStream *QuickTimeDecoder::getNextFramePacket(uint32 &descId) {
-	if (_videoStreamIndex < 0)
-		return NULL;
+void QuickTimeDecoder::buildSampleIndex(MOVStreamContext *st) {
+	st->sample_index_sz = st->nb_frames;
+	st->sample_index = new MOVsample[st->sample_index_sz];
 
-	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
+	// The time-to-sample table covers all the samples
+	uint32 sample = 0;
+	uint32 time = 0;
 
-	for (uint32 i = 0; i < _streams[_videoStreamIndex]->chunk_count; i++) {
-		int32 sampleToChunkIndex = -1;
+	for (int32 i = 0; i < st->stts_count; i++) {
+		for (int32 j = 0; j < st->stts_data[i].count; j++, sample++) {
+			st->sample_index[sample].offset = 0;
+			st->sample_index[sample].size = 0;
+			st->sample_index[sample].time = time;
+			st->sample_index[sample].id = 0;
+			time += st->stts_data[i].duration;
+		}
+	}
 
-		for (uint32 j = 0; j < _streams[_videoStreamIndex]->sample_to_chunk_sz; j++)
-			if (i >= _streams[_videoStreamIndex]->sample_to_chunk[j].first)
-				sampleToChunkIndex = j;
+	st->sample_index_end_time = time;
 
-		if (sampleToChunkIndex < 0)
-			error("This chunk (%d) is imaginary", sampleToChunkIndex);
+	// The sample size table may be shorter than that
+	uint32 sampleCount = st->sample_index_sz;
+	if (st->sample_size == 0)
+		sampleCount = MIN(sampleCount, st->sample_count);
 
-		totalSampleCount += _streams[_videoStreamIndex]->sample_to_chunk[sampleToChunkIndex].count;
+	// Go through the chunks, the sample-to-chunk table is sorted by the first chunk of each entry
+	sample = 0;
+	uint32 sampleToChunkIndex = 0;
 
-		if (totalSampleCount > getCurFrame()) {
-			actualChunk = i;
-			descId = _streams[_videoStreamIndex]->sample_to_chunk[sampleToChunkIndex].id;
-			sampleInChunk = _streams[_videoStreamIndex]->sample_to_chunk[sampleToChunkIndex].count - totalSampleCount + getCurFrame();
-			break;
+	for (uint32 i = 0; i < st->chunk_count && sample < sampleCount; i++) {
+		while (sampleToChunkIndex + 1 < st->sample_to_chunk_sz && i >= st->sample_to_chunk[sampleToChunkIndex + 1].first)
+			sampleToChunkIndex++;
+
+		if (sampleToChunkIndex >= st->sample_to_chunk_sz || i < st->sample_to_chunk[sampleToChunkIndex].first)
+			error("This chunk (%d) is imaginary", i);
+
+		const MOVstsc &entry = st->sample_to_chunk[sampleToChunkIndex];
+		uint32 offset = st->chunk_offsets[i];
+
+		for (uint32 j = 0; j < entry.count && sample < sampleCount; j++, sample++) {
+			st->sample_index[sample].offset = offset;
+			st->sample_index[sample].size = (st->sample_size != 0) ? st->sample_size : st->sample_sizes[sample];
+			st->sample_index[sample].id = entry.id;
+			offset += st->sample_index[sample].size;
 		}
 	}
+}
 
-	if (actualChunk < 0) {
-		warning ("Could not find data for frame %d", getCurFrame());
+Common::SeekableReadStream *QuickTimeDecoder::getNextFramePacket(uint32 &descId) {
+	if (_videoStreamIndex < 0)
 		return NULL;
-	}
 
-	// Next seek to that frame
-	_fd->seek(_streams[_videoStreamIndex]->chunk_offsets[actualChunk]);
+	MOVStreamContext *st = _streams[_videoStreamIndex];
 
-	// Then, if the chunk holds more than one frame, seek to where the frame we want is located
-	for (int32 i = getCurFrame() - sampleInChunk; i < getCurFrame(); i++) {
-		if (_streams[_videoStreamIndex]->sample_size != 0)
-			_fd->skip(_streams[_videoStreamIndex]->sample_size);
-		else
-			_fd->skip(_streams[_videoStreamIndex]->sample_sizes[i]);
+	if ((uint32)getCurFrame() >= st->sample_index_sz || !st->sample_index[getCurFrame()].id) {
+		warning ("Could not find data for frame %d", getCurFrame());
+		return NULL;
 	}
 
-	// Finally, read in the raw data for the frame
-	//printf ("Frame Data[%d]: Offset = %d, Size = %d\n", getCurFrame(), _fd->pos(), _streams[_videoStreamIndex]->sample_sizes[getCurFrame()]);
-
-	if (_streams[_videoStreamIndex]->sample_size != 0)
-		return _fd->readStream(_streams[_videoStreamIndex]->sample_size);
+	// The sample index tells where the frame is located
+	const MOVsample &sample = st->sample_index[getCurFrame()];
+	descId = sample.id;
 
-	return _fd->readStream(_streams[_videoStreamIndex]->sample_sizes[getCurFrame()]);
+	_fd->seek(sample.offset);
+	return _fd->readStream(sample.size);
 }
 
 bool QuickTimeDecoder::checkAudioCodecSupport(uint32 tag) {
@@ -1317,7 +1362,7 @@ bool QuickTimeDecoder::checkAudioCodecSupport(uint32 tag) {
 	if (tag == MKID_BE('twos') || tag == MKID_BE('raw ') || tag == MKID_BE('ima4'))
 		return true;
 
-#ifdef GRAPHICS_QDM2_H
+#ifdef VIDEO_CODECS_QDM2_H
 	if (tag == MKID_BE('QDM2'))
 		return true;
 #endif
@@ -1350,7 +1395,7 @@ Audio::AudioStream *QuickTimeDecoder::createAudioStream(Common::SeekableReadStre
 	} else if (entry->codecTag == MKID_BE('ima4')) {
 		// Riven uses this codec (as do some Myst ME videos)
 		return Audio::makeADPCMStream(stream, DisposeAfterUse::YES, stream->size(), Audio::kADPCMApple, entry->sampleRate, entry->channels, 34);
-#ifdef GRAPHICS_QDM2_H
+#ifdef VIDEO_CODECS_QDM2_H
 	} else if (entry->codecTag == MKID_BE('QDM2')) {
 		// Several Myst ME videos use this codec
 		return makeQDM2Stream(stream, _streams[_audioStreamIndex]->extradata);
@@ -1481,6 +1526,7 @@ QuickTimeDecoder::MOVStreamContext::~MOVStreamContext() {
 	delete[] sample_to_chunk;
 	delete[] sample_sizes;
 	delete[] keyframes;
+	delete[] sample_index;
 	delete[] stsdEntries;
 	delete extradata;
 }
@@ -104,6 +104,7 @@ public:
 	 */
 	const byte *getPalette() { _dirtyPalette = false; return _palette; }
 	bool hasDirtyPalette() const { return _dirtyPalette; }
+	bool hasDirtyRects() const { return true; }
 
 	/**
 	 * Set the beginning offset of the video so we can modify the offsets in the stco
@@ -149,6 +150,14 @@ private:
 		uint32 id;
 	};
 
+	// Where to find a sample, gathered from the chunk and sample tables
+	struct MOVsample {
+		uint32 offset;
+		uint32 size;
+		uint32 time;
+		uint32 id; // The sample description, 0 if the sample has no data
+	};
+
 	struct STSDEntry {
 		STSDEntry();
 		~STSDEntry();
@@ -191,6 +200,9 @@ private:
 		uint32 *sample_sizes;
 		uint32 keyframe_count;
 		uint32 *keyframes;
+		uint32 sample_index_sz;
+		MOVsample *sample_index;
+		uint32 sample_index_end_time;
 		int32 time_scale;
 		int time_rate;
 
@@ -228,6 +240,8 @@ private:
 	bool checkAudioCodecSupport(uint32 tag);
 	Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
 	uint32 getFrameDuration();
+	uint32 getFrameEndTime(uint32 frame) const;
+	void buildSampleIndex(MOVStreamContext *st);
 	void init();
 
 	Audio::QueuingAudioStream *_audStream;
@@ -247,6 +261,9 @@ private:
 	int8 _videoStreamIndex;
 	uint32 findKeyFrame(uint32 frame) const;
 
+	// The codec which decoded the previous frame, 0 after seeking
+	Codec *_prevVideoCodec;
+
 	Graphics::Surface *_scaledSurface;
 	const Graphics::Surface *scaleSurface(const Graphics::Surface *frame);
 	Common::Rational getScaleFactorX() const;
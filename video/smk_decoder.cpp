@@ -56,66 +56,73 @@ enum SmkBlockTypes {
 class BitStream {
 public:
 	BitStream(byte *buf, uint32 length)
-		: _buf(buf), _end(buf+length), _bitCount(8) {
-		_curByte = *_buf++;
+		: _buf(buf), _end(buf+length), _bits(0), _bitCount(0) {
+		refill();
 	}
 
 	bool getBit();
 	byte getBits8();
 
-	byte peek8() const;
+	uint32 peekBits();
 	void skip(int n);
 
 private:
+	void refill();
+
 	byte *_buf;
 	byte *_end;
-	byte _curByte;
-	byte  _bitCount;
+	uint32 _bits;		// Bits read ahead, the next one in the LSB
+	uint _bitCount;		// Number of bits read ahead
 };
 
+void BitStream::refill() {
+	while (_bitCount <= 24 && _buf < _end) {
+		_bits |= (uint32)*_buf++ << _bitCount;
+		_bitCount += 8;
+	}
+}
+
 bool BitStream::getBit() {
 	if (_bitCount == 0) {
-		assert(_buf < _end);
-		_curByte = *_buf++;
-		_bitCount = 8;
+		refill();
+		assert(_bitCount > 0);
 	}
 
-	bool v = _curByte & 1;
+	bool v = _bits & 1;
 
-	_curByte >>= 1;
+	_bits >>= 1;
 	--_bitCount;
 
 	return v;
 }
 
 byte BitStream::getBits8() {
-	assert(_buf < _end);
+	if (_bitCount < 8) {
+		refill();
+		assert(_bitCount >= 8);
+	}
 
-	byte v = (*_buf << _bitCount) | _curByte;
-	_curByte = *_buf++ >> (8 - _bitCount);
+	byte v = _bits & 0xFF;
+
+	_bits >>= 8;
+	_bitCount -= 8;
 
 	return v;
 }
 
-byte BitStream::peek8() const {
-	if (_buf == _end)
-		return _curByte;
+// Returns at least the next 16 bits, padded with zeros at the end of the stream
+uint32 BitStream::peekBits() {
+	if (_bitCount < 16)
+		refill();
 
-	assert(_buf < _end);
-	return (*_buf << _bitCount) | _curByte;
+	return _bits;
 }
 
 void BitStream::skip(int n) {
-	assert(n <= 8);
-	_curByte >>= n;
+	assert(n <= (int)_bitCount);
 
-	if (_bitCount >= n) {
-		_bitCount -= n;
-	} else {
-		assert(_buf < _end);
-		_bitCount = _bitCount + 8 - n;
-		_curByte = *_buf++ >> (8 - _bitCount);
-	}
+	_bits >>= n;
+	_bitCount -= n;
 }
 
 /*
@@ -190,7 +197,7 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint16 SmallHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
+	byte peek = bs.peekBits() & 0xFF;
 	uint16 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -220,14 +227,20 @@ private:
 		SMK_NODE = 0x80000000
 	};
 
+	enum {
+		// Codes up to this length are looked up directly, longer ones
+		// continue from the node at this length
+		SMK_LOOKUP_BITS = 12
+	};
+
 	uint32 decodeTree(uint32 prefix, int length);
 
 	uint32  _treeSize;
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 _prefixtree[1 << SMK_LOOKUP_BITS];
+	byte _prefixlength[1 << SMK_LOOKUP_BITS];
 
 	/* Used during construction */
 	BitStream &_bs;
@@ -238,6 +251,9 @@ private:
 
 BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 	: _bs(bs) {
+	for (int i = 0; i < (1 << SMK_LOOKUP_BITS); ++i)
+		_prefixtree[i] = _prefixlength[i] = 0;
+
 	uint32 bit = _bs.getBit();
 	if (!bit) {
 		_tree = new uint32[1];
@@ -246,9 +262,6 @@ BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
-
 	_loBytes = new SmallHuffmanTree(_bs);
 	_hiBytes = new SmallHuffmanTree(_bs);
 
@@ -298,8 +311,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= SMK_LOOKUP_BITS) {
+			for (int i = 0; i < (1 << SMK_LOOKUP_BITS); i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -318,9 +331,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == SMK_LOOKUP_BITS) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = SMK_LOOKUP_BITS;
 	}
 
 	uint32 r1 = decodeTree(prefix, length + 1);
@@ -332,7 +345,7 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint32 BigHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
+	uint32 peek = bs.peekBits() & ((1 << SMK_LOOKUP_BITS) - 1);
 	uint32 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -356,6 +369,7 @@ SmackerDecoder::SmackerDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soun
 	: _audioStarted(false), _audioStream(0), _mixer(mixer), _soundType(soundType) {
 	_surface = 0;
 	_fileStream = 0;
+	_backgroundReading = false;
 	_dirtyPalette = false;
 }
 
@@ -370,10 +384,19 @@ uint32 SmackerDecoder::getElapsedTime() const {
 	return VideoDecoder::getElapsedTime();
 }
 
+void SmackerDecoder::setBackgroundReading(bool enable) {
+	_backgroundReading = enable;
+
+	if (_fileStream)
+		_fileStream->setBackgroundReading(enable);
+}
+
 bool SmackerDecoder::load(Common::SeekableReadStream *stream) {
 	close();
 
-	_fileStream = stream;
+	// The frames are read sequentially, read the next ones while playing
+	_fileStream = new Common::ReadAheadSeekableReadStream(stream, DisposeAfterUse::YES);
+	_fileStream->setBackgroundReading(_backgroundReading);
 
 	// Seek to the first frame
 	_header.signature = _fileStream->readUint32BE();
@@ -582,27 +605,38 @@ const Graphics::Surface *SmackerDecoder::decodeNextFrame() {
 
 	byte *out;
 	uint type, run, j, mode;
-	uint32 p1, p2, clr, map;
-	byte hi, lo;
+	uint32 p1, p2, clr, map, hi, lo, row;
+
+	// Masks selecting the pixels of a row of a mono block, in memory order
+	uint32 monoMasks[16];
+	for (i = 0; i < 16; i++) {
+		const byte mask[4] = {
+			(byte)((i & 1) ? 0xFF : 0), (byte)((i & 2) ? 0xFF : 0),
+			(byte)((i & 4) ? 0xFF : 0), (byte)((i & 8) ? 0xFF : 0)
+		};
+		monoMasks[i] = READ_UINT32(mask);
+	}
+
+	_dirtyRects.clear();
 
 	while (block < blocks) {
 		type = _TypeTree->getCode(bs);
 		run = getBlockRun((type >> 2) & 0x3f);
 
+		const uint runStart = block;
+
 		switch (type & 3) {
 		case SMK_BLOCK_MONO:
 			while (run-- && block < blocks) {
 				clr = _MClrTree->getCode(bs);
 				map = _MMapTree->getCode(bs);
 				out = (byte *)_surface->pixels + (block / bw) * (stride * 4 * doubleY) + (block % bw) * 4;
-				hi = clr >> 8;
-				lo = clr & 0xff;
+				hi = (clr >> 8) * 0x01010101;
+				lo = (clr & 0xff) * 0x01010101;
 				for (i = 0; i < 4; i++) {
+					row = (hi & monoMasks[map & 0xF]) | (lo & ~monoMasks[map & 0xF]);
 					for (j = 0; j < doubleY; j++) {
-						out[0] = (map & 1) ? hi : lo;
-						out[1] = (map & 2) ? hi : lo;
-						out[2] = (map & 4) ? hi : lo;
-						out[3] = (map & 8) ? hi : lo;
+						WRITE_UINT32(out, row);
 						out += stride;
 					}
 					map >>= 4;
@@ -633,29 +667,25 @@ const Graphics::Surface *SmackerDecoder::decodeNextFrame() {
 						for (i = 0; i < 4; ++i) {
 							p1 = _FullTree->getCode(bs);
 							p2 = _FullTree->getCode(bs);
+							row = (p1 << 16) | p2;
 							for (j = 0; j < doubleY; ++j) {
-								out[2] = p1 & 0xff;
-								out[3] = p1 >> 8;
-								out[0] = p2 & 0xff;
-								out[1] = p2 >> 8;
+								WRITE_LE_UINT32(out, row);
 								out += stride;
 							}
 						}
 						break;
 					case 1:
 						p1 = _FullTree->getCode(bs);
-						out[0] = out[1] = p1 & 0xFF;
-						out[2] = out[3] = p1 >> 8;
+						row = (p1 & 0xFF) * 0x0101 | (p1 >> 8) * 0x01010000;
+						WRITE_LE_UINT32(out, row);
 						out += stride;
-						out[0] = out[1] = p1 & 0xFF;
-						out[2] = out[3] = p1 >> 8;
+						WRITE_LE_UINT32(out, row);
 						out += stride;
 						p2 = _FullTree->getCode(bs);
-						out[0] = out[1] = p2 & 0xFF;
-						out[2] = out[3] = p2 >> 8;
+						row = (p2 & 0xFF) * 0x0101 | (p2 >> 8) * 0x01010000;
+						WRITE_LE_UINT32(out, row);
 						out += stride;
-						out[0] = out[1] = p2 & 0xFF;
-						out[2] = out[3] = p2 >> 8;
+						WRITE_LE_UINT32(out, row);
 						out += stride;
 						break;
 					case 2:
@@ -665,18 +695,9 @@ const Graphics::Surface *SmackerDecoder::decodeNextFrame() {
 							// http://article.gmane.org/gmane.comp.video.ffmpeg.devel/78768
 							p2 = _FullTree->getCode(bs);
 							p1 = _FullTree->getCode(bs);
-							for (j = 0; j < doubleY; ++j) {
-								out[0] = p1 & 0xff;
-								out[1] = p1 >> 8;
-								out[2] = p2 & 0xff;
-								out[3] = p2 >> 8;
-								out += stride;
-							}
-							for (j = 0; j < doubleY; ++j) {
-								out[0] = p1 & 0xff;
-								out[1] = p1 >> 8;
-								out[2] = p2 & 0xff;
-								out[3] = p2 >> 8;
+							row = (p2 << 16) | p1;
+							for (j = 0; j < 2 * doubleY; ++j) {
+								WRITE_LE_UINT32(out, row);
 								out += stride;
 							}
 						}
@@ -686,8 +707,7 @@ const Graphics::Surface *SmackerDecoder::decodeNextFrame() {
 			}
 			break;
 		case SMK_BLOCK_SKIP:
-			while (run-- && block < blocks)
-				block++;
+			block += MIN<uint>(run, blocks - block);
 			break;
 		case SMK_BLOCK_FILL:
 			uint32 col;
@@ -696,25 +716,43 @@ const Graphics::Surface *SmackerDecoder::decodeNextFrame() {
 				out = (byte *)_surface->pixels + (block / bw) * (stride * 4 * doubleY) + (block % bw) * 4;
 				col = mode * 0x01010101;
 				for (i = 0; i < 4 * doubleY; ++i) {
-					out[0] = out[1] = out[2] = out[3] = col;
+					WRITE_UINT32(out, col);
 					out += stride;
 				}
 				++block;
 			}
 			break;
 		}
+
+		if ((type & 3) != SMK_BLOCK_SKIP)
+			addDirtyBlocks(runStart, block, bw, 4 * doubleY);
 	}
 
 	_fileStream->seek(startPos + frameSize);
 
 	free(_frameData);
 
-	if (_curFrame == 0)
+	if (_curFrame == 0) {
 		_startTime = g_system->getMillis();
+		setFullDirtyRect(getWidth(), getHeight());
+	}
 
 	return _surface;
 }
 
+void SmackerDecoder::addDirtyBlocks(uint firstBlock, uint endBlock, uint blocksPerRow, uint blockHeight) {
+	// Blocks are numbered row by row, add the run row by row as well
+	while (firstBlock < endBlock) {
+		const uint row = firstBlock / blocksPerRow;
+		const uint rowEnd = MIN<uint>((row + 1) * blocksPerRow, endBlock);
+
+		addDirtyRect(Common::Rect((firstBlock - row * blocksPerRow) * 4, row * blockHeight,
+		                          (rowEnd - row * blocksPerRow) * 4, (row + 1) * blockHeight));
+
+		firstBlock = rowEnd;
+	}
+}
+
 void SmackerDecoder::handleAudioTrack(byte track, uint32 chunkSize, uint32 unpackedSize) {
 	if (_header.audioInfo[track].hasAudio && chunkSize > 0 && track == 0) {
 		// If it's track 0, play the audio data
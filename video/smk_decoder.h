@@ -27,6 +27,7 @@
 #define VIDEO_SMK_PLAYER_H
 
 #include "video/video_decoder.h"
+#include "common/bufferedstream.h"
 #include "sound/mixer.h"
 
 namespace Audio {
@@ -70,16 +71,27 @@ public:
 	Graphics::PixelFormat getPixelFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
 	const byte *getPalette() { _dirtyPalette = false; return _palette; }
 	bool hasDirtyPalette() const { return _dirtyPalette; }
+	bool hasDirtyRects() const { return true; }
+
+	/**
+	 * Read the following frames of the video from a timer callback while
+	 * playing. Only enable this if the stream given to load() has a file
+	 * handle of its own, which nothing else reads from meanwhile.
+	 */
+	void setBackgroundReading(bool enable);
+
 	virtual void handleAudioTrack(byte track, uint32 chunkSize, uint32 unpackedSize);
 
 protected:
 	Common::Rational getFrameRate() const { return _frameRate; }
-	Common::SeekableReadStream *_fileStream;
+	Common::ReadAheadSeekableReadStream *_fileStream;
+	bool _backgroundReading;
 
 protected:
 	void unpackPalette();
 	// Possible runs of blocks
 	uint getBlockRun(int index) { return (index <= 58) ? index + 1 : 128 << (index - 59); }
+	void addDirtyBlocks(uint firstBlock, uint endBlock, uint blocksPerRow, uint blockHeight);
 	void queueCompressedBuffer(byte *buffer, uint32 bufferSize, uint32 unpackedSize, int streamNum);
 
 	enum AudioCompression {
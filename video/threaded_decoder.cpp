@@ -0,0 +1,358 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "video/threaded_decoder.h"
+
+#include "common/system.h"
+#include "common/timer.h"
+
+namespace Video {
+
+// All the wrappers share one timer callback, since removing a timer
+// callback removes all of its instances. The list is only modified while
+// the callback is removed, so the callback can walk it without locking.
+static Common::List<ThreadedVideoDecoder *> *s_decoders = 0;
+
+ThreadedVideoDecoder::ThreadedVideoDecoder(VideoDecoder *decoder, uint queueSize, DisposeAfterUse::Flag disposeAfterUse) :
+		_decoder(decoder), _seekableDecoder(0), _disposeAfterUse(disposeAfterUse) {
+	init(queueSize);
+}
+
+ThreadedVideoDecoder::ThreadedVideoDecoder(SeekableVideoDecoder *decoder, uint queueSize, DisposeAfterUse::Flag disposeAfterUse) :
+		_decoder(decoder), _seekableDecoder(decoder), _disposeAfterUse(disposeAfterUse) {
+	init(queueSize);
+}
+
+void ThreadedVideoDecoder::init(uint queueSize) {
+	assert(_decoder);
+	assert(queueSize > 0);
+
+	_shownFrame = 0;
+	_queueSize = queueSize;
+	_frameCount = 0;
+
+	memset(_palette, 0, sizeof(_palette));
+	_hasPalette = false;
+	_dirtyPalette = false;
+
+	_dropLateFrames = false;
+	_lateFrames = 0;
+	_droppedFrames = 0;
+
+	// Pick up a video the wrapped decoder already started
+	_curFrame = _decoder->getCurFrame();
+
+	registerDecoder(this, true);
+}
+
+ThreadedVideoDecoder::~ThreadedVideoDecoder() {
+	registerDecoder(this, false);
+
+	flushQueue();
+
+	for (FrameList::iterator it = _freeFrames.begin(); it != _freeFrames.end(); ++it) {
+		(*it)->surface.free();
+		delete *it;
+	}
+
+	if (_shownFrame) {
+		_shownFrame->surface.free();
+		delete _shownFrame;
+	}
+
+	if (_disposeAfterUse == DisposeAfterUse::YES)
+		delete _decoder;
+}
+
+void ThreadedVideoDecoder::registerDecoder(ThreadedVideoDecoder *decoder, bool add) {
+	Common::TimerManager *timer = g_system->getTimerManager();
+
+	// Once removed, the callback isn't running anymore
+	timer->removeTimerProc(prefetchProc);
+
+	if (!s_decoders)
+		s_decoders = new Common::List<ThreadedVideoDecoder *>();
+
+	if (add)
+		s_decoders->push_back(decoder);
+	else
+		s_decoders->remove(decoder);
+
+	if (!s_decoders->empty()) {
+		timer->installTimerProc(prefetchProc, kPrefetchInterval, 0);
+	} else {
+		delete s_decoders;
+		s_decoders = 0;
+	}
+}
+
+void ThreadedVideoDecoder::prefetchProc(void *refCon) {
+	for (Common::List<ThreadedVideoDecoder *>::iterator it = s_decoders->begin(); it != s_decoders->end(); ++it)
+		(*it)->prefetch();
+}
+
+void ThreadedVideoDecoder::prefetch() {
+	Common::StackLock lock(_mutex);
+
+	// Let the engine show the first frame itself, that starts the clock
+	if (!_decoder->isVideoLoaded() || _curFrame < 0 || isPaused())
+		return;
+
+	// Some decoders only end once their audio is finished too
+	if (_decoder->endOfVideo() || _decoder->getCurFrame() >= (int32)_decoder->getFrameCount() - 1)
+		return;
+
+	Frame *frame = getFreeFrame();
+	if (!frame)
+		return;
+
+	decodeFrame(frame);
+	_queue.push_back(frame);
+}
+
+ThreadedVideoDecoder::Frame *ThreadedVideoDecoder::getFreeFrame() {
+	if (_queue.size() >= _queueSize)
+		return 0;
+
+	if (!_freeFrames.empty()) {
+		Frame *frame = _freeFrames.front();
+		_freeFrames.pop_front();
+		return frame;
+	}
+
+	// There's one frame more than the queue holds, the one shown
+	assert(_frameCount <= _queueSize);
+	_frameCount++;
+	return new Frame();
+}
+
+void ThreadedVideoDecoder::decodeFrame(Frame *frame) {
+	// The time the frame is due, as the decoder sees it before decoding it
+	frame->dueTime = _decoder->getElapsedTime() + _decoder->getTimeToNextFrame();
+
+	const Graphics::Surface *surface = _decoder->decodeNextFrame();
+	frame->frameNumber = _decoder->getCurFrame();
+
+	// The decoder reuses its surface, keep a copy
+	frame->hasSurface = (surface != 0);
+	if (surface) {
+		if (frame->surface.w != surface->w || frame->surface.h != surface->h || frame->surface.bytesPerPixel != surface->bytesPerPixel)
+			frame->surface.create(surface->w, surface->h, surface->bytesPerPixel);
+
+		for (int y = 0; y < surface->h; y++)
+			memcpy(frame->surface.getBasePtr(0, y), surface->getBasePtr(0, y), surface->w * surface->bytesPerPixel);
+	}
+
+	frame->dirtyPalette = _decoder->hasDirtyPalette();
+	if (frame->dirtyPalette) {
+		const byte *palette = _decoder->getPalette();
+		if (palette)
+			memcpy(frame->palette, palette, sizeof(frame->palette));
+		else
+			frame->dirtyPalette = false;
+	}
+}
+
+void ThreadedVideoDecoder::flushQueue() {
+	while (!_queue.empty()) {
+		_freeFrames.push_back(_queue.front());
+		_queue.pop_front();
+	}
+}
+
+const Graphics::Surface *ThreadedVideoDecoder::decodeNextFrame() {
+	Common::StackLock lock(_mutex);
+
+	if (!_decoder->isVideoLoaded())
+		return 0;
+
+	if (_shownFrame)
+		_freeFrames.push_back(_shownFrame);
+	_shownFrame = 0;
+
+	const uint32 elapsedTime = _decoder->getElapsedTime();
+
+	if (_dropLateFrames) {
+		// Skip the frames whose successor is already due
+		while (_queue.size() >= 2 && elapsedTime >= (*++_queue.begin())->dueTime) {
+			Frame *frame = _queue.front();
+			_queue.pop_front();
+
+			if (frame->dirtyPalette) {
+				memcpy(_palette, frame->palette, sizeof(_palette));
+				_hasPalette = _dirtyPalette = true;
+			}
+
+			_freeFrames.push_back(frame);
+			_droppedFrames++;
+		}
+	}
+
+	if (!_queue.empty()) {
+		_shownFrame = _queue.front();
+		_queue.pop_front();
+	} else {
+		// Nothing decoded ahead (yet), decode it now
+		if (_freeFrames.empty()) {
+			_frameCount++;
+			_shownFrame = new Frame();
+		} else {
+			_shownFrame = _freeFrames.front();
+			_freeFrames.pop_front();
+		}
+
+		decodeFrame(_shownFrame);
+	}
+
+	if (elapsedTime > _shownFrame->dueTime + kLateFrameTime)
+		_lateFrames++;
+
+	if (_shownFrame->dirtyPalette) {
+		memcpy(_palette, _shownFrame->palette, sizeof(_palette));
+		_hasPalette = _dirtyPalette = true;
+	}
+
+	_curFrame = _shownFrame->frameNumber;
+
+	return _shownFrame->hasSurface ? &_shownFrame->surface : 0;
+}
+
+const byte *ThreadedVideoDecoder::getPalette() {
+	_dirtyPalette = false;
+	return _hasPalette ? _palette : 0;
+}
+
+uint32 ThreadedVideoDecoder::getTimeToNextFrame() const {
+	Common::StackLock lock(_mutex);
+
+	if (_queue.empty())
+		return _decoder->getTimeToNextFrame();
+
+	const uint32 elapsedTime = _decoder->getElapsedTime();
+	const uint32 dueTime = _queue.front()->dueTime;
+
+	if (dueTime <= elapsedTime)
+		return 0;
+
+	return dueTime - elapsedTime;
+}
+
+bool ThreadedVideoDecoder::endOfVideo() const {
+	Common::StackLock lock(_mutex);
+	return _queue.empty() && _decoder->endOfVideo();
+}
+
+uint16 ThreadedVideoDecoder::getWidth() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getWidth();
+}
+
+uint16 ThreadedVideoDecoder::getHeight() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getHeight();
+}
+
+uint32 ThreadedVideoDecoder::getFrameCount() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getFrameCount();
+}
+
+uint32 ThreadedVideoDecoder::getElapsedTime() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getElapsedTime();
+}
+
+Graphics::PixelFormat ThreadedVideoDecoder::getPixelFormat() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getPixelFormat();
+}
+
+bool ThreadedVideoDecoder::isVideoLoaded() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->isVideoLoaded();
+}
+
+bool ThreadedVideoDecoder::loadFile(const Common::String &filename) {
+	Common::StackLock lock(_mutex);
+
+	flushQueue();
+	reset();
+	_hasPalette = _dirtyPalette = false;
+	_lateFrames = _droppedFrames = 0;
+
+	return _decoder->loadFile(filename);
+}
+
+bool ThreadedVideoDecoder::load(Common::SeekableReadStream *stream) {
+	Common::StackLock lock(_mutex);
+
+	flushQueue();
+	reset();
+	_hasPalette = _dirtyPalette = false;
+	_lateFrames = _droppedFrames = 0;
+
+	return _decoder->load(stream);
+}
+
+void ThreadedVideoDecoder::close() {
+	Common::StackLock lock(_mutex);
+
+	flushQueue();
+	_decoder->close();
+	reset();
+}
+
+void ThreadedVideoDecoder::seekToFrame(uint32 frame) {
+	if (!_seekableDecoder) {
+		warning("ThreadedVideoDecoder: The wrapped decoder can't seek");
+		return;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	flushQueue();
+	_seekableDecoder->seekToFrame(frame);
+	_curFrame = _seekableDecoder->getCurFrame();
+}
+
+void ThreadedVideoDecoder::seekToTime(VideoTimestamp time) {
+	if (!_seekableDecoder) {
+		warning("ThreadedVideoDecoder: The wrapped decoder can't seek");
+		return;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	flushQueue();
+	_seekableDecoder->seekToTime(time);
+	_curFrame = _seekableDecoder->getCurFrame();
+}
+
+void ThreadedVideoDecoder::pauseVideoIntern(bool pause) {
+	Common::StackLock lock(_mutex);
+	_decoder->pauseVideo(pause);
+}
+
+} // End of namespace Video
@@ -0,0 +1,166 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef VIDEO_THREADED_DECODER_H
+#define VIDEO_THREADED_DECODER_H
+
+#include "video/video_decoder.h"
+
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/types.h"
+
+namespace Video {
+
+/**
+ * A VideoDecoder wrapper decoding the frames of another decoder ahead of
+ * time, so that decoding a heavy frame doesn't stall the engine.
+ *
+ * The frames are decoded from a timer callback, which the backend may run
+ * in a separate thread, into a bounded queue of frames and palettes. When
+ * the queue runs empty, decodeNextFrame() decodes synchronously, just like
+ * the wrapped decoder. Prefetching starts once the first frame has been
+ * shown, so that the clock of the wrapped decoder starts as usual.
+ *
+ * The wrapped decoder must not be used directly while it is wrapped.
+ */
+class ThreadedVideoDecoder : public SeekableVideoDecoder {
+public:
+	/**
+	 * Wrap a decoder.
+	 * @param decoder			the decoder to decode the frames with
+	 * @param queueSize			maximum number of frames decoded ahead
+	 * @param disposeAfterUse	whether to delete the decoder with the wrapper
+	 */
+	ThreadedVideoDecoder(VideoDecoder *decoder, uint queueSize = 4, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+	/**
+	 * Wrap a seekable decoder. Seeking flushes the frames decoded ahead.
+	 * @see ThreadedVideoDecoder(VideoDecoder *, uint, DisposeAfterUse::Flag)
+	 */
+	ThreadedVideoDecoder(SeekableVideoDecoder *decoder, uint queueSize = 4, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+	virtual ~ThreadedVideoDecoder();
+
+	uint16 getWidth() const;
+	uint16 getHeight() const;
+	uint32 getFrameCount() const;
+	uint32 getElapsedTime() const;
+	bool loadFile(const Common::String &filename);
+	bool load(Common::SeekableReadStream *stream);
+	void close();
+	bool isVideoLoaded() const;
+	const Graphics::Surface *decodeNextFrame();
+	Graphics::PixelFormat getPixelFormat() const;
+	const byte *getPalette();
+	bool hasDirtyPalette() const { return _dirtyPalette; }
+	bool endOfVideo() const;
+	uint32 getTimeToNextFrame() const;
+
+	/**
+	 * Returns whether the wrapped decoder can seek.
+	 */
+	bool isSeekable() const { return _seekableDecoder != 0; }
+
+	void seekToFrame(uint32 frame);
+	void seekToTime(VideoTimestamp time);
+
+	/**
+	 * Set whether queued frames are skipped when the next one is already
+	 * due. Palette changes of skipped frames are kept. Off by default.
+	 */
+	void setDropLateFrames(bool drop) { _dropLateFrames = drop; }
+
+	/**
+	 * Returns the number of frames shown more than kLateFrameTime ms
+	 * after they were due.
+	 */
+	uint32 getLateFrameCount() const { return _lateFrames; }
+
+	/**
+	 * Returns the number of frames skipped because they were late.
+	 */
+	uint32 getDroppedFrameCount() const { return _droppedFrames; }
+
+protected:
+	void pauseVideoIntern(bool pause);
+
+private:
+	enum {
+		kLateFrameTime = 20,		///< Lateness in ms for a frame to count as late
+		kPrefetchInterval = 10000	///< Interval of the prefetch timer in microseconds
+	};
+
+	struct Frame {
+		Graphics::Surface surface;
+		bool hasSurface;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		int32 frameNumber;
+		uint32 dueTime;		///< In the elapsed time of the wrapped decoder
+	};
+
+	typedef Common::List<Frame *> FrameList;
+
+	void init(uint queueSize);
+
+	/** Decodes the next frame of the wrapped decoder. Needs _mutex. */
+	void decodeFrame(Frame *frame);
+
+	/** Returns a frame to decode into, or 0 if the queue is full. Needs _mutex. */
+	Frame *getFreeFrame();
+
+	/** Drops the frames decoded ahead. Needs _mutex. */
+	void flushQueue();
+
+	/** Called from the timer, decodes a frame ahead if there's room for it. */
+	void prefetch();
+
+	static void prefetchProc(void *refCon);
+	static void registerDecoder(ThreadedVideoDecoder *decoder, bool add);
+
+	VideoDecoder *_decoder;
+	SeekableVideoDecoder *_seekableDecoder;
+	DisposeAfterUse::Flag _disposeAfterUse;
+
+	Common::Mutex _mutex;
+	FrameList _queue;		///< Frames decoded ahead, in order
+	FrameList _freeFrames;
+	Frame *_shownFrame;		///< The frame last returned by decodeNextFrame()
+	uint _queueSize;
+	uint _frameCount;		///< Number of frames allocated
+
+	byte _palette[256 * 3];
+	bool _hasPalette;
+	bool _dirtyPalette;
+
+	bool _dropLateFrames;
+	uint32 _lateFrames;
+	uint32 _droppedFrames;
+};
+
+} // End of namespace Video
+
+#endif
@@ -72,6 +72,7 @@ void VideoDecoder::reset() {
 	_curFrame = -1;
 	_startTime = 0;
 	_pauseLevel = 0;
+	_dirtyRects.clear();
 }
 
 bool VideoDecoder::endOfVideo() const {
@@ -105,6 +106,34 @@ void VideoDecoder::resetPauseStartTime() {
 		_pauseStartTime = g_system->getMillis();
 }
 
+void VideoDecoder::addDirtyRect(const Common::Rect &rect) {
+	if (rect.isEmpty())
+		return;
+
+	if (!_dirtyRects.empty()) {
+		Common::Rect &last = _dirtyRects.back();
+
+		// Extend the rectangle of the same row
+		if (last.top == rect.top && last.bottom == rect.bottom) {
+			last.extend(rect);
+			return;
+		}
+
+		// Extend the rectangle above with the same columns
+		if (last.left == rect.left && last.right == rect.right && last.bottom == rect.top) {
+			last.bottom = rect.bottom;
+			return;
+		}
+	}
+
+	_dirtyRects.push_back(rect);
+}
+
+void VideoDecoder::setFullDirtyRect(uint16 width, uint16 height) {
+	_dirtyRects.clear();
+	_dirtyRects.push_back(Common::Rect(width, height));
+}
+
 uint32 FixedRateVideoDecoder::getTimeToNextFrame() const {
 	if (endOfVideo() || _curFrame < 0)
 		return 0;
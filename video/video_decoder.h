@@ -29,6 +29,7 @@
 #include "common/events.h"
 #include "common/list.h"
 #include "common/rational.h"
+#include "common/rect.h"
 
 #include "graphics/surface.h"
 #include "graphics/pixelformat.h"
@@ -126,6 +127,25 @@ public:
 	 */
 	virtual bool hasDirtyPalette() const { return false; }
 
+	/**
+	 * Returns if the decoder keeps track of the areas each frame changes.
+	 * If not, any frame may change the whole surface.
+	 */
+	virtual bool hasDirtyRects() const { return false; }
+
+	/**
+	 * Returns the areas of the surface the frame returned by the last
+	 * decodeNextFrame() call changed. An empty list means the frame is
+	 * the same as the one before.
+	 *
+	 * The first frame after loading or seeking changes the whole surface.
+	 * A palette change alone doesn't show up in the list.
+	 *
+	 * @note only valid if hasDirtyRects() returns true and the last
+	 *       decodeNextFrame() call returned a surface
+	 */
+	const Common::List<Common::Rect> &getDirtyRects() const { return _dirtyRects; }
+
 	/**
 	 * Returns if the video is finished or not
 	 */
@@ -181,9 +201,22 @@ protected:
 	 */
 	void resetPauseStartTime();
 
+	/**
+	 * Add an area to the list of dirty rectangles. Areas added row by row
+	 * are merged into one rectangle for each row.
+	 */
+	void addDirtyRect(const Common::Rect &rect);
+
+	/**
+	 * Mark the whole surface as changed by the current frame
+	 */
+	void setFullDirtyRect(uint16 width, uint16 height);
+
 	int32 _curFrame;
 	int32 _startTime;
 
+	Common::List<Common::Rect> _dirtyRects;
+
 private:
 	uint32 _pauseLevel;
 	uint32 _pauseStartTime;